@@ -0,0 +1,203 @@
+/** @file broadcast.cpp
+	Compares broadcast rings against one fixed queue per subscriber for fanning out values.
+	A writer coroutine publishes `ticks` 64-byte ticks to 50 subscriber coroutines, either through one broadcast ring, or by pushing every tick to each subscriber's own queue. Rings and queues hold 64 values, and the ring uses backpressure. The sync types run on the simple scheduler, and the thread-safe types on the hybrid scheduler with one thread. Waiting coroutines are resumed directly, or through the scheduler's deferred resumer. Prints the time per tick.
+	Usage: `broadcast [ticks]` */
+#include <libcr/libcr.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+typedef cr::sync::FIFOScheduler Sync;
+typedef cr::HybridScheduler<cr::mt::FIFOConditionVariable, cr::sync::FIFOConditionVariable> Hybrid;
+
+/** A published value. */
+struct Tick
+{
+	/** The tick's contents. */
+	long fields[8];
+};
+
+/** The rings' and queues' capacity. */
+static constexpr std::size_t kSize = 64;
+/** The number of subscribers. */
+static constexpr std::size_t kSubscribers = 50;
+
+/** How many coroutines are still running. */
+static std::atomic_size_t s_running(0);
+
+template<class Ring>
+TEMPLATE_COROUTINE(RingWriter, (Ring), void)
+CR_STATE(
+	(Ring &) ring,
+	(std::size_t) ticks)
+	typename Ring::template PublishPattern<Tick const&> publish;
+	Tick tick;
+	std::size_t i;
+CR_INLINE
+	for(i = 0; i < ticks; i++)
+	{
+		tick.fields[0] = i;
+		CR_CALL(publish, (*ring, tick));
+	}
+CR_FINALLY
+	s_running.fetch_sub(1, std::memory_order_relaxed);
+CR_INLINE_END
+
+template<class Ring>
+TEMPLATE_COROUTINE(RingReader, (Ring), void)
+CR_STATE(
+	(Ring &) ring,
+	(std::size_t) ticks)
+	typename Ring::Cursor cursor;
+	typename Ring::Receive receive;
+	Tick tick;
+	std::size_t i;
+CR_INLINE
+	ring->subscribe(cursor);
+	for(i = 0; i < ticks; i++)
+	{
+		CR_CALL(receive, (*ring, cursor, tick));
+	}
+CR_FINALLY
+	ring->unsubscribe(cursor);
+	s_running.fetch_sub(1, std::memory_order_relaxed);
+CR_INLINE_END
+
+template<class Queue>
+TEMPLATE_COROUTINE(QueueWriter, (Queue), void)
+CR_STATE(
+	(Queue *) queues,
+	(std::size_t) ticks)
+	typename Queue::template PushPattern<Tick const&> push;
+	Tick tick;
+	std::size_t i;
+	std::size_t subscriber;
+CR_INLINE
+	for(i = 0; i < ticks; i++)
+	{
+		tick.fields[0] = i;
+		for(subscriber = 0; subscriber < kSubscribers; subscriber++)
+		{
+			CR_CALL(push, (queues[subscriber], tick));
+		}
+	}
+CR_FINALLY
+	s_running.fetch_sub(1, std::memory_order_relaxed);
+CR_INLINE_END
+
+template<class Queue>
+TEMPLATE_COROUTINE(QueueReader, (Queue), void)
+CR_STATE(
+	(Queue &) queue,
+	(std::size_t) ticks)
+	typename Queue::Pop pop;
+	Tick tick;
+	std::size_t i;
+CR_INLINE
+	for(i = 0; i < ticks; i++)
+	{
+		CR_CALL(pop, (*queue, tick));
+	}
+CR_FINALLY
+	s_running.fetch_sub(1, std::memory_order_relaxed);
+CR_INLINE_END
+
+/** Runs a scheduling round. */
+static void drive(
+	Sync &scheduler)
+{
+	scheduler.schedule();
+}
+
+/** Runs a scheduling round on the only thread. */
+static void drive(
+	Hybrid &scheduler)
+{
+	scheduler.schedule(0);
+}
+
+template<class Scheduler, class Ring>
+/** Fans the ticks out through a broadcast ring and returns the time per tick in nanoseconds. */
+static double run_ring(
+	std::size_t ticks,
+	bool deferred)
+{
+	Scheduler &scheduler = Scheduler::instance();
+	scheduler.initialise(1);
+
+	Ring ring;
+	if(deferred)
+		ring.set_resumer(scheduler.deferred());
+	RingWriter<Ring> writer;
+	std::vector<RingReader<Ring>> readers(kSubscribers);
+	s_running.store(kSubscribers + 1, std::memory_order_relaxed);
+
+	auto const start = std::chrono::steady_clock::now();
+	for(RingReader<Ring> &reader: readers)
+		reader.start(nullptr, ring, ticks);
+	writer.start(nullptr, ring, ticks);
+	while(s_running.load(std::memory_order_relaxed))
+		drive(scheduler);
+	auto const end = std::chrono::steady_clock::now();
+
+	return std::chrono::duration<double, std::nano>(end - start).count() / ticks;
+}
+
+template<class Scheduler, class Queue>
+/** Fans the ticks out through one queue per subscriber and returns the time per tick in nanoseconds. */
+static double run_queues(
+	std::size_t ticks,
+	bool deferred)
+{
+	Scheduler &scheduler = Scheduler::instance();
+	scheduler.initialise(1);
+
+	std::vector<Queue> queues(kSubscribers);
+	if(deferred)
+		for(Queue &queue: queues)
+			queue.set_resumer(scheduler.deferred());
+	QueueWriter<Queue> writer;
+	std::vector<QueueReader<Queue>> readers(kSubscribers);
+	s_running.store(kSubscribers + 1, std::memory_order_relaxed);
+
+	auto const start = std::chrono::steady_clock::now();
+	for(std::size_t i = 0; i < kSubscribers; i++)
+		readers[i].start(nullptr, queues[i], ticks);
+	writer.start(nullptr, queues.data(), ticks);
+	while(s_running.load(std::memory_order_relaxed))
+		drive(scheduler);
+	auto const end = std::chrono::steady_clock::now();
+
+	return std::chrono::duration<double, std::nano>(end - start).count() / ticks;
+}
+
+int main(
+	int argc,
+	char ** argv)
+{
+	std::size_t const ticks = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000;
+
+	typedef cr::sync::BroadcastRing<Tick, kSize> SyncRing;
+	typedef cr::mt::BroadcastRing<Tick, kSize> MtRing;
+	typedef cr::sync::FixedQueue<Tick, kSize> SyncQueue;
+	typedef cr::mt::FixedQueue<Tick, kSize> MtQueue;
+
+	std::printf("setup\tring [ns/tick]\tqueues [ns/tick]\n");
+	for(bool deferred: {true, false})
+	{
+		char const * resume = deferred ? "deferred" : "direct";
+		std::printf("mt, %s\t%.1f\t%.1f\n",
+			resume,
+			run_ring<Hybrid, MtRing>(ticks, deferred),
+			run_queues<Hybrid, MtQueue>(ticks, deferred));
+		std::printf("sync, %s\t%.1f\t%.1f\n",
+			resume,
+			run_ring<Sync, SyncRing>(ticks, deferred),
+			run_queues<Sync, SyncQueue>(ticks, deferred));
+	}
+
+	return 0;
+}
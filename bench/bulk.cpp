@@ -0,0 +1,162 @@
+/** @file bulk.cpp
+	Compares bulk pushing and popping against single pushes and pops on the fixed queues.
+	One coroutine pushes `items` longs through a 256-slot queue, and another coroutine pops them, either one by one or in batches of up to 64 values. The sync queue runs on the simple scheduler, and the thread-safe queue on the hybrid scheduler with one thread. Waiting coroutines are resumed through the scheduler's deferred resumer. Prints the time per item.
+	Usage: `bulk [items]` */
+#include <libcr/libcr.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+typedef cr::sync::FIFOScheduler Sync;
+typedef cr::HybridScheduler<cr::mt::FIFOConditionVariable, cr::sync::FIFOConditionVariable> Hybrid;
+
+/** The queues' capacity. */
+static constexpr std::size_t kSize = 256;
+/** The maximum batch size. */
+static constexpr std::size_t kBatch = 64;
+
+/** How many coroutines are still running. */
+static std::atomic_size_t s_running(0);
+
+template<class Queue>
+TEMPLATE_COROUTINE(Producer, (Queue), void)
+CR_STATE(
+	(Queue &) queue,
+	(std::size_t) items)
+	typename Queue::template PushPattern<long const&> push;
+	long value;
+CR_INLINE
+	for(value = 0; value < (long) items; value++)
+	{
+		CR_CALL(push, (*queue, value));
+	}
+CR_FINALLY
+	s_running.fetch_sub(1, std::memory_order_relaxed);
+CR_INLINE_END
+
+template<class Queue>
+TEMPLATE_COROUTINE(Consumer, (Queue), void)
+CR_STATE(
+	(Queue &) queue,
+	(std::size_t) items)
+	typename Queue::Pop pop;
+	std::size_t i;
+	long value;
+CR_INLINE
+	for(i = 0; i < items; i++)
+	{
+		CR_CALL(pop, (*queue, value));
+	}
+CR_FINALLY
+	s_running.fetch_sub(1, std::memory_order_relaxed);
+CR_INLINE_END
+
+template<class Queue>
+TEMPLATE_COROUTINE(BulkProducer, (Queue), void)
+CR_STATE(
+	(Queue &) queue,
+	(std::size_t) items)
+	typename Queue::PushBulk push;
+	long values[kBatch];
+	std::size_t pushed;
+	std::size_t batch;
+CR_INLINE
+	for(pushed = 0; pushed < items; pushed += batch)
+	{
+		batch = items - pushed < kBatch ? items - pushed : kBatch;
+		for(std::size_t i = 0; i < batch; i++)
+			values[i] = pushed + i;
+		CR_CALL(push, (*queue, values, batch));
+	}
+CR_FINALLY
+	s_running.fetch_sub(1, std::memory_order_relaxed);
+CR_INLINE_END
+
+template<class Queue>
+TEMPLATE_COROUTINE(BulkConsumer, (Queue), void)
+CR_STATE(
+	(Queue &) queue,
+	(std::size_t) items)
+	typename Queue::PopBulk pop;
+	long values[kBatch];
+	std::size_t popped;
+	std::size_t batch;
+CR_INLINE
+	for(popped = 0; popped < items; popped += batch)
+	{
+		CR_CALL(pop, (*queue, values, 1, items - popped < kBatch ? items - popped : kBatch, batch));
+	}
+CR_FINALLY
+	s_running.fetch_sub(1, std::memory_order_relaxed);
+CR_INLINE_END
+
+template<class Queue, template<class> class Push, template<class> class Pop>
+/** Moves the items through a sync queue on the simple scheduler and returns the time per item in nanoseconds. */
+static double run_sync(
+	std::size_t items)
+{
+	Sync &scheduler = Sync::instance();
+	scheduler.initialise();
+
+	Queue queue;
+	queue.set_resumer(scheduler.deferred());
+	Push<Queue> producer;
+	Pop<Queue> consumer;
+	s_running.store(2, std::memory_order_relaxed);
+
+	auto const start = std::chrono::steady_clock::now();
+	consumer.start(nullptr, queue, items);
+	producer.start(nullptr, queue, items);
+	while(s_running.load(std::memory_order_relaxed))
+		scheduler.schedule();
+	auto const end = std::chrono::steady_clock::now();
+
+	return std::chrono::duration<double, std::nano>(end - start).count() / items;
+}
+
+template<class Queue, template<class> class Push, template<class> class Pop>
+/** Moves the items through a thread-safe queue on a single hybrid scheduler thread and returns the time per item in nanoseconds. */
+static double run_mt(
+	std::size_t items)
+{
+	Hybrid &scheduler = Hybrid::instance();
+	scheduler.initialise(1);
+
+	Queue queue;
+	queue.set_resumer(scheduler.deferred());
+	Push<Queue> producer;
+	Pop<Queue> consumer;
+	s_running.store(2, std::memory_order_relaxed);
+
+	auto const start = std::chrono::steady_clock::now();
+	consumer.start(nullptr, queue, items);
+	producer.start(nullptr, queue, items);
+	while(s_running.load(std::memory_order_relaxed))
+		scheduler.schedule(0);
+	auto const end = std::chrono::steady_clock::now();
+
+	return std::chrono::duration<double, std::nano>(end - start).count() / items;
+}
+
+int main(
+	int argc,
+	char ** argv)
+{
+	std::size_t const items = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+
+	typedef cr::sync::FixedQueue<long, kSize> SyncQueue;
+	typedef cr::mt::FixedQueue<long, kSize> MtQueue;
+
+	std::printf("queue\tbulk [ns/item]\tsingle [ns/item]\n");
+	std::printf("sync\t%.1f\t%.1f\n",
+		run_sync<SyncQueue, BulkProducer, BulkConsumer>(items),
+		run_sync<SyncQueue, Producer, Consumer>(items));
+	std::printf("mt\t%.1f\t%.1f\n",
+		run_mt<MtQueue, BulkProducer, BulkConsumer>(items),
+		run_mt<MtQueue, Producer, Consumer>(items));
+
+	return 0;
+}
@@ -0,0 +1,169 @@
+/** @file channel.cpp
+	Compares rendezvous channels against single-slot fixed queues for request/response exchanges.
+	A client coroutine sends `rounds` 256-byte requests to a server coroutine, and waits for a response to each. The sync types run on the simple scheduler, and the thread-safe types on the hybrid scheduler with one thread. Waiting coroutines are resumed through the scheduler's deferred resumer. Prints the time per round trip.
+	Usage: `channel [rounds]` */
+#include <libcr/libcr.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+typedef cr::sync::FIFOScheduler Sync;
+typedef cr::HybridScheduler<cr::mt::FIFOConditionVariable, cr::sync::FIFOConditionVariable> Hybrid;
+
+/** A request or response. */
+struct Message
+{
+	/** The message's contents. */
+	char bytes[256];
+};
+
+/** How many coroutines are still running. */
+static std::atomic_size_t s_running(0);
+
+template<class Link>
+/** Names the sending and receiving coroutines of a channel or queue. */
+struct Operations;
+
+template<class T>
+struct Operations<cr::sync::Channel<T>>
+{
+	template<class V>
+	using Send = typename cr::sync::Channel<T>::template SendPattern<V>;
+	typedef typename cr::sync::Channel<T>::Receive Receive;
+};
+
+template<class T>
+struct Operations<cr::mt::Channel<T>>
+{
+	template<class V>
+	using Send = typename cr::mt::Channel<T>::template SendPattern<V>;
+	typedef typename cr::mt::Channel<T>::Receive Receive;
+};
+
+template<class T>
+struct Operations<cr::sync::FixedQueue<T, 1>>
+{
+	template<class V>
+	using Send = typename cr::sync::FixedQueue<T, 1>::template PushPattern<V>;
+	typedef typename cr::sync::FixedQueue<T, 1>::Pop Receive;
+};
+
+template<class T>
+struct Operations<cr::mt::FixedQueue<T, 1>>
+{
+	template<class V>
+	using Send = typename cr::mt::FixedQueue<T, 1>::template PushPattern<V>;
+	typedef typename cr::mt::FixedQueue<T, 1>::Pop Receive;
+};
+
+template<class Link>
+TEMPLATE_COROUTINE(Client, (Link), void)
+CR_STATE(
+	(Link &) requests,
+	(Link &) responses,
+	(std::size_t) rounds)
+	typename Operations<Link>::template Send<Message const&> send;
+	typename Operations<Link>::Receive receive;
+	Message request;
+	Message response;
+	std::size_t i;
+CR_INLINE
+	for(i = 0; i < rounds; i++)
+	{
+		request.bytes[0] = char(i);
+		CR_CALL(send, (*requests, request));
+		CR_CALL(receive, (*responses, response));
+	}
+CR_FINALLY
+	s_running.fetch_sub(1, std::memory_order_relaxed);
+CR_INLINE_END
+
+template<class Link>
+TEMPLATE_COROUTINE(Server, (Link), void)
+CR_STATE(
+	(Link &) requests,
+	(Link &) responses,
+	(std::size_t) rounds)
+	typename Operations<Link>::template Send<Message const&> send;
+	typename Operations<Link>::Receive receive;
+	Message message;
+	std::size_t i;
+CR_INLINE
+	for(i = 0; i < rounds; i++)
+	{
+		CR_CALL(receive, (*requests, message));
+		++message.bytes[0];
+		CR_CALL(send, (*responses, message));
+	}
+CR_FINALLY
+	s_running.fetch_sub(1, std::memory_order_relaxed);
+CR_INLINE_END
+
+template<class Link>
+/** Runs the round trips over sync channels or queues on the simple scheduler and returns the time per round trip in nanoseconds. */
+static double run_sync(
+	std::size_t rounds)
+{
+	Sync &scheduler = Sync::instance();
+	scheduler.initialise();
+
+	Link requests, responses;
+	requests.set_resumer(scheduler.deferred());
+	responses.set_resumer(scheduler.deferred());
+	Client<Link> client;
+	Server<Link> server;
+	s_running.store(2, std::memory_order_relaxed);
+
+	auto const start = std::chrono::steady_clock::now();
+	server.start(nullptr, requests, responses, rounds);
+	client.start(nullptr, requests, responses, rounds);
+	while(s_running.load(std::memory_order_relaxed))
+		scheduler.schedule();
+	auto const end = std::chrono::steady_clock::now();
+
+	return std::chrono::duration<double, std::nano>(end - start).count() / rounds;
+}
+
+template<class Link>
+/** Runs the round trips over thread-safe channels or queues on a single hybrid scheduler thread and returns the time per round trip in nanoseconds. */
+static double run_mt(
+	std::size_t rounds)
+{
+	Hybrid &scheduler = Hybrid::instance();
+	scheduler.initialise(1);
+
+	Link requests, responses;
+	requests.set_resumer(scheduler.deferred());
+	responses.set_resumer(scheduler.deferred());
+	Client<Link> client;
+	Server<Link> server;
+	s_running.store(2, std::memory_order_relaxed);
+
+	auto const start = std::chrono::steady_clock::now();
+	server.start(nullptr, requests, responses, rounds);
+	client.start(nullptr, requests, responses, rounds);
+	while(s_running.load(std::memory_order_relaxed))
+		scheduler.schedule(0);
+	auto const end = std::chrono::steady_clock::now();
+
+	return std::chrono::duration<double, std::nano>(end - start).count() / rounds;
+}
+
+int main(
+	int argc,
+	char ** argv)
+{
+	std::size_t const rounds = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+
+	std::printf("types\tchannel [ns/round trip]\tqueue [ns/round trip]\n");
+	std::printf("sync\t%.1f\t%.1f\n",
+		run_sync<cr::sync::Channel<Message>>(rounds),
+		run_sync<cr::sync::FixedQueue<Message, 1>>(rounds));
+	std::printf("mt\t%.1f\t%.1f\n",
+		run_mt<cr::mt::Channel<Message>>(rounds),
+		run_mt<cr::mt::FixedQueue<Message, 1>>(rounds));
+
+	return 0;
+}
@@ -0,0 +1,189 @@
+/** @file claim.cpp
+	Compares in-place claiming and peeking against pushing and popping copies on the fixed queues.
+	One coroutine writes `items` 4 KiB messages into a 64-slot queue, and another coroutine reads every message. With `Claim`/`Peek`, the messages are written and read in the queue's slots. With `Push`/`Pop`, they are built in the producer's state and read from the consumer's state, so each message is copied in and out of the queue. The sync queue runs on the simple scheduler, and the thread-safe queue on the hybrid scheduler with one thread. Waiting coroutines are resumed through the scheduler's deferred resumer. Prints the time per item.
+	Usage: `claim [items]` */
+#include <libcr/libcr.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+typedef cr::sync::FIFOScheduler Sync;
+typedef cr::HybridScheduler<cr::mt::FIFOConditionVariable, cr::sync::FIFOConditionVariable> Hybrid;
+
+/** A message. */
+struct Message
+{
+	/** The message's contents. */
+	std::uint64_t words[512];
+};
+
+/** The queues' capacity. */
+static constexpr std::size_t kSize = 64;
+
+/** How many coroutines are still running. */
+static std::atomic_size_t s_running(0);
+/** The sum of all read messages, so that reading them is not optimised away. */
+static std::uint64_t s_checksum;
+
+/** Writes a message. */
+static void write(
+	Message &message,
+	std::size_t index)
+{
+	std::memset(message.words, int(index), sizeof(message.words));
+}
+
+/** Reads a message. */
+static void read(
+	Message const& message)
+{
+	for(std::uint64_t word: message.words)
+		s_checksum += word;
+}
+
+template<class Queue>
+TEMPLATE_COROUTINE(Producer, (Queue), void)
+CR_STATE(
+	(Queue &) queue,
+	(std::size_t) items)
+	typename Queue::template PushPattern<Message const&> push;
+	Message message;
+	std::size_t i;
+CR_INLINE
+	for(i = 0; i < items; i++)
+	{
+		write(message, i);
+		CR_CALL(push, (*queue, message));
+	}
+CR_FINALLY
+	s_running.fetch_sub(1, std::memory_order_relaxed);
+CR_INLINE_END
+
+template<class Queue>
+TEMPLATE_COROUTINE(Consumer, (Queue), void)
+CR_STATE(
+	(Queue &) queue,
+	(std::size_t) items)
+	typename Queue::Pop pop;
+	Message message;
+	std::size_t i;
+CR_INLINE
+	for(i = 0; i < items; i++)
+	{
+		CR_CALL(pop, (*queue, message));
+		read(message);
+	}
+CR_FINALLY
+	s_running.fetch_sub(1, std::memory_order_relaxed);
+CR_INLINE_END
+
+template<class Queue>
+TEMPLATE_COROUTINE(Claimer, (Queue), void)
+CR_STATE(
+	(Queue &) queue,
+	(std::size_t) items)
+	typename Queue::Claim claim;
+	Message * slot;
+	std::size_t i;
+CR_INLINE
+	for(i = 0; i < items; i++)
+	{
+		CR_CALL(claim, (*queue, slot));
+		write(*slot, i);
+		queue->publish(slot);
+	}
+CR_FINALLY
+	s_running.fetch_sub(1, std::memory_order_relaxed);
+CR_INLINE_END
+
+template<class Queue>
+TEMPLATE_COROUTINE(Peeker, (Queue), void)
+CR_STATE(
+	(Queue &) queue,
+	(std::size_t) items)
+	typename Queue::Peek peek;
+	Message const * element;
+	std::size_t i;
+CR_INLINE
+	for(i = 0; i < items; i++)
+	{
+		CR_CALL(peek, (*queue, element));
+		read(*element);
+		queue->release(element);
+	}
+CR_FINALLY
+	s_running.fetch_sub(1, std::memory_order_relaxed);
+CR_INLINE_END
+
+template<class Queue, template<class> class Write, template<class> class Read>
+/** Moves the messages through a sync queue on the simple scheduler and returns the time per item in nanoseconds. */
+static double run_sync(
+	std::size_t items)
+{
+	Sync &scheduler = Sync::instance();
+	scheduler.initialise();
+
+	static Queue queue;
+	queue.set_resumer(scheduler.deferred());
+	static Write<Queue> producer;
+	static Read<Queue> consumer;
+	s_running.store(2, std::memory_order_relaxed);
+
+	auto const start = std::chrono::steady_clock::now();
+	consumer.start(nullptr, queue, items);
+	producer.start(nullptr, queue, items);
+	while(s_running.load(std::memory_order_relaxed))
+		scheduler.schedule();
+	auto const end = std::chrono::steady_clock::now();
+
+	return std::chrono::duration<double, std::nano>(end - start).count() / items;
+}
+
+template<class Queue, template<class> class Write, template<class> class Read>
+/** Moves the messages through a thread-safe queue on a single hybrid scheduler thread and returns the time per item in nanoseconds. */
+static double run_mt(
+	std::size_t items)
+{
+	Hybrid &scheduler = Hybrid::instance();
+	scheduler.initialise(1);
+
+	static Queue queue;
+	queue.set_resumer(scheduler.deferred());
+	static Write<Queue> producer;
+	static Read<Queue> consumer;
+	s_running.store(2, std::memory_order_relaxed);
+
+	auto const start = std::chrono::steady_clock::now();
+	consumer.start(nullptr, queue, items);
+	producer.start(nullptr, queue, items);
+	while(s_running.load(std::memory_order_relaxed))
+		scheduler.schedule(0);
+	auto const end = std::chrono::steady_clock::now();
+
+	return std::chrono::duration<double, std::nano>(end - start).count() / items;
+}
+
+int main(
+	int argc,
+	char ** argv)
+{
+	std::size_t const items = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 262144;
+
+	typedef cr::sync::FixedQueue<Message, kSize> SyncQueue;
+	typedef cr::mt::FixedQueue<Message, kSize> MtQueue;
+
+	std::printf("queue\tclaim/peek [ns/item]\tpush/pop [ns/item]\n");
+	std::printf("sync\t%.1f\t%.1f\n",
+		run_sync<SyncQueue, Claimer, Peeker>(items),
+		run_sync<SyncQueue, Producer, Consumer>(items));
+	std::printf("mt\t%.1f\t%.1f\n",
+		run_mt<MtQueue, Claimer, Peeker>(items),
+		run_mt<MtQueue, Producer, Consumer>(items));
+	std::printf("checksum\t%llu\n", (unsigned long long) s_checksum);
+
+	return 0;
+}
@@ -0,0 +1,54 @@
+/** @file event.cpp
+	Measures registering many coroutines with a thread-safe event, and firing it.
+	Every round, `waiters` coroutines start waiting for the event, and then the event is fired, which resumes all of them, and cleared again. Runs on a single thread. Prints the registration time per waiter, and the time per `fire()`.
+	Usage: `event [waiters] [rounds]` */
+#include <libcr/libcr.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+/** The event under test. */
+static cr::mt::PODEvent s_event;
+/** How many waiters were resumed. */
+static std::size_t s_resumed;
+
+COROUTINE(Waiter, void)
+CR_STATE()
+CR_INLINE
+	CR_AWAIT(s_event.wait());
+	++s_resumed;
+CR_FINALLY
+CR_INLINE_END
+
+int main(
+	int argc,
+	char ** argv)
+{
+	std::size_t const waiters = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+	std::size_t const rounds = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 20;
+
+	s_event.initialise();
+	std::vector<Waiter> coroutines(waiters);
+	double registering = 0, firing = 0;
+	for(std::size_t round = 0; round < rounds; round++)
+	{
+		auto const start = std::chrono::steady_clock::now();
+		for(Waiter &waiter: coroutines)
+			waiter.start(nullptr);
+		auto const fire = std::chrono::steady_clock::now();
+		s_event.fire();
+		auto const end = std::chrono::steady_clock::now();
+		s_event.clear();
+
+		registering += std::chrono::duration<double, std::nano>(fire - start).count();
+		firing += std::chrono::duration<double, std::milli>(end - fire).count();
+	}
+
+	std::printf("registering\t%.1f ns/waiter\n", registering / (rounds * waiters));
+	std::printf("fire()\t%.2f ms\n", firing / rounds);
+	std::printf("resumed\t%zu of %zu\n", s_resumed, rounds * waiters);
+
+	return 0;
+}
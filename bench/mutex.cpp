@@ -0,0 +1,171 @@
+/** @file mutex.cpp
+	Measures the thread-safe mutex on the hybrid scheduler, against the previous design built on a consumable event.
+	The uncontended case locks and unlocks the mutex from a single thread. In the contended cases, 32 coroutines on 4 threads each run `sections` critical sections, and yield while holding the mutex, so that the others queue up behind it. Unlocking resumes the next owner directly, or through the scheduler's deferred resumer with and without barging. The previous design only supports direct resumption. Thread counts above the machine's core count measure oversubscription.
+	Usage: `mutex [sections]` */
+#include <libcr/libcr.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+typedef cr::HybridScheduler<cr::mt::FIFOConditionVariable, cr::sync::FIFOConditionVariable> Hybrid;
+
+template<class ConditionVariable>
+/** The previous mutex design, kept as a baseline.
+	The mutex is a consumable event that is active while the mutex is unlocked: locking consumes the event, and unlocking fires it, which passes the mutex on to one waiting coroutine. */
+class EventMutex
+{
+	/** The event that is active while the mutex is unlocked. */
+	cr::mt::PODConsumableEventPattern<ConditionVariable> m_event;
+public:
+	/** Initialises the mutex to an unlocked state. */
+	void initialise()
+	{
+		m_event.initialise(true);
+	}
+
+	/** Does nothing, as the previous design has no barging mode. */
+	void set_barging(
+		std::uint32_t)
+	{
+	}
+
+	/** Tries to lock the mutex. */
+	bool try_lock()
+	{
+		return m_event.try_consume();
+	}
+
+	/** Locks the mutex. To be used with `#CR_AWAIT`. */
+	typename cr::mt::PODConsumableEventPattern<ConditionVariable>::ConsumeCall lock()
+	{
+		return m_event.consume();
+	}
+
+	/** Unlocks the mutex. Always resumes the next owner directly. */
+	void unlock(
+		cr::Resumer = cr::Resumer())
+	{
+		m_event.fire();
+	}
+};
+
+/** The number of contending coroutines. */
+static constexpr std::size_t kCoroutines = 32;
+/** The number of scheduler threads. */
+static constexpr std::size_t kThreads = 4;
+
+/** How many coroutines are still running. */
+static std::atomic_size_t s_running(0);
+/** Changed inside the critical sections. */
+static std::size_t s_counter;
+
+template<class Mutex>
+TEMPLATE_COROUTINE(Locker, (Mutex), Hybrid)
+CR_STATE(
+	(Mutex &) mutex,
+	(std::size_t) sections,
+	(bool) deferred)
+	std::size_t i;
+CR_INLINE
+	for(i = 0; i < sections; i++)
+	{
+		CR_AWAIT(mutex->lock());
+		++s_counter;
+		CR_YIELD;
+		mutex->unlock(deferred ? Hybrid::instance().deferred() : cr::Resumer());
+	}
+CR_FINALLY
+	s_running.fetch_sub(1, std::memory_order_relaxed);
+CR_INLINE_END
+
+template<class Mutex>
+/** Locks and unlocks the mutex without contention and returns the time per pair in nanoseconds. */
+static double uncontended(
+	std::size_t sections)
+{
+	Mutex mutex;
+	mutex.initialise();
+
+	auto const start = std::chrono::steady_clock::now();
+	for(std::size_t i = 0; i < sections; i++)
+	{
+		if(!mutex.try_lock())
+			std::abort();
+		++s_counter;
+		mutex.unlock();
+	}
+	auto const end = std::chrono::steady_clock::now();
+
+	return std::chrono::duration<double, std::nano>(end - start).count() / sections;
+}
+
+template<class Mutex>
+/** Runs the contending coroutines to completion and returns the time per critical section in nanoseconds. */
+static double contended(
+	std::size_t sections,
+	bool deferred,
+	std::uint32_t barging)
+{
+	Hybrid &scheduler = Hybrid::instance();
+	scheduler.initialise(kThreads);
+
+	Mutex mutex;
+	mutex.initialise();
+	mutex.set_barging(barging);
+	std::vector<Locker<Mutex>> lockers(kCoroutines);
+	s_running.store(kCoroutines, std::memory_order_relaxed);
+
+	// Idle threads park, so that they do not take the CPU from busy threads when the machine is oversubscribed.
+	std::vector<std::thread> pool;
+	for(std::size_t thread = 0; thread < kThreads; thread++)
+		pool.emplace_back([&scheduler, thread] {
+			scheduler.run_until_stopped(thread);
+		});
+
+	auto const start = std::chrono::steady_clock::now();
+	for(Locker<Mutex> &locker: lockers)
+		locker.start(nullptr, mutex, sections, deferred);
+	while(s_running.load(std::memory_order_relaxed))
+		std::this_thread::yield();
+	auto const end = std::chrono::steady_clock::now();
+
+	scheduler.stop();
+	for(std::thread &thread: pool)
+		thread.join();
+
+	return std::chrono::duration<double, std::nano>(end - start).count() / (kCoroutines * sections);
+}
+
+int main(
+	int argc,
+	char ** argv)
+{
+	std::size_t const sections = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000;
+
+	typedef EventMutex<cr::mt::PODConditionVariable> OldMutex;
+	typedef EventMutex<cr::mt::PODFIFOConditionVariable> OldFIFOMutex;
+
+	std::printf("setup\tevent mutex\tevent fifo mutex\tmutex\tfifo mutex\t[ns/section]\n");
+	std::printf("uncontended lock+unlock\t%.1f\t%.1f\t%.1f\t%.1f\n",
+		uncontended<OldMutex>(sections * kCoroutines),
+		uncontended<OldFIFOMutex>(sections * kCoroutines),
+		uncontended<cr::mt::PODMutex>(sections * kCoroutines),
+		uncontended<cr::mt::PODFIFOMutex>(sections * kCoroutines));
+	std::printf("direct handoff\t%.1f\t%.1f\t%.1f\t%.1f\n",
+		contended<OldMutex>(sections, false, 0),
+		contended<OldFIFOMutex>(sections, false, 0),
+		contended<cr::mt::PODMutex>(sections, false, 0),
+		contended<cr::mt::PODFIFOMutex>(sections, false, 0));
+	std::printf("deferred handoff\t-\t-\t%.1f\t%.1f\n",
+		contended<cr::mt::PODMutex>(sections, true, 0),
+		contended<cr::mt::PODFIFOMutex>(sections, true, 0));
+	std::printf("deferred, barging=4\t-\t-\t%.1f\t%.1f\n",
+		contended<cr::mt::PODMutex>(sections, true, 4),
+		contended<cr::mt::PODFIFOMutex>(sections, true, 4));
+
+	return 0;
+}
@@ -0,0 +1,113 @@
+/** @file schedulers.cpp
+	Compares the work-stealing scheduler against the hybrid scheduler's sampling-based balancing.
+	Every eighth coroutine does much more work per step than the others, so that the load is skewed no matter how coroutines are assigned to threads. Prints the wall time each scheduler needs to run all coroutines to completion, for 2 to 64 threads. Thread counts above the machine's core count measure oversubscription.
+	Usage: `schedulers [coroutines] [steps]` */
+#include <libcr/libcr.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+typedef cr::HybridScheduler<cr::mt::FIFOConditionVariable, cr::sync::FIFOConditionVariable> Hybrid;
+typedef cr::StealingScheduler<cr::mt::FIFOConditionVariable> Stealing;
+
+/** How many coroutines are still running. */
+static std::atomic_size_t s_running(0);
+
+/** Burns CPU time for a number of work units. */
+static void work(
+	std::size_t units)
+{
+	for(std::size_t i = 0; i < units * 256; i++)
+		std::atomic_signal_fence(std::memory_order_seq_cst);
+}
+
+COROUTINE(HybridWorker, Hybrid)
+CR_STATE(
+	(std::size_t) steps,
+	(std::size_t) weight)
+	std::size_t i;
+CR_INLINE
+	for(i = 0; i < steps; i++)
+	{
+		work(weight);
+		CR_YIELD;
+	}
+CR_FINALLY
+	s_running.fetch_sub(1, std::memory_order_relaxed);
+CR_INLINE_END
+
+COROUTINE(StealingWorker, Stealing)
+CR_STATE(
+	(std::size_t) steps,
+	(std::size_t) weight)
+	std::size_t i;
+CR_INLINE
+	for(i = 0; i < steps; i++)
+	{
+		work(weight);
+		CR_YIELD;
+	}
+CR_FINALLY
+	s_running.fetch_sub(1, std::memory_order_relaxed);
+CR_INLINE_END
+
+template<class Scheduler, class Worker>
+/** Runs all coroutines to completion and returns the elapsed wall time in milliseconds. */
+static double run(
+	std::size_t threads,
+	std::size_t coroutines,
+	std::size_t steps)
+{
+	Scheduler &scheduler = Scheduler::instance();
+	scheduler.initialise(threads);
+
+	std::vector<Worker> workers(coroutines);
+	std::atomic_bool stop(false);
+	s_running.store(coroutines, std::memory_order_relaxed);
+
+	auto const start = std::chrono::steady_clock::now();
+
+	std::vector<std::thread> pool;
+	for(std::size_t thread = 0; thread < threads; thread++)
+		pool.emplace_back([&scheduler, &stop, thread] {
+			while(!stop.load(std::memory_order_relaxed))
+				scheduler.schedule(thread);
+		});
+
+	// All coroutines arrive in one burst.
+	for(std::size_t i = 0; i < coroutines; i++)
+		workers[i].start(nullptr, steps, i % 8 ? 1 : 64);
+
+	while(s_running.load(std::memory_order_relaxed))
+		std::this_thread::yield();
+
+	auto const end = std::chrono::steady_clock::now();
+
+	stop.store(true, std::memory_order_relaxed);
+	for(std::thread &thread: pool)
+		thread.join();
+
+	return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(
+	int argc,
+	char ** argv)
+{
+	std::size_t const coroutines = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4096;
+	std::size_t const steps = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 64;
+
+	std::printf("threads\thybrid [ms]\tstealing [ms]\n");
+	for(std::size_t threads = 2; threads <= 64; threads *= 2)
+	{
+		double const hybrid = run<Hybrid, HybridWorker>(threads, coroutines, steps);
+		double const stealing = run<Stealing, StealingWorker>(threads, coroutines, steps);
+		std::printf("%zu\t%.1f\t%.1f\n", threads, hybrid, stealing);
+	}
+
+	return 0;
+}
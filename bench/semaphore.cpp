@@ -0,0 +1,362 @@
+/** @file semaphore.cpp
+	Measures the thread-safe semaphore on the hybrid scheduler, against the previous lock-based design.
+	The uncontended case notifies and waits in a single coroutine, so the wait never blocks. In the contended case, 32 coroutines on 4 threads share a semaphore with a count of 4, and yield after every wait and notification. In the producer/consumer case, 8 producers notify a semaphore that 8 consumers wait for with a timeout. Notifications resume waiting coroutines through the scheduler's deferred resumer. Thread counts above the machine's core count measure oversubscription.
+	Usage: `semaphore [operations]` */
+#include <libcr/libcr.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+typedef cr::HybridScheduler<cr::mt::FIFOConditionVariable, cr::sync::FIFOConditionVariable> Hybrid;
+
+/** The previous semaphore design, kept as a baseline.
+	A soft mutex guards the slow paths, and a separate counter tracks the coroutines that are still registering with the condition variable, so that every notification with an empty count takes the lock. */
+class LockedSemaphore
+{
+	/** Soft mutex protecting the semaphore. */
+	cr::mt::detail::PODSoftMutex m_mutex;
+	/** The condition variable. */
+	cr::mt::PODFIFOConditionVariable m_cv;
+	/** The semaphore's count. */
+	cr::util::Atomic<std::size_t> m_count;
+	/** The count of currently registering coroutines. */
+	cr::util::Atomic<std::size_t> m_registering;
+
+	/** Tries to take a unit of the count. */
+	bool try_wait()
+	{
+		std::size_t count = 1;
+		while(count)
+			if(m_count.compare_exchange_weak(
+				count,
+				count - 1,
+				std::memory_order_acq_rel,
+				std::memory_order_relaxed))
+				return true;
+
+		return false;
+	}
+public:
+	/** Initialises the semaphore. */
+	void initialise(
+		std::size_t count)
+	{
+		m_cv.initialise();
+		std::atomic_init(&m_count, count);
+		std::atomic_init(&m_registering, (std::size_t) 0);
+		m_mutex.initialise();
+	}
+
+	/** Notifies the semaphore. */
+	void notify(
+		cr::Resumer resumer = cr::Resumer())
+	{
+		if(m_cv.notify_one(resumer))
+			return;
+
+		// Try to increment the semaphore (safe if it is > 0).
+		std::size_t count = 1;
+		while(count)
+			if(m_count.compare_exchange_weak(
+				count,
+				count + 1,
+				std::memory_order_acq_rel,
+				std::memory_order_relaxed))
+				return;
+
+		for(;;)
+		{
+			// If there are registering coroutines, try again.
+			if(m_registering.load_strong(std::memory_order_relaxed))
+				continue;
+
+			cr::mt::detail::LockGuard lock { m_mutex };
+			if(m_registering.load_strong(std::memory_order_relaxed))
+				continue;
+
+			// Once more, try to remove a coroutine, and otherwise increment the count.
+			if(cr::Coroutine * const removed = m_cv.remove_one())
+			{
+				lock.unlock();
+				cr::mt::PODFIFOConditionVariable::acquire_and_complete(removed, removed);
+				resumer(removed);
+			} else
+				m_count.fetch_add(1, std::memory_order_acq_rel);
+			return;
+		}
+	}
+
+	/** Helper type for waiting for the semaphore using `#CR_AWAIT`. */
+	class WaitCall
+	{
+		/** The semaphore to wait for. */
+		LockedSemaphore &m_semaphore;
+	public:
+		/** Initialises the wait call. */
+		WaitCall(
+			LockedSemaphore &semaphore):
+			m_semaphore(semaphore)
+		{
+		}
+
+		/** Waits for the semaphore. */
+		cr::sync::mayblock libcr_wait(
+			cr::Coroutine * coroutine)
+		{
+			if(m_semaphore.try_wait())
+				return cr::sync::nonblock();
+
+			cr::mt::detail::LockGuard lock { m_semaphore.m_mutex };
+			// Was the semaphore increased in the meantime?
+			if(m_semaphore.try_wait())
+				return cr::sync::nonblock();
+
+			m_semaphore.m_registering.fetch_add(1, std::memory_order_relaxed);
+			lock.unlock();
+
+			(void) m_semaphore.m_cv.wait().libcr_wait(coroutine);
+
+			m_semaphore.m_registering.fetch_sub(1, std::memory_order_release);
+			return cr::sync::block();
+		}
+	};
+
+	/** Waits for the semaphore. */
+	WaitCall wait()
+	{
+		return *this;
+	}
+
+	/** Helper type for waiting for the semaphore with a timeout using `#CR_AWAIT`. */
+	class TimedWaitCall
+	{
+		/** The semaphore to wait for. */
+		LockedSemaphore &m_semaphore;
+		/** The deadline of the wait. */
+		cr::Deadline m_deadline;
+	public:
+		/** Initialises the timed wait call. */
+		TimedWaitCall(
+			LockedSemaphore &semaphore,
+			cr::Deadline const& deadline):
+			m_semaphore(semaphore),
+			m_deadline(deadline)
+		{
+		}
+
+		/** Waits for the semaphore until the deadline expires. */
+		cr::sync::mayblock libcr_wait(
+			cr::Coroutine * coroutine)
+		{
+			if(m_semaphore.try_wait())
+				return cr::sync::nonblock();
+
+			cr::mt::detail::LockGuard lock { m_semaphore.m_mutex };
+			// Was the semaphore increased in the meantime?
+			if(m_semaphore.try_wait())
+				return cr::sync::nonblock();
+
+			m_semaphore.m_registering.fetch_add(1, std::memory_order_relaxed);
+			lock.unlock();
+
+			(void) m_semaphore.m_cv.wait_for(m_deadline).libcr_wait(coroutine);
+
+			m_semaphore.m_registering.fetch_sub(1, std::memory_order_release);
+			return cr::sync::block();
+		}
+	};
+
+	/** Waits for the semaphore until the deadline expires. */
+	TimedWaitCall wait_for(
+		cr::Deadline const& deadline)
+	{
+		return TimedWaitCall(*this, deadline);
+	}
+};
+
+/** How many coroutines are still running. */
+static std::atomic_size_t s_running(0);
+/** How often a timed wait expired. */
+static std::atomic_size_t s_expired(0);
+
+template<class Semaphore>
+TEMPLATE_COROUTINE(Uncontended, (Semaphore), Hybrid)
+CR_STATE(
+	(Semaphore &) semaphore,
+	(std::size_t) operations)
+	std::size_t i;
+CR_INLINE
+	for(i = 0; i < operations; i++)
+	{
+		semaphore->notify();
+		CR_AWAIT(semaphore->wait());
+	}
+CR_FINALLY
+CR_INLINE_END
+
+template<class Semaphore>
+TEMPLATE_COROUTINE(Holder, (Semaphore), Hybrid)
+CR_STATE(
+	(Semaphore &) semaphore,
+	(std::size_t) operations)
+	std::size_t i;
+CR_INLINE
+	for(i = 0; i < operations; i++)
+	{
+		CR_AWAIT(semaphore->wait());
+		semaphore->notify(Hybrid::instance().deferred());
+		CR_YIELD;
+	}
+CR_FINALLY
+	s_running.fetch_sub(1, std::memory_order_relaxed);
+CR_INLINE_END
+
+template<class Semaphore>
+TEMPLATE_COROUTINE(Producer, (Semaphore), Hybrid)
+CR_STATE(
+	(Semaphore &) semaphore,
+	(std::size_t) items)
+	std::size_t i;
+CR_INLINE
+	for(i = 0; i < items; i++)
+	{
+		semaphore->notify(Hybrid::instance().deferred());
+		if(i % 16 == 15)
+		{
+			CR_YIELD;
+		}
+	}
+CR_FINALLY
+	s_running.fetch_sub(1, std::memory_order_relaxed);
+CR_INLINE_END
+
+template<class Semaphore>
+TEMPLATE_COROUTINE(Consumer, (Semaphore), Hybrid)
+CR_STATE(
+	(Semaphore &) semaphore,
+	(std::size_t) items)
+	cr::Timeout timeout;
+	std::size_t received;
+CR_INLINE
+	for(received = 0; received < items;)
+	{
+		CR_AWAIT(
+			semaphore->wait_for(CR_TIMEOUT(timeout, std::chrono::seconds(1))),
+			{ s_expired.fetch_add(1, std::memory_order_relaxed); continue; });
+		++received;
+	}
+CR_FINALLY
+	s_running.fetch_sub(1, std::memory_order_relaxed);
+CR_INLINE_END
+
+template<class Start>
+/** Runs coroutines on the hybrid scheduler until they are done, and returns the elapsed wall time in nanoseconds.
+@param[in] start:
+	Starts the coroutines and sets `s_running`. */
+static double run(
+	std::size_t threads,
+	Start start)
+{
+	Hybrid &scheduler = Hybrid::instance();
+	scheduler.initialise(threads);
+
+	// Idle threads park, so that they do not take the CPU from busy threads when the machine is oversubscribed.
+	std::vector<std::thread> pool;
+	for(std::size_t thread = 0; thread < threads; thread++)
+		pool.emplace_back([&scheduler, thread] {
+			scheduler.run_until_stopped(thread);
+		});
+
+	auto const begin = std::chrono::steady_clock::now();
+	start();
+	while(s_running.load(std::memory_order_relaxed))
+		std::this_thread::yield();
+	auto const end = std::chrono::steady_clock::now();
+
+	scheduler.stop();
+	for(std::thread &thread: pool)
+		thread.join();
+
+	return std::chrono::duration<double, std::nano>(end - begin).count();
+}
+
+template<class Semaphore>
+/** Notifies and waits in a single coroutine, and returns the time per pair in nanoseconds. */
+static double uncontended(
+	std::size_t operations)
+{
+	Hybrid::instance().initialise(1);
+	Semaphore semaphore;
+	semaphore.initialise(0);
+	Uncontended<Semaphore> coroutine;
+
+	auto const begin = std::chrono::steady_clock::now();
+	coroutine.start(nullptr, semaphore, operations);
+	auto const end = std::chrono::steady_clock::now();
+
+	return std::chrono::duration<double, std::nano>(end - begin).count() / operations;
+}
+
+template<class Semaphore>
+/** Lets 32 coroutines on 4 threads share a count of 4, and returns the time per operation in nanoseconds. */
+static double contended(
+	std::size_t operations)
+{
+	std::size_t const coroutines = 32;
+	std::size_t const each = operations / coroutines / 4;
+	Semaphore semaphore;
+	semaphore.initialise(4);
+	std::vector<Holder<Semaphore>> holders(coroutines);
+	double const elapsed = run(4, [&] {
+		s_running.store(coroutines, std::memory_order_relaxed);
+		for(Holder<Semaphore> &holder: holders)
+			holder.start(nullptr, semaphore, each);
+	});
+	return elapsed / (coroutines * each);
+}
+
+template<class Semaphore>
+/** Lets 8 producers notify 8 timed consumers on 4 threads, and returns the time per item in nanoseconds. */
+static double producer_consumer(
+	std::size_t operations)
+{
+	std::size_t const pairs = 8;
+	std::size_t const each = operations / pairs / 4;
+	Semaphore semaphore;
+	semaphore.initialise(0);
+	std::vector<Producer<Semaphore>> producers(pairs);
+	std::vector<Consumer<Semaphore>> consumers(pairs);
+	double const elapsed = run(4, [&] {
+		s_running.store(2 * pairs, std::memory_order_relaxed);
+		for(Consumer<Semaphore> &consumer: consumers)
+			consumer.start(nullptr, semaphore, each);
+		for(Producer<Semaphore> &producer: producers)
+			producer.start(nullptr, semaphore, each);
+	});
+	return elapsed / (pairs * each);
+}
+
+int main(
+	int argc,
+	char ** argv)
+{
+	std::size_t const operations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+
+	std::printf("setup\tlocked [ns/op]\tsingle-word [ns/op]\n");
+	std::printf("uncontended notify+wait\t%.1f\t%.1f\n",
+		uncontended<LockedSemaphore>(operations),
+		uncontended<cr::mt::PODFIFOSemaphore>(operations));
+	std::printf("32 coroutines / 4 threads, count 4\t%.1f\t%.1f\n",
+		contended<LockedSemaphore>(operations),
+		contended<cr::mt::PODFIFOSemaphore>(operations));
+	std::printf("8 producers / 8 timed consumers\t%.1f\t%.1f\n",
+		producer_consumer<LockedSemaphore>(operations),
+		producer_consumer<cr::mt::PODFIFOSemaphore>(operations));
+	std::printf("expired timed waits\t%zu\n", s_expired.load(std::memory_order_relaxed));
+
+	return 0;
+}
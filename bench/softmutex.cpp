@@ -0,0 +1,99 @@
+/** @file softmutex.cpp
+	Measures the internal soft mutex under thread contention, against the previous plain spin lock.
+	For 1, 4 and 16 threads, every thread locks the mutex `operations` times around a short critical section. Prints the time per lock and unlock. Thread counts above the machine's core count measure oversubscription.
+	Build once with and once without `-DLIBCR_FUTEX=ON` to compare plain backoff against the futex fallback.
+	Usage: `softmutex [operations]` */
+#include <libcr/libcr.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+/** The previous soft mutex design, kept as a baseline.
+	Locking retries a compare-and-swap without pausing, so waiting threads keep taking the cache line exclusively. */
+class SpinMutex
+{
+	/** Whether the mutex is locked. */
+	std::atomic_bool m_locked;
+public:
+	/** Initialises the mutex. */
+	SpinMutex():
+		m_locked(false)
+	{
+	}
+
+	/** Locks the mutex. */
+	void lock()
+	{
+		bool value;
+		do {
+			value = false;
+		} while(!m_locked.compare_exchange_weak(
+			value,
+			true,
+			std::memory_order_acquire,
+			std::memory_order_relaxed));
+	}
+
+	/** Unlocks the mutex. */
+	void unlock()
+	{
+		m_locked.store(false, std::memory_order_release);
+	}
+};
+
+/** Changed inside the critical sections. */
+static std::size_t s_counter;
+
+template<class Mutex>
+/** Runs the threads and returns the time per lock and unlock in nanoseconds. */
+static double run(
+	std::size_t threads,
+	std::size_t operations)
+{
+	static Mutex mutex;
+	std::vector<std::thread> pool;
+	auto const start = std::chrono::steady_clock::now();
+	for(std::size_t thread = 0; thread < threads; thread++)
+		pool.emplace_back([operations] {
+			for(std::size_t i = 0; i < operations; i++)
+			{
+				mutex.lock();
+				++s_counter;
+				mutex.unlock();
+			}
+		});
+	for(std::thread &thread: pool)
+		thread.join();
+	auto const end = std::chrono::steady_clock::now();
+
+	return std::chrono::duration<double, std::nano>(end - start).count() / (threads * operations);
+}
+
+int main(
+	int argc,
+	char ** argv)
+{
+	std::size_t const operations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+
+#ifdef LIBCR_FUTEX
+	std::printf("mode: backoff+futex\n");
+#else
+	std::printf("mode: backoff\n");
+#endif
+
+	std::printf("threads\tspin lock [ns/lock]\tsoft mutex [ns/lock]\n");
+	for(std::size_t threads = 1; threads <= 16; threads *= 4)
+		std::printf("%zu\t%.1f\t%.1f\n",
+			threads,
+			run<SpinMutex>(threads, operations),
+			run<cr::mt::detail::SoftMutex>(threads, operations));
+
+	if(s_counter != 42 * operations)
+		std::printf("lost updates: %zu of %zu\n", 42 * operations - s_counter, 42 * operations);
+
+	return 0;
+}
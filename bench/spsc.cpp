@@ -0,0 +1,140 @@
+/** @file spsc.cpp
+	Compares the single-producer single-consumer queues against the fixed queues.
+	One coroutine pushes `items` longs through a 64-slot queue, and another coroutine pops them. The sync queues run on the simple scheduler, and the thread-safe queues on the hybrid scheduler with one and two threads. Waiting coroutines are resumed through the scheduler's deferred resumer. Prints the time per item. Thread counts above the machine's core count measure oversubscription.
+	Build with `-DLIBCR_TRAMPOLINE=ON` to measure trampolined resumption.
+	Usage: `spsc [items]` */
+#include <libcr/libcr.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+typedef cr::sync::FIFOScheduler Sync;
+typedef cr::HybridScheduler<cr::mt::FIFOConditionVariable, cr::sync::FIFOConditionVariable> Hybrid;
+
+/** The queues' capacity. */
+static constexpr std::size_t kSize = 64;
+
+/** How many coroutines are still running. */
+static std::atomic_size_t s_running(0);
+
+template<class Queue>
+TEMPLATE_COROUTINE(Producer, (Queue), void)
+CR_STATE(
+	(Queue &) queue,
+	(std::size_t) items)
+	typename Queue::template PushPattern<long const&> push;
+	long value;
+CR_INLINE
+	for(value = 0; value < (long) items; value++)
+	{
+		CR_CALL(push, (*queue, value));
+	}
+CR_FINALLY
+	s_running.fetch_sub(1, std::memory_order_relaxed);
+CR_INLINE_END
+
+template<class Queue>
+TEMPLATE_COROUTINE(Consumer, (Queue), void)
+CR_STATE(
+	(Queue &) queue,
+	(std::size_t) items)
+	typename Queue::Pop pop;
+	std::size_t i;
+	long value;
+CR_INLINE
+	for(i = 0; i < items; i++)
+	{
+		CR_CALL(pop, (*queue, value));
+	}
+CR_FINALLY
+	s_running.fetch_sub(1, std::memory_order_relaxed);
+CR_INLINE_END
+
+template<class Queue>
+/** Moves the items through a sync queue on the simple scheduler and returns the time per item in nanoseconds. */
+static double run_sync(
+	std::size_t items)
+{
+	Sync &scheduler = Sync::instance();
+	scheduler.initialise();
+
+	Queue queue;
+	queue.set_resumer(scheduler.deferred());
+	Producer<Queue> producer;
+	Consumer<Queue> consumer;
+	s_running.store(2, std::memory_order_relaxed);
+
+	auto const start = std::chrono::steady_clock::now();
+	consumer.start(nullptr, queue, items);
+	producer.start(nullptr, queue, items);
+	while(s_running.load(std::memory_order_relaxed))
+		scheduler.schedule();
+	auto const end = std::chrono::steady_clock::now();
+
+	return std::chrono::duration<double, std::nano>(end - start).count() / items;
+}
+
+template<class Queue>
+/** Moves the items through a thread-safe queue on the hybrid scheduler and returns the time per item in nanoseconds. */
+static double run_mt(
+	std::size_t threads,
+	std::size_t items)
+{
+	Hybrid &scheduler = Hybrid::instance();
+	scheduler.initialise(threads);
+
+	Queue queue;
+	queue.set_resumer(scheduler.deferred());
+	Producer<Queue> producer;
+	Consumer<Queue> consumer;
+	s_running.store(2, std::memory_order_relaxed);
+
+	// Idle threads park, so that they do not take the CPU from busy threads when the machine is oversubscribed.
+	std::vector<std::thread> pool;
+	for(std::size_t thread = 0; thread < threads; thread++)
+		pool.emplace_back([&scheduler, thread] {
+			scheduler.run_until_stopped(thread);
+		});
+
+	auto const start = std::chrono::steady_clock::now();
+	consumer.start(nullptr, queue, items);
+	producer.start(nullptr, queue, items);
+	while(s_running.load(std::memory_order_relaxed))
+		std::this_thread::yield();
+	auto const end = std::chrono::steady_clock::now();
+
+	scheduler.stop();
+	for(std::thread &thread: pool)
+		thread.join();
+
+	return std::chrono::duration<double, std::nano>(end - start).count() / items;
+}
+
+int main(
+	int argc,
+	char ** argv)
+{
+	std::size_t const items = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 400000;
+
+#ifdef LIBCR_TRAMPOLINE
+	std::printf("mode: trampoline\n");
+#else
+	std::printf("mode: direct\n");
+#endif
+
+	std::printf("setup\tspsc [ns/item]\tfixed [ns/item]\n");
+	std::printf("sync\t%.1f\t%.1f\n",
+		run_sync<cr::sync::SPSCQueue<long, kSize>>(items),
+		run_sync<cr::sync::FixedQueue<long, kSize>>(items));
+	for(std::size_t threads = 1; threads <= 2; threads++)
+		std::printf("mt, %zu threads\t%.1f\t%.1f\n",
+			threads,
+			run_mt<cr::mt::SPSCQueue<long, kSize>>(threads, items),
+			run_mt<cr::mt::FixedQueue<long, kSize>>(threads, items));
+
+	return 0;
+}
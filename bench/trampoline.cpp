@@ -0,0 +1,101 @@
+/** @file trampoline.cpp
+	Measures how the resumption mode affects chains of notifications and nested calls.
+	In the relay, K coroutines each wait for their own semaphore and then notify the next coroutine's, so that every hop resumes the next coroutine from within the previous one. With direct resumption, a lap of the relay nests K resumptions on the native stack, so large K overflow the stack. With `LIBCR_TRAMPOLINE`, nested resumptions run from a flat loop instead. The call chain measures the cost of `#CR_CALL` and the return to the parent at a given depth.
+	Build once with and once without `-DLIBCR_TRAMPOLINE=ON` to compare both modes.
+	Usage: `trampoline [max relay length]` */
+#include <libcr/libcr.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+typedef cr::SchedulerPattern<cr::sync::FIFOConditionVariable> Scheduler;
+
+/** The relay's semaphores, one per coroutine. */
+static std::vector<cr::sync::PODSemaphore> s_relay;
+
+COROUTINE(Runner, Scheduler)
+CR_STATE(
+	(std::size_t) index,
+	(std::size_t) laps)
+	std::size_t lap;
+CR_INLINE
+	for(lap = 0; lap < laps; lap++)
+	{
+		CR_AWAIT(s_relay[index].wait());
+		s_relay[(index + 1) % s_relay.size()].notify();
+	}
+CR_FINALLY
+CR_INLINE_END
+
+COROUTINE(Link, Scheduler)
+CR_STATE(
+	(Link *) next,
+	(std::size_t) depth)
+CR_INLINE
+	if(depth)
+	{
+		CR_CALL(*next, (next + 1, depth - 1));
+	}
+CR_FINALLY
+CR_INLINE_END
+
+/** Passes a notification around a relay of `length` coroutines and returns the time per hop in nanoseconds. */
+static double relay(
+	std::size_t length,
+	std::size_t hops)
+{
+	std::size_t const laps = hops / length ? hops / length : 1;
+	s_relay.resize(length);
+	std::vector<Runner> runners(length);
+	for(std::size_t i = 0; i < length; i++)
+	{
+		s_relay[i].initialise(0);
+		runners[i].start(nullptr, i, laps);
+	}
+
+	auto const start = std::chrono::steady_clock::now();
+	s_relay[0].notify();
+	auto const end = std::chrono::steady_clock::now();
+
+	return std::chrono::duration<double, std::nano>(end - start).count() / (laps * length);
+}
+
+/** Runs a chain of nested calls `repeat` times and returns the time per call in nanoseconds. */
+static double chain(
+	std::size_t depth,
+	std::size_t repeat)
+{
+	std::vector<Link> links(depth + 1);
+
+	auto const start = std::chrono::steady_clock::now();
+	for(std::size_t i = 0; i < repeat; i++)
+		links[0].start(nullptr, links.data() + 1, depth);
+	auto const end = std::chrono::steady_clock::now();
+
+	return std::chrono::duration<double, std::nano>(end - start).count() / (repeat * depth);
+}
+
+int main(
+	int argc,
+	char ** argv)
+{
+	std::size_t const max_relay = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+
+#ifdef LIBCR_TRAMPOLINE
+	std::printf("mode: trampoline\n");
+#else
+	std::printf("mode: direct\n");
+#endif
+
+	std::printf("relay length\t[ns/hop]\n");
+	for(std::size_t length = 10; length <= max_relay; length *= 10)
+		std::printf("%zu\t%.1f\n", length, relay(length, 2000000));
+
+	std::printf("call depth\t[ns/call]\n");
+	for(std::size_t depth = 10; depth <= 1000; depth *= 10)
+		std::printf("%zu\t%.1f\n", depth, chain(depth, 2000000 / depth));
+
+	return 0;
+}
@@ -0,0 +1,105 @@
+/** @file waiters.cpp
+	Measures how fast the thread-safe FIFO primitives release long waiting lists.
+	Every round, `waiters` coroutines start waiting for a condition variable, an event, and a semaphore in turn. Then the waiting list is released by calling `notify_one()` once per waiter, by one `fire()`, or by calling `notify()` once per waiter. Runs on a single thread. Prints the release time per waiter.
+	Build once with and once without `-DLIBCR_FENCED_LOADS=ON` to compare the two strong load strategies.
+	Usage: `waiters [waiters] [rounds]` */
+#include <libcr/libcr.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+/** The condition variable under test. */
+static cr::mt::PODFIFOConditionVariable s_cv;
+/** The event under test. */
+static cr::mt::PODFIFOEvent s_event;
+/** The semaphore under test. */
+static cr::mt::PODFIFOSemaphore s_semaphore;
+/** How many waiters were resumed. */
+static std::size_t s_resumed;
+
+COROUTINE(CvWaiter, void)
+CR_STATE()
+CR_INLINE
+	CR_AWAIT(s_cv.wait());
+	++s_resumed;
+CR_FINALLY
+CR_INLINE_END
+
+COROUTINE(EventWaiter, void)
+CR_STATE()
+CR_INLINE
+	CR_AWAIT(s_event.wait());
+	++s_resumed;
+CR_FINALLY
+CR_INLINE_END
+
+COROUTINE(SemaphoreWaiter, void)
+CR_STATE()
+CR_INLINE
+	CR_AWAIT(s_semaphore.wait());
+	++s_resumed;
+CR_FINALLY
+CR_INLINE_END
+
+template<class Waiter, class Release>
+/** Lets the waiters wait, releases them, and returns the release time per waiter in nanoseconds.
+@param[in] release:
+	Releases all waiters. */
+static double run(
+	std::size_t waiters,
+	std::size_t rounds,
+	Release release)
+{
+	std::vector<Waiter> coroutines(waiters);
+	double elapsed = 0;
+	for(std::size_t round = 0; round < rounds; round++)
+	{
+		for(Waiter &waiter: coroutines)
+			waiter.start(nullptr);
+		auto const start = std::chrono::steady_clock::now();
+		release();
+		auto const end = std::chrono::steady_clock::now();
+		elapsed += std::chrono::duration<double, std::nano>(end - start).count();
+	}
+
+	return elapsed / (rounds * waiters);
+}
+
+int main(
+	int argc,
+	char ** argv)
+{
+	std::size_t const waiters = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+	std::size_t const rounds = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 20;
+
+	s_cv.initialise();
+	s_event.initialise();
+	s_semaphore.initialise(0);
+
+#ifdef LIBCR_FENCED_LOADS
+	std::printf("strong loads: fence+load\n");
+#else
+	std::printf("strong loads: compare-and-swap\n");
+#endif
+
+	std::printf("primitive\t[ns/waiter]\n");
+	std::printf("cv notify_one\t%.1f\n", run<CvWaiter>(waiters, rounds, [waiters] {
+		for(std::size_t i = 0; i < waiters; i++)
+			s_cv.notify_one();
+	}));
+	std::printf("event fire\t%.1f\n", run<EventWaiter>(waiters, rounds, [] {
+		s_event.fire();
+		s_event.clear();
+	}));
+	std::printf("semaphore notify\t%.1f\n", run<SemaphoreWaiter>(waiters, rounds, [waiters] {
+		for(std::size_t i = 0; i < waiters; i++)
+			s_semaphore.notify();
+	}));
+
+	if(s_resumed != 3 * rounds * waiters)
+		std::printf("resumed %zu of %zu\n", s_resumed, 3 * rounds * waiters);
+
+	return 0;
+}
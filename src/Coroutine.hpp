@@ -7,9 +7,11 @@
 #include "Protothread.hpp"
 #include "detail/Thread.hpp"
 #include "detail/NextPointer.hpp"
+#include "detail/Trampoline.hpp"
 
 #include <atomic>
 #include <cstddef>
+#include <cinttypes>
 #include <utility>
 
 namespace cr
@@ -41,6 +43,13 @@ namespace cr
 		impl_t libcr_coroutine;
 		/** When waiting for a resource, the next coroutine in line, or null if last. */
 		detail::NextPointer libcr_next_waiting;
+		union
+		{
+			/** When sleeping, the timer tick at which the coroutine wakes up. */
+			std::uint64_t libcr_deadline;
+			/** When waiting in a doubly linked list, the previous coroutine in line, or null if first. */
+			Coroutine * libcr_prev_waiting;
+		};
 
 		/** Prepares the coroutine to be the root coroutine.
 		@param[in] coroutine:
@@ -62,6 +71,11 @@ namespace cr
 			This should only be called by library functions. */
 		inline void operator()();
 
+		/** Resumes the coroutine after the operation it waited for completed.
+			With `LIBCR_TRAMPOLINE`, a resumption from within another resumption is deferred to a per-thread ring and run from a flat loop, so that chains of notifications and returns do not nest on the native stack. Otherwise, this is equivalent to `operator()`.
+			This should only be called by library functions. */
+		inline void resume();
+
 		template<class T>
 		/** Short-hand for `Context::local()`. */
 		inline T &local();
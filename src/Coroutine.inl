@@ -8,6 +8,15 @@ namespace cr
 		(this->*libcr_coroutine)();
 	}
 
+	void Coroutine::resume()
+	{
+#ifdef LIBCR_TRAMPOLINE
+		detail::Trampoline::resume(this);
+#else
+		(*this)();
+#endif
+	}
+
 	template<class T>
 	T &Coroutine::local()
 	{
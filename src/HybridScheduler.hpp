@@ -5,8 +5,14 @@
 
 #include "detail/Thread.hpp"
 #include "util/Atomic.hpp"
+#include "util/Backoff.hpp"
 #include "sync/Block.hpp"
 #include "util/Rng.hpp"
+#include "mt/detail/SoftMutex.hpp"
+#include "TimerWheel.hpp"
+#include "Timeout.hpp"
+#include "Resumer.hpp"
+#include "io/Ring.hpp"
 
 #include <vector>
 
@@ -24,8 +30,9 @@ namespace cr
 		static HybridScheduler<MtCV, SyncCV> s_instance;
 
 		typedef std::uint64_t time_t;
-		/** Thread context type. */
-		struct ThreadContext
+		/** Thread context type.
+			Each context occupies its own cache lines, so that threads do not contend when publishing their load. */
+		struct alignas(64) ThreadContext
 		{
 			/** Initialises the thread context. */
 			ThreadContext();
@@ -33,24 +40,149 @@ namespace cr
 			MtCV global_cv;
 			/** The coroutines owned by the thread. */
 			SyncCV local_cv;
+			/** The thread's sleeping coroutines and timeouts. */
+			TimerWheel timers;
+			/** Protects the timing wheel, as other threads insert sleeping coroutines and cancel timeouts. */
+			mt::detail::SoftMutex timer_mutex;
 			/** The time needed to execute all coroutines once. */
 			util::Atomic<time_t> load;
 			/** The thread's scheduling RNG. */
 			util::Rng rng;
+			/** The number of scheduling rounds. */
+			std::atomic<std::uint64_t> rounds;
+			/** The number of resumed coroutines. */
+			std::atomic<std::uint64_t> coroutines;
+			/** The nanoseconds spent scheduling in `run_until_stopped()`, excluding parked time. */
+			std::atomic<std::uint64_t> busy;
+			/** The nanoseconds spent blocked waiting for work. */
+			std::atomic<std::uint64_t> parked;
+			/** Incremented before and after each round of `run_until_stopped()`. */
+			std::atomic<std::uint64_t> activity;
+			/** Whether the thread's last round of `run_until_stopped()` found no pending work. */
+			std::atomic_bool idle;
+#ifdef LIBCR_HAS_REACTOR
+			/** The thread's I/O reactor, which also blocks the thread while it has nothing to do. */
+			io::Reactor reactor;
+			/** The thread's I/O submission ring, which falls back to the reactor if io_uring is unavailable. */
+			io::Ring ring;
+#endif
 		};
 
 		/** The scheduler's thread contexts. */
 		std::vector<ThreadContext> m_threads;
-		/** The thread with the highest load. */
-		util::Atomic<std::size_t> m_busy_thread;
-		/** The thread with the lowest load. */
-		util::Atomic<std::size_t> m_idle_thread;
+		/** Whether `run_until_stopped()` should return. */
+		std::atomic_bool m_stopped;
+		/** The number of idle rounds before a thread parks. */
+		std::size_t m_spin_rounds;
 
+		/** Picks the less loaded of two threads.
+		@param[in] a:
+			The first thread.
+		@param[in] b:
+			The second thread.
+		@return
+			The thread with the lower recorded load. */
+		inline std::size_t less_loaded(
+			std::size_t a,
+			std::size_t b);
+
+		/** Samples two random peers of a thread and picks the less loaded one.
+			This replaces a global load scan, so that no thread has to coordinate the others.
+		@param[in] thread:
+			The sampling thread.
+			Must not be the only thread.
+		@return
+			The less loaded of the sampled peers. */
+		inline std::size_t sample_idle_peer(
+			std::size_t thread);
+
+		/** Assigns a coroutine without a thread to a lightly loaded thread.
+		@param[in] coroutine:
+			The coroutine to assign. */
+		inline void assign_thread(
+			Coroutine * coroutine);
+
+		/** Selects the timing wheel that watches a timed waiting coroutine.
+		@param[in] scheduler:
+			The scheduler.
+		@param[in] waiter:
+			The waiting coroutine.
+		@param[out] mutex:
+			The mutex protecting the timing wheel, or null if it is not shared.
+		@return
+			The timing wheel. */
+		static PODTimerWheel &select_timers(
+			void * scheduler,
+			Coroutine * waiter,
+			mt::detail::PODSoftMutex * &mutex);
+
+		/** Hands a notified coroutine over to the scheduler, see `deferred()`.
+		@param[in] scheduler:
+			The scheduler.
+		@param[in] coroutine:
+			The notified coroutine. */
+		static void defer(
+			void * scheduler,
+			Coroutine * coroutine);
+
+		/** Adds to a counter that is only written by its owning thread.
+		@param[in,out] counter:
+			The counter.
+		@param[in] amount:
+			The amount to add. */
+		static inline void count(
+			std::atomic<std::uint64_t> &counter,
+			std::uint64_t amount);
 
-		/** Detects the current load distribution of the scheduler threads. */
-		inline void detect_load();
+#ifdef LIBCR_HAS_REACTOR
+		/** Polls a thread's reactor, and records the time spent blocking.
+		@param[in] ctx:
+			The thread's context.
+		@param[in] timeout:
+			The poll timeout in milliseconds, see `io::Reactor::poll()`.
+		@return
+			The number of resumed coroutines. */
+		static std::size_t sleep(
+			ThreadContext &ctx,
+			int timeout);
+#endif
+
+		/** Blocks an idle thread until its next sleeping coroutine is due, another thread hands it a coroutine, a timer is inserted, or I/O arrives.
+			Without reactor support, only yields the thread.
+		@param[in] thread:
+			The idle thread. */
+		void park(
+			std::size_t thread);
+
+		/** Runs one scheduling round of a thread, see `schedule()`.
+			Never blocks.
+		@param[in] thread:
+			The thread index.
+		@param[out] pending:
+			Whether coroutines are still sleeping or waiting for I/O, or the timing wheel could not be checked.
+		@return
+			Whether any coroutines were executed. */
+		inline bool run_round(
+			std::size_t thread,
+			bool &pending);
 
 	public:
+		/** Statistics of a scheduling thread. */
+		struct Stats
+		{
+			/** The number of scheduling rounds. */
+			std::uint64_t rounds;
+			/** The number of resumed coroutines. */
+			std::uint64_t coroutines;
+			/** The time spent scheduling in `run_until_stopped()`, excluding parked time. */
+			std::chrono::nanoseconds busy;
+			/** The time spent blocked waiting for work. */
+			std::chrono::nanoseconds parked;
+		};
+
+		/** The default number of idle rounds before a thread parks. */
+		static constexpr std::size_t kDefaultSpinRounds = 64;
+
 		/** Initialises the scheduler. */
 		HybridScheduler();
 
@@ -64,15 +196,47 @@ namespace cr
 		/** The number of threads run by the scheduler. */
 		inline std::size_t threads() const;
 
-		/** Executes all coroutines currently waiting for a specified thread.
+		/** Executes all coroutines currently waiting for a specified thread, and wakes up the thread's sleeping coroutines that are due.
 			Records the thread's execution time and auto-balances the load.
+			Submits the I/O operations queued during this call in one batch, and resumes the coroutines whose operations completed.
+			Never blocks, so that it can be driven from the caller's own loop. Use `run_until_stopped()` to block idle threads.
 		@param[in] thread:
 			The thread index.
 		@return
-			Whether any coroutines were executed. */
+			Whether any coroutines were executed, are still sleeping, or are waiting for I/O. */
 		inline bool schedule(
 			std::size_t thread = 0);
 
+		/** Runs a scheduling thread until `stop()` is called.
+			When the thread runs no coroutine for the configured number of rounds, it is parked instead of spinning, until its next sleeping coroutine is due, I/O arrives, or another thread hands it a coroutine.
+		@param[in] thread:
+			The thread index. */
+		void run_until_stopped(
+			std::size_t thread = 0);
+
+		/** Makes all threads return from `run_until_stopped()`, waking parked threads.
+			Coroutines that did not finish remain in the scheduler. */
+		void stop();
+
+		/** Whether all threads running `run_until_stopped()` are idle, and no coroutine is waiting, sleeping, or waiting for I/O in the scheduler.
+			Coroutines that are only waiting on synchronisation primitives are not seen, as they do not belong to any thread yet. */
+		bool idle() const;
+
+		/** Reads a thread's statistics.
+			The counters are updated without synchronisation, so they may lag slightly behind.
+		@param[in] thread:
+			The thread index.
+		@return
+			The thread's statistics. */
+		Stats stats(
+			std::size_t thread) const;
+
+		/** Sets the number of consecutive idle rounds a thread spins before it parks.
+		@param[in] rounds:
+			The number of rounds, 0 to park right away. */
+		inline void set_spin_rounds(
+			std::size_t rounds);
+
 		/** Helper class for enqueuing a coroutine into the scheduler using `#CR_AWAIT`.  */
 		class EnqueueCall
 		{
@@ -95,6 +259,151 @@ namespace cr
 		/** Enqueues a coroutine in the scheduler. */
 		[[nodiscard]] constexpr EnqueueCall enqueue();
 
+		/** Creates a resumer that enqueues notified coroutines into the scheduler instead of resuming them directly.
+			Pass it to a notifying call, so that the notifying coroutine continues right away, and the notified coroutines run on their next scheduling round. Works from any thread: coroutines are always handed over through the target thread's thread-safe queue. */
+		[[nodiscard]] inline Resumer deferred();
+
+		/** Helper class for putting a coroutine to sleep using `#CR_AWAIT`. */
+		class SleepCall
+		{
+			/** The scheduler whose timing wheels to use. */
+			HybridScheduler<MtCV, SyncCV> &m_scheduler;
+			/** The tick at which to wake up. */
+			std::uint64_t m_deadline;
+		public:
+			/** Initialises the sleep call.
+			@param[in] scheduler:
+				The scheduler whose timing wheels to use.
+			@param[in] deadline:
+				The tick at which to wake up. */
+			constexpr SleepCall(
+				HybridScheduler<MtCV, SyncCV> &scheduler,
+				std::uint64_t deadline);
+
+			/** Puts a coroutine to sleep in its thread's timing wheel, unless the deadline has already passed.
+			@param[in] coroutine:
+				The coroutine to put to sleep. */
+			[[nodiscard]] sync::mayblock libcr_wait(
+				Coroutine * coroutine);
+		};
+
+		/** Puts a coroutine to sleep until a point in time.
+		@param[in] time:
+			The time to wake up at. */
+		[[nodiscard]] inline SleepCall sleep_until(
+			TimerWheel::clock::time_point time);
+
+		template<class Rep, class Period>
+		/** Puts a coroutine to sleep for a duration.
+		@param[in] duration:
+			The minimal time to sleep for. */
+		[[nodiscard]] inline SleepCall sleep_for(
+			std::chrono::duration<Rep, Period> duration);
+
+		template<class Rep, class Period>
+		/** Creates a deadline for a timed wait that expires after a duration.
+		@param[in] timeout:
+			The timeout to use. It has to outlive the timed wait.
+		@param[in] duration:
+			The minimal time to wait for. */
+		[[nodiscard]] inline Deadline deadline_for(
+			PODTimeout &timeout,
+			std::chrono::duration<Rep, Period> duration);
+
+		/** Creates a deadline for a timed wait that expires at a point in time.
+		@param[in] timeout:
+			The timeout to use. It has to outlive the timed wait.
+		@param[in] time:
+			The time at which the wait expires. */
+		[[nodiscard]] inline Deadline deadline_until(
+			PODTimeout &timeout,
+			TimerWheel::clock::time_point time);
+
+#ifdef LIBCR_HAS_REACTOR
+		/** Helper class for waiting for file descriptor readiness using `#CR_AWAIT`. */
+		class ReadyCall
+		{
+			/** The scheduler whose reactors to use. */
+			HybridScheduler<MtCV, SyncCV> &m_scheduler;
+			/** The file descriptor to wait for. */
+			int m_fd;
+			/** The readiness to wait for. */
+			io::Reactor::Events m_events;
+		public:
+			/** Initialises the ready call.
+			@param[in] scheduler:
+				The scheduler whose reactors to use.
+			@param[in] fd:
+				The file descriptor to wait for.
+			@param[in] events:
+				The readiness to wait for. */
+			constexpr ReadyCall(
+				HybridScheduler<MtCV, SyncCV> &scheduler,
+				int fd,
+				io::Reactor::Events events);
+
+			/** Waits in the reactor of the coroutine's thread until the file descriptor is ready.
+			@param[in] coroutine:
+				The coroutine to wait. */
+			[[nodiscard]] sync::mayblock libcr_wait(
+				Coroutine * coroutine);
+		};
+
+		/** Waits until a non-blocking file descriptor is readable.
+			The readiness is edge-triggered, see `io::Reactor`.
+		@param[in] fd:
+			The file descriptor to wait for. */
+		[[nodiscard]] constexpr ReadyCall readable(
+			int fd);
+		/** Waits until a non-blocking file descriptor is writable.
+			The readiness is edge-triggered, see `io::Reactor`.
+		@param[in] fd:
+			The file descriptor to wait for. */
+		[[nodiscard]] constexpr ReadyCall writable(
+			int fd);
+
+		/** Helper class for performing an I/O operation using `#CR_AWAIT`. */
+		class PerformCall
+		{
+			/** The scheduler whose rings to use. */
+			HybridScheduler<MtCV, SyncCV> &m_scheduler;
+			/** The operation to perform. */
+			io::PODOperation &m_operation;
+		public:
+			/** Initialises the perform call.
+			@param[in] scheduler:
+				The scheduler whose rings to use.
+			@param[in] operation:
+				The prepared operation. */
+			constexpr PerformCall(
+				HybridScheduler<MtCV, SyncCV> &scheduler,
+				io::PODOperation &operation);
+
+			/** Queues the operation in the ring of the coroutine's thread.
+				The operation is submitted at the end of the thread's next `schedule()` call.
+			@param[in] coroutine:
+				The coroutine to wait for the operation. */
+			[[nodiscard]] sync::mayblock libcr_wait(
+				Coroutine * coroutine);
+		};
+
+		/** Performs a prepared I/O operation using io_uring, or using the reactor if io_uring is unavailable.
+			Afterwards, the operation's result is available.
+		@param[in] operation:
+			The prepared operation. It has to outlive the call. */
+		[[nodiscard]] constexpr PerformCall perform(
+			io::PODOperation &operation);
+
+		/** Stops watching a file descriptor in all threads' reactors, and fails the coroutines waiting for it.
+			Has to be called before closing a watched file descriptor.
+		@param[in] fd:
+			The file descriptor to stop watching.
+		@return
+			Whether any coroutine was failed. */
+		bool remove(
+			int fd);
+#endif
+
 		/** Retrieves the static scheduler instance. */
 		static inline HybridScheduler<MtCV, SyncCV> &instance();
 	};
@@ -1,6 +1,8 @@
 #include <timer/Timer.hpp>
 #include <thread>
 #include <cstdlib>
+#include <climits>
+#include <atomic>
 
 namespace cr
 {
@@ -11,9 +13,25 @@ namespace cr
 	HybridScheduler<MtCV, SyncCV>::ThreadContext::ThreadContext():
 		global_cv(),
 		local_cv(),
+		timers(),
+		timer_mutex(),
 		load((~(time_t)0)>>11), // prevent overflow
-		rng(rand())
+		rng(rand()),
+		rounds(0),
+		coroutines(0),
+		busy(0),
+		parked(0),
+		activity(0),
+		idle(false)
+#ifdef LIBCR_HAS_REACTOR
+		, reactor()
+		, ring(reactor)
+#endif
 	{
+#ifdef LIBCR_HAS_REACTOR
+		// Interrupt a blocking poll when another thread inserts an earlier deadline.
+		timers.set_waker(&io::Reactor::wake, &reactor);
+#endif
 	}
 
 	template<class MtCV, class SyncCV>
@@ -22,77 +40,292 @@ namespace cr
 	{
 		if(threads < 2)
 			threads = 1;
-		m_busy_thread.store(0, std::memory_order_relaxed);
-		m_idle_thread.store(0, std::memory_order_relaxed);
 		m_threads.~vector();
 		new (&m_threads) std::vector<ThreadContext>{threads};
+		m_stopped.store(false, std::memory_order_relaxed);
 	}
 
 	template<class MtCV, class SyncCV>
-	void HybridScheduler<MtCV, SyncCV>::detect_load()
+	std::size_t HybridScheduler<MtCV, SyncCV>::less_loaded(
+		std::size_t a,
+		std::size_t b)
 	{
-		std::size_t idle = 0;
-		time_t idle_time = m_threads[0].load.load_weak(std::memory_order_relaxed);
-		std::size_t busy = 0;
-		time_t busy_time = idle_time;
+		return m_threads[b].load.load_weak(std::memory_order_relaxed)
+			< m_threads[a].load.load_weak(std::memory_order_relaxed)
+			? b
+			: a;
+	}
+
+	template<class MtCV, class SyncCV>
+	std::size_t HybridScheduler<MtCV, SyncCV>::sample_idle_peer(
+		std::size_t thread)
+	{
+		util::Rng &rng = m_threads[thread].rng;
+		std::size_t const peers = m_threads.size() - 1;
 
-		for(std::size_t i = 1; i < m_threads.size(); i++)
+		// Pick two random threads other than the sampling thread.
+		std::size_t a = (rng.byte() | (std::size_t(rng.byte()) << 8)) % peers;
+		std::size_t b = (rng.byte() | (std::size_t(rng.byte()) << 8)) % peers;
+		if(a >= thread)
+			a++;
+		if(b >= thread)
+			b++;
+
+		return less_loaded(a, b);
+	}
+
+	template<class MtCV, class SyncCV>
+	void HybridScheduler<MtCV, SyncCV>::assign_thread(
+		Coroutine * coroutine)
+	{
+		std::size_t idle_thread = 0;
+		if(std::size_t threads = m_threads.size(); threads != 1)
 		{
-			time_t time = m_threads[i].load.load_weak(std::memory_order_relaxed);
-			if(time < idle_time)
-			{
-				idle_time = time;
-				idle = i;
-			} else if(time > busy_time)
-			{
-				busy_time = time;
-				busy = i;
-			}
+			// Derive two candidate threads from the coroutine's address, instead of sharing a global idle thread.
+			std::uint64_t hash = reinterpret_cast<std::uintptr_t>(coroutine) * 0x9e3779b97f4a7c15ull;
+			idle_thread = less_loaded(
+				(hash >> 32) % threads,
+				(hash >> 48) % threads);
 		}
+		coroutine->libcr_thread = (detail::Thread) idle_thread;
+	}
+
+	template<class MtCV, class SyncCV>
+	PODTimerWheel &HybridScheduler<MtCV, SyncCV>::select_timers(
+		void * scheduler,
+		Coroutine * waiter,
+		mt::detail::PODSoftMutex * &mutex)
+	{
+		HybridScheduler<MtCV, SyncCV> &self = *static_cast<HybridScheduler<MtCV, SyncCV> *>(scheduler);
+		// The waiting coroutine is resumed by the thread owning the timing wheel on expiry.
+		if(!detail::valid(waiter->libcr_thread))
+			self.assign_thread(waiter);
 
-		m_busy_thread.store(busy, std::memory_order_relaxed);
-		m_idle_thread.store(idle, std::memory_order_relaxed);
+		ThreadContext &ctx = self.m_threads[(std::size_t)waiter->libcr_thread];
+		mutex = &ctx.timer_mutex;
+		return ctx.timers;
 	}
 
 	template<class MtCV, class SyncCV>
 	HybridScheduler<MtCV, SyncCV>::HybridScheduler():
 		m_threads(std::thread::hardware_concurrency()),
-		m_busy_thread(1),
-		m_idle_thread(0)
+		m_stopped(false),
+		m_spin_rounds(kDefaultSpinRounds)
 	{
 	}
 
 	template<class MtCV, class SyncCV>
-	bool HybridScheduler<MtCV, SyncCV>::schedule(
+	std::size_t HybridScheduler<MtCV, SyncCV>::threads() const
+	{
+		return m_threads.size();
+	}
+
+	template<class MtCV, class SyncCV>
+	void HybridScheduler<MtCV, SyncCV>::park(
 		std::size_t thread)
 	{
-		std::size_t busy;
-		bool balance = false;
-		std::uint8_t balance_odds;
-		std::size_t idle_thread;
+#ifdef LIBCR_HAS_REACTOR
+		ThreadContext &ctx = m_threads[thread];
+		// Announce the sleep first, so that enqueuing threads either see it or their coroutines are seen here.
+		ctx.reactor.prepare_sleep();
+		if(m_stopped.load(std::memory_order_relaxed)
+		|| !ctx.global_cv.empty()
+		|| ctx.ring.queued())
+		{
+			(void)sleep(ctx, 0);
+			return;
+		}
 
-		if(m_threads.size() != 1)
+		// Sleep until the next sleeping coroutine is due, or until woken if there is none.
+		int timeout = 0;
 		{
-			busy = m_busy_thread.load_weak(std::memory_order_relaxed);
-			balance = busy == thread;
-			if(balance)
+			mt::detail::LockGuard lock;
+			if(lock.try_lock(ctx.timer_mutex))
 			{
-				idle_thread = m_idle_thread.load_weak(std::memory_order_relaxed);
-				if((balance = idle_thread != busy))
+				if(ctx.timers.empty())
+					timeout = -1;
+				else
 				{
-					auto idle_time = m_threads[idle_thread].load.load_weak(std::memory_order_relaxed);
-					auto busy_time = m_threads[busy].load.load_weak(std::memory_order_relaxed);
-					balance_odds = (time_t(256)*busy_time) / (busy_time + idle_time + time_t(1));
-					if(balance_odds < 3)
-						balance = false;
+					std::uint64_t const next = ctx.timers.next_tick(), now = TimerWheel::now();
+					if(next > now)
+						timeout = next - now > (std::uint64_t)INT_MAX
+							? INT_MAX
+							: int(next - now);
 				}
 			}
 		}
+		(void)sleep(ctx, timeout);
+#else
+		(void) thread;
+		std::this_thread::yield();
+#endif
+	}
+
+	template<class MtCV, class SyncCV>
+	void HybridScheduler<MtCV, SyncCV>::run_until_stopped(
+		std::size_t thread)
+	{
+		ThreadContext &ctx = m_threads[thread];
+		std::size_t idle = 0;
+		while(!m_stopped.load(std::memory_order_relaxed))
+		{
+			// Odd while inside a round, so that `idle()` can tell whether the thread's state is stable.
+			std::uint64_t const activity = ctx.activity.load(std::memory_order_relaxed);
+			ctx.activity.store(activity + 1, std::memory_order_relaxed);
+
+			std::uint64_t const parked = ctx.parked.load(std::memory_order_relaxed);
+			TimerWheel::clock::time_point const begin = TimerWheel::clock::now();
+			bool pending;
+			bool const worked = run_round(thread, pending);
+			std::chrono::nanoseconds const elapsed = TimerWheel::clock::now() - begin;
+			count(ctx.busy, elapsed.count() - (ctx.parked.load(std::memory_order_relaxed) - parked));
+
+			ctx.idle.store(!worked && !pending, std::memory_order_relaxed);
+			ctx.activity.store(activity + 2, std::memory_order_release);
+
+			if(worked)
+				idle = 0;
+			else if(++idle > m_spin_rounds)
+			{
+				idle = 0;
+				park(thread);
+			} else
+				util::cpu_relax();
+		}
+	}
+
+	template<class MtCV, class SyncCV>
+	void HybridScheduler<MtCV, SyncCV>::stop()
+	{
+		m_stopped.store(true, std::memory_order_relaxed);
+#ifdef LIBCR_HAS_REACTOR
+		for(ThreadContext &ctx : m_threads)
+			ctx.reactor.wake();
+#endif
+	}
+
+	template<class MtCV, class SyncCV>
+	bool HybridScheduler<MtCV, SyncCV>::idle() const
+	{
+		std::size_t const threads = m_threads.size();
+		std::vector<std::uint64_t> activity(threads);
+		for(std::size_t i = 0; i < threads; i++)
+		{
+			activity[i] = m_threads[i].activity.load(std::memory_order_acquire);
+			if((activity[i] & 1) || !m_threads[i].idle.load(std::memory_order_relaxed))
+				return false;
+		}
+
+		for(ThreadContext const &ctx : m_threads)
+			if(!ctx.global_cv.empty())
+				return false;
+
+		// Any round started in between may have created work.
+		std::atomic_thread_fence(std::memory_order_acquire);
+		for(std::size_t i = 0; i < threads; i++)
+			if(m_threads[i].activity.load(std::memory_order_relaxed) != activity[i])
+				return false;
+
+		return true;
+	}
+
+	template<class MtCV, class SyncCV>
+	typename HybridScheduler<MtCV, SyncCV>::Stats HybridScheduler<MtCV, SyncCV>::stats(
+		std::size_t thread) const
+	{
+		ThreadContext const &ctx = m_threads[thread];
+		return Stats{
+			ctx.rounds.load(std::memory_order_relaxed),
+			ctx.coroutines.load(std::memory_order_relaxed),
+			std::chrono::nanoseconds(ctx.busy.load(std::memory_order_relaxed)),
+			std::chrono::nanoseconds(ctx.parked.load(std::memory_order_relaxed))
+		};
+	}
+
+	template<class MtCV, class SyncCV>
+	void HybridScheduler<MtCV, SyncCV>::count(
+		std::atomic<std::uint64_t> &counter,
+		std::uint64_t amount)
+	{
+		// Only the owning thread writes its counters, so no read-modify-write is needed.
+		counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+	}
+
+#ifdef LIBCR_HAS_REACTOR
+	template<class MtCV, class SyncCV>
+	std::size_t HybridScheduler<MtCV, SyncCV>::sleep(
+		ThreadContext &ctx,
+		int timeout)
+	{
+		if(!timeout)
+			return ctx.reactor.poll(0);
+
+		TimerWheel::clock::time_point const begin = TimerWheel::clock::now();
+		std::size_t resumed = ctx.reactor.poll(timeout);
+		std::chrono::nanoseconds const parked = TimerWheel::clock::now() - begin;
+		count(ctx.parked, parked.count());
+		count(ctx.coroutines, resumed);
+		return resumed;
+	}
+#endif
+
+	template<class MtCV, class SyncCV>
+	void HybridScheduler<MtCV, SyncCV>::set_spin_rounds(
+		std::size_t rounds)
+	{
+		m_spin_rounds = rounds;
+	}
+
+	template<class MtCV, class SyncCV>
+	bool HybridScheduler<MtCV, SyncCV>::schedule(
+		std::size_t thread)
+	{
+		bool pending;
+		bool const worked = run_round(thread, pending);
+		return worked || pending;
+	}
 
+	template<class MtCV, class SyncCV>
+	bool HybridScheduler<MtCV, SyncCV>::run_round(
+		std::size_t thread,
+		bool &pending)
+	{
 		ThreadContext &ctx = m_threads[thread];
+		bool balance = false;
+		std::uint8_t balance_odds = 0;
+		std::size_t idle_thread = thread;
+
+		// Compare against a sampled peer and hand over enough coroutines to even out the difference.
+		if(m_threads.size() != 1)
+		{
+			idle_thread = sample_idle_peer(thread);
+			auto idle_time = m_threads[idle_thread].load.load_weak(std::memory_order_relaxed);
+			auto busy_time = ctx.load.load_weak(std::memory_order_relaxed);
+			if((balance = busy_time > idle_time))
+			{
+				balance_odds = (time_t(128)*(busy_time - idle_time)) / (busy_time + time_t(1));
+				if(balance_odds < 3)
+					balance = false;
+			}
+		}
+
 		Coroutine * gfirst, * glast;
 		bool result = ctx.global_cv.remove_all(gfirst, glast);
 
+		Coroutine * due = nullptr;
+		// Whether the timing wheel holds sleeping coroutines, or could not be checked.
+		bool sleeping = true;
+		{
+			// Other threads only hold the lock briefly, so skip the timing wheel this round if it is busy.
+			mt::detail::LockGuard lock;
+			if(lock.try_lock(ctx.timer_mutex))
+			{
+				if(!ctx.timers.empty())
+					due = ctx.timers.advance(TimerWheel::now());
+				sleeping = !ctx.timers.empty();
+			}
+		}
+
 		timer::Timer<std::chrono::microseconds> timer;
 		Coroutine * lfirst;
 		if((lfirst = ctx.local_cv.remove_all()))
@@ -101,9 +334,21 @@ namespace cr
 		Coroutine * next;
 
 		Coroutine * q_first = nullptr, * q_last = nullptr;
+		std::size_t resumed = 0;
 
 		timer.start();
 
+		if(due)
+		{
+			result = true;
+			do {
+				next = due->libcr_next_waiting.plain;
+				resumed++;
+				(*due)();
+				due = next;
+			} while(due);
+		}
+
 		while(lfirst)
 		{
 			next = lfirst->libcr_next_waiting.plain;
@@ -117,7 +362,10 @@ namespace cr
 				q_last = lfirst;
 			}
 			else
+			{
+				resumed++;
 				(*lfirst)();
+			}
 			lfirst = next;
 		}
 
@@ -134,21 +382,48 @@ namespace cr
 				q_last = gfirst;
 			}
 			else
+			{
+				resumed++;
 				(*gfirst)();
+			}
 			gfirst = next;
 		}
 
 		if(q_first)
+		{
 			(void)m_threads[idle_thread].global_cv.wait(false).libcr_wait(q_first, q_last);
+#ifdef LIBCR_HAS_REACTOR
+			m_threads[idle_thread].reactor.wake();
+#endif
+		}
 
-		// The first thread updates the statistics.
-		if(m_threads.size() != 1)
+#ifdef LIBCR_HAS_REACTOR
+		// Submit the I/O queued during this round with a single system call.
+		if(std::size_t completed = ctx.ring.submit())
 		{
-			if(thread == 0)
-				detect_load();
-			ctx.load.store(timer.stop(), std::memory_order_relaxed);
+			result = true;
+			resumed += completed;
 		}
+#endif
 
+		count(ctx.rounds, 1);
+		count(ctx.coroutines, resumed);
+
+		if(m_threads.size() != 1)
+			ctx.load.store(timer.stop(), std::memory_order_relaxed);
+
+#ifdef LIBCR_HAS_REACTOR
+		// Collect I/O readiness without blocking, only `park()` blocks.
+		if(ctx.reactor.waiting() || ctx.ring.pending())
+		{
+			if(sleep(ctx, 0))
+				result = true;
+			pending = sleeping || ctx.reactor.waiting() || ctx.ring.pending();
+		} else
+			pending = sleeping;
+#else
+		pending = sleeping;
+#endif
 		return result;
 	}
 
@@ -165,9 +440,13 @@ namespace cr
 	{
 		if(!detail::valid(coroutine->libcr_thread))
 		{
-			std::size_t idle_thread = m_scheduler.m_idle_thread.load_weak(std::memory_order_relaxed);
-			coroutine->libcr_thread = (detail::Thread) idle_thread;
-			return m_scheduler.m_threads[idle_thread].global_cv.wait(false).libcr_wait(coroutine);
+			m_scheduler.assign_thread(coroutine);
+			ThreadContext &ctx = m_scheduler.m_threads[(std::size_t)coroutine->libcr_thread];
+			sync::block result = ctx.global_cv.wait(false).libcr_wait(coroutine);
+#ifdef LIBCR_HAS_REACTOR
+			ctx.reactor.wake();
+#endif
+			return result;
 		} else
 		{
 			return m_scheduler.m_threads[(std::size_t)coroutine->libcr_thread].local_cv.wait().libcr_wait(coroutine);
@@ -180,6 +459,168 @@ namespace cr
 		return this;
 	}
 
+	template<class MtCV, class SyncCV>
+	void HybridScheduler<MtCV, SyncCV>::defer(
+		void * scheduler,
+		Coroutine * coroutine)
+	{
+		HybridScheduler<MtCV, SyncCV> &self = *static_cast<HybridScheduler<MtCV, SyncCV> *>(scheduler);
+		if(!detail::valid(coroutine->libcr_thread))
+			self.assign_thread(coroutine);
+
+		// The notifier may run on any thread, so the local queue cannot be used.
+		ThreadContext &ctx = self.m_threads[(std::size_t)coroutine->libcr_thread];
+		(void) ctx.global_cv.wait(false).libcr_wait(coroutine);
+#ifdef LIBCR_HAS_REACTOR
+		ctx.reactor.wake();
+#endif
+	}
+
+	template<class MtCV, class SyncCV>
+	Resumer HybridScheduler<MtCV, SyncCV>::deferred()
+	{
+		return Resumer(this, &defer);
+	}
+
+	template<class MtCV, class SyncCV>
+	constexpr HybridScheduler<MtCV, SyncCV>::SleepCall::SleepCall(
+		HybridScheduler<MtCV, SyncCV> &scheduler,
+		std::uint64_t deadline):
+		m_scheduler(scheduler),
+		m_deadline(deadline)
+	{
+	}
+
+	template<class MtCV, class SyncCV>
+	sync::mayblock HybridScheduler<MtCV, SyncCV>::SleepCall::libcr_wait(
+		Coroutine * coroutine)
+	{
+		if(m_deadline <= TimerWheel::now())
+			return sync::nonblock();
+
+		if(!detail::valid(coroutine->libcr_thread))
+			m_scheduler.assign_thread(coroutine);
+
+		ThreadContext &ctx = m_scheduler.m_threads[(std::size_t)coroutine->libcr_thread];
+		mt::detail::LockGuard lock(ctx.timer_mutex);
+		ctx.timers.insert(coroutine, m_deadline);
+		return sync::block();
+	}
+
+	template<class MtCV, class SyncCV>
+	typename HybridScheduler<MtCV, SyncCV>::SleepCall HybridScheduler<MtCV, SyncCV>::sleep_until(
+		TimerWheel::clock::time_point time)
+	{
+		return SleepCall(*this, TimerWheel::tick(time));
+	}
+
+	template<class MtCV, class SyncCV>
+	template<class Rep, class Period>
+	typename HybridScheduler<MtCV, SyncCV>::SleepCall HybridScheduler<MtCV, SyncCV>::sleep_for(
+		std::chrono::duration<Rep, Period> duration)
+	{
+		return sleep_until(TimerWheel::clock::now() + std::chrono::ceil<TimerWheel::clock::duration>(duration));
+	}
+
+	template<class MtCV, class SyncCV>
+	Deadline HybridScheduler<MtCV, SyncCV>::deadline_until(
+		PODTimeout &timeout,
+		TimerWheel::clock::time_point time)
+	{
+		return Deadline(timeout, TimerWheel::tick(time), this, &select_timers);
+	}
+
+	template<class MtCV, class SyncCV>
+	template<class Rep, class Period>
+	Deadline HybridScheduler<MtCV, SyncCV>::deadline_for(
+		PODTimeout &timeout,
+		std::chrono::duration<Rep, Period> duration)
+	{
+		return deadline_until(timeout, TimerWheel::clock::now() + std::chrono::ceil<TimerWheel::clock::duration>(duration));
+	}
+
+#ifdef LIBCR_HAS_REACTOR
+	template<class MtCV, class SyncCV>
+	constexpr HybridScheduler<MtCV, SyncCV>::ReadyCall::ReadyCall(
+		HybridScheduler<MtCV, SyncCV> &scheduler,
+		int fd,
+		io::Reactor::Events events):
+		m_scheduler(scheduler),
+		m_fd(fd),
+		m_events(events)
+	{
+	}
+
+	template<class MtCV, class SyncCV>
+	sync::mayblock HybridScheduler<MtCV, SyncCV>::ReadyCall::libcr_wait(
+		Coroutine * coroutine)
+	{
+		// The coroutine is resumed by the thread polling the reactor.
+		if(!detail::valid(coroutine->libcr_thread))
+			m_scheduler.assign_thread(coroutine);
+
+		io::Reactor &reactor = m_scheduler.m_threads[(std::size_t)coroutine->libcr_thread].reactor;
+		return io::Reactor::ReadyCall(reactor, m_fd, m_events).libcr_wait(coroutine);
+	}
+
+	template<class MtCV, class SyncCV>
+	constexpr typename HybridScheduler<MtCV, SyncCV>::ReadyCall HybridScheduler<MtCV, SyncCV>::readable(
+		int fd)
+	{
+		return ReadyCall(*this, fd, io::Reactor::kReadable);
+	}
+
+	template<class MtCV, class SyncCV>
+	constexpr typename HybridScheduler<MtCV, SyncCV>::ReadyCall HybridScheduler<MtCV, SyncCV>::writable(
+		int fd)
+	{
+		return ReadyCall(*this, fd, io::Reactor::kWritable);
+	}
+
+	template<class MtCV, class SyncCV>
+	constexpr HybridScheduler<MtCV, SyncCV>::PerformCall::PerformCall(
+		HybridScheduler<MtCV, SyncCV> &scheduler,
+		io::PODOperation &operation):
+		m_scheduler(scheduler),
+		m_operation(operation)
+	{
+	}
+
+	template<class MtCV, class SyncCV>
+	sync::mayblock HybridScheduler<MtCV, SyncCV>::PerformCall::libcr_wait(
+		Coroutine * coroutine)
+	{
+		// The coroutine is resumed by the thread owning the ring.
+		bool const assigned = !detail::valid(coroutine->libcr_thread);
+		if(assigned)
+			m_scheduler.assign_thread(coroutine);
+
+		ThreadContext &ctx = m_scheduler.m_threads[(std::size_t)coroutine->libcr_thread];
+		sync::mayblock result = ctx.ring.perform(m_operation).libcr_wait(coroutine);
+		// A coroutine from outside the scheduler may have queued into a sleeping thread's ring.
+		if(assigned)
+			ctx.reactor.wake();
+		return result;
+	}
+
+	template<class MtCV, class SyncCV>
+	constexpr typename HybridScheduler<MtCV, SyncCV>::PerformCall HybridScheduler<MtCV, SyncCV>::perform(
+		io::PODOperation &operation)
+	{
+		return PerformCall(*this, operation);
+	}
+
+	template<class MtCV, class SyncCV>
+	bool HybridScheduler<MtCV, SyncCV>::remove(
+		int fd)
+	{
+		bool failed = false;
+		for(ThreadContext &ctx : m_threads)
+			failed |= ctx.reactor.remove(fd);
+		return failed;
+	}
+#endif
+
 	template<class MtCV, class SyncCV>
 	HybridScheduler<MtCV, SyncCV> &HybridScheduler<MtCV, SyncCV>::instance()
 	{
@@ -0,0 +1,54 @@
+/** @file Resumer.hpp
+	Contains the policy type that decides how notified coroutines are resumed. */
+#ifndef __libcr_resumer_hpp_defined
+#define __libcr_resumer_hpp_defined
+
+#include "Coroutine.hpp"
+
+namespace cr
+{
+	/** Decides how a notifying call resumes the coroutines it notifies.
+		By default, notified coroutines are resumed directly, so the notifier only continues after they block again. A deferring resumer, as created by a scheduler's `deferred()`, enqueues them into the scheduler instead, so that the notifier continues right away. */
+	class Resumer
+	{
+	public:
+		/** Hands a notified coroutine over to a scheduler.
+		@param[in] scheduler:
+			The scheduler.
+		@param[in] coroutine:
+			The notified coroutine. */
+		typedef void (*defer_t)(
+			void * scheduler,
+			Coroutine * coroutine);
+
+	private:
+		/** The scheduler to hand notified coroutines to, if deferring. */
+		void * m_scheduler;
+		/** Hands notified coroutines to the scheduler, or null to resume them directly. */
+		defer_t m_defer;
+	public:
+		/** Creates a resumer that resumes notified coroutines directly. */
+		constexpr Resumer();
+		/** Creates a resumer that hands notified coroutines to a scheduler.
+		@param[in] scheduler:
+			The scheduler.
+		@param[in] defer:
+			Hands a notified coroutine over to the scheduler. */
+		constexpr Resumer(
+			void * scheduler,
+			defer_t defer);
+
+		/** Whether notified coroutines are handed to a scheduler. */
+		constexpr bool deferred() const;
+
+		/** Resumes a notified coroutine according to the policy.
+		@param[in] coroutine:
+			The notified coroutine. */
+		inline void operator()(
+			Coroutine * coroutine) const;
+	};
+}
+
+#include "Resumer.inl"
+
+#endif
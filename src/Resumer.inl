@@ -0,0 +1,30 @@
+namespace cr
+{
+	constexpr Resumer::Resumer():
+		m_scheduler(nullptr),
+		m_defer(nullptr)
+	{
+	}
+
+	constexpr Resumer::Resumer(
+		void * scheduler,
+		defer_t defer):
+		m_scheduler(scheduler),
+		m_defer(defer)
+	{
+	}
+
+	constexpr bool Resumer::deferred() const
+	{
+		return m_defer != nullptr;
+	}
+
+	void Resumer::operator()(
+		Coroutine * coroutine) const
+	{
+		if(m_defer)
+			m_defer(m_scheduler, coroutine);
+		else
+			coroutine->resume();
+	}
+}
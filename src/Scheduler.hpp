@@ -5,6 +5,10 @@
 
 #include "sync/Block.hpp"
 #include "util/CVTraits.hpp"
+#include "mt/detail/SoftMutex.hpp"
+#include "TimerWheel.hpp"
+#include "Timeout.hpp"
+#include "Resumer.hpp"
 
 namespace cr
 {
@@ -21,6 +25,33 @@ namespace cr
 		/** The scheduler's condition variable.
 			This is used to notify waiting coroutines. */
 		util::remove_cv_pod_t<ConditionVariable> m_cv;
+		/** The scheduler's sleeping coroutines. */
+		TimerWheel m_timers;
+		/** Protects the timing wheel if the scheduler is thread-safe. */
+		mt::detail::SoftMutex m_timer_mutex;
+
+		/** Selects the timing wheel that watches a timed waiting coroutine.
+		@param[in] scheduler:
+			The scheduler.
+		@param[in] waiter:
+			The waiting coroutine.
+		@param[out] mutex:
+			The mutex protecting the timing wheel, or null if it is not shared.
+		@return
+			The timing wheel. */
+		static PODTimerWheel &select_timers(
+			void * scheduler,
+			Coroutine * waiter,
+			mt::detail::PODSoftMutex * &mutex);
+
+		/** Hands a notified coroutine over to the scheduler, see `deferred()`.
+		@param[in] scheduler:
+			The scheduler.
+		@param[in] coroutine:
+			The notified coroutine. */
+		static void defer(
+			void * scheduler,
+			Coroutine * coroutine);
 	public:
 		/** Returns a singleton instance. */
 		static inline SchedulerPattern<ConditionVariable> &instance();
@@ -31,14 +62,74 @@ namespace cr
 		inline void initialise(
 			std::size_t unused = 0);
 
-		/** Progresses all currently waiting coroutines.
+		/** Progresses all currently waiting coroutines, and wakes up all sleeping coroutines that are due.
 		@return
-			Whether any coroutines were waiting. */
+			Whether any coroutines were waiting or sleeping. */
 		bool schedule(
 			std::size_t = 0);
 
 		/** Enqueues a coroutine to wait for scheduling. */
 		constexpr typename ConditionVariable::WaitCall enqueue();
+
+		/** Creates a resumer that enqueues notified coroutines into the scheduler instead of resuming them directly.
+			Pass it to a notifying call, so that the notifying coroutine continues right away, and the notified coroutines run on their next scheduling round. */
+		[[nodiscard]] inline Resumer deferred();
+
+		/** Helper class for putting a coroutine to sleep using `#CR_AWAIT`. */
+		class SleepCall
+		{
+			/** The scheduler whose timing wheel to use. */
+			SchedulerPattern<ConditionVariable> &m_scheduler;
+			/** The tick at which to wake up. */
+			std::uint64_t m_deadline;
+		public:
+			/** Initialises the sleep call.
+			@param[in] scheduler:
+				The scheduler whose timing wheel to use.
+			@param[in] deadline:
+				The tick at which to wake up. */
+			constexpr SleepCall(
+				SchedulerPattern<ConditionVariable> &scheduler,
+				std::uint64_t deadline);
+
+			/** Puts a coroutine to sleep, unless the deadline has already passed.
+			@param[in] coroutine:
+				The coroutine to put to sleep. */
+			[[nodiscard]] sync::mayblock libcr_wait(
+				Coroutine * coroutine);
+		};
+
+		/** Puts a coroutine to sleep until a point in time.
+		@param[in] time:
+			The time to wake up at. */
+		[[nodiscard]] inline SleepCall sleep_until(
+			TimerWheel::clock::time_point time);
+
+		template<class Rep, class Period>
+		/** Puts a coroutine to sleep for a duration.
+		@param[in] duration:
+			The minimal time to sleep for. */
+		[[nodiscard]] inline SleepCall sleep_for(
+			std::chrono::duration<Rep, Period> duration);
+
+		template<class Rep, class Period>
+		/** Creates a deadline for a timed wait that expires after a duration.
+		@param[in] timeout:
+			The timeout to use. It has to outlive the timed wait.
+		@param[in] duration:
+			The minimal time to wait for. */
+		[[nodiscard]] inline Deadline deadline_for(
+			PODTimeout &timeout,
+			std::chrono::duration<Rep, Period> duration);
+
+		/** Creates a deadline for a timed wait that expires at a point in time.
+		@param[in] timeout:
+			The timeout to use. It has to outlive the timed wait.
+		@param[in] time:
+			The time at which the wait expires. */
+		[[nodiscard]] inline Deadline deadline_until(
+			PODTimeout &timeout,
+			TimerWheel::clock::time_point time);
 	};
 }
 
@@ -15,11 +15,52 @@ namespace cr
 	{
 	}
 
+	template<class ConditionVariable>
+	PODTimerWheel &SchedulerPattern<ConditionVariable>::select_timers(
+		void * scheduler,
+		Coroutine *,
+		mt::detail::PODSoftMutex * &mutex)
+	{
+		SchedulerPattern<ConditionVariable> &self = *static_cast<SchedulerPattern<ConditionVariable> *>(scheduler);
+		if constexpr(util::is_mt_cv_v<ConditionVariable>)
+			mutex = &self.m_timer_mutex;
+		else
+			mutex = nullptr;
+		return self.m_timers;
+	}
+
 	template<class ConditionVariable>
 	bool SchedulerPattern<ConditionVariable>::schedule(
 		std::size_t)
 	{
-		return m_cv.notify_all();
+		bool result = m_cv.notify_all();
+
+		Coroutine * due = nullptr;
+		if constexpr(util::is_mt_cv_v<ConditionVariable>)
+		{
+			// Only one thread needs to advance the timing wheel at a time.
+			mt::detail::LockGuard lock;
+			if(!lock.try_lock(m_timer_mutex))
+				return true;
+			if(!m_timers.empty())
+				due = m_timers.advance(TimerWheel::now());
+			result |= !m_timers.empty();
+		} else
+		{
+			if(!m_timers.empty())
+				due = m_timers.advance(TimerWheel::now());
+			result |= !m_timers.empty();
+		}
+
+		while(due)
+		{
+			Coroutine * next = due->libcr_next_waiting.plain;
+			(*due)();
+			due = next;
+			result = true;
+		}
+
+		return result;
 	}
 
 	template<class ConditionVariable>
@@ -27,4 +68,77 @@ namespace cr
 	{
 		return m_cv.wait();
 	}
+
+	template<class ConditionVariable>
+	void SchedulerPattern<ConditionVariable>::defer(
+		void * scheduler,
+		Coroutine * coroutine)
+	{
+		SchedulerPattern<ConditionVariable> &self = *static_cast<SchedulerPattern<ConditionVariable> *>(scheduler);
+		(void) self.enqueue().libcr_wait(coroutine);
+	}
+
+	template<class ConditionVariable>
+	Resumer SchedulerPattern<ConditionVariable>::deferred()
+	{
+		return Resumer(this, &defer);
+	}
+
+	template<class ConditionVariable>
+	constexpr SchedulerPattern<ConditionVariable>::SleepCall::SleepCall(
+		SchedulerPattern<ConditionVariable> &scheduler,
+		std::uint64_t deadline):
+		m_scheduler(scheduler),
+		m_deadline(deadline)
+	{
+	}
+
+	template<class ConditionVariable>
+	sync::mayblock SchedulerPattern<ConditionVariable>::SleepCall::libcr_wait(
+		Coroutine * coroutine)
+	{
+		if(m_deadline <= TimerWheel::now())
+			return sync::nonblock();
+
+		if constexpr(util::is_mt_cv_v<ConditionVariable>)
+		{
+			mt::detail::LockGuard lock(m_scheduler.m_timer_mutex);
+			m_scheduler.m_timers.insert(coroutine, m_deadline);
+		} else
+			m_scheduler.m_timers.insert(coroutine, m_deadline);
+
+		return sync::block();
+	}
+
+	template<class ConditionVariable>
+	typename SchedulerPattern<ConditionVariable>::SleepCall SchedulerPattern<ConditionVariable>::sleep_until(
+		TimerWheel::clock::time_point time)
+	{
+		return SleepCall(*this, TimerWheel::tick(time));
+	}
+
+	template<class ConditionVariable>
+	template<class Rep, class Period>
+	typename SchedulerPattern<ConditionVariable>::SleepCall SchedulerPattern<ConditionVariable>::sleep_for(
+		std::chrono::duration<Rep, Period> duration)
+	{
+		return sleep_until(TimerWheel::clock::now() + std::chrono::ceil<TimerWheel::clock::duration>(duration));
+	}
+
+	template<class ConditionVariable>
+	Deadline SchedulerPattern<ConditionVariable>::deadline_until(
+		PODTimeout &timeout,
+		TimerWheel::clock::time_point time)
+	{
+		return Deadline(timeout, TimerWheel::tick(time), this, &select_timers);
+	}
+
+	template<class ConditionVariable>
+	template<class Rep, class Period>
+	Deadline SchedulerPattern<ConditionVariable>::deadline_for(
+		PODTimeout &timeout,
+		std::chrono::duration<Rep, Period> duration)
+	{
+		return deadline_until(timeout, TimerWheel::clock::now() + std::chrono::ceil<TimerWheel::clock::duration>(duration));
+	}
 }
\ No newline at end of file
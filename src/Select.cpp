@@ -0,0 +1,155 @@
+#include "Select.hpp"
+
+#include <cassert>
+
+namespace cr
+{
+	void PODSelectCase::initialise()
+	{
+		Coroutine::prepare(
+			static_cast<impl_t>(&PODSelectCase::libcr_notified),
+			(Context *) nullptr);
+		m_select = nullptr;
+		m_target = Selectable();
+		m_kept = false;
+	}
+
+	void PODSelectCase::bind(
+		Selectable const& target)
+	{
+		release();
+		m_target = target;
+	}
+
+	void PODSelectCase::release()
+	{
+		if(!m_kept)
+			return;
+
+		m_kept = false;
+		if(m_target.m_release)
+			m_target.m_release(m_target.m_object);
+	}
+
+	void PODSelectCase::libcr_notified()
+	{
+		PODSelect &select = *m_select;
+		bool const error = libcr_error;
+		libcr_error = false;
+
+		if(m_target.m_settle)
+			m_target.m_settle(m_target.m_object);
+
+		std::size_t const index = static_cast<std::size_t>(this - select.m_cases);
+		std::size_t expected = PODSelect::kNone;
+		std::size_t finished = 1;
+		if(select.m_fired.compare_exchange_strong(
+			expected,
+			index,
+			std::memory_order_acq_rel,
+			std::memory_order_acquire))
+		{
+			select.m_error = error;
+			// Nodes that cannot be removed anymore were notified, and finish on their own.
+			for(std::size_t i = 0; i < select.m_count; i++)
+			{
+				PODSelectCase &node = select.m_cases[i];
+				if(i != index && node.m_target.m_remove(node.m_target.m_object, &node))
+					++finished;
+			}
+		} else if(!error)
+		{
+			// Another node won. Passing the notification on would wake a coroutine that was not notified, so keep it for the next wait.
+			m_kept = true;
+		}
+
+		// The nodes and the select must not be touched once the wait finished.
+		if(select.finish(finished))
+		{
+			Coroutine * waiter = select.m_waiter;
+			waiter->libcr_error = select.m_error;
+			waiter->resume();
+		}
+	}
+
+	void PODSelect::initialise()
+	{
+		m_waiter = nullptr;
+		m_cases = nullptr;
+		m_count = 0;
+		std::atomic_init(&m_fired, kNone);
+		std::atomic_init(&m_pending, (std::size_t) 0);
+		m_error = false;
+	}
+
+	sync::mayblock PODSelect::WaitCall::libcr_wait(
+		Coroutine * coroutine)
+	{
+		assert(coroutine != nullptr);
+		assert(m_count != 0 && "A select needs at least one node.");
+		assert(!m_select.m_pending.load(std::memory_order_relaxed) && "The select is already in use.");
+
+		// A notification kept from an earlier wait finishes the wait right away.
+		for(std::size_t i = 0; i < m_count; i++)
+			if(m_cases[i].m_kept)
+			{
+				m_cases[i].m_kept = false;
+				m_select.m_error = false;
+				m_select.m_fired.store(i, std::memory_order_relaxed);
+				return sync::nonblock();
+			}
+
+		m_select.m_waiter = coroutine;
+		m_select.m_cases = m_cases;
+		m_select.m_count = m_count;
+		m_select.m_error = false;
+
+		for(std::size_t i = 0; i < m_count; i++)
+		{
+			PODSelectCase &node = m_cases[i];
+			assert(node.m_target.m_add && "The node is not bound to a primitive.");
+			node.m_select = &m_select;
+			node.libcr_thread = coroutine->libcr_thread;
+			node.libcr_error = false;
+			// Nodes that are not added yet must not look like they are waiting.
+			node.libcr_next_waiting.plain = nullptr;
+			node.libcr_prev_waiting = nullptr;
+		}
+
+		cr::detail::Thread const thread = coroutine->libcr_thread;
+		if(m_invalidate_thread)
+			coroutine->libcr_thread = cr::detail::Thread::kInvalid;
+
+		// Registering counts as a node, so that the waiting coroutine is not resumed while nodes are still being added.
+		m_select.m_pending.store(m_count + 1, std::memory_order_relaxed);
+		m_select.m_fired.store(kNone, std::memory_order_release);
+
+		std::size_t added = 0;
+		while(added < m_count)
+		{
+			PODSelectCase &node = m_cases[added++];
+			node.m_target.m_add(node.m_target.m_object, &node);
+
+			// The primitives order this against the winner's removals, so either the winner removes this node, or this sees the winner.
+			if(m_select.m_fired.load(std::memory_order_acquire) != kNone)
+			{
+				if(node.m_target.m_remove(node.m_target.m_object, &node))
+				{
+					bool const last = m_select.finish(1);
+					assert(!last);
+					(void) last;
+				}
+				break;
+			}
+		}
+
+		// Nodes that were never added are finished, too.
+		if(m_select.finish(m_count - added + 1))
+		{
+			coroutine->libcr_thread = thread;
+			coroutine->libcr_error = m_select.m_error;
+			return sync::nonblock();
+		}
+		return sync::block();
+	}
+}
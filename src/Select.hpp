@@ -0,0 +1,186 @@
+/** @file Select.hpp
+	Contains the select type used for waiting on several primitives at once. */
+#ifndef __libcr_select_hpp_defined
+#define __libcr_select_hpp_defined
+
+#include "Coroutine.hpp"
+#include "Selectable.hpp"
+#include "sync/Block.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+namespace cr
+{
+	// Forward declarations.
+	class PODSelect;
+
+	/** POD waiting node of a select, one per awaited primitive.
+		The nodes are provided by the caller, usually as part of the waiting coroutine's state, so that selecting never allocates. While waiting, each node takes the waiting coroutine's place in its primitive's waiting list. The first node to be notified wins, removes the other nodes from their primitives, and resumes the waiting coroutine.
+		A node that is notified after another node won keeps the notification instead of passing it on, so that it neither wakes coroutines that were not notified, nor lets them overtake older waiters. The next wait that uses the node then finishes right away with the node. If the node is not used again, `release()` passes the kept notification on. */
+	class PODSelectCase : public Coroutine
+	{
+		friend class PODSelect;
+
+		/** The select the node is part of. */
+		PODSelect * m_select;
+		/** How to wait for the primitive the node is bound to. */
+		Selectable m_target;
+		/** Whether the node kept a notification that arrived after another node won. */
+		bool m_kept;
+
+		template<class ConditionVariable>
+		/** Adds a node to a condition variable, using a removable waiting list for thread-safe condition variables. */
+		static void add_to(
+			void * cv,
+			Coroutine * node);
+		template<class ConditionVariable>
+		/** Removes a node from a condition variable using its `remove()` method. */
+		static bool remove_from(
+			void * cv,
+			Coroutine * node);
+		template<class ConditionVariable>
+		/** Passes a notification on using the condition variable's `notify_one()` method. */
+		static void forward_to(
+			void * cv);
+
+		/** Called when the primitive notifies the node.
+			If the node is the first to be notified, it removes the other nodes and resumes the waiting coroutine. Otherwise, the node keeps the notification for the next wait, unless it is a failure. */
+		void libcr_notified();
+	public:
+		/** Initialises the node. */
+		void initialise();
+
+		template<class ConditionVariable, class = std::enable_if_t<!std::is_same_v<std::remove_cv_t<ConditionVariable>, Selectable>>>
+		/** Binds the node to a condition variable.
+			Must not be called while the node is waiting. A kept notification is released first.
+		@param[in] cv:
+			A `sync` or `mt` condition variable. */
+		inline void bind(
+			ConditionVariable &cv);
+		/** Binds the node to a primitive.
+			Must not be called while the node is waiting. A kept notification is released first.
+		@param[in] target:
+			How to wait for the primitive, as returned by one of its `select_*()` methods. */
+		void bind(
+			Selectable const& target);
+
+		/** Whether the node kept a notification for the next wait. */
+		inline bool kept() const;
+		/** Passes a kept notification on to the primitive, if there is one.
+			Has to be called when the node is not used for waiting anymore, so that the notification is not lost. */
+		void release();
+	};
+
+	/** Waiting node of a select. */
+	class SelectCase : public PODSelectCase
+	{
+		using PODSelectCase::initialise;
+	public:
+		/** Initialises the node. */
+		inline SelectCase();
+	};
+
+	/** POD select for waiting until the first of several primitives is notified.
+		Each primitive gets its own node, which is bound to it beforehand. After the wait, `fired()` tells which primitive notified the waiting coroutine, and all nodes are unregistered again and can be reused right away. If the winning notification set the error flag, the waiting coroutine's error flag is set as well.
+		Besides condition variables, the events, futures, semaphores and fixed queues of `sync` and `mt` can be selected, through their `select_*()` methods. A selected wait has the same effect as the wait it is named after: a consumed event stays consumed, and a semaphore unit stays taken. Queues only report that they became poppable or pushable, and the following `Pop` or `Push` still has to be awaited. Other primitives, such as the SPSC, unbounded and priority queues, channels and broadcast rings, cannot be selected. */
+	class PODSelect
+	{
+		friend class PODSelectCase;
+	public:
+		/** Returned by `fired()` while no primitive fired. */
+		static constexpr std::size_t kNone = ~std::size_t(0);
+	private:
+		/** The waiting coroutine. */
+		Coroutine * m_waiter;
+		/** The nodes of the current wait. */
+		PODSelectCase * m_cases;
+		/** The number of nodes of the current wait. */
+		std::size_t m_count;
+		/** The index of the node that fired, or `kNone`. */
+		std::atomic_size_t m_fired;
+		/** The number of nodes that may still run, plus one while the nodes are being registered.
+			Whoever brings it to zero resumes the waiting coroutine, so that no node is accessed after the wait. */
+		std::atomic_size_t m_pending;
+		/** Whether the winning notification set the error flag. */
+		bool m_error;
+
+		/** Marks parts of the wait as finished.
+		@param[in] count:
+			The number of finished nodes.
+		@return
+			Whether the wait is completely finished. */
+		inline bool finish(
+			std::size_t count);
+	public:
+		/** Initialises the select. */
+		void initialise();
+
+		/** The index of the node whose primitive notified the last wait. */
+		inline std::size_t fired() const;
+
+		/** Helper class for waiting on several primitives using `#CR_AWAIT`. */
+		class WaitCall
+		{
+			/** The select to wait with. */
+			PODSelect &m_select;
+			/** The nodes to wait with. */
+			PODSelectCase * m_cases;
+			/** The number of nodes. */
+			std::size_t m_count;
+			/** Whether to invalidate the waiting coroutine's thread. */
+			bool m_invalidate_thread;
+		public:
+			/** Initialises the wait call.
+			@param[in] select:
+				The select to wait with.
+			@param[in] cases:
+				The bound nodes to wait with.
+			@param[in] count:
+				The number of nodes.
+			@param[in] invalidate_thread:
+				Whether to invalidate the waiting coroutine's thread. */
+			constexpr WaitCall(
+				PODSelect &select,
+				PODSelectCase * cases,
+				std::size_t count,
+				bool invalidate_thread);
+
+			/** Adds the nodes to their primitives.
+				Finishes right away if a node kept a notification from an earlier wait.
+			@param[in] coroutine:
+				The waiting coroutine.
+			@return
+				Whether the coroutine waits. */
+			[[nodiscard]] sync::mayblock libcr_wait(
+				Coroutine * coroutine);
+		};
+
+		/** Waits until one of the nodes' primitives is notified.
+			To be used with `#CR_AWAIT`. A notification that arrives at a node after another node already won is kept by the node for the next wait, unless it is a failure.
+		@param[in] cases:
+			The bound nodes to wait with.
+		@param[in] count:
+			The number of nodes.
+		@param[in] invalidate_thread:
+			Whether to invalidate the waiting coroutine's thread. Should be set if any primitive is thread-safe. */
+		[[nodiscard]] constexpr WaitCall wait(
+			PODSelectCase * cases,
+			std::size_t count,
+			bool invalidate_thread = true);
+	};
+
+	/** Select for waiting until the first of several primitives is notified. */
+	class Select : public PODSelect
+	{
+		using PODSelect::initialise;
+	public:
+		/** Initialises the select. */
+		inline Select();
+	};
+}
+
+#include "Select.inl"
+
+#endif
@@ -0,0 +1,88 @@
+#include "util/CVTraits.hpp"
+
+namespace cr
+{
+	template<class ConditionVariable>
+	void PODSelectCase::add_to(
+		void * cv,
+		Coroutine * node)
+	{
+		if constexpr(util::is_mt_cv_v<ConditionVariable>)
+			static_cast<ConditionVariable *>(cv)->push_removable(node);
+		else
+			(void) static_cast<ConditionVariable *>(cv)->wait().libcr_wait(node);
+	}
+
+	template<class ConditionVariable>
+	bool PODSelectCase::remove_from(
+		void * cv,
+		Coroutine * node)
+	{
+		return static_cast<ConditionVariable *>(cv)->remove(node);
+	}
+
+	template<class ConditionVariable>
+	void PODSelectCase::forward_to(
+		void * cv)
+	{
+		(void) static_cast<ConditionVariable *>(cv)->notify_one();
+	}
+
+	template<class ConditionVariable, class>
+	void PODSelectCase::bind(
+		ConditionVariable &cv)
+	{
+		bind(Selectable(
+			&cv,
+			&add_to<ConditionVariable>,
+			&remove_from<ConditionVariable>,
+			nullptr,
+			&forward_to<ConditionVariable>));
+	}
+
+	bool PODSelectCase::kept() const
+	{
+		return m_kept;
+	}
+
+	SelectCase::SelectCase()
+	{
+		initialise();
+	}
+
+	bool PODSelect::finish(
+		std::size_t count)
+	{
+		return m_pending.fetch_sub(count, std::memory_order_acq_rel) == count;
+	}
+
+	std::size_t PODSelect::fired() const
+	{
+		return m_fired.load(std::memory_order_relaxed);
+	}
+
+	constexpr PODSelect::WaitCall::WaitCall(
+		PODSelect &select,
+		PODSelectCase * cases,
+		std::size_t count,
+		bool invalidate_thread):
+		m_select(select),
+		m_cases(cases),
+		m_count(count),
+		m_invalidate_thread(invalidate_thread)
+	{
+	}
+
+	constexpr PODSelect::WaitCall PODSelect::wait(
+		PODSelectCase * cases,
+		std::size_t count,
+		bool invalidate_thread)
+	{
+		return WaitCall(*this, cases, count, invalidate_thread);
+	}
+
+	Select::Select()
+	{
+		initialise();
+	}
+}
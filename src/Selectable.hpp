@@ -0,0 +1,83 @@
+/** @file Selectable.hpp
+	Contains the type that describes how a select waits for a primitive. */
+#ifndef __libcr_selectable_hpp_defined
+#define __libcr_selectable_hpp_defined
+
+#include "Coroutine.hpp"
+
+namespace cr
+{
+	// Forward declarations.
+	class PODSelect;
+	class PODSelectCase;
+
+	/** Describes how a select waits for a primitive.
+		Primitives that can be selected return it from their `select_*()` methods, which are named after the wait they replace. A select case waits for the primitive through a proxy node, which takes the selecting coroutine's place in the primitive's waiting list. */
+	class Selectable
+	{
+		friend class PODSelect;
+		friend class PODSelectCase;
+	public:
+		/** Adds a node to a primitive's waiting list.
+			If the awaited condition already holds, the node is notified instead.
+		@param[in] object:
+			The primitive.
+		@param[in] node:
+			The node to add. */
+		typedef void (*add_t)(
+			void * object,
+			Coroutine * node);
+		/** Removes a node from a primitive's waiting list.
+			Must also accept nodes that were never added.
+		@param[in] object:
+			The primitive.
+		@param[in] node:
+			The node to remove.
+		@return
+			Whether the node was still waiting. */
+		typedef bool (*remove_t)(
+			void * object,
+			Coroutine * node);
+		/** Called for a primitive whenever one of its nodes is notified, or passes on a notification that a node kept but does not use.
+		@param[in] object:
+			The primitive. */
+		typedef void (*notify_t)(
+			void * object);
+
+	private:
+		/** The primitive. */
+		void * m_object;
+		/** Adds a node to the primitive. */
+		add_t m_add;
+		/** Removes a node from the primitive. */
+		remove_t m_remove;
+		/** Called for every notified node, or null. */
+		notify_t m_settle;
+		/** Passes a kept notification on, or null if notifications need not be passed on. */
+		notify_t m_release;
+	public:
+		/** Describes nothing. */
+		constexpr Selectable();
+		/** Describes how to wait for a primitive.
+		@param[in] object:
+			The primitive.
+		@param[in] add:
+			Adds a node to the primitive.
+		@param[in] remove:
+			Removes a node from the primitive.
+		@param[in] settle:
+			Called for every notified node, or null.
+		@param[in] release:
+			Passes a kept notification on, or null. */
+		constexpr Selectable(
+			void * object,
+			add_t add,
+			remove_t remove,
+			notify_t settle,
+			notify_t release);
+	};
+}
+
+#include "Selectable.inl"
+
+#endif
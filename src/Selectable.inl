@@ -0,0 +1,25 @@
+namespace cr
+{
+	constexpr Selectable::Selectable():
+		m_object(nullptr),
+		m_add(nullptr),
+		m_remove(nullptr),
+		m_settle(nullptr),
+		m_release(nullptr)
+	{
+	}
+
+	constexpr Selectable::Selectable(
+		void * object,
+		add_t add,
+		remove_t remove,
+		notify_t settle,
+		notify_t release):
+		m_object(object),
+		m_add(add),
+		m_remove(remove),
+		m_settle(settle),
+		m_release(release)
+	{
+	}
+}
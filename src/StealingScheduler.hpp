@@ -0,0 +1,209 @@
+/** @file StealingScheduler.hpp
+	Contains a multi-threaded work-stealing scheduler that keeps thread affinity. */
+#ifndef __libcr_stealingscheduler_hpp_defined
+#define __libcr_stealingscheduler_hpp_defined
+
+#include "detail/Thread.hpp"
+#include "mt/detail/WorkDeque.hpp"
+#include "mt/detail/SoftMutex.hpp"
+#include "util/Atomic.hpp"
+#include "sync/Block.hpp"
+#include "util/Rng.hpp"
+#include "TimerWheel.hpp"
+#include "Timeout.hpp"
+#include "Resumer.hpp"
+
+#include <vector>
+
+namespace cr
+{
+	template<class MtCV, std::size_t kDequeSize = 256>
+	/** Multi-threaded scheduler type that balances load by work stealing and keeps thread affinity.
+		Every thread owns a bounded deque of ready coroutines. A thread that runs out of work steals half of another thread's deque in a single operation, and the stolen coroutines stay with the stealing thread from then on.
+	@tparam MtCV:
+		The multi-threading enabled condition variable type to use when a thread's deque is full.
+	@tparam kDequeSize:
+		The capacity of each thread's deque. */
+	class StealingScheduler
+	{
+		/** The static scheduler instance. */
+		static StealingScheduler<MtCV, kDequeSize> s_instance;
+
+		/** Thread context type. */
+		struct ThreadContext
+		{
+			/** Initialises the thread context. */
+			ThreadContext();
+			/** The coroutines owned by the thread. */
+			mt::detail::WorkDeque<kDequeSize> deque;
+			/** The coroutines handed over by other threads, or that did not fit into the deque.
+				They are moved into the deque at the start of each scheduling round, so that other threads can steal them. */
+			MtCV overflow_cv;
+			/** The thread's sleeping coroutines and timeouts. */
+			TimerWheel timers;
+			/** Protects the timing wheel, as other threads insert sleeping coroutines and cancel timeouts. */
+			mt::detail::SoftMutex timer_mutex;
+			/** The thread's victim selection RNG. */
+			util::Rng rng;
+		};
+
+		/** The context of the thread the calling thread is currently scheduling, if any.
+			Only that thread may push into the context's deque. */
+		static thread_local ThreadContext * s_current;
+
+		/** The scheduler's thread contexts. */
+		std::vector<ThreadContext> m_threads;
+		/** The thread to assign the next new coroutine to. */
+		util::Atomic<std::size_t> m_next_thread;
+
+		/** Tries to steal work from other threads.
+		@param[in] thread:
+			The stealing thread's index.
+		@return
+			The number of stolen coroutines. */
+		inline std::size_t steal(
+			std::size_t thread);
+
+		/** Assigns a coroutine without a thread to the next thread in turn.
+		@param[in] coroutine:
+			The coroutine to assign. */
+		inline void assign_thread(
+			Coroutine * coroutine);
+
+		/** Selects the timing wheel that watches a timed waiting coroutine.
+		@param[in] scheduler:
+			The scheduler.
+		@param[in] waiter:
+			The waiting coroutine.
+		@param[out] mutex:
+			The mutex protecting the timing wheel, or null if it is not shared.
+		@return
+			The timing wheel. */
+		static PODTimerWheel &select_timers(
+			void * scheduler,
+			Coroutine * waiter,
+			mt::detail::PODSoftMutex * &mutex);
+
+		/** Hands a notified coroutine over to the scheduler, see `deferred()`.
+		@param[in] scheduler:
+			The scheduler.
+		@param[in] coroutine:
+			The notified coroutine. */
+		static void defer(
+			void * scheduler,
+			Coroutine * coroutine);
+
+	public:
+		/** Initialises the scheduler. */
+		StealingScheduler();
+
+		/** Initialises the scheduler to support a specified number of threads.
+		@param[in] threads:
+			The number of threads to support.
+			Must match the number of actual scheduling threads. */
+		void initialise(
+			std::size_t threads);
+
+		/** The number of threads run by the scheduler. */
+		inline std::size_t threads() const;
+
+		/** Executes all coroutines currently waiting for a specified thread, and wakes up the thread's sleeping coroutines that are due.
+			If the thread has no work, it first tries to steal from other threads.
+		@param[in] thread:
+			The thread index.
+		@return
+			Whether any coroutines were executed or are still sleeping. */
+		inline bool schedule(
+			std::size_t thread = 0);
+
+		/** Helper class for enqueuing a coroutine into the scheduler using `#CR_AWAIT`.  */
+		class EnqueueCall
+		{
+			/** The scheduler to enqueue into.*/
+			StealingScheduler<MtCV, kDequeSize> &m_scheduler;
+		public:
+			/** Initialises the enqueue call.
+			@param[in] scheduler:
+				The scheduler to enqueue into. */
+			constexpr EnqueueCall(
+				StealingScheduler<MtCV, kDequeSize> * scheduler);
+
+			/** Enqueues a coroutine in the scheduler.
+				Coroutines without a thread are distributed among the threads. Coroutines enqueued from outside their thread's scheduling loop go through the thread's overflow queue, as only the owning thread may push into a deque.
+			@param[in] coroutine:
+				The coroutine to enqueue. */
+			[[nodiscard]] sync::block libcr_wait(
+				Coroutine * coroutine);
+		};
+
+		/** Enqueues a coroutine in the scheduler. */
+		[[nodiscard]] constexpr EnqueueCall enqueue();
+
+		/** Creates a resumer that enqueues notified coroutines into the scheduler instead of resuming them directly.
+			Pass it to a notifying call, so that the notifying coroutine continues right away, and the notified coroutines run on their next scheduling round. Works from any thread: coroutines are always handed over through the target thread's overflow queue. */
+		[[nodiscard]] inline Resumer deferred();
+
+		/** Helper class for putting a coroutine to sleep using `#CR_AWAIT`. */
+		class SleepCall
+		{
+			/** The scheduler whose timing wheels to use. */
+			StealingScheduler<MtCV, kDequeSize> &m_scheduler;
+			/** The tick at which to wake up. */
+			std::uint64_t m_deadline;
+		public:
+			/** Initialises the sleep call.
+			@param[in] scheduler:
+				The scheduler whose timing wheels to use.
+			@param[in] deadline:
+				The tick at which to wake up. */
+			constexpr SleepCall(
+				StealingScheduler<MtCV, kDequeSize> &scheduler,
+				std::uint64_t deadline);
+
+			/** Puts a coroutine to sleep in its thread's timing wheel, unless the deadline has already passed.
+			@param[in] coroutine:
+				The coroutine to put to sleep. */
+			[[nodiscard]] sync::mayblock libcr_wait(
+				Coroutine * coroutine);
+		};
+
+		/** Puts a coroutine to sleep until a point in time.
+		@param[in] time:
+			The time to wake up at. */
+		[[nodiscard]] inline SleepCall sleep_until(
+			TimerWheel::clock::time_point time);
+
+		template<class Rep, class Period>
+		/** Puts a coroutine to sleep for a duration.
+		@param[in] duration:
+			The minimal time to sleep for. */
+		[[nodiscard]] inline SleepCall sleep_for(
+			std::chrono::duration<Rep, Period> duration);
+
+		template<class Rep, class Period>
+		/** Creates a deadline for a timed wait that expires after a duration.
+		@param[in] timeout:
+			The timeout to use. It has to outlive the timed wait.
+		@param[in] duration:
+			The minimal time to wait for. */
+		[[nodiscard]] inline Deadline deadline_for(
+			PODTimeout &timeout,
+			std::chrono::duration<Rep, Period> duration);
+
+		/** Creates a deadline for a timed wait that expires at a point in time.
+		@param[in] timeout:
+			The timeout to use. It has to outlive the timed wait.
+		@param[in] time:
+			The time at which the wait expires. */
+		[[nodiscard]] inline Deadline deadline_until(
+			PODTimeout &timeout,
+			TimerWheel::clock::time_point time);
+
+		/** Retrieves the static scheduler instance. */
+		static inline StealingScheduler<MtCV, kDequeSize> &instance();
+	};
+}
+
+#include "StealingScheduler.inl"
+
+#endif
@@ -0,0 +1,267 @@
+#include <thread>
+#include <cstdlib>
+
+namespace cr
+{
+	template<class MtCV, std::size_t kDequeSize>
+	StealingScheduler<MtCV, kDequeSize> StealingScheduler<MtCV, kDequeSize>::s_instance;
+
+	template<class MtCV, std::size_t kDequeSize>
+	thread_local typename StealingScheduler<MtCV, kDequeSize>::ThreadContext * StealingScheduler<MtCV, kDequeSize>::s_current = nullptr;
+
+	template<class MtCV, std::size_t kDequeSize>
+	StealingScheduler<MtCV, kDequeSize>::ThreadContext::ThreadContext():
+		deque(),
+		overflow_cv(),
+		timers(),
+		timer_mutex(),
+		rng(rand())
+	{
+	}
+
+	template<class MtCV, std::size_t kDequeSize>
+	StealingScheduler<MtCV, kDequeSize>::StealingScheduler():
+		m_threads(std::thread::hardware_concurrency()),
+		m_next_thread(0)
+	{
+	}
+
+	template<class MtCV, std::size_t kDequeSize>
+	void StealingScheduler<MtCV, kDequeSize>::initialise(
+		std::size_t threads)
+	{
+		if(threads < 2)
+			threads = 1;
+		m_next_thread.store(0, std::memory_order_relaxed);
+		m_threads.~vector();
+		new (&m_threads) std::vector<ThreadContext>{threads};
+	}
+
+	template<class MtCV, std::size_t kDequeSize>
+	std::size_t StealingScheduler<MtCV, kDequeSize>::threads() const
+	{
+		return m_threads.size();
+	}
+
+	template<class MtCV, std::size_t kDequeSize>
+	std::size_t StealingScheduler<MtCV, kDequeSize>::steal(
+		std::size_t thread)
+	{
+		std::size_t const threads = m_threads.size();
+		ThreadContext &ctx = m_threads[thread];
+
+		// Start at a random victim, so that idle threads do not all hit the same one.
+		std::size_t victim = (ctx.rng.byte() | (std::size_t(ctx.rng.byte()) << 8)) % threads;
+		for(std::size_t i = 0; i < threads; i++, victim = (victim + 1) % threads)
+		{
+			if(victim == thread)
+				continue;
+
+			if(std::size_t stolen = ctx.deque.steal_half(m_threads[victim].deque, thread))
+				return stolen;
+		}
+
+		return 0;
+	}
+
+	template<class MtCV, std::size_t kDequeSize>
+	void StealingScheduler<MtCV, kDequeSize>::assign_thread(
+		Coroutine * coroutine)
+	{
+		std::size_t thread = m_next_thread.fetch_add(1, std::memory_order_relaxed) % m_threads.size();
+		coroutine->libcr_thread = (detail::Thread) thread;
+	}
+
+	template<class MtCV, std::size_t kDequeSize>
+	PODTimerWheel &StealingScheduler<MtCV, kDequeSize>::select_timers(
+		void * scheduler,
+		Coroutine * waiter,
+		mt::detail::PODSoftMutex * &mutex)
+	{
+		StealingScheduler<MtCV, kDequeSize> &self = *static_cast<StealingScheduler<MtCV, kDequeSize> *>(scheduler);
+		// The waiting coroutine is resumed by the thread owning the timing wheel on expiry.
+		if(!detail::valid(waiter->libcr_thread))
+			self.assign_thread(waiter);
+
+		ThreadContext &ctx = self.m_threads[(std::size_t)waiter->libcr_thread];
+		mutex = &ctx.timer_mutex;
+		return ctx.timers;
+	}
+
+	template<class MtCV, std::size_t kDequeSize>
+	bool StealingScheduler<MtCV, kDequeSize>::schedule(
+		std::size_t thread)
+	{
+		ThreadContext &ctx = m_threads[thread];
+		s_current = &ctx;
+		Coroutine * first, * last;
+		bool result = ctx.overflow_cv.remove_all(first, last);
+
+		// Move handed over coroutines into the deque, where idle threads can steal them.
+		Coroutine * next = nullptr;
+		for(; first; first = next)
+		{
+			next = MtCV::acquire_and_complete(first, last);
+			if(!ctx.deque.push(first))
+				break;
+		}
+
+		Coroutine * due = nullptr;
+		bool sleeping = true;
+		{
+			// Other threads only hold the lock briefly, so skip the timing wheel this round if it is busy.
+			mt::detail::LockGuard lock;
+			if(lock.try_lock(ctx.timer_mutex))
+			{
+				if(!ctx.timers.empty())
+					due = ctx.timers.advance(TimerWheel::now());
+				sleeping = !ctx.timers.empty();
+			}
+		}
+
+		// Only run what is ready now, coroutines enqueued meanwhile wait for the next round.
+		std::size_t count = ctx.deque.size();
+		if(!count && !result && !due && m_threads.size() != 1)
+			count = steal(thread);
+
+		if(count || due)
+			result = true;
+
+		while(due)
+		{
+			Coroutine * const after = due->libcr_next_waiting.plain;
+			(*due)();
+			due = after;
+		}
+
+		while(count--)
+		{
+			Coroutine * coroutine = ctx.deque.pop();
+			if(!coroutine)
+				break;
+			(*coroutine)();
+		}
+
+		// The coroutines that did not fit into the deque run directly.
+		while(first)
+		{
+			(*first)();
+			if((first = next))
+				next = MtCV::acquire_and_complete(first, last);
+		}
+
+		s_current = nullptr;
+		return result || sleeping;
+	}
+
+	template<class MtCV, std::size_t kDequeSize>
+	constexpr StealingScheduler<MtCV, kDequeSize>::EnqueueCall::EnqueueCall(
+		StealingScheduler<MtCV, kDequeSize> * scheduler):
+		m_scheduler(*scheduler)
+	{
+	}
+
+	template<class MtCV, std::size_t kDequeSize>
+	sync::block StealingScheduler<MtCV, kDequeSize>::EnqueueCall::libcr_wait(
+		Coroutine * coroutine)
+	{
+		if(!detail::valid(coroutine->libcr_thread))
+			m_scheduler.assign_thread(coroutine);
+
+		ThreadContext &ctx = m_scheduler.m_threads[(std::size_t)coroutine->libcr_thread];
+		// Coroutines assigned to another thread, or enqueued outside of a scheduling round, cannot be pushed by their owner.
+		if(s_current == &ctx && ctx.deque.push(coroutine))
+			return sync::block();
+
+		return ctx.overflow_cv.wait(false).libcr_wait(coroutine);
+	}
+
+	template<class MtCV, std::size_t kDequeSize>
+	constexpr typename StealingScheduler<MtCV, kDequeSize>::EnqueueCall StealingScheduler<MtCV, kDequeSize>::enqueue()
+	{
+		return this;
+	}
+
+	template<class MtCV, std::size_t kDequeSize>
+	void StealingScheduler<MtCV, kDequeSize>::defer(
+		void * scheduler,
+		Coroutine * coroutine)
+	{
+		StealingScheduler<MtCV, kDequeSize> &self = *static_cast<StealingScheduler<MtCV, kDequeSize> *>(scheduler);
+		if(!detail::valid(coroutine->libcr_thread))
+			self.assign_thread(coroutine);
+
+		// The notifier may run on any thread, so the owner-only deque cannot be used.
+		ThreadContext &ctx = self.m_threads[(std::size_t)coroutine->libcr_thread];
+		(void) ctx.overflow_cv.wait(false).libcr_wait(coroutine);
+	}
+
+	template<class MtCV, std::size_t kDequeSize>
+	Resumer StealingScheduler<MtCV, kDequeSize>::deferred()
+	{
+		return Resumer(this, &defer);
+	}
+
+	template<class MtCV, std::size_t kDequeSize>
+	constexpr StealingScheduler<MtCV, kDequeSize>::SleepCall::SleepCall(
+		StealingScheduler<MtCV, kDequeSize> &scheduler,
+		std::uint64_t deadline):
+		m_scheduler(scheduler),
+		m_deadline(deadline)
+	{
+	}
+
+	template<class MtCV, std::size_t kDequeSize>
+	sync::mayblock StealingScheduler<MtCV, kDequeSize>::SleepCall::libcr_wait(
+		Coroutine * coroutine)
+	{
+		if(m_deadline <= TimerWheel::now())
+			return sync::nonblock();
+
+		if(!detail::valid(coroutine->libcr_thread))
+			m_scheduler.assign_thread(coroutine);
+
+		ThreadContext &ctx = m_scheduler.m_threads[(std::size_t)coroutine->libcr_thread];
+		mt::detail::LockGuard lock(ctx.timer_mutex);
+		ctx.timers.insert(coroutine, m_deadline);
+		return sync::block();
+	}
+
+	template<class MtCV, std::size_t kDequeSize>
+	typename StealingScheduler<MtCV, kDequeSize>::SleepCall StealingScheduler<MtCV, kDequeSize>::sleep_until(
+		TimerWheel::clock::time_point time)
+	{
+		return SleepCall(*this, TimerWheel::tick(time));
+	}
+
+	template<class MtCV, std::size_t kDequeSize>
+	template<class Rep, class Period>
+	typename StealingScheduler<MtCV, kDequeSize>::SleepCall StealingScheduler<MtCV, kDequeSize>::sleep_for(
+		std::chrono::duration<Rep, Period> duration)
+	{
+		return sleep_until(TimerWheel::clock::now() + std::chrono::ceil<TimerWheel::clock::duration>(duration));
+	}
+
+	template<class MtCV, std::size_t kDequeSize>
+	Deadline StealingScheduler<MtCV, kDequeSize>::deadline_until(
+		PODTimeout &timeout,
+		TimerWheel::clock::time_point time)
+	{
+		return Deadline(timeout, TimerWheel::tick(time), this, &select_timers);
+	}
+
+	template<class MtCV, std::size_t kDequeSize>
+	template<class Rep, class Period>
+	Deadline StealingScheduler<MtCV, kDequeSize>::deadline_for(
+		PODTimeout &timeout,
+		std::chrono::duration<Rep, Period> duration)
+	{
+		return deadline_until(timeout, TimerWheel::clock::now() + std::chrono::ceil<TimerWheel::clock::duration>(duration));
+	}
+
+	template<class MtCV, std::size_t kDequeSize>
+	StealingScheduler<MtCV, kDequeSize> &StealingScheduler<MtCV, kDequeSize>::instance()
+	{
+		return s_instance;
+	}
+}
@@ -0,0 +1,78 @@
+#include "Timeout.hpp"
+#include "TimerWheel.hpp"
+
+#include <cassert>
+
+namespace cr
+{
+	void PODTimeout::initialise()
+	{
+		Coroutine::prepare(
+			static_cast<impl_t>(&PODTimeout::libcr_notified),
+			(Context *) nullptr);
+		m_timer_link = nullptr;
+	}
+
+	void PODTimeout::unregister()
+	{
+		mt::detail::LockGuard lock;
+		if(m_wheel_mutex)
+			lock.lock(*m_wheel_mutex);
+		// The timing wheel might have already removed the timeout, but then it failed to remove it from the waiting list.
+		if(m_timer_link)
+			m_wheel->cancel(*this);
+	}
+
+	void PODTimeout::libcr_notified()
+	{
+		unregister();
+
+		Coroutine * waiter = m_waiter;
+		waiter->libcr_error = libcr_error;
+		libcr_error = false;
+		waiter->resume();
+	}
+
+	Coroutine * PODTimeout::expire()
+	{
+		if(!m_remove(m_list, this))
+			return nullptr;
+
+		m_waiter->libcr_error = true;
+		return m_waiter;
+	}
+
+	bool Deadline::withdraw() const
+	{
+		if(!m_timeout->m_remove(m_timeout->m_list, m_timeout))
+			return false;
+
+		m_timeout->unregister();
+		return true;
+	}
+
+	Deadline::Registration::Registration(
+		Deadline const& deadline,
+		Coroutine * waiter,
+		void * list,
+		PODTimeout::remove_t remove):
+		m_lock(),
+		m_timeout(*deadline.m_timeout)
+	{
+		mt::detail::PODSoftMutex * mutex;
+		PODTimerWheel &wheel = deadline.m_select(deadline.m_scheduler, waiter, mutex);
+		if(mutex)
+			m_lock.lock(*mutex);
+
+		assert(!m_timeout.m_timer_link && "The timeout is already in use.");
+
+		m_timeout.m_waiter = waiter;
+		m_timeout.m_list = list;
+		m_timeout.m_remove = remove;
+		m_timeout.m_wheel = &wheel;
+		m_timeout.m_wheel_mutex = mutex;
+		m_timeout.libcr_error = false;
+		m_timeout.libcr_thread = waiter->libcr_thread;
+		wheel.insert(m_timeout, deadline.m_tick);
+	}
+}
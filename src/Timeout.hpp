@@ -0,0 +1,176 @@
+/** @file Timeout.hpp
+	Contains the timeout type used for timed waits. */
+#ifndef __libcr_timeout_hpp_defined
+#define __libcr_timeout_hpp_defined
+
+#include "Coroutine.hpp"
+#include "mt/detail/SoftMutex.hpp"
+
+#include <cinttypes>
+
+namespace cr
+{
+	// Forward declarations.
+	class PODTimerWheel;
+	class Deadline;
+
+	/** POD timeout for timed waits.
+		A timeout has to outlive the timed wait it is used for, so it is usually part of the waiting coroutine's state. While waiting, it takes the waiting coroutine's place in the waiting list, and it is registered in a timing wheel at the same time. Whichever of the two triggers first removes the timeout from the other, so that the waiting coroutine is resumed exactly once, and the timeout can be reused right away. On expiry, the waiting coroutine's error flag is set. */
+	class PODTimeout : public Coroutine
+	{
+		friend class PODTimerWheel;
+		friend class Deadline;
+	public:
+		/** Removes a timeout from the waiting list it was put into.
+		@param[in] list:
+			The waiting list.
+		@param[in] timeout:
+			The timeout to remove.
+		@return
+			Whether the timeout was still in the waiting list. */
+		typedef bool (*remove_t)(
+			void * list,
+			Coroutine * timeout);
+
+		template<class List>
+		/** Removes a timeout from a waiting list using the list's `remove()` method.
+		@tparam List:
+			The waiting list type.
+		@param[in] list:
+			The waiting list.
+		@param[in] timeout:
+			The timeout to remove.
+		@return
+			Whether the timeout was still in the waiting list. */
+		static bool remove_from(
+			void * list,
+			Coroutine * timeout);
+
+	private:
+		/** The coroutine waiting for the timeout. */
+		Coroutine * m_waiter;
+		/** The waiting list the timeout was put into. */
+		void * m_list;
+		/** Removes the timeout from the waiting list. */
+		remove_t m_remove;
+		/** The timing wheel the timeout is registered in. */
+		PODTimerWheel * m_wheel;
+		/** Protects the timing wheel, or null if the timing wheel is not shared. */
+		mt::detail::PODSoftMutex * m_wheel_mutex;
+		/** The tick at which the timeout expires. */
+		std::uint64_t m_deadline;
+		/** The next timeout in the timing wheel's list. */
+		PODTimeout * m_timer_next;
+		/** The reference to this timeout in the timing wheel's list, or null if not in a timing wheel. */
+		PODTimeout ** m_timer_link;
+
+		/** Unregisters the timeout from the timing wheel, if it is still registered there. */
+		void unregister();
+
+		/** Called when the waiting list notifies the timeout.
+			Unregisters the timeout from the timing wheel and resumes the waiting coroutine. */
+		void libcr_notified();
+
+		/** Called by the timing wheel when the timeout expired, while the timing wheel is locked.
+		@return
+			The waiting coroutine to resume, or null if the waiting list already notified the timeout. */
+		Coroutine * expire();
+	public:
+		/** Initialises the timeout. */
+		void initialise();
+	};
+
+	/** Timeout for timed waits. */
+	class Timeout : public PODTimeout
+	{
+		using PODTimeout::initialise;
+	public:
+		/** Initialises the timeout. */
+		inline Timeout();
+	};
+
+	/** A timeout combined with its deadline and the scheduler that watches it.
+		Schedulers create deadlines, and timed wait calls take them as argument. */
+	class Deadline
+	{
+	public:
+		/** Selects the timing wheel that watches a waiting coroutine.
+		@param[in] scheduler:
+			The scheduler.
+		@param[in] waiter:
+			The waiting coroutine.
+		@param[out] mutex:
+			The mutex protecting the timing wheel, or null if it is not shared.
+		@return
+			The timing wheel. */
+		typedef PODTimerWheel &(*select_t)(
+			void * scheduler,
+			Coroutine * waiter,
+			mt::detail::PODSoftMutex * &mutex);
+
+	private:
+		/** The timeout to use. */
+		PODTimeout * m_timeout;
+		/** The tick at which the timeout expires. */
+		std::uint64_t m_tick;
+		/** The scheduler to watch the timeout. */
+		void * m_scheduler;
+		/** Selects the scheduler's timing wheel. */
+		select_t m_select;
+	public:
+		/** Creates an unset deadline, so that deadlines can be stored in coroutine states. */
+		Deadline() = default;
+		/** Creates a deadline.
+		@param[in] timeout:
+			The timeout to use.
+		@param[in] tick:
+			The tick at which the timeout expires.
+		@param[in] scheduler:
+			The scheduler to watch the timeout.
+		@param[in] select:
+			Selects the scheduler's timing wheel. */
+		constexpr Deadline(
+			PODTimeout &timeout,
+			std::uint64_t tick,
+			void * scheduler,
+			select_t select);
+
+		/** Takes the deadline's timeout back out of its waiting list and its timing wheel, so that a timed wait can finish without blocking after all.
+			Only valid after the timeout was registered and put into its waiting list.
+		@return
+			Whether the timeout was still waiting. If not, it was notified or expired, and resumes the waiting coroutine on its own. */
+		bool withdraw() const;
+
+		/** Helper class that registers a timeout, and keeps the timing wheel locked until the timeout is in its waiting list.
+			This way, the timeout cannot be triggered before it is completely registered. */
+		class Registration
+		{
+			/** The locked mutex, if any. */
+			mt::detail::LockGuard m_lock;
+			/** The registered timeout. */
+			PODTimeout &m_timeout;
+		public:
+			/** Registers a timeout in the timing wheel.
+			@param[in] deadline:
+				The deadline to register.
+			@param[in] waiter:
+				The waiting coroutine.
+			@param[in] list:
+				The waiting list the timeout will be put into.
+			@param[in] remove:
+				Removes the timeout from the waiting list. */
+			Registration(
+				Deadline const& deadline,
+				Coroutine * waiter,
+				void * list,
+				PODTimeout::remove_t remove);
+
+			/** The timeout to put into the waiting list instead of the waiting coroutine. */
+			inline Coroutine * timeout();
+		};
+	};
+}
+
+#include "Timeout.inl"
+
+#endif
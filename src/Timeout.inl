@@ -0,0 +1,32 @@
+namespace cr
+{
+	template<class List>
+	bool PODTimeout::remove_from(
+		void * list,
+		Coroutine * timeout)
+	{
+		return static_cast<List *>(list)->remove(timeout);
+	}
+
+	Timeout::Timeout()
+	{
+		initialise();
+	}
+
+	constexpr Deadline::Deadline(
+		PODTimeout &timeout,
+		std::uint64_t tick,
+		void * scheduler,
+		select_t select):
+		m_timeout(&timeout),
+		m_tick(tick),
+		m_scheduler(scheduler),
+		m_select(select)
+	{
+	}
+
+	Coroutine * Deadline::Registration::timeout()
+	{
+		return &m_timeout;
+	}
+}
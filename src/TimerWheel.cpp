@@ -0,0 +1,292 @@
+#include "TimerWheel.hpp"
+#include "Timeout.hpp"
+
+namespace cr
+{
+	void PODTimerWheel::initialise()
+	{
+		m_now = now();
+		m_size = 0;
+		for(std::size_t level = 0; level < kLevels; level++)
+		{
+			m_occupied[level] = 0;
+			for(std::size_t slot = 0; slot < kSlots; slot++)
+			{
+				m_slots[level][slot] = nullptr;
+				m_timeouts[level][slot] = nullptr;
+			}
+		}
+		m_overflow = nullptr;
+		m_timeout_overflow = nullptr;
+		m_due = nullptr;
+		m_wake = nullptr;
+		m_wake_context = nullptr;
+	}
+
+	std::uint64_t PODTimerWheel::next_tick() const
+	{
+		if(m_due)
+			return m_now;
+		if(!m_size)
+			return ~std::uint64_t(0);
+
+		// Slots at or before the current position of a level have already been cascaded or expired.
+		for(std::size_t level = 0; level < kLevels; level++)
+		{
+			std::size_t shift = level * kSlotBits;
+			std::size_t position = (m_now >> shift) & (kSlots - 1);
+			if(position == kSlots - 1)
+				continue;
+			std::uint64_t later = m_occupied[level] & (~std::uint64_t(0) << (position + 1));
+			if(later)
+			{
+				std::uint64_t block = (m_now >> (shift + kSlotBits)) << (shift + kSlotBits);
+				return block | (std::uint64_t(__builtin_ctzll(later)) << shift);
+			}
+		}
+
+		// Only the overflow list is left, which is cascaded at the next top level rotation.
+		std::size_t const top = kLevels * kSlotBits;
+		return ((m_now >> top) + 1) << top;
+	}
+
+	void PODTimerWheel::set_waker(
+		wake_t wake,
+		void * context)
+	{
+		m_wake = wake;
+		m_wake_context = context;
+	}
+
+	void PODTimerWheel::link(
+		PODTimeout * &list,
+		PODTimeout * timeout)
+	{
+		timeout->m_timer_next = list;
+		if(list)
+			list->m_timer_link = &timeout->m_timer_next;
+		list = timeout;
+		timeout->m_timer_link = &list;
+	}
+
+	void PODTimerWheel::unlink(
+		PODTimeout * timeout)
+	{
+		*timeout->m_timer_link = timeout->m_timer_next;
+		if(timeout->m_timer_next)
+			timeout->m_timer_next->m_timer_link = timeout->m_timer_link;
+		timeout->m_timer_link = nullptr;
+	}
+
+	void PODTimerWheel::expire(
+		PODTimeout * timeout)
+	{
+		--m_size;
+		if(Coroutine * waiter = timeout->expire())
+		{
+			waiter->libcr_next_waiting.plain = m_due;
+			m_due = waiter;
+		}
+	}
+
+	void PODTimerWheel::place(
+		Coroutine * coroutine)
+	{
+		std::uint64_t deadline = coroutine->libcr_deadline;
+		Coroutine ** list;
+
+		if(deadline <= m_now)
+		{
+			--m_size;
+			list = &m_due;
+		} else
+		{
+			std::size_t level, slot;
+			locate(deadline, level, slot);
+			if(level >= kLevels)
+				list = &m_overflow;
+			else
+			{
+				m_occupied[level] |= std::uint64_t(1) << slot;
+				list = &m_slots[level][slot];
+			}
+		}
+
+		coroutine->libcr_next_waiting.plain = *list;
+		*list = coroutine;
+	}
+
+	void PODTimerWheel::place(
+		PODTimeout * timeout)
+	{
+		std::uint64_t deadline = timeout->m_deadline;
+
+		if(deadline <= m_now)
+		{
+			timeout->m_timer_link = nullptr;
+			expire(timeout);
+			return;
+		}
+
+		std::size_t level, slot;
+		locate(deadline, level, slot);
+		if(level >= kLevels)
+			link(m_timeout_overflow, timeout);
+		else
+		{
+			m_occupied[level] |= std::uint64_t(1) << slot;
+			link(m_timeouts[level][slot], timeout);
+		}
+	}
+
+	void PODTimerWheel::cascade(
+		std::size_t level,
+		std::size_t slot)
+	{
+		Coroutine * list = m_slots[level][slot];
+		m_slots[level][slot] = nullptr;
+		PODTimeout * timeouts = m_timeouts[level][slot];
+		m_timeouts[level][slot] = nullptr;
+		m_occupied[level] &= ~(std::uint64_t(1) << slot);
+
+		while(list)
+		{
+			Coroutine * next = list->libcr_next_waiting.plain;
+			place(list);
+			list = next;
+		}
+
+		while(timeouts)
+		{
+			PODTimeout * next = timeouts->m_timer_next;
+			place(timeouts);
+			timeouts = next;
+		}
+	}
+
+	void PODTimerWheel::catch_up()
+	{
+		// Nothing is in the slots, so they need not be cascaded, and stale bits of cancelled timeouts can be dropped.
+		if(m_size)
+			return;
+		std::uint64_t const current = now();
+		if(current <= m_now)
+			return;
+		m_now = current;
+		for(std::size_t level = 0; level < kLevels; level++)
+			m_occupied[level] = 0;
+	}
+
+	void PODTimerWheel::insert(
+		Coroutine * coroutine,
+		std::uint64_t deadline)
+	{
+		catch_up();
+		coroutine->libcr_deadline = deadline;
+		++m_size;
+		place(coroutine);
+		if(m_wake)
+			m_wake(m_wake_context);
+	}
+
+	void PODTimerWheel::insert(
+		PODTimeout &timeout,
+		std::uint64_t deadline)
+	{
+		catch_up();
+		// The timeout is not in its waiting list yet, so it must not expire right away.
+		timeout.m_deadline = deadline > m_now ? deadline : m_now + 1;
+		++m_size;
+		place(&timeout);
+		if(m_wake)
+			m_wake(m_wake_context);
+	}
+
+	void PODTimerWheel::cancel(
+		PODTimeout &timeout)
+	{
+		// The slot's occupation bit stays set, empty slots are skipped cheaply.
+		unlink(&timeout);
+		--m_size;
+	}
+
+	Coroutine * PODTimerWheel::advance(
+		std::uint64_t now)
+	{
+		while(m_size && m_now < now)
+		{
+			// Expire the remaining level 0 slots of the current block.
+			std::uint64_t block_end = m_now | (kSlots - 1);
+			std::uint64_t end = now < block_end ? now : block_end;
+			std::size_t first = (m_now + 1) & (kSlots - 1);
+			std::size_t last = end & (kSlots - 1);
+			if(end > m_now)
+			{
+				std::uint64_t mask = (~std::uint64_t(0) >> (kSlots - 1 - last)) & (~std::uint64_t(0) << first);
+				for(std::uint64_t due = m_occupied[0] & mask; due; due &= due - 1)
+				{
+					std::size_t slot = __builtin_ctzll(due);
+					Coroutine * list = m_slots[0][slot];
+					m_slots[0][slot] = nullptr;
+					while(list)
+					{
+						Coroutine * next = list->libcr_next_waiting.plain;
+						list->libcr_next_waiting.plain = m_due;
+						m_due = list;
+						--m_size;
+						list = next;
+					}
+
+					while(PODTimeout * timeout = m_timeouts[0][slot])
+					{
+						unlink(timeout);
+						expire(timeout);
+					}
+				}
+				m_occupied[0] &= ~mask;
+			}
+
+			m_now = end;
+			if(m_now == now)
+				break;
+
+			// Enter the next block, and move the entries of the higher levels' current slots down.
+			++m_now;
+			std::size_t top = 1;
+			while(top < kLevels && !(m_now & ((std::uint64_t(1) << ((top+1) * kSlotBits)) - 1)))
+				++top;
+
+			if(top == kLevels)
+			{
+				Coroutine * list = m_overflow;
+				m_overflow = nullptr;
+				while(list)
+				{
+					Coroutine * next = list->libcr_next_waiting.plain;
+					place(list);
+					list = next;
+				}
+
+				PODTimeout * timeouts = m_timeout_overflow;
+				m_timeout_overflow = nullptr;
+				while(timeouts)
+				{
+					PODTimeout * next = timeouts->m_timer_next;
+					place(timeouts);
+					timeouts = next;
+				}
+				--top;
+			}
+
+			for(std::size_t level = top; level; level--)
+				cascade(level, (m_now >> (level * kSlotBits)) & (kSlots - 1));
+		}
+
+		if(m_now < now)
+			m_now = now;
+
+		Coroutine * due = m_due;
+		m_due = nullptr;
+		return due;
+	}
+}
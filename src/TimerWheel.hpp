@@ -0,0 +1,180 @@
+/** @file TimerWheel.hpp
+	Contains the hierarchical timing wheel used by the schedulers to implement sleeping. */
+#ifndef __libcr_timerwheel_hpp_defined
+#define __libcr_timerwheel_hpp_defined
+
+#include <chrono>
+#include <cinttypes>
+#include <cstddef>
+
+namespace cr
+{
+	// Forward declarations.
+	class Coroutine;
+	class PODTimeout;
+
+	/** POD hierarchical timing wheel of sleeping coroutines (not thread-safe).
+		Coroutines are linked intrusively through their `libcr_next_waiting` pointer and remember their wake-up tick in `libcr_deadline`, so no allocations are needed. Timeouts are kept in separate, doubly linked lists, so that they can be cancelled. Insertion and cancellation are O(1), and expiry is amortised O(1) per entry. */
+	class PODTimerWheel
+	{
+	public:
+		/** The clock used for deadlines. */
+		typedef std::chrono::steady_clock clock;
+		/** The wheel's tick length. */
+		typedef std::chrono::milliseconds tick_t;
+		/** Callback that wakes up the thread advancing the wheel. */
+		typedef void (*wake_t)(
+			void * context);
+
+	private:
+		/** log2 of the number of slots per level. */
+		static constexpr std::size_t kSlotBits = 6;
+		/** The number of slots per level. */
+		static constexpr std::size_t kSlots = std::size_t(1) << kSlotBits;
+		/** The number of levels.
+			Deadlines further ahead than the levels cover are kept in an overflow list. */
+		static constexpr std::size_t kLevels = 4;
+
+		/** The tick up to which the wheel has been advanced. */
+		std::uint64_t m_now;
+		/** The number of coroutines and timeouts in the wheel that are not yet due. */
+		std::size_t m_size;
+		/** For every level, which slots may hold coroutines or timeouts. */
+		std::uint64_t m_occupied[kLevels];
+		/** The sleeping coroutines in the slots of every level. */
+		Coroutine * m_slots[kLevels][kSlots];
+		/** The timeouts in the slots of every level. */
+		PODTimeout * m_timeouts[kLevels][kSlots];
+		/** Coroutines that are too far ahead to fit into the levels. */
+		Coroutine * m_overflow;
+		/** Timeouts that are too far ahead to fit into the levels. */
+		PODTimeout * m_timeout_overflow;
+		/** Coroutines that are due, including the waiting coroutines of expired timeouts. */
+		Coroutine * m_due;
+		/** Called after every insertion, or null. */
+		wake_t m_wake;
+		/** The wake-up callback's context. */
+		void * m_wake_context;
+
+		/** Finds the list matching a deadline.
+		@param[in] deadline:
+			The deadline, which must not be due yet.
+		@param[out] level:
+			The matching level, or `kLevels` if the deadline is too far ahead.
+		@param[out] slot:
+			The matching slot within the level. */
+		inline void locate(
+			std::uint64_t deadline,
+			std::size_t &level,
+			std::size_t &slot);
+		/** Puts a coroutine into the slot matching its deadline. */
+		void place(
+			Coroutine * coroutine);
+		/** Puts a timeout into the slot matching its deadline, or expires it. */
+		void place(
+			PODTimeout * timeout);
+		/** Links a timeout into a list.
+		@param[in] list:
+			The list to link into.
+		@param[in] timeout:
+			The timeout to link. */
+		static inline void link(
+			PODTimeout * &list,
+			PODTimeout * timeout);
+		/** Unlinks a timeout from its list. */
+		static inline void unlink(
+			PODTimeout * timeout);
+		/** Expires a timeout that was removed from its list. */
+		void expire(
+			PODTimeout * timeout);
+		/** Moves the coroutines of a slot into the slots matching their deadline.
+		@param[in] level:
+			The slot's level.
+		@param[in] slot:
+			The slot's index. */
+		void cascade(
+			std::size_t level,
+			std::size_t slot);
+		/** Moves an empty wheel forward to the current tick.
+			The schedulers do not advance empty wheels, so that an insertion would otherwise be placed relative to a stale tick, and the next `advance()` would have to walk all blocks since. */
+		void catch_up();
+	public:
+		/** Initialises the wheel to be empty. */
+		void initialise();
+
+		/** Converts a time point into a tick, rounding up.
+		@param[in] time:
+			The time point to convert.
+		@return
+			The first tick not before `time`. */
+		static inline std::uint64_t tick(
+			clock::time_point time);
+		/** The current tick, rounded down. */
+		static inline std::uint64_t now();
+
+		/** Whether there are no sleeping coroutines or timeouts. */
+		inline bool empty() const;
+
+		/** A lower bound of the next tick at which a coroutine or timeout is due.
+			Exact for deadlines within the current block of the lowest level.
+		@return
+			The tick, or the maximum tick if the wheel is empty. */
+		std::uint64_t next_tick() const;
+
+		/** Sets the callback to invoke after every insertion.
+			A thread that blocks until `next_tick()` uses it to be woken up when an earlier deadline is inserted by another thread.
+		@param[in] wake:
+			The callback, or null.
+		@param[in] context:
+			The callback's argument. */
+		void set_waker(
+			wake_t wake,
+			void * context);
+
+		/** Inserts a sleeping coroutine.
+		@param[in] coroutine:
+			The coroutine to insert.
+		@param[in] deadline:
+			The tick at which to wake the coroutine up. */
+		void insert(
+			Coroutine * coroutine,
+			std::uint64_t deadline);
+
+		/** Inserts a timeout.
+		@param[in] timeout:
+			The timeout to insert. It must not be in a timing wheel.
+		@param[in] deadline:
+			The tick at which the timeout expires. A timeout that is already due expires at the next tick. */
+		void insert(
+			PODTimeout &timeout,
+			std::uint64_t deadline);
+
+		/** Removes a timeout that did not expire yet.
+		@param[in] timeout:
+			The timeout to remove. */
+		void cancel(
+			PODTimeout &timeout);
+
+		/** Advances the wheel and removes all coroutines that are due.
+			Expired timeouts are removed from their waiting lists, and their waiting coroutines are returned with their error flags set.
+		@param[in] now:
+			The current tick.
+		@return
+			The list of due coroutines, linked through `libcr_next_waiting.plain`. */
+		Coroutine * advance(
+			std::uint64_t now);
+	};
+
+	/** Hierarchical timing wheel of sleeping coroutines (not thread-safe). */
+	class TimerWheel : public PODTimerWheel
+	{
+	public:
+		/** Initialises the wheel to be empty. */
+		inline TimerWheel();
+	};
+
+}
+
+#include "TimerWheel.inl"
+
+#endif
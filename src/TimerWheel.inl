@@ -0,0 +1,38 @@
+namespace cr
+{
+	std::uint64_t PODTimerWheel::tick(
+		clock::time_point time)
+	{
+		auto since_epoch = time.time_since_epoch();
+		auto ticks = std::chrono::duration_cast<tick_t>(since_epoch);
+		if(ticks < since_epoch)
+			++ticks;
+		return ticks.count();
+	}
+
+	std::uint64_t PODTimerWheel::now()
+	{
+		return std::chrono::duration_cast<tick_t>(clock::now().time_since_epoch()).count();
+	}
+
+	bool PODTimerWheel::empty() const
+	{
+		return !m_size && !m_due;
+	}
+
+	void PODTimerWheel::locate(
+		std::uint64_t deadline,
+		std::size_t &level,
+		std::size_t &slot)
+	{
+		// The level is determined by the highest bit in which the deadline and the current tick differ.
+		level = (63 - __builtin_clzll(deadline ^ m_now)) / kSlotBits;
+		if(level < kLevels)
+			slot = (deadline >> (level * kSlotBits)) & (kSlots - 1);
+	}
+
+	TimerWheel::TimerWheel()
+	{
+		initialise();
+	}
+}
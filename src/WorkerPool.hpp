@@ -0,0 +1,67 @@
+/** @file WorkerPool.hpp
+	Contains a managed pool of scheduling threads. */
+#ifndef __libcr_workerpool_hpp_defined
+#define __libcr_workerpool_hpp_defined
+
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace cr
+{
+	template<class Scheduler>
+	/** Runs a scheduler's threads, so that the number of threads always matches the scheduler's configuration.
+		Workers are pinned to CPUs according to the CPU topology, and park while idle.
+	@tparam Scheduler:
+		The scheduler type. Must provide `initialise()`, `run_until_stopped()`, `stop()`, `idle()`, and `stats()`, like `HybridScheduler`. */
+	class WorkerPool
+	{
+		/** The scheduler to run. */
+		Scheduler &m_scheduler;
+		/** The worker threads. */
+		std::vector<std::thread> m_workers;
+	public:
+		/** Creates a pool without starting it.
+		@param[in] scheduler:
+			The scheduler to run. */
+		explicit WorkerPool(
+			Scheduler &scheduler = Scheduler::instance());
+		/** Stops the pool, if it is still running. */
+		~WorkerPool();
+
+		WorkerPool(WorkerPool const&) = delete;
+		WorkerPool &operator=(WorkerPool const&) = delete;
+
+		/** Initialises the scheduler and starts the workers.
+			Has to be called before any coroutine is enqueued into the scheduler, as initialising the scheduler resets it.
+		@param[in] workers:
+			The number of workers, or 0 to start one worker per available CPU.
+		@param[in] pin:
+			Whether to pin each worker to a CPU. */
+		void start(
+			std::size_t workers = 0,
+			bool pin = true);
+
+		/** Waits until the scheduler has no more pending coroutines, and then stops the workers. */
+		void drain();
+
+		/** Stops the workers after their current round, and waits for them to exit.
+			Coroutines that did not finish remain in the scheduler. */
+		void stop();
+
+		/** The number of running workers. */
+		inline std::size_t workers() const;
+
+		/** Reads a worker's statistics.
+		@param[in] worker:
+			The worker index.
+		@return
+			The worker's statistics. */
+		inline auto stats(
+			std::size_t worker) const;
+	};
+}
+
+#include "WorkerPool.inl"
+
+#endif
@@ -0,0 +1,85 @@
+#include "util/Topology.hpp"
+
+#include <cassert>
+#include <chrono>
+
+namespace cr
+{
+	template<class Scheduler>
+	WorkerPool<Scheduler>::WorkerPool(
+		Scheduler &scheduler):
+		m_scheduler(scheduler),
+		m_workers()
+	{
+	}
+
+	template<class Scheduler>
+	WorkerPool<Scheduler>::~WorkerPool()
+	{
+		stop();
+	}
+
+	template<class Scheduler>
+	void WorkerPool<Scheduler>::start(
+		std::size_t workers,
+		bool pin)
+	{
+		assert(m_workers.empty() && "The pool is already running.");
+
+		std::vector<int> cpus = util::cpu_order();
+		if(!workers)
+			workers = cpus.empty()
+				? std::thread::hardware_concurrency()
+				: cpus.size();
+		if(!workers)
+			workers = 1;
+
+		m_scheduler.initialise(workers);
+		m_workers.reserve(workers);
+		for(std::size_t i = 0; i < workers; i++)
+		{
+			int cpu = (pin && !cpus.empty()) ? cpus[i % cpus.size()] : -1;
+			m_workers.emplace_back([this, i, cpu] {
+				if(cpu != -1)
+					(void) util::pin_thread(cpu);
+				m_scheduler.run_until_stopped(i);
+			});
+		}
+	}
+
+	template<class Scheduler>
+	void WorkerPool<Scheduler>::drain()
+	{
+		if(m_workers.empty())
+			return;
+
+		while(!m_scheduler.idle())
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		stop();
+	}
+
+	template<class Scheduler>
+	void WorkerPool<Scheduler>::stop()
+	{
+		if(m_workers.empty())
+			return;
+
+		m_scheduler.stop();
+		for(std::thread &worker : m_workers)
+			worker.join();
+		m_workers.clear();
+	}
+
+	template<class Scheduler>
+	std::size_t WorkerPool<Scheduler>::workers() const
+	{
+		return m_workers.size();
+	}
+
+	template<class Scheduler>
+	auto WorkerPool<Scheduler>::stats(
+		std::size_t worker) const
+	{
+		return m_scheduler.stats(worker);
+	}
+}
@@ -2,6 +2,7 @@
 #define __libcr_detail_nextpointer_hpp_defined
 
 #include "../util/Atomic.hpp"
+#include "../util/Backoff.hpp"
 
 namespace cr
 {
@@ -27,7 +28,7 @@ namespace cr::detail
 		using util::Atomic<Coroutine *>::load_strong;
 
 		/** Waits until the pointer points to another coroutine.
-			Performs relaxed load_weak, until non-null value is read.
+			Performs relaxed load_weak, backing off with `util::Backoff`, until non-null value is read.
 		@return
 			The next waiting coroutine. */
 		inline Coroutine * wait_weak();
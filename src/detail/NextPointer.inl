@@ -8,17 +8,19 @@ namespace cr::detail
 
 	Coroutine * AtomicNextPointer::wait_weak()
 	{
+		// The pointer is set right after the coroutine is linked, so this never waits long, and never blocks.
+		util::Backoff backoff;
 		Coroutine * next;
-		while(!(next = load_weak(std::memory_order_relaxed)));
+		while(!(next = load_weak(std::memory_order_relaxed)))
+			backoff.pause();
 		return next;
 	}
 
 	Coroutine * AtomicNextPointer::wait_strong()
 	{
-		Coroutine * next = load_strong(std::memory_order_relaxed);
-		while(!next)
-			next = load_weak(std::memory_order_relaxed);
-		return next;
+		if(Coroutine * next = load_strong(std::memory_order_relaxed))
+			return next;
+		return wait_weak();
 	}
 
 	void AtomicNextPointer::release()
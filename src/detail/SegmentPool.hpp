@@ -0,0 +1,64 @@
+/** @file SegmentPool.hpp
+	Contains the per-thread pool of queue segments used by the unbounded queues. */
+#ifndef __libcr_detail_segmentpool_hpp_defined
+#define __libcr_detail_segmentpool_hpp_defined
+
+#include <cstddef>
+
+namespace cr::detail
+{
+	template<class T, std::size_t kSize>
+	/** A fixed-size block of queue elements, linked to the next block.
+	@tparam T:
+		The element type.
+	@tparam kSize:
+		The number of elements per segment. */
+	struct Segment
+	{
+		static_assert(kSize > 0, "A segment needs to hold at least one element.");
+
+		/** The next segment. */
+		Segment * next;
+		/** The segment's elements. */
+		T values[kSize];
+	};
+
+	template<class T, std::size_t kSize>
+	/** Per-thread pool of unused segments.
+		Released segments are kept for reuse by the releasing thread, so that queues in a steady state do not allocate. Every thread keeps at most `kMaxPooled` segments of each type, and frees any surplus.
+	@tparam T:
+		The element type.
+	@tparam kSize:
+		The number of elements per segment. */
+	class SegmentPool
+	{
+	public:
+		/** The maximum number of segments kept per thread. */
+		static constexpr std::size_t kMaxPooled = 64;
+	private:
+		/** The unused segments. */
+		Segment<T, kSize> * m_free;
+		/** The number of unused segments. */
+		std::size_t m_count;
+
+		/** The calling thread's pool. */
+		static thread_local SegmentPool s_instance;
+	public:
+		/** Frees the pooled segments when the thread exits. */
+		~SegmentPool();
+
+		/** Takes a segment from the calling thread's pool, or allocates one if the pool is empty.
+		@return
+			The segment. Its `next` pointer is null. */
+		static Segment<T, kSize> * allocate();
+		/** Returns a segment to the calling thread's pool, or frees it if the pool is full.
+		@param[in] segment:
+			The segment, which must have been returned by `allocate()`. */
+		static void release(
+			Segment<T, kSize> * segment);
+	};
+}
+
+#include "SegmentPool.inl"
+
+#endif
@@ -0,0 +1,49 @@
+namespace cr::detail
+{
+	// Zero-initialised, so that the pool needs no constructor.
+	template<class T, std::size_t kSize>
+	thread_local SegmentPool<T, kSize> SegmentPool<T, kSize>::s_instance;
+
+	template<class T, std::size_t kSize>
+	SegmentPool<T, kSize>::~SegmentPool()
+	{
+		while(Segment<T, kSize> * segment = m_free)
+		{
+			m_free = segment->next;
+			delete segment;
+		}
+		m_count = 0;
+	}
+
+	template<class T, std::size_t kSize>
+	Segment<T, kSize> * SegmentPool<T, kSize>::allocate()
+	{
+		SegmentPool &self = s_instance;
+		Segment<T, kSize> * segment = self.m_free;
+		if(segment)
+		{
+			self.m_free = segment->next;
+			--self.m_count;
+		} else
+			segment = new Segment<T, kSize>;
+
+		segment->next = nullptr;
+		return segment;
+	}
+
+	template<class T, std::size_t kSize>
+	void SegmentPool<T, kSize>::release(
+		Segment<T, kSize> * segment)
+	{
+		SegmentPool &self = s_instance;
+		if(self.m_count == kMaxPooled)
+		{
+			delete segment;
+			return;
+		}
+
+		segment->next = self.m_free;
+		self.m_free = segment;
+		++self.m_count;
+	}
+}
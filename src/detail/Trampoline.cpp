@@ -0,0 +1,33 @@
+#include "Trampoline.hpp"
+
+#ifdef LIBCR_TRAMPOLINE
+
+#include "../Coroutine.hpp"
+
+namespace cr::detail
+{
+	// Zero-initialised, so that no thread-local initialisation guard is needed.
+	thread_local Trampoline Trampoline::s_instance;
+
+	void Trampoline::resume(
+		Coroutine * coroutine)
+	{
+		Trampoline &self = s_instance;
+		if(self.m_active)
+		{
+			if(self.m_tail - self.m_head < kCapacity)
+				self.m_ring[self.m_tail++ & (kCapacity - 1)] = coroutine;
+			else
+				(*coroutine)();
+			return;
+		}
+
+		self.m_active = true;
+		(*coroutine)();
+		while(self.m_head != self.m_tail)
+			(*self.m_ring[self.m_head++ & (kCapacity - 1)])();
+		self.m_active = false;
+	}
+}
+
+#endif
@@ -0,0 +1,43 @@
+/** @file Trampoline.hpp
+	Contains the per-thread resumption ring used with `LIBCR_TRAMPOLINE`. */
+#ifndef __libcr_detail_trampoline_hpp_defined
+#define __libcr_detail_trampoline_hpp_defined
+
+#include <cstddef>
+
+namespace cr
+{
+	// Forward declarations.
+	class Coroutine;
+}
+
+namespace cr::detail
+{
+	/** Per-thread ring of pending resumptions.
+		The outermost resumption of a thread runs the ring from a flat loop, and nested resumptions are only queued. If the ring is full, resumptions fall back to a direct call. */
+	class Trampoline
+	{
+		/** The ring's capacity. Must be a power of two. */
+		static constexpr std::size_t kCapacity = 256;
+
+		/** The queued coroutines. */
+		Coroutine * m_ring[kCapacity];
+		/** The index of the next coroutine to resume. */
+		std::size_t m_head;
+		/** The index after the last queued coroutine. */
+		std::size_t m_tail;
+		/** Whether the thread is running the loop. */
+		bool m_active;
+
+		/** The calling thread's trampoline. */
+		static thread_local Trampoline s_instance;
+	public:
+		/** Resumes a coroutine directly, or queues it if the thread is already resuming another coroutine.
+		@param[in] coroutine:
+			The coroutine to resume. */
+		static void resume(
+			Coroutine * coroutine);
+	};
+}
+
+#endif
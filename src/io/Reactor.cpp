@@ -0,0 +1,255 @@
+#include "Reactor.hpp"
+
+#ifdef LIBCR_HAS_REACTOR
+
+#include "../Coroutine.hpp"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <cassert>
+
+namespace cr::io
+{
+	Reactor::Reactor():
+		m_epoll(-1),
+		m_wakeup(-1),
+		m_open(false),
+		m_mutex(),
+		m_entries(),
+		m_waiting(0),
+		m_sleeping(false)
+	{
+	}
+
+	bool Reactor::open()
+	{
+		if(m_open.load(std::memory_order_relaxed))
+			return m_epoll != -1;
+
+		m_epoll = epoll_create1(EPOLL_CLOEXEC);
+		m_wakeup = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+		assert(m_epoll != -1 && "Could not create the epoll instance.");
+		assert(m_wakeup != -1 && "Could not create the wake-up event.");
+
+		epoll_event event {};
+		event.events = EPOLLIN;
+		// File descriptors are never negative, so -1 identifies the wake-up event.
+		event.data.fd = -1;
+		if(m_epoll != -1 && m_wakeup != -1)
+			epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_wakeup, &event);
+
+		m_open.store(true, std::memory_order_release);
+		return m_epoll != -1;
+	}
+
+	Reactor::~Reactor()
+	{
+		assert(!waiting() && "Coroutines are still waiting for I/O.");
+		if(m_wakeup != -1)
+			close(m_wakeup);
+		if(m_epoll != -1)
+			close(m_epoll);
+	}
+
+	Reactor::Entry * Reactor::entry(
+		int fd)
+	{
+		if(fd < 0 || !open())
+			return nullptr;
+
+		if(m_entries.size() <= (std::size_t)fd)
+			m_entries.resize(fd + 1, Entry{nullptr, nullptr, 0, false});
+
+		Entry &entry = m_entries[fd];
+		if(!entry.registered)
+		{
+			// Register for both directions once, so that waiting needs no further system calls.
+			epoll_event event {};
+			event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+			event.data.fd = fd;
+			if(epoll_ctl(m_epoll, EPOLL_CTL_ADD, fd, &event) == -1)
+				return nullptr;
+			entry.registered = true;
+			entry.ready = 0;
+		}
+
+		return &entry;
+	}
+
+	sync::mayblock Reactor::ReadyCall::libcr_wait(
+		Coroutine * coroutine)
+	{
+		assert(coroutine != nullptr);
+
+		mt::detail::LockGuard lock(m_reactor.m_mutex);
+		Entry * entry = m_reactor.entry(m_fd);
+		if(!entry)
+		{
+			coroutine->libcr_error = true;
+			return sync::nonblock();
+		}
+
+		// Consume readiness that arrived while nobody was waiting.
+		if(entry->ready & m_events)
+		{
+			entry->ready &= ~m_events;
+			return sync::nonblock();
+		}
+
+		Coroutine * &list = (m_events == kReadable) ? entry->readers : entry->writers;
+		coroutine->libcr_next_waiting.plain = list;
+		list = coroutine;
+		m_reactor.m_waiting.fetch_add(1, std::memory_order_relaxed);
+
+		return sync::block();
+	}
+
+	bool Reactor::remove(
+		int fd)
+	{
+		Coroutine * failed = nullptr;
+		{
+			mt::detail::LockGuard lock(m_mutex);
+			if(fd < 0 || m_entries.size() <= (std::size_t)fd)
+				return false;
+
+			Entry &entry = m_entries[fd];
+			if(!entry.registered)
+				return false;
+
+			epoll_ctl(m_epoll, EPOLL_CTL_DEL, fd, nullptr);
+
+			failed = entry.readers;
+			if(Coroutine * writers = entry.writers)
+			{
+				Coroutine * last = writers;
+				while(last->libcr_next_waiting.plain)
+					last = last->libcr_next_waiting.plain;
+				last->libcr_next_waiting.plain = failed;
+				failed = writers;
+			}
+			entry = Entry{nullptr, nullptr, 0, false};
+		}
+
+		bool result = failed != nullptr;
+		while(failed)
+		{
+			Coroutine * next = failed->libcr_next_waiting.plain;
+			m_waiting.fetch_sub(1, std::memory_order_relaxed);
+			failed->libcr_error = true;
+			failed->resume();
+			failed = next;
+		}
+
+		return result;
+	}
+
+	void Reactor::prepare_sleep()
+	{
+		if(!m_open.load(std::memory_order_acquire))
+		{
+			mt::detail::LockGuard lock(m_mutex);
+			(void) open();
+		}
+
+		// Releases the wake-up event to the waking threads.
+		m_sleeping.store(true, std::memory_order_release);
+		// Pairs with the fence in `wake()`: either the waker sees the flag, or the sleeper sees the waker's work.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+	}
+
+	std::size_t Reactor::poll(
+		int timeout)
+	{
+		// Nothing was watched yet, and the polling thread did not prepare to sleep.
+		if(!m_open.load(std::memory_order_acquire) || m_epoll == -1)
+			return 0;
+
+		epoll_event events[kMaxEvents];
+		int count = epoll_wait(m_epoll, events, kMaxEvents, timeout);
+		m_sleeping.store(false, std::memory_order_relaxed);
+
+		if(count <= 0)
+			return 0;
+
+		// Collect the coroutines to resume, and resume them after unlocking.
+		Coroutine * ready = nullptr;
+		{
+			mt::detail::LockGuard lock(m_mutex);
+			for(int i = 0; i < count; i++)
+			{
+				int fd = events[i].data.fd;
+				if(fd == -1)
+				{
+					std::uint64_t value;
+					(void) !read(m_wakeup, &value, sizeof(value));
+					continue;
+				}
+
+				if(m_entries.size() <= (std::size_t)fd || !m_entries[fd].registered)
+					continue;
+
+				Entry &entry = m_entries[fd];
+				std::uint32_t flags = events[i].events;
+				// Errors and hang-ups wake both directions, so that the I/O operation reports them.
+				if(flags & (EPOLLERR | EPOLLHUP))
+					flags |= EPOLLIN | EPOLLOUT;
+
+				Coroutine * lists[2] = { nullptr, nullptr };
+				if(flags & (EPOLLIN | EPOLLRDHUP))
+				{
+					if(!(lists[0] = entry.readers))
+						entry.ready |= kReadable;
+					entry.readers = nullptr;
+				}
+				if(flags & EPOLLOUT)
+				{
+					if(!(lists[1] = entry.writers))
+						entry.ready |= kWritable;
+					entry.writers = nullptr;
+				}
+
+				for(Coroutine * list : lists)
+					while(list)
+					{
+						Coroutine * next = list->libcr_next_waiting.plain;
+						list->libcr_next_waiting.plain = ready;
+						ready = list;
+						list = next;
+					}
+			}
+		}
+
+		std::size_t result = 0;
+		while(ready)
+		{
+			result++;
+			Coroutine * next = ready->libcr_next_waiting.plain;
+			m_waiting.fetch_sub(1, std::memory_order_relaxed);
+			(*ready)();
+			ready = next;
+		}
+
+		return result;
+	}
+
+	void Reactor::wake()
+	{
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if(m_sleeping.load(std::memory_order_relaxed)
+		&& m_sleeping.exchange(false, std::memory_order_acquire))
+		{
+			std::uint64_t value = 1;
+			(void) !write(m_wakeup, &value, sizeof(value));
+		}
+	}
+
+	void Reactor::wake(
+		void * reactor)
+	{
+		static_cast<Reactor *>(reactor)->wake();
+	}
+}
+
+#endif
@@ -0,0 +1,193 @@
+/** @file Reactor.hpp
+	Contains the epoll based I/O reactor. */
+#ifndef __libcr_io_reactor_hpp_defined
+#define __libcr_io_reactor_hpp_defined
+
+#ifdef __linux__
+/** Defined if the I/O reactor is supported on the target platform. */
+#define LIBCR_HAS_REACTOR 1
+#endif
+
+#ifdef LIBCR_HAS_REACTOR
+
+#include "../sync/Block.hpp"
+#include "../mt/detail/SoftMutex.hpp"
+
+#include <atomic>
+#include <cinttypes>
+#include <cstddef>
+#include <vector>
+
+namespace cr
+{
+	// Forward declarations.
+	class Coroutine;
+}
+
+namespace cr::io
+{
+	// Forward declarations.
+	class Ring;
+
+	/** Edge-triggered epoll reactor that lets coroutines wait for file descriptor readiness.
+		A reactor is polled by a single thread, but coroutines on any thread may wait on it. Waiting coroutines are linked intrusively through their `libcr_next_waiting` pointer, so waiting needs no allocations once a file descriptor is known.
+		As readiness is edge-triggered, a coroutine has to perform I/O until it would block before waiting for the same readiness again. */
+	class Reactor
+	{
+		friend class Ring;
+	public:
+		/** Readiness events to wait for. */
+		enum Events : std::uint8_t
+		{
+			/** The file descriptor can be read from. */
+			kReadable = 1,
+			/** The file descriptor can be written to. */
+			kWritable = 2
+		};
+
+	private:
+		/** The waiting state of a file descriptor. */
+		struct Entry
+		{
+			/** The coroutines waiting until the file descriptor is readable. */
+			Coroutine * readers;
+			/** The coroutines waiting until the file descriptor is writable. */
+			Coroutine * writers;
+			/** Readiness that was signalled while no coroutine was waiting. */
+			std::uint8_t ready;
+			/** Whether the file descriptor is registered with epoll. */
+			bool registered;
+		};
+
+		/** The maximum number of events to fetch per poll. */
+		static constexpr std::size_t kMaxEvents = 64;
+
+		/** The epoll instance, or -1 if not created (yet). */
+		int m_epoll;
+		/** The event file descriptor used to interrupt a blocking poll, or -1 if not created (yet). */
+		int m_wakeup;
+		/** Whether `open()` was called.
+			Publishes the file descriptors to the polling thread. */
+		std::atomic_bool m_open;
+		/** Protects the entries. */
+		mt::detail::SoftMutex m_mutex;
+		/** The file descriptors' waiting states, indexed by file descriptor. */
+		std::vector<Entry> m_entries;
+		/** The number of waiting coroutines. */
+		std::atomic_size_t m_waiting;
+		/** Whether the polling thread is blocked, or about to block, in `poll()`. */
+		std::atomic_bool m_sleeping;
+
+		/** Creates the epoll instance and the wake-up event, unless that was done already.
+			The reactor must be locked.
+		@return
+			Whether the epoll instance exists. */
+		bool open();
+
+		/** Finds or creates a file descriptor's entry, and registers the file descriptor with epoll.
+			The reactor must be locked.
+		@param[in] fd:
+			The file descriptor.
+		@return
+			The entry, or null if the file descriptor could not be registered. */
+		Entry * entry(
+			int fd);
+	public:
+		/** Initialises the reactor.
+			The epoll instance is only created once a file descriptor is watched or the polling thread prepares to sleep, so that threads that never block or perform I/O need no file descriptors. */
+		Reactor();
+		/** Closes the epoll instance, if it was created.
+			No coroutine may be waiting anymore. */
+		~Reactor();
+
+		Reactor(Reactor const&) = delete;
+		Reactor &operator=(Reactor const&) = delete;
+
+		/** Helper class for waiting for file descriptor readiness using `#CR_AWAIT`. */
+		class ReadyCall
+		{
+			/** The reactor to wait on. */
+			Reactor &m_reactor;
+			/** The file descriptor to wait for. */
+			int m_fd;
+			/** The readiness to wait for. */
+			Events m_events;
+		public:
+			/** Initialises the ready call.
+			@param[in] reactor:
+				The reactor to wait on.
+			@param[in] fd:
+				The file descriptor to wait for.
+			@param[in] events:
+				The readiness to wait for. */
+			constexpr ReadyCall(
+				Reactor &reactor,
+				int fd,
+				Events events);
+
+			/** Waits until the file descriptor is ready.
+				Fails if the file descriptor cannot be watched.
+			@param[in] coroutine:
+				The coroutine to wait.
+			@return
+				Whether the call blocks. */
+			[[nodiscard]] sync::mayblock libcr_wait(
+				Coroutine * coroutine);
+		};
+
+		/** Waits until a file descriptor is readable.
+			The file descriptor has to be non-blocking. To be used with `#CR_AWAIT`.
+		@param[in] fd:
+			The file descriptor to wait for. */
+		[[nodiscard]] constexpr ReadyCall readable(
+			int fd);
+		/** Waits until a file descriptor is writable.
+			The file descriptor has to be non-blocking. To be used with `#CR_AWAIT`.
+		@param[in] fd:
+			The file descriptor to wait for. */
+		[[nodiscard]] constexpr ReadyCall writable(
+			int fd);
+
+		/** Stops watching a file descriptor, and fails all coroutines waiting for it.
+			Has to be called before closing a watched file descriptor.
+		@param[in] fd:
+			The file descriptor to stop watching.
+		@return
+			Whether any coroutine was failed. */
+		bool remove(
+			int fd);
+
+		/** The number of coroutines waiting for readiness. */
+		inline std::size_t waiting() const;
+
+		/** Announces that the polling thread is about to block in `poll()`.
+			After this, `wake()` interrupts the next blocking `poll()`. The caller has to check for other pending work after announcing, and then call `poll()`. Creates the epoll instance on first use. */
+		void prepare_sleep();
+
+		/** Polls for readiness, and resumes the coroutines whose file descriptors became ready.
+			Ends a sleep announced by `prepare_sleep()`.
+		@param[in] timeout:
+			The maximum time to block in milliseconds, 0 to not block, or -1 to block until an event arrives or `wake()` is called.
+		@return
+			The number of resumed coroutines. */
+		std::size_t poll(
+			int timeout);
+
+		/** Interrupts a blocking or announced `poll()`.
+			Cheap if the polling thread is not sleeping. Callable from any thread. */
+		void wake();
+
+		/** Calls `wake()` on a reactor.
+			Usable as a timing wheel's wake-up callback.
+		@param[in] reactor:
+			The reactor to wake. */
+		static void wake(
+			void * reactor);
+	};
+}
+
+#include "Reactor.inl"
+
+#endif
+
+#endif
@@ -0,0 +1,29 @@
+namespace cr::io
+{
+	constexpr Reactor::ReadyCall::ReadyCall(
+		Reactor &reactor,
+		int fd,
+		Events events):
+		m_reactor(reactor),
+		m_fd(fd),
+		m_events(events)
+	{
+	}
+
+	constexpr Reactor::ReadyCall Reactor::readable(
+		int fd)
+	{
+		return ReadyCall(*this, fd, kReadable);
+	}
+
+	constexpr Reactor::ReadyCall Reactor::writable(
+		int fd)
+	{
+		return ReadyCall(*this, fd, kWritable);
+	}
+
+	std::size_t Reactor::waiting() const
+	{
+		return m_waiting.load(std::memory_order_relaxed);
+	}
+}
@@ -0,0 +1,334 @@
+#include "Ring.hpp"
+
+#ifdef LIBCR_HAS_REACTOR
+
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+/** Defined if the io_uring interface is available at compile time. */
+#define LIBCR_HAS_IO_URING 1
+#endif
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+
+namespace cr::io
+{
+	void PODOperation::initialise()
+	{
+		Coroutine::prepare(
+			static_cast<impl_t>(&PODOperation::libcr_notified),
+			(Context *) nullptr);
+		m_result = 0;
+	}
+
+	int PODOperation::perform()
+	{
+		long result;
+		switch(m_opcode)
+		{
+		case kRead:
+			result = (m_offset == kCurrent)
+				? ::read(m_fd, m_buffer, m_length)
+				: ::pread(m_fd, m_buffer, m_length, (off_t) m_offset);
+			break;
+		case kWrite:
+			result = (m_offset == kCurrent)
+				? ::write(m_fd, m_buffer, m_length)
+				: ::pwrite(m_fd, m_buffer, m_length, (off_t) m_offset);
+			break;
+		case kAccept:
+			result = ::accept(m_fd, static_cast<sockaddr *>(m_buffer), m_address_length);
+			break;
+		case kFsync:
+			result = ::fsync(m_fd);
+			break;
+		default:
+			assert(!"Invalid operation.");
+			return -EINVAL;
+		}
+
+		return result < 0 ? -errno : (int) result;
+	}
+
+	bool PODOperation::retry()
+	{
+		for(;;)
+		{
+			int result = perform();
+			if(result != -EAGAIN && result != -EWOULDBLOCK)
+			{
+				m_result = result;
+				return true;
+			}
+
+			libcr_error = false;
+			Reactor::ReadyCall ready(
+				m_ring->m_reactor,
+				m_fd,
+				m_opcode == kWrite ? Reactor::kWritable : Reactor::kReadable);
+			if(!ready.libcr_wait(this))
+				return false;
+
+			// The file descriptor cannot be watched, so report that it would block.
+			if(libcr_error)
+			{
+				libcr_error = false;
+				m_result = result;
+				return true;
+			}
+		}
+	}
+
+	void PODOperation::libcr_notified()
+	{
+		// The reactor stopped watching the file descriptor.
+		if(libcr_error)
+		{
+			libcr_error = false;
+			complete(-ECANCELED);
+		} else if(retry())
+			complete(m_result);
+	}
+
+	void PODOperation::complete(
+		int result)
+	{
+		m_result = result;
+		Coroutine * waiter = m_waiter;
+		if(result < 0)
+			waiter->libcr_error = true;
+		waiter->resume();
+	}
+
+	Ring::Ring(
+		Reactor &reactor,
+		unsigned entries):
+		m_reactor(reactor),
+		m_fd(-1),
+		m_mutex(),
+		m_sq_ring(MAP_FAILED),
+		m_sq_ring_size(0),
+		m_cq_ring(MAP_FAILED),
+		m_cq_ring_size(0),
+		m_sqes_size(0),
+		m_queued(0),
+		m_in_flight(0)
+	{
+		m_sqes = MAP_FAILED;
+#ifdef LIBCR_HAS_IO_URING
+		if(!entries)
+			return;
+
+		{
+			// Completions signal the reactor's wake-up event, so it has to exist.
+			mt::detail::LockGuard lock(reactor.m_mutex);
+			(void) reactor.open();
+		}
+
+		io_uring_params params;
+		std::memset(&params, 0, sizeof(params));
+		int fd = (int) syscall(__NR_io_uring_setup, entries, &params);
+		if(fd < 0)
+			return;
+
+		m_sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+		m_cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+		bool const single = params.features & IORING_FEAT_SINGLE_MMAP;
+		if(single && m_cq_ring_size > m_sq_ring_size)
+			m_sq_ring_size = m_cq_ring_size;
+
+		m_sq_ring = mmap(nullptr, m_sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+		if(single)
+			m_cq_ring = m_sq_ring;
+		else
+			m_cq_ring = mmap(nullptr, m_cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+		m_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+		m_sqes = mmap(nullptr, m_sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+
+		// Completions signal the reactor's wake-up event, so that a sleeping thread notices them.
+		if(m_sq_ring == MAP_FAILED
+		|| m_cq_ring == MAP_FAILED
+		|| m_sqes == MAP_FAILED
+		|| reactor.m_wakeup == -1
+		|| syscall(__NR_io_uring_register, fd, IORING_REGISTER_EVENTFD, &reactor.m_wakeup, 1) < 0)
+		{
+			if(m_sqes != MAP_FAILED)
+				munmap(m_sqes, m_sqes_size);
+			if(!single && m_cq_ring != MAP_FAILED)
+				munmap(m_cq_ring, m_cq_ring_size);
+			if(m_sq_ring != MAP_FAILED)
+				munmap(m_sq_ring, m_sq_ring_size);
+			m_sq_ring = m_cq_ring = m_sqes = MAP_FAILED;
+			close(fd);
+			return;
+		}
+
+		char * sq = static_cast<char *>(m_sq_ring);
+		m_sq_head = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+		m_sq_tail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+		m_sq_mask = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+		m_sq_array = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+
+		char * cq = static_cast<char *>(m_cq_ring);
+		m_cq_head = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+		m_cq_tail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+		m_cq_mask = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+		m_cqes = cq + params.cq_off.cqes;
+
+		m_fd = fd;
+#else
+		(void) entries;
+#endif
+	}
+
+	Ring::~Ring()
+	{
+		assert(!pending() && "Operations are still in flight.");
+		if(m_fd == -1)
+			return;
+
+		munmap(m_sqes, m_sqes_size);
+		if(m_cq_ring != m_sq_ring)
+			munmap(m_cq_ring, m_cq_ring_size);
+		munmap(m_sq_ring, m_sq_ring_size);
+		close(m_fd);
+	}
+
+	void Ring::flush()
+	{
+#ifdef LIBCR_HAS_IO_URING
+		unsigned queued = m_queued.load(std::memory_order_relaxed);
+		while(queued)
+		{
+			long submitted = syscall(__NR_io_uring_enter, m_fd, queued, 0, 0, nullptr, 0);
+			if(submitted < 0)
+			{
+				if(errno == EINTR)
+					continue;
+				// Out of resources: keep the rest queued until the next submission.
+				break;
+			}
+			queued -= (unsigned) submitted;
+			m_in_flight.fetch_add(submitted, std::memory_order_relaxed);
+			m_queued.fetch_sub(submitted, std::memory_order_relaxed);
+			if(!submitted)
+				break;
+		}
+#endif
+	}
+
+	bool Ring::queue(
+		PODOperation &operation)
+	{
+#ifdef LIBCR_HAS_IO_URING
+		mt::detail::LockGuard lock(m_mutex);
+
+		unsigned tail = *m_sq_tail;
+		// Submit early if the submission queue is full.
+		if(tail - __atomic_load_n(m_sq_head, __ATOMIC_ACQUIRE) > m_sq_mask)
+		{
+			flush();
+			if(tail - __atomic_load_n(m_sq_head, __ATOMIC_ACQUIRE) > m_sq_mask)
+				return false;
+		}
+
+		unsigned index = tail & m_sq_mask;
+		io_uring_sqe &sqe = static_cast<io_uring_sqe *>(m_sqes)[index];
+		std::memset(&sqe, 0, sizeof(sqe));
+		sqe.fd = operation.m_fd;
+		sqe.user_data = reinterpret_cast<std::uintptr_t>(&operation);
+		switch(operation.m_opcode)
+		{
+		case PODOperation::kRead:
+		case PODOperation::kWrite:
+			sqe.opcode = (operation.m_opcode == PODOperation::kRead)
+				? IORING_OP_READ
+				: IORING_OP_WRITE;
+			sqe.addr = reinterpret_cast<std::uintptr_t>(operation.m_buffer);
+			sqe.len = operation.m_length;
+			sqe.off = operation.m_offset;
+			break;
+		case PODOperation::kAccept:
+			sqe.opcode = IORING_OP_ACCEPT;
+			sqe.addr = reinterpret_cast<std::uintptr_t>(operation.m_buffer);
+			sqe.addr2 = reinterpret_cast<std::uintptr_t>(operation.m_address_length);
+			break;
+		case PODOperation::kFsync:
+			sqe.opcode = IORING_OP_FSYNC;
+			break;
+		}
+		m_sq_array[index] = index;
+		__atomic_store_n(m_sq_tail, tail + 1, __ATOMIC_RELEASE);
+		m_queued.fetch_add(1, std::memory_order_relaxed);
+		return true;
+#else
+		(void) operation;
+		return false;
+#endif
+	}
+
+	sync::mayblock Ring::PerformCall::libcr_wait(
+		Coroutine * coroutine)
+	{
+		assert(coroutine != nullptr);
+
+		m_operation.m_waiter = coroutine;
+		m_operation.m_ring = &m_ring;
+
+		if(m_ring.native())
+		{
+			if(m_ring.queue(m_operation))
+				return sync::block();
+
+			m_operation.m_result = -EBUSY;
+			coroutine->libcr_error = true;
+			return sync::nonblock();
+		}
+
+		if(!m_operation.retry())
+			return sync::block();
+
+		if(m_operation.m_result < 0)
+			coroutine->libcr_error = true;
+		return sync::nonblock();
+	}
+
+	std::size_t Ring::submit()
+	{
+		if(m_fd == -1)
+			return 0;
+
+#ifdef LIBCR_HAS_IO_URING
+		if(queued())
+		{
+			mt::detail::LockGuard lock(m_mutex);
+			flush();
+		}
+
+		std::size_t result = 0;
+		unsigned head = *m_cq_head;
+		while(head != __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE))
+		{
+			io_uring_cqe const &cqe = static_cast<io_uring_cqe *>(m_cqes)[head & m_cq_mask];
+			PODOperation * operation = reinterpret_cast<PODOperation *>(cqe.user_data);
+			int res = cqe.res;
+			// Release the entry before resuming, as the coroutine may reuse the operation.
+			__atomic_store_n(m_cq_head, ++head, __ATOMIC_RELEASE);
+			m_in_flight.fetch_sub(1, std::memory_order_relaxed);
+
+			operation->complete(res);
+			result++;
+		}
+
+		return result;
+#else
+		return 0;
+#endif
+	}
+}
+
+#endif
@@ -0,0 +1,281 @@
+/** @file Ring.hpp
+	Contains the io_uring based I/O submission ring. */
+#ifndef __libcr_io_ring_hpp_defined
+#define __libcr_io_ring_hpp_defined
+
+#include "Reactor.hpp"
+
+#ifdef LIBCR_HAS_REACTOR
+
+#include "../Coroutine.hpp"
+
+#include <sys/socket.h>
+
+namespace cr::io
+{
+	// Forward declarations.
+	class Ring;
+
+	/** POD asynchronous I/O operation.
+		An operation has to outlive the I/O it describes, so it is usually part of the waiting coroutine's state. If the operation has to wait for readiness instead of being submitted to io_uring, it takes the waiting coroutine's place in the reactor, and retries the I/O when it is resumed. */
+	class PODOperation : public Coroutine
+	{
+		friend class Ring;
+	public:
+		/** Offset that reads or writes at the file descriptor's current position. */
+		static constexpr std::uint64_t kCurrent = ~std::uint64_t(0);
+
+	private:
+		/** The kinds of operations. */
+		enum Opcode : std::uint8_t
+		{
+			kRead,
+			kWrite,
+			kAccept,
+			kFsync
+		};
+
+		/** The kind of operation. */
+		Opcode m_opcode;
+		/** The file descriptor to operate on. */
+		int m_fd;
+		/** The I/O buffer, or the address to accept into. */
+		void * m_buffer;
+		/** The I/O buffer's length, or the address length to accept into. */
+		union
+		{
+			std::uint32_t m_length;
+			socklen_t * m_address_length;
+		};
+		/** The file offset. */
+		std::uint64_t m_offset;
+		/** The coroutine waiting for the operation. */
+		Coroutine * m_waiter;
+		/** The ring the operation was submitted to. */
+		Ring * m_ring;
+		/** The operation's result. */
+		int m_result;
+
+		/** Called when the reactor signals readiness while waiting for it in the fallback path.
+			Retries the operation, and resumes the waiting coroutine once it completed. */
+		void libcr_notified();
+
+		/** Performs the operation using a non-blocking system call.
+		@return
+			The system call's result, or the negated `errno` value. */
+		int perform();
+
+		/** Performs the operation until it completes or has to wait for readiness.
+		@return
+			Whether the operation completed. Otherwise, it waits in the reactor. */
+		bool retry();
+
+		/** Completes the operation, and resumes the waiting coroutine.
+		@param[in] result:
+			The operation's result. */
+		void complete(
+			int result);
+	public:
+		/** Initialises the operation. */
+		void initialise();
+
+		/** Prepares a read.
+		@param[in] fd:
+			The file descriptor to read from.
+		@param[out] buffer:
+			The buffer to read into.
+		@param[in] length:
+			The buffer's length.
+		@param[in] offset:
+			The file offset to read at, or `kCurrent`.
+		@return
+			The operation. */
+		inline PODOperation &read(
+			int fd,
+			void * buffer,
+			std::uint32_t length,
+			std::uint64_t offset = kCurrent);
+		/** Prepares a write.
+		@param[in] fd:
+			The file descriptor to write to.
+		@param[in] buffer:
+			The buffer to write.
+		@param[in] length:
+			The buffer's length.
+		@param[in] offset:
+			The file offset to write at, or `kCurrent`.
+		@return
+			The operation. */
+		inline PODOperation &write(
+			int fd,
+			void const * buffer,
+			std::uint32_t length,
+			std::uint64_t offset = kCurrent);
+		/** Prepares accepting a connection.
+		@param[in] fd:
+			The listening socket.
+		@param[out] address:
+			The peer's address, or null.
+		@param[in,out] length:
+			The address buffer's length, or null.
+		@return
+			The operation. */
+		inline PODOperation &accept(
+			int fd,
+			sockaddr * address = nullptr,
+			socklen_t * length = nullptr);
+		/** Prepares flushing a file to its storage.
+		@param[in] fd:
+			The file to flush.
+		@return
+			The operation. */
+		inline PODOperation &fsync(
+			int fd);
+
+		/** The completed operation's result, as returned by the system call.
+			Failures are reported as negated `errno` values, and set the waiting coroutine's error flag. */
+		inline int result() const;
+	};
+
+	/** Asynchronous I/O operation. */
+	class Operation : public PODOperation
+	{
+		using PODOperation::initialise;
+	public:
+		/** Initialises the operation. */
+		inline Operation();
+	};
+
+	/** io_uring submission ring that lets coroutines await I/O operations.
+		Operations are queued when awaited and submitted in one batch by `submit()`, which also resumes the coroutines whose operations completed. A ring is owned by a single thread, and signals completions through its reactor's wake-up event, so that the owning thread can block in `Reactor::poll()`.
+		If io_uring is unavailable, operations are performed as non-blocking system calls, and wait for readiness in the reactor instead. Then, sockets and pipes have to be non-blocking, while regular files are accessed synchronously. */
+	class Ring
+	{
+		friend class PODOperation;
+
+		/** The reactor to wait in if io_uring is unavailable. */
+		Reactor &m_reactor;
+		/** The io_uring instance, or -1 if unavailable. */
+		int m_fd;
+		/** Protects the submission queue. */
+		mt::detail::SoftMutex m_mutex;
+
+		/** The submission queue's head index. */
+		unsigned * m_sq_head;
+		/** The submission queue's tail index. */
+		unsigned * m_sq_tail;
+		/** The submission queue's index mask. */
+		unsigned m_sq_mask;
+		/** The submission queue's indirection array. */
+		unsigned * m_sq_array;
+		/** The submission queue entries. */
+		void * m_sqes;
+		/** The completion queue's head index. */
+		unsigned * m_cq_head;
+		/** The completion queue's tail index. */
+		unsigned * m_cq_tail;
+		/** The completion queue's index mask. */
+		unsigned m_cq_mask;
+		/** The completion queue entries. */
+		void * m_cqes;
+
+		/** The mapped submission queue ring. */
+		void * m_sq_ring;
+		/** The mapped submission queue ring's size. */
+		std::size_t m_sq_ring_size;
+		/** The mapped completion queue ring, if it is mapped separately. */
+		void * m_cq_ring;
+		/** The mapped completion queue ring's size. */
+		std::size_t m_cq_ring_size;
+		/** The mapped submission queue entries' size. */
+		std::size_t m_sqes_size;
+
+		/** The number of queued, but not yet submitted operations. */
+		std::atomic<unsigned> m_queued;
+		/** The number of submitted, but not yet completed operations. */
+		std::atomic_size_t m_in_flight;
+
+		/** Submits the queued operations.
+			The submission queue must be locked. */
+		void flush();
+
+		/** Queues an operation.
+		@param[in] operation:
+			The prepared operation.
+		@return
+			Whether the operation was queued. */
+		bool queue(
+			PODOperation &operation);
+	public:
+		/** The default number of submission queue entries. */
+		static constexpr unsigned kDefaultEntries = 256;
+
+		/** Creates the io_uring instance.
+		@param[in] reactor:
+			The reactor to signal completions to, and to fall back to if io_uring is unavailable.
+		@param[in] entries:
+			The number of submission queue entries, or 0 to always fall back to the reactor. */
+		Ring(
+			Reactor &reactor,
+			unsigned entries = kDefaultEntries);
+		/** Closes the io_uring instance.
+			No operation may be in flight anymore. */
+		~Ring();
+
+		Ring(Ring const&) = delete;
+		Ring &operator=(Ring const&) = delete;
+
+		/** Whether io_uring is used. */
+		inline bool native() const;
+
+		/** Helper class for performing an operation using `#CR_AWAIT`. */
+		class PerformCall
+		{
+			/** The ring to submit to. */
+			Ring &m_ring;
+			/** The operation to perform. */
+			PODOperation &m_operation;
+		public:
+			/** Initialises the perform call.
+			@param[in] ring:
+				The ring to submit to.
+			@param[in] operation:
+				The prepared operation. */
+			constexpr PerformCall(
+				Ring &ring,
+				PODOperation &operation);
+
+			/** Queues the operation, or performs it right away if io_uring is unavailable and the file descriptor is ready.
+			@param[in] coroutine:
+				The coroutine to wait for the operation.
+			@return
+				Whether the call blocks. */
+			[[nodiscard]] sync::mayblock libcr_wait(
+				Coroutine * coroutine);
+		};
+
+		/** Performs a prepared operation. To be used with `#CR_AWAIT`.
+			Afterwards, the operation's result is available.
+		@param[in] operation:
+			The prepared operation. */
+		[[nodiscard]] constexpr PerformCall perform(
+			PODOperation &operation);
+
+		/** The number of queued or submitted operations that did not complete yet. */
+		inline std::size_t pending() const;
+		/** Whether there are queued operations that were not submitted yet. */
+		inline bool queued() const;
+
+		/** Submits all queued operations, and resumes the coroutines whose operations completed.
+			Must only be called by the owning thread.
+		@return
+			The number of resumed coroutines. */
+		std::size_t submit();
+	};
+}
+
+#include "Ring.inl"
+
+#endif
+
+#endif
@@ -0,0 +1,94 @@
+namespace cr::io
+{
+	PODOperation &PODOperation::read(
+		int fd,
+		void * buffer,
+		std::uint32_t length,
+		std::uint64_t offset)
+	{
+		m_opcode = kRead;
+		m_fd = fd;
+		m_buffer = buffer;
+		m_length = length;
+		m_offset = offset;
+		return *this;
+	}
+
+	PODOperation &PODOperation::write(
+		int fd,
+		void const * buffer,
+		std::uint32_t length,
+		std::uint64_t offset)
+	{
+		m_opcode = kWrite;
+		m_fd = fd;
+		m_buffer = const_cast<void *>(buffer);
+		m_length = length;
+		m_offset = offset;
+		return *this;
+	}
+
+	PODOperation &PODOperation::accept(
+		int fd,
+		sockaddr * address,
+		socklen_t * length)
+	{
+		m_opcode = kAccept;
+		m_fd = fd;
+		m_buffer = address;
+		m_address_length = length;
+		m_offset = 0;
+		return *this;
+	}
+
+	PODOperation &PODOperation::fsync(
+		int fd)
+	{
+		m_opcode = kFsync;
+		m_fd = fd;
+		m_buffer = nullptr;
+		m_length = 0;
+		m_offset = 0;
+		return *this;
+	}
+
+	int PODOperation::result() const
+	{
+		return m_result;
+	}
+
+	Operation::Operation()
+	{
+		initialise();
+	}
+
+	bool Ring::native() const
+	{
+		return m_fd != -1;
+	}
+
+	constexpr Ring::PerformCall::PerformCall(
+		Ring &ring,
+		PODOperation &operation):
+		m_ring(ring),
+		m_operation(operation)
+	{
+	}
+
+	constexpr Ring::PerformCall Ring::perform(
+		PODOperation &operation)
+	{
+		return PerformCall(*this, operation);
+	}
+
+	std::size_t Ring::pending() const
+	{
+		return m_queued.load(std::memory_order_relaxed)
+			+ m_in_flight.load(std::memory_order_relaxed);
+	}
+
+	bool Ring::queued() const
+	{
+		return m_queued.load(std::memory_order_relaxed) != 0;
+	}
+}
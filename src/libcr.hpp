@@ -6,12 +6,21 @@
 #include "Coroutine.hpp"
 #include "Context.hpp"
 #include "HybridScheduler.hpp"
+#include "Resumer.hpp"
 #include "Scheduler.hpp"
+#include "Select.hpp"
+#include "Selectable.hpp"
+#include "StealingScheduler.hpp"
+#include "Timeout.hpp"
+#include "TimerWheel.hpp"
+#include "WorkerPool.hpp"
 #include "primitives.hpp"
 
 #include "sync/sync.hpp"
 #include "mt/mt.hpp"
 #include "util/util.hpp"
+#include "io/Reactor.hpp"
+#include "io/Ring.hpp"
 
 /** The libcr namespace. */
 namespace cr
@@ -0,0 +1,190 @@
+/** @file BroadcastRing.hpp
+	Contains the thread-safe single-writer broadcast ring types. */
+#ifndef __libcr_mt_broadcastring_hpp_defined
+#define __libcr_mt_broadcastring_hpp_defined
+
+#include "ConditionVariable.hpp"
+#include "detail/BoundedRing.hpp"
+#include "detail/ParkingLot.hpp"
+#include "detail/SoftMutex.hpp"
+#include "detail/WaiterSlot.hpp"
+#include "../sync/BroadcastRing.hpp"
+#include "../primitives.hpp"
+#include "../util/Backoff.hpp"
+#include "../util/RefConv.hpp"
+
+#include <atomic>
+#include <cstddef>
+
+namespace cr::mt
+{
+	using sync::BroadcastPolicy;
+
+	template<class T, std::size_t kSize, BroadcastPolicy kPolicy = BroadcastPolicy::kBackpressure>
+	/** POD fixed capacity ring that delivers every value to all subscribers, which may run on different threads.
+		The writer stores each value once and wakes all waiting subscribers with a single notification. Every subscriber reads through its own cursor, so subscribers do not contend with each other, and the writer only looks at the cursors when the ring seems full. Only one coroutine may write at a time.
+		With `BroadcastPolicy::kOverwrite`, the writer moves the cursors of lapped subscribers half a ring ahead, so that it only has to look at the cursors every half lap. The writer only waits if a lapped subscriber is copying the oldest value at that moment.
+	@tparam T:
+		The ring's element type. Must be copy assignable.
+	@tparam kSize:
+		The ring's capacity. It is rounded up to a power of two.
+	@tparam kPolicy:
+		What to do when the ring is full. */
+	class PODBroadcastRing
+	{
+	public:
+		/** The ring's actual capacity. */
+		static constexpr std::size_t kCapacity = detail::round_up_pow2(kSize);
+
+		/** A subscriber's reading position.
+			Cursors are provided by the subscribers, usually as part of their coroutine state, and have to stay subscribed while they are in use. */
+		class Cursor
+		{
+			friend class PODBroadcastRing;
+			/** The ring the cursor is subscribed to. */
+			PODBroadcastRing * m_ring;
+			/** The next subscribed cursor. */
+			Cursor * m_next;
+			/** The number of values read or skipped through the cursor, and whether the subscriber is copying a value. */
+			std::atomic_size_t m_sequence;
+			/** The number of values this cursor skipped because they were overwritten. */
+			std::atomic_size_t m_lost;
+		public:
+			/** The number of values this cursor skipped because they were overwritten.
+				Always 0 with `BroadcastPolicy::kBackpressure`. */
+			inline std::size_t lost() const;
+		};
+
+	private:
+		static_assert(kSize > 0, "A ring needs to hold at least one element.");
+		/** Masks indices into the value array. */
+		static constexpr std::size_t kMask = kCapacity - 1;
+		/** Set in a cursor's sequence while its subscriber copies a value, so that the writer does not overwrite it. */
+		static constexpr std::size_t kReading = ~(~std::size_t(0) >> 1);
+		/** How far lapped cursors are moved ahead of the oldest value, and how many slots have to be free before a waiting writer is resumed. */
+		static constexpr std::size_t kSkip = (kCapacity + 1) / 2;
+
+		/** The number of written values. */
+		alignas(64) std::atomic_size_t m_tail;
+		/** A lower bound of the slowest subscriber's sequence. Only updated by the writer when the ring seems full. */
+		std::size_t m_slowest;
+		/** The writer, while it waits for the slowest subscriber.
+			Subscribers only resume it once half of the ring is free, so that the writer does not look at all cursors after every read. */
+		detail::PODWaiterSlot m_writer;
+		/** How to resume waiting coroutines. */
+		Resumer m_resumer;
+		/** Protects the list of cursors. */
+		alignas(64) mutable detail::PODSoftMutex m_mutex;
+		/** The subscribed cursors. */
+		Cursor * m_cursors;
+		/** The subscribers waiting for a value. */
+		alignas(64) detail::PODParkingLot<PODConditionVariable> m_readers;
+		/** The ring's values. */
+		alignas(64) T m_values[kCapacity];
+
+		/** Whether a cursor has a value to read.
+		@param[in] cursor:
+			The cursor. */
+		static bool readable(
+			void const * cursor);
+		/** Whether half of a ring is free.
+		@param[in] ring:
+			The ring. */
+		static bool writable(
+			void const * ring);
+
+		/** The slowest subscriber's sequence, or the tail if there are no subscribers. */
+		std::size_t slowest() const;
+
+		/** Whether the writer has to make room before writing the next value.
+			Refreshes the slowest subscriber's sequence only if necessary. */
+		inline bool full();
+
+		/** Moves lapped cursors ahead, so that the oldest value can be overwritten. */
+		void overwrite();
+
+		template<class V>
+		/** Writes a value and notifies the waiting subscribers. */
+		inline void put(
+			V &&value);
+	public:
+		/** Initialises the ring. */
+		void initialise();
+
+		/** Sets how coroutines waiting for the ring are resumed.
+			By default, they are resumed directly by the writing or reading coroutine. Use a scheduler's `deferred()` resumer to enqueue them instead, so that the notifying coroutine continues right away.
+		@param[in] resumer:
+			How to resume waiting coroutines. */
+		inline void set_resumer(
+			Resumer resumer);
+
+		/** Subscribes a cursor to the ring.
+			The cursor receives all values written after this call.
+		@param[out] cursor:
+			The cursor to subscribe. */
+		void subscribe(
+			Cursor &cursor);
+		/** Unsubscribes a cursor from the ring.
+			Must not be called while a subscriber uses the cursor.
+		@param[in] cursor:
+			The subscribed cursor. */
+		void unsubscribe(
+			Cursor &cursor);
+
+		/** Reads the next value through a cursor, if available.
+			Only one coroutine may read through a cursor at a time.
+		@param[in] cursor:
+			The subscribed cursor.
+		@param[out] target:
+			The location to copy the value to.
+		@return
+			Whether a value was read. */
+		bool try_receive(
+			Cursor &cursor,
+			T &target);
+
+		template<class V>
+		/** Writes a value to the ring.
+			Must only be used by one coroutine at a time.
+		@tparam V:
+			The written value's type. */
+		TEMPLATE_COROUTINE(PublishPattern, (V), void)
+		CR_STATE(
+			(PODBroadcastRing<T, kSize, kPolicy> &) ring,
+			(V) value);
+		CR_EXTERNAL
+
+		union Publish {
+			PublishPattern<T const&> copy;
+			PublishPattern<T &&> move;
+		};
+
+		/** Reads the next value through a cursor, waiting for it if necessary. */
+		COROUTINE(Receive, void)
+		CR_STATE(
+			(PODBroadcastRing<T, kSize, kPolicy> &) ring,
+			(Cursor &) cursor,
+			(T &) target);
+		CR_EXTERNAL
+	};
+
+	template<class T, std::size_t kSize, BroadcastPolicy kPolicy = BroadcastPolicy::kBackpressure>
+	/** Non-POD fixed capacity ring that delivers every value to all subscribers, which may run on different threads.
+	@tparam T:
+		The ring's element type.
+	@tparam kSize:
+		The ring's capacity. It is rounded up to a power of two.
+	@tparam kPolicy:
+		What to do when the ring is full. */
+	class BroadcastRing : public PODBroadcastRing<T, kSize, kPolicy>
+	{
+		using PODBroadcastRing<T, kSize, kPolicy>::initialise;
+	public:
+		/** Initialises the ring. */
+		inline BroadcastRing();
+	};
+}
+
+#include "BroadcastRing.inl"
+
+#endif
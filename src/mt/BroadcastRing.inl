@@ -0,0 +1,226 @@
+#include <cassert>
+
+namespace cr::mt
+{
+	template<class T, std::size_t kSize, BroadcastPolicy kPolicy>
+	std::size_t PODBroadcastRing<T, kSize, kPolicy>::Cursor::lost() const
+	{
+		return m_lost.load(std::memory_order_relaxed);
+	}
+
+	template<class T, std::size_t kSize, BroadcastPolicy kPolicy>
+	bool PODBroadcastRing<T, kSize, kPolicy>::readable(
+		void const * cursor)
+	{
+		Cursor const * self = static_cast<Cursor const *>(cursor);
+		return (self->m_sequence.load(std::memory_order_relaxed) & ~kReading)
+			!= self->m_ring->m_tail.load(std::memory_order_acquire);
+	}
+
+	template<class T, std::size_t kSize, BroadcastPolicy kPolicy>
+	bool PODBroadcastRing<T, kSize, kPolicy>::writable(
+		void const * ring)
+	{
+		PODBroadcastRing<T, kSize, kPolicy> const * self = static_cast<PODBroadcastRing<T, kSize, kPolicy> const *>(ring);
+		return self->m_tail.load(std::memory_order_relaxed) - self->slowest() <= kCapacity - kSkip;
+	}
+
+	template<class T, std::size_t kSize, BroadcastPolicy kPolicy>
+	std::size_t PODBroadcastRing<T, kSize, kPolicy>::slowest() const
+	{
+		std::size_t const tail = m_tail.load(std::memory_order_relaxed);
+		std::size_t slowest = tail;
+
+		detail::LockGuard lock(m_mutex);
+		for(Cursor const * cursor = m_cursors; cursor; cursor = cursor->m_next)
+		{
+			// Acquire, so that the subscriber's copy of a value happens before the value is overwritten.
+			std::size_t const sequence = cursor->m_sequence.load(std::memory_order_acquire) & ~kReading;
+			if(tail - sequence > tail - slowest)
+				slowest = sequence;
+		}
+		return slowest;
+	}
+
+	template<class T, std::size_t kSize, BroadcastPolicy kPolicy>
+	bool PODBroadcastRing<T, kSize, kPolicy>::full()
+	{
+		std::size_t const tail = m_tail.load(std::memory_order_relaxed);
+		if(tail - m_slowest != kCapacity)
+			return false;
+
+		// Sequences only grow, so the cached value stays a lower bound until it is refreshed here.
+		m_slowest = slowest();
+		return tail - m_slowest == kCapacity;
+	}
+
+	template<class T, std::size_t kSize, BroadcastPolicy kPolicy>
+	void PODBroadcastRing<T, kSize, kPolicy>::overwrite()
+	{
+		std::size_t const tail = m_tail.load(std::memory_order_relaxed);
+		std::size_t const oldest = tail - kCapacity;
+		std::size_t const skip_to = oldest + kSkip;
+		std::size_t slowest = tail;
+
+		detail::LockGuard lock(m_mutex);
+		for(Cursor * cursor = m_cursors; cursor; cursor = cursor->m_next)
+		{
+			std::size_t sequence = cursor->m_sequence.load(std::memory_order_acquire);
+			util::Backoff backoff;
+			while(tail - (sequence & ~kReading) > tail - skip_to)
+			{
+				if(sequence & kReading)
+				{
+					// The subscriber copies a value that stays, so leave it alone.
+					if((sequence & ~kReading) != oldest)
+						break;
+					// The subscriber copies the oldest value, which is about to be overwritten.
+					backoff.pause();
+					sequence = cursor->m_sequence.load(std::memory_order_acquire);
+				} else if(cursor->m_sequence.compare_exchange_weak(
+					sequence,
+					skip_to,
+					std::memory_order_acquire,
+					std::memory_order_acquire))
+				{
+					cursor->m_lost.fetch_add(skip_to - sequence, std::memory_order_relaxed);
+					sequence = skip_to;
+				}
+			}
+
+			sequence &= ~kReading;
+			if(tail - sequence > tail - slowest)
+				slowest = sequence;
+		}
+		m_slowest = slowest;
+	}
+
+	template<class T, std::size_t kSize, BroadcastPolicy kPolicy>
+	template<class V>
+	void PODBroadcastRing<T, kSize, kPolicy>::put(
+		V &&value)
+	{
+		std::size_t const tail = m_tail.load(std::memory_order_relaxed);
+		util::assign(m_values[tail & kMask], std::forward<V>(value));
+		m_tail.store(tail + 1, std::memory_order_release);
+		m_readers.unpark_all(m_resumer);
+	}
+
+	template<class T, std::size_t kSize, BroadcastPolicy kPolicy>
+	void PODBroadcastRing<T, kSize, kPolicy>::initialise()
+	{
+		std::atomic_init(&m_tail, (std::size_t) 0);
+		m_slowest = 0;
+		m_writer.initialise();
+		m_resumer = Resumer();
+		m_mutex.initialise();
+		m_cursors = nullptr;
+		m_readers.initialise();
+	}
+
+	template<class T, std::size_t kSize, BroadcastPolicy kPolicy>
+	void PODBroadcastRing<T, kSize, kPolicy>::set_resumer(
+		Resumer resumer)
+	{
+		m_resumer = resumer;
+	}
+
+	template<class T, std::size_t kSize, BroadcastPolicy kPolicy>
+	void PODBroadcastRing<T, kSize, kPolicy>::subscribe(
+		Cursor &cursor)
+	{
+		detail::LockGuard lock(m_mutex);
+		cursor.m_ring = this;
+		std::atomic_init(&cursor.m_sequence, m_tail.load(std::memory_order_acquire));
+		std::atomic_init(&cursor.m_lost, (std::size_t) 0);
+		cursor.m_next = m_cursors;
+		m_cursors = &cursor;
+	}
+
+	template<class T, std::size_t kSize, BroadcastPolicy kPolicy>
+	void PODBroadcastRing<T, kSize, kPolicy>::unsubscribe(
+		Cursor &cursor)
+	{
+		detail::LockGuard lock(m_mutex);
+		Cursor ** link = &m_cursors;
+		while(*link != &cursor)
+		{
+			assert(*link && "The cursor is not subscribed.");
+			link = &(*link)->m_next;
+		}
+		*link = cursor.m_next;
+		lock.unlock();
+
+		// The writer might have waited for this cursor.
+		if(kPolicy == BroadcastPolicy::kBackpressure)
+			m_writer.notify(m_resumer);
+	}
+
+	template<class T, std::size_t kSize, BroadcastPolicy kPolicy>
+	bool PODBroadcastRing<T, kSize, kPolicy>::try_receive(
+		Cursor &cursor,
+		T &target)
+	{
+		std::size_t sequence = cursor.m_sequence.load(std::memory_order_relaxed);
+		if(kPolicy == BroadcastPolicy::kOverwrite)
+		{
+			// Mark the value as being copied, unless the writer moved the cursor ahead in the meantime.
+			do {
+				if(sequence == m_tail.load(std::memory_order_acquire))
+					return false;
+			} while(!cursor.m_sequence.compare_exchange_weak(
+				sequence,
+				sequence | kReading,
+				std::memory_order_acquire,
+				std::memory_order_relaxed));
+		} else if(sequence == m_tail.load(std::memory_order_acquire))
+			return false;
+
+		util::assign(target, m_values[sequence & kMask]);
+		cursor.m_sequence.store(sequence + 1, std::memory_order_release);
+
+		if(kPolicy == BroadcastPolicy::kBackpressure)
+		{
+			// Pairs with the fence in the writer's wait: if the writer missed the new sequence, the tail read here is the one it waits at. Every cursor passes this point at most once per wait.
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if(m_tail.load(std::memory_order_relaxed) - (sequence + 1) == kCapacity - kSkip)
+				m_writer.notify(m_resumer);
+		}
+		return true;
+	}
+
+	template<class T, std::size_t kSize, BroadcastPolicy kPolicy>
+	template<class V>
+	CR_IMPL(PODBroadcastRing<T, kSize, kPolicy>::PublishPattern<V>)
+		if(kPolicy == BroadcastPolicy::kOverwrite)
+		{
+			if(ring->full())
+				ring->overwrite();
+		} else
+		{
+			// Only subscribers free slots, and they notify once half of the ring is free.
+			while(ring->full())
+				CR_AWAIT(ring->m_writer.wait(&writable, ring));
+		}
+		ring->put(std::forward<V>(value));
+	CR_FINALLY
+	CR_IMPL_END
+
+	template<class T, std::size_t kSize, BroadcastPolicy kPolicy>
+	CR_IMPL(PODBroadcastRing<T, kSize, kPolicy>::Receive)
+		while(!ring->try_receive(*cursor, *target))
+		{
+			CR_AWAIT(
+				ring->m_readers.park(&readable, cursor),
+				{ ring->m_readers.leave(); CR_THROW; });
+			ring->m_readers.leave();
+		}
+	CR_FINALLY
+	CR_IMPL_END
+
+	template<class T, std::size_t kSize, BroadcastPolicy kPolicy>
+	BroadcastRing<T, kSize, kPolicy>::BroadcastRing()
+	{
+		initialise();
+	}
+}
@@ -8,6 +8,7 @@ namespace cr::mt
 	{
 		std::atomic_init(&m_first_waiting, (Coroutine *)nullptr);
 		std::atomic_init(&m_last_waiting, (Coroutine *)nullptr);
+		m_timed.initialise();
 	}
 
 	sync::block PODFIFOConditionVariable::WaitCall::libcr_wait(
@@ -17,7 +18,11 @@ namespace cr::mt
 		assert(coroutine != nullptr);
 
 		if(m_invalidate_thread)
-			coroutine->libcr_thread = detail::Thread::kInvalid;
+			coroutine->libcr_thread = cr::detail::Thread::kInvalid;
+
+		// While timeouts are waiting, queue up behind them, so that all waiting coroutines keep one order.
+		if(!m_cv.m_timed.empty() && m_cv.m_timed.push_if_waiting(coroutine, last))
+			return sync::block();
 
 		last->libcr_next_waiting.atomic.release();
 
@@ -48,13 +53,14 @@ namespace cr::mt
 		return sync::block();
 	}
 
-	bool PODFIFOConditionVariable::notify_one()
+	bool PODFIFOConditionVariable::notify_one(
+		Resumer resumer)
 	{
 		Coroutine * removed = remove_one();
 
 		if(removed)
 		{
-			(*removed)();
+			resumer(removed);
 			return true;
 		} else {
 			return false;
@@ -68,7 +74,7 @@ namespace cr::mt
 		if(removed)
 		{
 			removed->libcr_error = true;
-			(*removed)();
+			removed->resume();
 			return true;
 		} else {
 			return false;
@@ -82,8 +88,9 @@ namespace cr::mt
 			nullptr,
 			std::memory_order_relaxed);
 
+		// The lock-free list's coroutines started waiting before the timed waiting list's coroutines.
 		if(!first)
-			return nullptr;
+			return m_timed.pop();
 
 		// No other coroutines can be removed until first is set again.
 
@@ -117,7 +124,8 @@ namespace cr::mt
 		return first;
 	}
 
-	bool PODFIFOConditionVariable::notify_all()
+	bool PODFIFOConditionVariable::notify_all(
+		Resumer resumer)
 	{
 		Coroutine * first, * last;
 		// Return if there are no coroutines.
@@ -130,7 +138,7 @@ namespace cr::mt
 			next = acquire_and_complete(first, last);
 
 			// Notify the coroutine.
-			(*first)();
+			resumer(first);
 			// Set the next coroutine.
 			first = next;
 		} while(next);
@@ -152,7 +160,7 @@ namespace cr::mt
 
 			first->libcr_error = true;
 			// Notify the coroutine.
-			(*first)();
+			first->resume();
 			// Set the next coroutine.
 			first = next;
 		} while(next);
@@ -172,25 +180,36 @@ namespace cr::mt
 			std::memory_order_relaxed);
 		// Now, no further coroutine can be removed while first is null.
 
-		// If there was no first coroutine, then there is nothing to notify.
+		// If there was no first coroutine, then only the timed waiting list can have coroutines.
 		if(!first)
-		{
 			last = nullptr;
-			return false;
-		}
+		else
+		{
+			// We need to watch out for coroutines being added before setting last to null.
 
-		// We need to watch out for coroutines being added before setting last to null.
+			// Remove the last coroutine.
+			last = m_last_waiting.exchange(
+				nullptr,
+				std::memory_order_relaxed);
+			// Now, the queue is empty, and adding a coroutine sets first, unlocking the queue.
 
-		// Remove the last coroutine.
-		last = m_last_waiting.exchange(
-			nullptr,
-			std::memory_order_relaxed);
-		// Now, the queue is empty, and adding a coroutine sets first, unlocking the queue.
+			// Sanity check: The last coroutine should not be null.
+			assert(last != nullptr);
+		}
 
-		// Sanity check: The last coroutine should not be null.
-		assert(last != nullptr);
+		// The timed waiting list's coroutines started waiting after the lock-free list's coroutines.
+		Coroutine * timed_last;
+		if(Coroutine * timed = m_timed.pop_all(timed_last))
+		{
+			if(first)
+				// Nobody else links to the last coroutine anymore, and the exchange keeps its release intact.
+				last->libcr_next_waiting.atomic.update(timed);
+			else
+				first = timed;
+			last = timed_last;
+		}
 
-		return true;
+		return first != nullptr;
 	}
 
 	Coroutine * PODFIFOConditionVariable::acquire_and_complete(
@@ -216,6 +235,39 @@ namespace cr::mt
 
 	}
 
+	sync::block PODFIFOConditionVariable::TimedWaitCall::libcr_wait(
+		Coroutine * coroutine)
+	{
+		assert(coroutine != nullptr);
+
+		// The timing wheel stays locked until the timeout is in the list.
+		Deadline::Registration registration(
+			m_deadline,
+			coroutine,
+			&m_cv,
+			&PODTimeout::remove_from<PODFIFOConditionVariable>);
+
+		if(m_invalidate_thread)
+			coroutine->libcr_thread = cr::detail::Thread::kInvalid;
+
+		m_cv.m_timed.push(registration.timeout());
+
+		return sync::block();
+	}
+
+	void PODFIFOConditionVariable::push_removable(
+		Coroutine * coroutine)
+	{
+		assert(coroutine != nullptr);
+		m_timed.push(coroutine);
+	}
+
+	bool PODFIFOConditionVariable::remove(
+		Coroutine * timeout)
+	{
+		return m_timed.remove(timeout);
+	}
+
 	FIFOConditionVariable::FIFOConditionVariable()
 	{
 		initialise();
@@ -230,6 +282,7 @@ namespace cr::mt
 	void PODConditionVariable::initialise()
 	{
 		std::atomic_init(&m_waiting, (Coroutine *)nullptr);
+		m_timed.initialise();
 	}
 
 	sync::block PODConditionVariable::WaitCall::libcr_wait(
@@ -239,7 +292,7 @@ namespace cr::mt
 		assert(coroutine != nullptr);
 
 		if(m_invalidate_thread)
-			coroutine->libcr_thread = detail::Thread::kInvalid;
+			coroutine->libcr_thread = cr::detail::Thread::kInvalid;
 
 		// Weak load sufficient, as the loop will perform a strong load anyway if necessary.
 		Coroutine * first = m_cv.m_waiting.load(std::memory_order_relaxed);
@@ -259,13 +312,14 @@ namespace cr::mt
 		return sync::block();
 	}
 
-	bool PODConditionVariable::notify_one()
+	bool PODConditionVariable::notify_one(
+		Resumer resumer)
 	{
 		Coroutine * removed = remove_one();
 		if(removed)
 		{
 			// Notify the first removed coroutine.
-			(*removed)();
+			resumer(removed);
 
 			return true;
 		} else
@@ -279,7 +333,7 @@ namespace cr::mt
 		{
 			removed->libcr_error = true;
 			// Notify the first removed coroutine.
-			(*removed)();
+			removed->resume();
 
 			return true;
 		} else
@@ -288,6 +342,9 @@ namespace cr::mt
 
 	Coroutine * PODConditionVariable::remove_one()
 	{
+		if(Coroutine * timeout = m_timed.pop())
+			return timeout;
+
 		// Remove the first coroutine.
 		Coroutine * removed = m_waiting.exchange(
 			nullptr,
@@ -344,14 +401,17 @@ namespace cr::mt
 		return removed;
 	}
 
-	bool PODConditionVariable::notify_all()
+	bool PODConditionVariable::notify_all(
+		Resumer resumer)
 	{
+		bool notified = m_timed.notify_all(false, resumer);
+
 		// Remove the waiting coroutines.
 		Coroutine * first;
 		Coroutine * last;
 		if(!remove_all(first, last))
 		// If there was no coroutine, return.
-			return false;
+			return notified;
 
 		// Now, the queue is empty.
 
@@ -361,7 +421,7 @@ namespace cr::mt
 			// Resume the coroutine and get the next in line.
 			next = acquire_and_complete(first, nullptr);
 			// notify the coroutine.
-			(*first)();
+			resumer(first);
 
 			first = next;
 		} while(next);
@@ -370,12 +430,14 @@ namespace cr::mt
 
 	bool PODConditionVariable::fail_all()
 	{
+		bool notified = m_timed.notify_all(true);
+
 		// Remove the waiting coroutines.
 		Coroutine * first;
 		Coroutine * last;
 		if(!remove_all(first, last))
 		// If there was no coroutine, return.
-			return false;
+			return notified;
 
 		// Now, the queue is empty.
 
@@ -386,7 +448,7 @@ namespace cr::mt
 			next = acquire_and_complete(first, nullptr);
 			first->libcr_error = true;
 			// notify the coroutine.
-			(*first)();
+			first->resume();
 
 			first = next;
 		} while(next);
@@ -416,6 +478,39 @@ namespace cr::mt
 		return coroutine->libcr_next_waiting.atomic.acquire_strong();
 	}
 
+	sync::block PODConditionVariable::TimedWaitCall::libcr_wait(
+		Coroutine * coroutine)
+	{
+		assert(coroutine != nullptr);
+
+		// The timing wheel stays locked until the timeout is in the list.
+		Deadline::Registration registration(
+			m_deadline,
+			coroutine,
+			&m_cv,
+			&PODTimeout::remove_from<PODConditionVariable>);
+
+		if(m_invalidate_thread)
+			coroutine->libcr_thread = cr::detail::Thread::kInvalid;
+
+		m_cv.m_timed.push(registration.timeout());
+
+		return sync::block();
+	}
+
+	void PODConditionVariable::push_removable(
+		Coroutine * coroutine)
+	{
+		assert(coroutine != nullptr);
+		m_timed.push(coroutine);
+	}
+
+	bool PODConditionVariable::remove(
+		Coroutine * timeout)
+	{
+		return m_timed.remove(timeout);
+	}
+
 	ConditionVariable::ConditionVariable()
 	{
 		initialise();
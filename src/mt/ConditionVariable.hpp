@@ -4,6 +4,9 @@
 #define __libcr_mt_conditionvariable_hpp_defined
 
 #include "../sync/Block.hpp"
+#include "../Timeout.hpp"
+#include "../Resumer.hpp"
+#include "detail/TimedWaitList.hpp"
 
 #include <atomic>
 
@@ -16,13 +19,16 @@ namespace cr
 
 namespace cr::mt
 {
-	/** Threadsafe POD condition variable with FIFO notifications. */
+	/** Threadsafe POD condition variable with FIFO notifications.
+		Timed and untimed waiters are notified in the order they started waiting: while timed waiters are in the removable waiting list, untimed waiters queue up behind them in that list. */
 	class PODFIFOConditionVariable
 	{
 		/** The first waiting coroutine. */
 		std::atomic<Coroutine *> m_first_waiting;
 		/** The last waiting coroutine. */
 		std::atomic<Coroutine *> m_last_waiting;
+		/** The timeouts of the timed waiting coroutines. */
+		detail::PODTimedWaitList m_timed;
 	public:
 		/** Initialises the condition variable. */
 		void initialise();
@@ -65,11 +71,71 @@ namespace cr::mt
 		[[nodiscard]] constexpr WaitCall wait(
 			bool invalidate_thread = true);
 
+		/** Helper class for waiting for a condition variable with a timeout using `#CR_AWAIT`. */
+		class TimedWaitCall
+		{
+			/** The condition variable to wait for. */
+			PODFIFOConditionVariable &m_cv;
+			/** The deadline of the wait. */
+			Deadline m_deadline;
+			/** Whether to invalidate the waiting coroutine's thread. */
+			bool m_invalidate_thread;
+		public:
+			/** Initialises the timed wait call.
+			@param[in] cv:
+				The condition variable to wait for.
+			@param[in] deadline:
+				The deadline of the wait.
+			@param[in] invalidate_thread:
+				Whether to invalidate the waiting coroutine's thread. */
+			constexpr TimedWaitCall(
+				PODFIFOConditionVariable &cv,
+				Deadline const& deadline,
+				bool invalidate_thread);
+
+			/** Adds a coroutine's timeout to the timed waiting list, and registers it with the scheduler.
+			@param[in] coroutine:
+				The coroutine to wait.
+			@return
+				Whether the call blocks. */
+			[[nodiscard]] sync::block libcr_wait(
+				Coroutine * coroutine);
+		};
+
+		/** Adds a coroutine to the queue until it is notified or the deadline expires.
+			On expiry, the coroutine is removed from the queue and resumed with its error flag set.
+		@param[in] deadline:
+			The deadline of the wait, as created by the scheduler.
+		@param[in] invalidate_thread:
+			Whether to invalidate the waiting coroutine's thread. */
+		[[nodiscard]] constexpr TimedWaitCall wait_for(
+			Deadline const& deadline,
+			bool invalidate_thread = true);
+
+		/** Adds a coroutine to the timed waiting list without a deadline, so that it can be removed again with `remove()`.
+			Used by waits that register in several places at once, such as `cr::PODSelect`. The coroutine's thread is not changed.
+		@param[in] coroutine:
+			The coroutine to add. */
+		void push_removable(
+			Coroutine * coroutine);
+
+		/** Removes a timed waiting coroutine's timeout, or a coroutine added with `push_removable()`, from the queue.
+			Does not notify the removed coroutine. Untimed waiting coroutines cannot be removed.
+		@param[in] timeout:
+			The timeout or coroutine to remove.
+		@return
+			Whether it was still waiting. */
+		bool remove(
+			Coroutine * timeout);
+
 		/** Notifies the first waiting coroutine, if exists.
 			Removes the notified coroutine from the waiting queue.
+		@param[in] resumer:
+			How to resume the notified coroutine.
 		@return
 			Whether a coroutine was notified. */
-		bool notify_one();
+		bool notify_one(
+			Resumer resumer = Resumer());
 
 		/** Notifies the first waiting coroutine, if exists, and sets its error flag.
 			Removes the notified coroutine from the waiting queue.
@@ -85,9 +151,12 @@ namespace cr::mt
 
 		/** Notifies all waiting coroutines.
 			Only notifies and removes coroutines that were waiting before the call, not those added during the call.
+		@param[in] resumer:
+			How to resume the notified coroutines.
 		@return
 			Whether any coroutines were notified. */
-		bool notify_all();
+		bool notify_all(
+			Resumer resumer = Resumer());
 
 		/** Notifies all waiting coroutines, and sets their error flags.
 			Only notifies and removes coroutines that were waiting before the call, not those added during the call.
@@ -96,7 +165,7 @@ namespace cr::mt
 		bool fail_all();
 
 		/** Removes the all waiting coroutines from the waiting queue.
-			`acquire_and_complete()` needs to be called on all removed coroutines before accessing them. No coroutine is acquired or executed.
+			Timed waiting coroutines are removed as their timeouts, which resume their coroutines when executed. `acquire_and_complete()` needs to be called on all removed coroutines before accessing them. No coroutine is acquired or executed.
 		@param[out] first:
 			The first removed coroutine.
 		@param[out] last:
@@ -134,11 +203,13 @@ namespace cr::mt
 	};
 
 	/** Threadsafe POD condition variable without notification ordering guarantees.
-		As long as only `notify_all()` is used, and not `notify_one()`, the coroutines are guaranteed to be notified in LIFO order. `notify_one()` can reorder the queue under certain circumstances. */
+		As long as only `notify_all()` is used, and not `notify_one()`, the coroutines are guaranteed to be notified in LIFO order. `notify_one()` can reorder the queue under certain circumstances. Timed waiters are notified before untimed ones, in FIFO order. */
 	class PODConditionVariable
 	{
 		/** The latest waiting coroutine. */
 		std::atomic<Coroutine *> m_waiting;
+		/** The timeouts of the timed waiting coroutines. */
+		detail::PODTimedWaitList m_timed;
 	public:
 		/** Initialises the condition variable. */
 		void initialise();
@@ -182,11 +253,71 @@ namespace cr::mt
 		[[nodiscard]] constexpr WaitCall wait(
 			bool invalidate_thread = true);
 
+		/** Helper class for waiting for a condition variable with a timeout using `#CR_AWAIT`. */
+		class TimedWaitCall
+		{
+			/** The condition variable to wait for. */
+			PODConditionVariable &m_cv;
+			/** The deadline of the wait. */
+			Deadline m_deadline;
+			/** Whether to invalidate the waiting coroutine's thread. */
+			bool m_invalidate_thread;
+		public:
+			/** Initialises the timed wait call.
+			@param[in] cv:
+				The condition variable to wait for.
+			@param[in] deadline:
+				The deadline of the wait.
+			@param[in] invalidate_thread:
+				Whether to invalidate the waiting coroutine's thread. */
+			constexpr TimedWaitCall(
+				PODConditionVariable &cv,
+				Deadline const& deadline,
+				bool invalidate_thread);
+
+			/** Adds a coroutine's timeout to the timed waiting list, and registers it with the scheduler.
+			@param[in] coroutine:
+				The coroutine to wait.
+			@return
+				Whether the call blocks. */
+			[[nodiscard]] sync::block libcr_wait(
+				Coroutine * coroutine);
+		};
+
+		/** Adds a coroutine to the queue until it is notified or the deadline expires.
+			On expiry, the coroutine is removed from the queue and resumed with its error flag set.
+		@param[in] deadline:
+			The deadline of the wait, as created by the scheduler.
+		@param[in] invalidate_thread:
+			Whether to invalidate the waiting coroutine's thread. */
+		[[nodiscard]] constexpr TimedWaitCall wait_for(
+			Deadline const& deadline,
+			bool invalidate_thread = true);
+
+		/** Adds a coroutine to the timed waiting list without a deadline, so that it can be removed again with `remove()`.
+			Used by waits that register in several places at once, such as `cr::PODSelect`. The coroutine's thread is not changed.
+		@param[in] coroutine:
+			The coroutine to add. */
+		void push_removable(
+			Coroutine * coroutine);
+
+		/** Removes a timed waiting coroutine's timeout, or a coroutine added with `push_removable()`, from the queue.
+			Does not notify the removed coroutine. Untimed waiting coroutines cannot be removed.
+		@param[in] timeout:
+			The timeout or coroutine to remove.
+		@return
+			Whether it was still waiting. */
+		bool remove(
+			Coroutine * timeout);
+
 		/** Notifies the first waiting coroutine, if exists.
 			Removes the notified coroutine from the waiting queue.
+		@param[in] resumer:
+			How to resume the notified coroutine.
 		@return
 			Whether a coroutine was notified. */
-		bool notify_one();
+		bool notify_one(
+			Resumer resumer = Resumer());
 
 		/** Notifies the first waiting coroutine, if exists, and sets its error flag.
 			Removes the notified coroutine from the waiting queue.
@@ -202,9 +333,12 @@ namespace cr::mt
 
 		/** Notifies all waiting coroutines.
 			Only notifies and removes coroutines that were waiting before the call, not those added during the call.
+		@param[in] resumer:
+			How to resume the notified coroutines.
 		@return
 			Whether any coroutines were notified. */
-		bool notify_all();
+		bool notify_all(
+			Resumer resumer = Resumer());
 
 		/** Notifies all waiting coroutines, and sets their error flags.
 			Only notifies and removes coroutines that were waiting before the call, not those added during the call.
@@ -212,7 +346,7 @@ namespace cr::mt
 			Whether a coroutine was notified. */
 		bool fail_all();
 
-		/** Removes the all waiting coroutines from the waiting queue.
+		/** Removes the all untimed waiting coroutines from the waiting queue.
 			`resume_and_wait_for_completion()` needs to be called on all removed coroutines before accessing them. No coroutine is acquired or executed.
 		@param[out] first:
 			The first removed coroutine.
@@ -1,5 +1,12 @@
 namespace cr::mt
 {
+	bool PODFIFOConditionVariable::empty() const
+	{
+		// The last waiting coroutine is set first when adding, and cleared last when removing.
+		return !m_last_waiting.load(std::memory_order_relaxed)
+			&& m_timed.empty();
+	}
+
 	constexpr PODFIFOConditionVariable::WaitCall::WaitCall(
 		PODFIFOConditionVariable &cv,
 		bool invalidate_thread):
@@ -14,6 +21,29 @@ namespace cr::mt
 		return WaitCall(*this, invalidate_thread);
 	}
 
+	constexpr PODFIFOConditionVariable::TimedWaitCall::TimedWaitCall(
+		PODFIFOConditionVariable &cv,
+		Deadline const& deadline,
+		bool invalidate_thread):
+		m_cv(cv),
+		m_deadline(deadline),
+		m_invalidate_thread(invalidate_thread)
+	{
+	}
+
+	constexpr PODFIFOConditionVariable::TimedWaitCall PODFIFOConditionVariable::wait_for(
+		Deadline const& deadline,
+		bool invalidate_thread)
+	{
+		return TimedWaitCall(*this, deadline, invalidate_thread);
+	}
+
+	bool PODConditionVariable::empty() const
+	{
+		return !m_waiting.load(std::memory_order_relaxed)
+			&& m_timed.empty();
+	}
+
 	constexpr PODConditionVariable::WaitCall::WaitCall(
 		PODConditionVariable &cv,
 		bool invalidate_thread):
@@ -27,4 +57,21 @@ namespace cr::mt
 	{
 		return WaitCall(*this, invalidate_thread);
 	}
+
+	constexpr PODConditionVariable::TimedWaitCall::TimedWaitCall(
+		PODConditionVariable &cv,
+		Deadline const& deadline,
+		bool invalidate_thread):
+		m_cv(cv),
+		m_deadline(deadline),
+		m_invalidate_thread(invalidate_thread)
+	{
+	}
+
+	constexpr PODConditionVariable::TimedWaitCall PODConditionVariable::wait_for(
+		Deadline const& deadline,
+		bool invalidate_thread)
+	{
+		return TimedWaitCall(*this, deadline, invalidate_thread);
+	}
 }
\ No newline at end of file
@@ -1,6 +1,9 @@
 #include "Event.hpp"
 #include "../Coroutine.hpp"
 
+#include <cassert>
+#include <type_traits>
+
 namespace cr::mt
 {
 	template<class ConditionVariable>
@@ -8,83 +11,166 @@ namespace cr::mt
 		bool active)
 	{
 		m_cv.initialise();
-		std::atomic_init(&m_active, active);
-		std::atomic_init(&m_registering, (std::size_t) 0);
-		m_mutex.initialise();
+		std::atomic_init(&m_state, active ? kFired : std::uintptr_t(0));
+		std::atomic_init(&m_fires, (std::uint32_t) 0);
 	}
 
 	template<class ConditionVariable>
-	void PODEventPattern<ConditionVariable>::fire()
+	bool PODEventPattern<ConditionVariable>::push(
+		Coroutine * coroutine,
+		bool consume)
 	{
+		cr::detail::Thread const thread = coroutine->libcr_thread;
+		// The coroutine might be resumed by any thread as soon as it is in the list.
+		coroutine->libcr_thread = cr::detail::Thread::kInvalid;
+
+		std::uintptr_t state = m_state.load(std::memory_order_acquire);
 		for(;;)
 		{
-			// If there are registering coroutines, try again.
-			if(m_registering.load_strong(std::memory_order_relaxed))
-				continue;
-
-			// Otherwise, lock the event.
-			detail::LockGuard lock { m_mutex };
-			// If there are registering coroutines, try again.
-			if(m_registering.load_strong(std::memory_order_relaxed))
-				continue;
-
-			// Otherwise, set the event to active.
-			m_active.store(true, std::memory_order_release);
-			break;
+			if(state == kFired)
+			{
+				if(consume && !m_state.compare_exchange_weak(
+					state,
+					0,
+					std::memory_order_acquire,
+					std::memory_order_acquire))
+					continue;
+
+				coroutine->libcr_thread = thread;
+				return false;
+			}
+
+			// Release the coroutine and set its successor to be the first waiting coroutine.
+			if(state)
+				coroutine->libcr_next_waiting.atomic.release_with_next(reinterpret_cast<Coroutine *>(state));
+			else
+				coroutine->libcr_next_waiting.atomic.release();
+
+			if(m_state.compare_exchange_weak(
+				state,
+				reinterpret_cast<std::uintptr_t>(coroutine),
+				std::memory_order_release,
+				std::memory_order_acquire))
+				return true;
+		}
+	}
+
+	template<class ConditionVariable>
+	void PODEventPattern<ConditionVariable>::fire()
+	{
+		std::uintptr_t const state = m_state.exchange(kFired, std::memory_order_acq_rel);
+		m_fires.fetch_add(1, std::memory_order_release);
+
+		// Timed waiting coroutines either see the new fire count, or are seen here.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if(!m_cv.empty())
+			m_cv.notify_all();
+
+		if(state == kFired || !state)
+			return;
+
+		Coroutine * waiting = reinterpret_cast<Coroutine *>(state);
+		if constexpr(std::is_same_v<ConditionVariable, PODFIFOConditionVariable>)
+		{
+			// The list starts with the most recently waiting coroutine.
+			Coroutine * reversed = nullptr;
+			do {
+				Coroutine * const next = waiting->libcr_next_waiting.atomic.acquire_strong();
+				waiting->libcr_next_waiting.atomic.update(reversed);
+				reversed = waiting;
+				waiting = next;
+			} while(waiting);
+			waiting = reversed;
 		}
 
-		m_cv.notify_all();
+		do {
+			// Get the next coroutine before the notified one reuses its pointer.
+			Coroutine * const next = waiting->libcr_next_waiting.atomic.acquire_strong();
+			waiting->resume();
+			waiting = next;
+		} while(waiting);
 	}
 
 	template<class ConditionVariable>
 	void PODEventPattern<ConditionVariable>::clear()
 	{
-		m_active.store(false, std::memory_order_relaxed);
+		// Waiting coroutines imply an inactive event.
+		std::uintptr_t state = kFired;
+		m_state.compare_exchange_strong(
+			state,
+			0,
+			std::memory_order_relaxed,
+			std::memory_order_relaxed);
 	}
 
 	template<class ConditionVariable>
 	sync::mayblock PODEventPattern<ConditionVariable>::WaitCall::libcr_wait(
 		Coroutine * coroutine)
 	{
-		// `compare_exchange_strong` is used to enforce stronger synchronisation than `load`.
-		bool active = true;
-		// Fetch whether the event is active now.
-		m_event.m_active.compare_exchange_strong(
-			active,
-			active,
-			std::memory_order_acquire, // Acquire if event is active.
-			std::memory_order_relaxed);
-		// Return if it is active.
-		if(active)
+		if(m_event.active())
 			return sync::nonblock();
 
-		// Lock the event.
-		detail::LockGuard lock { m_event.m_mutex };
-		// Fetch whether the event is active now.
-		active = true;
-		m_event.m_active.compare_exchange_strong(
-			active,
-			active,
-			std::memory_order_acquire, // Acquire if event is active.
-			std::memory_order_relaxed);
-		// Return if it is active.
-		if(active)
+		if(m_event.push(coroutine, false))
+			return sync::block();
+		else
 			return sync::nonblock();
+	}
 
-		// Increment the registering count.
-		m_event.m_registering.fetch_add(1, std::memory_order_relaxed);
+	template<class ConditionVariable>
+	sync::mayblock PODEventPattern<ConditionVariable>::TimedWaitCall::libcr_wait(
+		Coroutine * coroutine)
+	{
+		std::uint32_t const fires = m_event.m_fires.load(std::memory_order_acquire);
+		if(m_event.active())
+			return sync::nonblock();
 
-		// Unlock the event.
-		lock.unlock();
+		cr::detail::Thread const thread = coroutine->libcr_thread;
+		// Register the coroutine's timeout instead of the coroutine.
+		(void) m_event.m_cv.wait_for(m_deadline).libcr_wait(coroutine);
+
+		// If the event was fired while registering, it might have missed the timeout.
+		// Only take back this wait's own timeout: the other timeouts might have started waiting after the event was cleared again.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if(m_event.m_fires.load(std::memory_order_relaxed) != fires
+		&& m_deadline.withdraw())
+		{
+			coroutine->libcr_thread = thread;
+			return sync::nonblock();
+		}
 
-		// Register the coroutine.
-		coroutine->libcr_unpack_wait(m_event.m_cv.wait());
-		// Decrement the registering count.
-		// Release because the operation must not be reordered.
-		m_event.m_registering.fetch_sub(1, std::memory_order_release);
 		return sync::block();
 	}
 
+	template<class ConditionVariable>
+	void PODEventPattern<ConditionVariable>::select_add(
+		void * event,
+		Coroutine * node)
+	{
+		PODEventPattern<ConditionVariable> &self = *static_cast<PODEventPattern<ConditionVariable> *>(event);
+		std::uint32_t const fires = self.m_fires.load(std::memory_order_acquire);
+		if(self.active())
+		{
+			node->resume();
+			return;
+		}
+
+		self.m_cv.push_removable(node);
+
+		// If the event was fired while registering, it might have missed the node, so notify it here unless it was notified.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if(self.m_fires.load(std::memory_order_relaxed) != fires
+		&& self.m_cv.remove(node))
+			node->resume();
+	}
+
+	template<class ConditionVariable>
+	bool PODEventPattern<ConditionVariable>::select_remove(
+		void * event,
+		Coroutine * node)
+	{
+		return static_cast<PODEventPattern<ConditionVariable> *>(event)->m_cv.remove(node);
+	}
+
 	template<class ConditionVariable>
 	EventPattern<ConditionVariable>::EventPattern()
 	{
@@ -92,78 +178,173 @@ namespace cr::mt
 	}
 
 	template<class ConditionVariable>
-	void PODConsumableEventPattern<ConditionVariable>::fire()
+	void PODConsumableEventPattern<ConditionVariable>::initialise(
+		bool active)
 	{
-		if(m_cv.notify_one())
-			return;
+		PODEventPattern<ConditionVariable>::initialise(active);
+		m_queue = nullptr;
+		std::atomic_init(&m_pending, (std::uint32_t) 0);
+	}
 
+	template<class ConditionVariable>
+	void PODConsumableEventPattern<ConditionVariable>::serve()
+	{
 		for(;;)
 		{
-			// If there are registering coroutines, try again.
-			if(m_registering.load_strong(std::memory_order_relaxed))
-				continue;
+			if(!m_queue)
+			{
+				std::uintptr_t state = m_state.load(std::memory_order_relaxed);
+				for(;;)
+				{
+					if(state == kFired)
+						return;
 
-			// Otherwise, lock the event.
-			detail::LockGuard lock { m_mutex };
+					if(!state)
+					{
+						// The coroutines in the condition variable started waiting after those in the waiting list.
+						if(m_cv.notify_one())
+							return;
 
-			// If there are registering coroutines, try again.
-			if(m_registering.load_strong(std::memory_order_relaxed))
-				continue;
+						if(m_state.compare_exchange_weak(
+							state,
+							kFired,
+							std::memory_order_release,
+							std::memory_order_relaxed))
+							break;
+					} else if(m_state.compare_exchange_weak(
+						state,
+						0,
+						std::memory_order_acquire,
+						std::memory_order_relaxed))
+					{
+						// Take all coroutines that started waiting so far.
+						Coroutine * waiting = reinterpret_cast<Coroutine *>(state);
+						if constexpr(std::is_same_v<ConditionVariable, PODFIFOConditionVariable>)
+						{
+							// The list starts with the most recently waiting coroutine.
+							Coroutine * reversed = nullptr;
+							do {
+								Coroutine * const next = waiting->libcr_next_waiting.atomic.acquire_strong();
+								waiting->libcr_next_waiting.atomic.update(reversed);
+								reversed = waiting;
+								waiting = next;
+							} while(waiting);
+							waiting = reversed;
+						}
+						m_queue = waiting;
+						break;
+					}
+				}
 
-			// Once more, try to remove a coroutine.
-			Coroutine * removed = m_cv.remove_one();
-			if(removed)
-			{
-				lock.unlock();
-				m_cv.acquire_and_complete(removed, removed);
-				(*removed)();
-				return;
-			} else
-			{
-				// Otherwise, set the event to active.
-				m_active.exchange(true, std::memory_order_release);
-				return;
+				if(!m_queue)
+				{
+					// A coroutine entering the condition variable might have missed the event while registering.
+					std::atomic_thread_fence(std::memory_order_seq_cst);
+					if(m_cv.empty() || !try_consume())
+						return;
+					continue;
+				}
 			}
+
+			// Get the next coroutine before the notified one reuses its pointer.
+			Coroutine * const notified = m_queue;
+			m_queue = notified->libcr_next_waiting.atomic.acquire_strong();
+			notified->resume();
+			return;
 		}
 	}
 
+	template<class ConditionVariable>
+	void PODConsumableEventPattern<ConditionVariable>::fire()
+	{
+		// Another call is serving the pending fires, and will also serve this one.
+		if(m_pending.fetch_add(1, std::memory_order_acquire))
+			return;
+
+		// Notified coroutines that fire the event again only add to the pending fires, so the queue is never accessed recursively.
+		do {
+			serve();
+		} while(m_pending.fetch_sub(1, std::memory_order_acq_rel) != 1);
+	}
+
 	template<class ConditionVariable>
 	sync::mayblock PODConsumableEventPattern<ConditionVariable>::ConsumeCall::libcr_wait(
 		Coroutine * coroutine)
 	{
-		// Set the event to inactive.
-		// Return if the event was active.
 		if(m_event.try_consume())
 			return sync::nonblock();
 
-		// Lock the event.
-		detail::LockGuard lock { m_event.m_mutex };
-		// Set the event to inactive.
-		// Return if the event was active.
+		// While timed consumers wait, queue up behind them, so that all consumers keep one order.
+		if(!m_event.m_cv.empty())
+		{
+			(void) m_event.m_cv.wait().libcr_wait(coroutine);
+
+			// If the event was fired while registering, it might have missed the coroutine, so fire it again.
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if(m_event.try_consume())
+				m_event.fire();
+
+			return sync::block();
+		}
+
+		if(m_event.push(coroutine, true))
+			return sync::block();
+		else
+			return sync::nonblock();
+	}
+
+	template<class ConditionVariable>
+	sync::mayblock PODConsumableEventPattern<ConditionVariable>::TimedConsumeCall::libcr_wait(
+		Coroutine * coroutine)
+	{
 		if(m_event.try_consume())
 			return sync::nonblock();
 
-		// Increment the registering count.
-		m_event.m_registering.fetch_add(1, std::memory_order_relaxed);
-		// Unlock the event.
-		lock.unlock();
+		// Register the coroutine's timeout instead of the coroutine.
+		(void) m_event.m_cv.wait_for(m_deadline).libcr_wait(coroutine);
 
-		// Register the coroutine.
-		(void) m_event.m_cv.wait().libcr_wait(coroutine);
+		// If the event was fired while registering, it might have missed the timeout, so fire it again.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if(m_event.try_consume())
+			m_event.fire();
 
-		// Decrement the registering count.
-		// Release, because the operation must not be reordered.
-		m_event.m_registering.fetch_sub(1, std::memory_order_release);
 		return sync::block();
 	}
 
+	template<class ConditionVariable>
+	void PODConsumableEventPattern<ConditionVariable>::select_add(
+		void * event,
+		Coroutine * node)
+	{
+		PODConsumableEventPattern<ConditionVariable> &self = *static_cast<PODConsumableEventPattern<ConditionVariable> *>(event);
+		if(self.try_consume())
+		{
+			node->resume();
+			return;
+		}
+
+		self.m_cv.push_removable(node);
+
+		// If the event was fired while registering, it might have missed the node, so fire it again.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if(self.try_consume())
+			self.fire();
+	}
+
+	template<class ConditionVariable>
+	void PODConsumableEventPattern<ConditionVariable>::select_release(
+		void * event)
+	{
+		static_cast<PODConsumableEventPattern<ConditionVariable> *>(event)->fire();
+	}
+
 	template<class ConditionVariable>
 	bool PODConsumableEventPattern<ConditionVariable>::try_consume()
 	{
-		bool active = true;
-		return m_active.compare_exchange_strong(
-			active,
-			false,
+		std::uintptr_t state = kFired;
+		return m_state.compare_exchange_strong(
+			state,
+			0,
 			std::memory_order_acquire,
 			std::memory_order_relaxed);
 	}
@@ -183,4 +364,4 @@ namespace cr::mt
 	template class EventPattern<PODFIFOConditionVariable>;
 	template class ConsumableEventPattern<PODConditionVariable>;
 	template class ConsumableEventPattern<PODFIFOConditionVariable>;
-}
\ No newline at end of file
+}
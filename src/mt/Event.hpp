@@ -4,8 +4,10 @@
 #define __libcr_mt_event_hpp_defined
 
 #include "ConditionVariable.hpp"
-#include "detail/SoftMutex.hpp"
-#include "../util/Atomic.hpp"
+#include "../Selectable.hpp"
+
+#include <atomic>
+#include <cstdint>
 
 namespace cr::mt
 {
@@ -14,19 +16,51 @@ namespace cr::mt
 
 	template<class ConditionVariable>
 	/** Threadsafe POD repeatable event type.
+		Whether the event happened and the list of waiting coroutines share a single atomic word, so that waiting and firing are lock-free. Only timed and selected waits go through the condition variable, as their timeouts and select nodes need to be removable. Consumers of consumable events that start waiting while timed consumers wait queue up behind them in the condition variable, so that consumers are notified in the order they started waiting.
 	@tparam ConditionVariable:
-		Which condition variable flavour to use. */
+		Which condition variable flavour to use. Determines whether waiting coroutines are notified in LIFO or FIFO order. */
 	class PODEventPattern
 	{
 		friend class PODConsumableEventPattern<ConditionVariable>;
-		/** The event's condition variable. */
+
+		/** The state of an active event. Otherwise, the state points to the most recently waiting coroutine, or is null. */
+		static constexpr std::uintptr_t kFired = 1;
+
+		/** The event's condition variable, holding the timed waiting coroutines. */
 		ConditionVariable m_cv;
-		/** Whether the event happened. */
-		std::atomic_bool m_active;
-		/** Number of currently registering coroutines. */
-		util::Atomic<std::size_t> m_registering;
-		/** Userspace mutex. */
-		detail::PODSoftMutex m_mutex;
+		/** The event's state. */
+		std::atomic<std::uintptr_t> m_state;
+		/** The number of times the event was fired, so that timed waiting coroutines notice a `fire()` even if the event was cleared again before they finished registering. */
+		std::atomic<std::uint32_t> m_fires;
+
+		/** Adds a coroutine to the event's waiting list, unless the event is active.
+		@param[in] coroutine:
+			The coroutine to add.
+		@param[in] consume:
+			Whether to clear the event if it is active.
+		@return
+			Whether the coroutine was added. */
+		bool push(
+			Coroutine * coroutine,
+			bool consume);
+		/** Adds a select node to the event's condition variable, or notifies it if the event is active.
+		@param[in] event:
+			The event.
+		@param[in] node:
+			The node to add. */
+		static void select_add(
+			void * event,
+			Coroutine * node);
+		/** Removes a select node from the event's condition variable.
+		@param[in] event:
+			The event.
+		@param[in] node:
+			The node to remove.
+		@return
+			Whether the node was still waiting. */
+		static bool select_remove(
+			void * event,
+			Coroutine * node);
 	public:
 		/** Initialises the event.
 		@param[in] active:
@@ -68,6 +102,44 @@ namespace cr::mt
 		/** Waits until the event happens.
 			If has not yet happened, blocks the coroutine until the event happens. To be used with `#CR_AWAIT`. */
 		[[nodiscard]] constexpr WaitCall wait();
+
+		/** Helper class for waiting for an event with a timeout using `#CR_AWAIT`. */
+		class TimedWaitCall
+		{
+			/** The event to wait for. */
+			PODEventPattern<ConditionVariable> &m_event;
+			/** The deadline of the wait. */
+			Deadline m_deadline;
+		public:
+			/** Initialises the timed wait call.
+			@param[in] event:
+				The event to wait for.
+			@param[in] deadline:
+				The deadline of the wait. */
+			constexpr TimedWaitCall(
+				PODEventPattern<ConditionVariable> &event,
+				Deadline const& deadline);
+
+			/** Waits for the event until the deadline expires.
+				Blocks if the event did not happen yet.
+			@param[in] coroutine:
+				The coroutine to wait for the event.
+			@return
+				Whether the call blocks. */
+			[[nodiscard]] sync::mayblock libcr_wait(
+				Coroutine * coroutine);
+		};
+
+		/** Waits until the event happens or the deadline expires.
+			If has not yet happened, blocks the coroutine until the event happens, and fails if the deadline expires first. To be used with `#CR_AWAIT`.
+		@param[in] deadline:
+			The deadline of the wait, as created by the scheduler. */
+		[[nodiscard]] constexpr TimedWaitCall wait_for(
+			Deadline const& deadline);
+
+		/** Describes how `Select` waits for the event.
+			A selected wait finishes like `wait()`. Like timed waits, it goes through the condition variable. */
+		[[nodiscard]] inline Selectable select_wait();
 	};
 
 	template<class ConditionVariable>
@@ -80,6 +152,8 @@ namespace cr::mt
 		using PODEventPattern<ConditionVariable>::fire;
 		using PODEventPattern<ConditionVariable>::clear;
 		using PODEventPattern<ConditionVariable>::wait;
+		using PODEventPattern<ConditionVariable>::wait_for;
+		using PODEventPattern<ConditionVariable>::select_wait;
 		using PODEventPattern<ConditionVariable>::active;
 
 		/** Initialises the event. */
@@ -89,17 +163,45 @@ namespace cr::mt
 	template<class ConditionVariable>
 	class PODConsumableEventPattern : PODEventPattern<ConditionVariable>
 	{
+		using PODEventPattern<ConditionVariable>::kFired;
 		using PODEventPattern<ConditionVariable>::m_cv;
-		using PODEventPattern<ConditionVariable>::m_active;
-		using PODEventPattern<ConditionVariable>::m_registering;
-		using PODEventPattern<ConditionVariable>::m_mutex;
+		using PODEventPattern<ConditionVariable>::m_state;
+		using PODEventPattern<ConditionVariable>::push;
+
+		/** The coroutines taken from the waiting list, in the order they are notified. Only accessed by the `fire()` call that serves the pending fires. */
+		Coroutine * m_queue;
+		/** The number of `fire()` calls that were not served yet. The call that raises it from zero serves all of them, so that only one call at a time takes coroutines from the queue. */
+		std::atomic<std::uint32_t> m_pending;
+
+		/** Serves a single `fire()` call.
+			Notifies the next queued coroutine. If the queue is empty, takes the waiting list into it first. Sets the event if no coroutine is waiting. */
+		void serve();
+		using PODEventPattern<ConditionVariable>::select_remove;
+
+		/** Adds a select node to the event's condition variable, or notifies it after consuming the event if it is active.
+		@param[in] event:
+			The event.
+		@param[in] node:
+			The node to add. */
+		static void select_add(
+			void * event,
+			Coroutine * node);
+		/** Passes on a consumption that a select node kept but does not use.
+		@param[in] event:
+			The event. */
+		static void select_release(
+			void * event);
 	public:
-		using PODEventPattern<ConditionVariable>::initialise;
+		/** Initialises the event.
+		@param[in] active:
+			Whether the event should be active from the beginning. */
+		void initialise(
+			bool active = false);
 		using PODEventPattern<ConditionVariable>::clear;
 		using PODEventPattern<ConditionVariable>::active;
 
 		/** Notifies only one coroutine.
-			The event is only set if no coroutine is waiting. */
+			The coroutines in the waiting list are notified before those in the condition variable, as they started waiting earlier. The event is only set if no coroutine is waiting. While another `fire()` call is in progress, that call performs the notification instead. */
 		void fire();
 
 		/** Helper class for waiting for a consumable event using `#CR_AWAIT`. */
@@ -126,6 +228,43 @@ namespace cr::mt
 		/** Waits until the event happens.
 			If has not yet happened, blocks the coroutine until the event happens. Otherwise, clears the event. To be used with `#CR_AWAIT`. */
 		[[nodiscard]] constexpr ConsumeCall consume();
+
+		/** Helper class for waiting for a consumable event with a timeout using `#CR_AWAIT`. */
+		class TimedConsumeCall
+		{
+			/** The event to wait for. */
+			PODConsumableEventPattern<ConditionVariable> &m_event;
+			/** The deadline of the wait. */
+			Deadline m_deadline;
+		public:
+			/** Initialises the timed wait call.
+			@param[in] event:
+				The consumable event to wait for.
+			@param[in] deadline:
+				The deadline of the wait. */
+			constexpr TimedConsumeCall(
+				PODConsumableEventPattern<ConditionVariable> &event,
+				Deadline const& deadline);
+
+			/** Waits for the event until the deadline expires.
+			@param[in] coroutine:
+				The coroutine waiting for the event.
+			@return
+				Whether the call blocks. */
+			[[nodiscard]] sync::mayblock libcr_wait(
+				Coroutine * coroutine);
+		};
+
+		/** Waits until the event happens or the deadline expires.
+			If has not yet happened, blocks the coroutine until the event happens, and fails if the deadline expires first. Otherwise, clears the event. To be used with `#CR_AWAIT`.
+		@param[in] deadline:
+			The deadline of the wait, as created by the scheduler. */
+		[[nodiscard]] constexpr TimedConsumeCall consume_for(
+			Deadline const& deadline);
+
+		/** Describes how `Select` waits for the event.
+			A selected wait finishes like `consume()`. Like timed waits, it goes through the condition variable. */
+		[[nodiscard]] inline Selectable select_consume();
 		/** Tries to consume the event, if it is active.
 			If it was active, consumes it and sets it to inactive.
 		@return
@@ -141,6 +280,8 @@ namespace cr::mt
 		using PODConsumableEventPattern<ConditionVariable>::fire;
 		using PODConsumableEventPattern<ConditionVariable>::clear;
 		using PODConsumableEventPattern<ConditionVariable>::consume;
+		using PODConsumableEventPattern<ConditionVariable>::consume_for;
+		using PODConsumableEventPattern<ConditionVariable>::select_consume;
 		using PODConsumableEventPattern<ConditionVariable>::active;
 
 		/** Initialises the event. */
@@ -34,6 +34,7 @@ namespace cr::mt
 		inline void fulfill();
 	public:
 		using Event::wait;
+		using Event::select_wait;
 		using Event::initialise;
 		/** Whether the future is fulfilled. */
 		inline bool fulfilled() const;
@@ -59,6 +60,7 @@ namespace cr::mt
 			T const& value);
 	public:
 		using Event::wait;
+		using Event::select_wait;
 		/** Whether the future was fulfilled. */
 		inline bool fulfilled() const;
 
@@ -96,6 +98,7 @@ namespace cr::mt
 		FuturePattern();
 
 		using PODFuturePattern<void, Event>::wait;
+		using PODFuturePattern<void, Event>::select_wait;
 		using PODFuturePattern<void, Event>::initialise;
 		using PODFuturePattern<void, Event>::fulfilled;
 		using PODFuturePattern<void, Event>::listeners;
@@ -113,6 +116,7 @@ namespace cr::mt
 		FuturePattern();
 
 		using PODFuturePattern<T, Event>::wait;
+		using PODFuturePattern<T, Event>::select_wait;
 		using PODFuturePattern<T, Event>::initialise;
 		using PODFuturePattern<T, Event>::fulfilled;
 		using PODFuturePattern<T, Event>::listeners;
@@ -1,17 +1,195 @@
 #include "Mutex.hpp"
 #include "../Coroutine.hpp"
-#include "Promise.hpp"
+
+#include <cassert>
+#include <type_traits>
 
 namespace cr::mt
 {
 	template<class ConditionVariable>
 	void PODMutexPattern<ConditionVariable>::initialise()
 	{
-		PODConsumableEventPattern<ConditionVariable>::initialise(true);
+		std::atomic_init(&m_state, std::uintptr_t(0));
+		m_queue = nullptr;
+		m_barging = 0;
+		std::atomic_init(&m_stolen, (std::uint32_t) 0);
+		m_waker.prepare(
+			static_cast<Coroutine::impl_t>(&Waker::libcr_wake),
+			(Context *) nullptr);
+		m_waker.m_mutex = this;
+	}
+
+	template<class ConditionVariable>
+	sync::mayblock PODMutexPattern<ConditionVariable>::LockCall::libcr_wait(
+		Coroutine * coroutine)
+	{
+		std::uintptr_t state = m_mutex.m_state.load(std::memory_order_relaxed);
+		// Lock the mutex if possible. While barging, it might be unlocked even though coroutines are waiting.
+		while(!(state & kLocked))
+			if(m_mutex.m_state.compare_exchange_weak(
+				state,
+				state | kLocked,
+				std::memory_order_acquire,
+				std::memory_order_relaxed))
+				return sync::nonblock();
+
+		cr::detail::Thread const thread = coroutine->libcr_thread;
+		// The coroutine might be resumed by any thread as soon as it is in the list.
+		coroutine->libcr_thread = cr::detail::Thread::kInvalid;
+
+		for(;;)
+		{
+			if(!(state & kLocked))
+			{
+				if(m_mutex.m_state.compare_exchange_weak(
+					state,
+					state | kLocked,
+					std::memory_order_acquire,
+					std::memory_order_relaxed))
+				{
+					coroutine->libcr_thread = thread;
+					return sync::nonblock();
+				}
+				continue;
+			}
+
+			// Release the coroutine and set its successor to be the most recently waiting coroutine.
+			if(Coroutine * const first = reinterpret_cast<Coroutine *>(state & ~kFlags))
+				coroutine->libcr_next_waiting.atomic.release_with_next(first);
+			else
+				coroutine->libcr_next_waiting.atomic.release();
+
+			if(m_mutex.m_state.compare_exchange_weak(
+				state,
+				reinterpret_cast<std::uintptr_t>(coroutine) | (state & kFlags),
+				std::memory_order_release,
+				std::memory_order_relaxed))
+				return sync::block();
+		}
+	}
+
+	template<class ConditionVariable>
+	Coroutine * PODMutexPattern<ConditionVariable>::take_next()
+	{
+		assert(m_state.load(std::memory_order_relaxed) & kLocked);
+
+		if(!m_queue)
+		{
+			// Take all coroutines that started waiting so far.
+			std::uintptr_t state = m_state.load(std::memory_order_relaxed);
+			do {
+				if(!(state & ~kFlags))
+					return nullptr;
+			} while(!m_state.compare_exchange_weak(
+				state,
+				state & kFlags,
+				std::memory_order_acquire,
+				std::memory_order_relaxed));
+
+			Coroutine * waiting = reinterpret_cast<Coroutine *>(state & ~kFlags);
+			if constexpr(std::is_same_v<ConditionVariable, PODFIFOConditionVariable>)
+			{
+				// The list starts with the most recently waiting coroutine.
+				Coroutine * reversed = nullptr;
+				do {
+					Coroutine * const next = waiting->libcr_next_waiting.atomic.acquire_strong();
+					waiting->libcr_next_waiting.atomic.update(reversed);
+					reversed = waiting;
+					waiting = next;
+				} while(waiting);
+				waiting = reversed;
+			}
+			m_queue = waiting;
+		}
+
+		Coroutine * const next = m_queue;
+		m_queue = next->libcr_next_waiting.atomic.acquire_strong();
+		return next;
+	}
+
+	template<class ConditionVariable>
+	void PODMutexPattern<ConditionVariable>::hand_over(
+		Resumer resumer)
+	{
+		for(;;)
+		{
+			if(Coroutine * const next = take_next())
+			{
+				// The mutex stays locked, and now belongs to the next coroutine.
+				m_stolen.store(0, std::memory_order_relaxed);
+				resumer(next);
+				return;
+			}
+
+			// Unlock the mutex, unless a coroutine starts waiting in the meantime.
+			std::uintptr_t state = m_state.load(std::memory_order_relaxed);
+			while(!(state & ~kFlags))
+				if(m_state.compare_exchange_weak(
+					state,
+					state & ~kLocked,
+					std::memory_order_release,
+					std::memory_order_relaxed))
+					return;
+		}
+	}
+
+	template<class ConditionVariable>
+	void PODMutexPattern<ConditionVariable>::release(
+		Resumer resumer)
+	{
+		std::uintptr_t state = m_state.load(std::memory_order_relaxed);
+		for(;;)
+		{
+			// The queue must be read before unlocking, as it belongs to the mutex's owner.
+			bool const wake = !(state & kWaking) && (m_queue || (state & ~kFlags));
+			if(m_state.compare_exchange_weak(
+				state,
+				(state & ~kLocked) | (wake ? kWaking : 0),
+				std::memory_order_release,
+				std::memory_order_relaxed))
+			{
+				if(wake)
+					resumer(&m_waker);
+				return;
+			}
+		}
+	}
+
+	template<class ConditionVariable>
+	void PODMutexPattern<ConditionVariable>::Waker::libcr_wake()
+	{
+		// The waker can be scheduled again as soon as it is done, so only use the mutex from here on.
+		PODMutexPattern<ConditionVariable> &mutex = *m_mutex;
+
+		std::uintptr_t state = mutex.m_state.load(std::memory_order_relaxed);
+		for(;;)
+		{
+			if(state & kLocked)
+			{
+				// The mutex was taken first, and unlocking it will schedule the waker again.
+				if(mutex.m_state.compare_exchange_weak(
+					state,
+					state & ~kWaking,
+					std::memory_order_relaxed,
+					std::memory_order_relaxed))
+				{
+					mutex.m_stolen.fetch_add(1, std::memory_order_relaxed);
+					return;
+				}
+			} else if(mutex.m_state.compare_exchange_weak(
+				state,
+				(state | kLocked) & ~kWaking,
+				std::memory_order_acquire,
+				std::memory_order_relaxed))
+			{
+				mutex.hand_over(Resumer());
+				return;
+			}
+		}
 	}
 
 	template class PODMutexPattern<PODConditionVariable>;
 	template class PODMutexPattern<PODFIFOConditionVariable>;
 	template class MutexPattern<PODConditionVariable>;
 	template class MutexPattern<PODFIFOConditionVariable>;
-}
\ No newline at end of file
+}
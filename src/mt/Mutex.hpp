@@ -3,30 +3,119 @@
 #ifndef __libcr_mt_mutex_hpp_defined
 #define __libcr_mt_mutex_hpp_defined
 
-#include "Event.hpp"
+#include "ConditionVariable.hpp"
+#include "../Coroutine.hpp"
+#include "../sync/Block.hpp"
+
+#include <atomic>
+#include <cstdint>
 
 namespace cr::mt
 {
 	template<class ConditionVariable>
-	/** POD mutex type. */
-	class PODMutexPattern : PODConsumableEventPattern<ConditionVariable>
+	/** POD mutex type.
+		Whether the mutex is locked and the list of coroutines that started waiting for it share a single atomic word, so that uncontended locking and unlocking take a single compare-and-swap. Unlocking hands the mutex directly to the next waiting coroutine, which then does not need to race for it again.
+		Optionally, unlocking releases the mutex instead, so that running coroutines can take it before the next waiting coroutine is scheduled (see `set_barging()`).
+		Direct handoff is the default, because it keeps the waiting order strict. Its cost is that the mutex stays locked until the next owner runs: with a deferred resumer and more scheduler threads than CPUs, every handoff waits for the next owner's thread to be scheduled, and throughput can drop by orders of magnitude. Enable barging for mutexes that are unlocked through a scheduler.
+	@tparam ConditionVariable:
+		Which condition variable flavour's notification order to use: `PODFIFOConditionVariable` hands the mutex to waiting coroutines in FIFO order. */
+	class PODMutexPattern
 	{
+		/** Set while the mutex is locked. */
+		static constexpr std::uintptr_t kLocked = 1;
+		/** Set while the waker is scheduled. */
+		static constexpr std::uintptr_t kWaking = 2;
+		/** The state's flag bits. The remaining bits point to the most recently waiting coroutine, or are null. */
+		static constexpr std::uintptr_t kFlags = kLocked | kWaking;
+
+		/** Locks the mutex for the next waiting coroutine once it is scheduled, if the mutex was not taken in the meantime. Only used in barging mode. */
+		class Waker : public Coroutine
+		{
+			friend class PODMutexPattern<ConditionVariable>;
+			/** The mutex to lock. */
+			PODMutexPattern<ConditionVariable> * m_mutex;
+
+			/** Called when the waker is scheduled. */
+			void libcr_wake();
+		};
+
+		/** The mutex's state. */
+		std::atomic<std::uintptr_t> m_state;
+		/** The waiting coroutines taken from the state, in the order in which they get the mutex.
+			Only accessed by the mutex's owner. */
+		Coroutine * m_queue;
+		/** How often in a row the waker may find the mutex taken before unlocking hands it over directly, or 0 to always hand it over directly. */
+		std::uint32_t m_barging;
+		/** How often in a row the waker found the mutex taken. */
+		std::atomic<std::uint32_t> m_stolen;
+		/** The waker. */
+		Waker m_waker;
+
+		/** Removes the next waiting coroutine.
+			The mutex must be locked.
+		@return
+			The next waiting coroutine, or null if none is waiting. */
+		Coroutine * take_next();
+		/** Hands the mutex to the next waiting coroutine, or unlocks it if none is waiting.
+		@param[in] resumer:
+			How to resume the next waiting coroutine. */
+		void hand_over(
+			Resumer resumer);
+		/** Unlocks the mutex, and schedules the waker if coroutines are waiting.
+		@param[in] resumer:
+			How to resume the waker. */
+		void release(
+			Resumer resumer);
 	public:
+		/** Initialises the mutex to an unlocked state. */
+		void initialise();
+
+		/** Sets whether unlocking releases the mutex instead of handing it over.
+			In barging mode, unlocking schedules the next waiting coroutine, but coroutines that lock the mutex until then take it first. This keeps the mutex from being locked while its next owner is not running yet, which increases throughput when waiting coroutines are resumed through a scheduler. Once waiting coroutines were overtaken `limit` times in a row, the mutex is handed over directly again, so that they do not starve.
+			The trade-off is fairness against throughput: without barging, waiting coroutines get the mutex strictly in order, but a deferred handoff leaves the mutex idle until the next owner's thread runs it, which is slow when threads are oversubscribed. With barging, a waiting coroutine may be overtaken up to `limit` times per handoff, and `FIFOMutex` only keeps its order among the waiting coroutines. With direct resumption, the next owner runs right away, so barging gains little.
+			Must not be changed while the mutex is in use.
+		@param[in] limit:
+			How often in a row waiting coroutines may be overtaken, or 0 to always hand the mutex over directly. */
+		inline void set_barging(
+			std::uint32_t limit);
+
 		/** Tries to lock the mutex.
 			Never blocks the coroutine.
 		@return
 			Whether the lock was acquired. */
 		inline bool try_lock();
-		/** Locks the mutex.
-			If the mutex is locked already, blocks the coroutine until the mutex is released. To be used with `#CR_AWAIT`. */
-		inline typename PODConsumableEventPattern<ConditionVariable>::ConsumeCall lock();
-		/** Unlocks the mutex.
-			The mutex must be locked. Only the owner should unlock the mutex. */
-		inline void unlock();
 
-		/** Initialises the mutex to an unlocked state. */
-		void initialise();
+		/** Helper type that simplifies usage of `lock()` with `#CR_AWAIT`. */
+		class LockCall
+		{
+			/** The mutex to lock. */
+			PODMutexPattern<ConditionVariable> &m_mutex;
+		public:
+			/** Creates a lock call.
+			@param[in] mutex:
+				The mutex to lock. */
+			constexpr LockCall(
+				PODMutexPattern<ConditionVariable> &mutex);
+
+			/** Locks the mutex, or adds the coroutine to the mutex's waiting list.
+			@param[in] coroutine:
+				The coroutine locking the mutex.
+			@return
+				Whether the call blocks. */
+			[[nodiscard]] sync::mayblock libcr_wait(
+				Coroutine * coroutine);
+		};
 
+		/** Locks the mutex.
+			If the mutex is locked already, blocks the coroutine until the mutex is handed to it. To be used with `#CR_AWAIT`. */
+		[[nodiscard]] constexpr LockCall lock();
+
+		/** Unlocks the mutex.
+			The mutex must be locked. Only the owner should unlock the mutex.
+		@param[in] resumer:
+			How to resume the next waiting coroutine. */
+		inline void unlock(
+			Resumer resumer = Resumer());
 	};
 
 	template<class ConditionVariable>
@@ -36,6 +125,9 @@ namespace cr::mt
 		using PODMutexPattern<ConditionVariable>::initialise;
 	public:
 		inline MutexPattern();
+
+		MutexPattern(MutexPattern const&) = delete;
+		MutexPattern &operator=(MutexPattern const&) = delete;
 	};
 
 	typedef PODMutexPattern<PODConditionVariable> PODMutex;
@@ -46,4 +138,4 @@ namespace cr::mt
 
 #include "Mutex.inl"
 
-#endif
\ No newline at end of file
+#endif
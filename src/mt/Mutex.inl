@@ -1,21 +1,55 @@
 namespace cr::mt
 {
+	template<class ConditionVariable>
+	void PODMutexPattern<ConditionVariable>::set_barging(
+		std::uint32_t limit)
+	{
+		m_barging = limit;
+	}
+
 	template<class ConditionVariable>
 	bool PODMutexPattern<ConditionVariable>::try_lock()
 	{
-		return PODConsumableEventPattern<ConditionVariable>::try_consume();
+		std::uintptr_t state = m_state.load(std::memory_order_relaxed);
+		while(!(state & kLocked))
+			if(m_state.compare_exchange_weak(
+				state,
+				state | kLocked,
+				std::memory_order_acquire,
+				std::memory_order_relaxed))
+				return true;
+		return false;
 	}
 
 	template<class ConditionVariable>
-	typename PODConsumableEventPattern<ConditionVariable>::ConsumeCall PODMutexPattern<ConditionVariable>::lock()
+	constexpr PODMutexPattern<ConditionVariable>::LockCall::LockCall(
+		PODMutexPattern<ConditionVariable> &mutex):
+		m_mutex(mutex)
 	{
-		return PODConsumableEventPattern<ConditionVariable>::consume();
 	}
 
 	template<class ConditionVariable>
-	void PODMutexPattern<ConditionVariable>::unlock()
+	constexpr typename PODMutexPattern<ConditionVariable>::LockCall PODMutexPattern<ConditionVariable>::lock()
 	{
-		PODConsumableEventPattern<ConditionVariable>::clear();
+		return LockCall(*this);
+	}
+
+	template<class ConditionVariable>
+	void PODMutexPattern<ConditionVariable>::unlock(
+		Resumer resumer)
+	{
+		std::uintptr_t state = kLocked;
+		if(!m_queue && m_state.compare_exchange_strong(
+			state,
+			0,
+			std::memory_order_release,
+			std::memory_order_relaxed))
+			return;
+
+		if(m_barging && m_stolen.load(std::memory_order_relaxed) < m_barging)
+			release(resumer);
+		else
+			hand_over(resumer);
 	}
 
 	template<class ConditionVariable>
@@ -23,4 +57,4 @@ namespace cr::mt
 	{
 		initialise();
 	}
-}
\ No newline at end of file
+}
@@ -0,0 +1,179 @@
+/** @file PriorityQueue.hpp
+	Contains the thread-safe priority queue types. */
+#ifndef __libcr_mt_priorityqueue_hpp_defined
+#define __libcr_mt_priorityqueue_hpp_defined
+
+#include "ConditionVariable.hpp"
+#include "detail/BoundedRing.hpp"
+#include "detail/ParkingLot.hpp"
+#include "../primitives.hpp"
+#include "../util/RefConv.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace cr::mt
+{
+	template<class T, std::size_t kSize, std::size_t kLevels, class ConditionVariable>
+	/** POD fixed queue type with priority levels.
+		Every level is a lock-free ring buffer of its own, so that pushing to a full level never blocks the other levels. Popping takes the oldest value of the highest non-empty level, which is found through a bitmap of the non-empty levels. Coroutines only wait in a condition variable while all levels are empty, or while their level is full.
+	@tparam T:
+		The queue's element type.
+		May also be a complex type, as the operations on the queue's values are not atomic.
+	@tparam kSize:
+		The capacity of each priority level. It is rounded up to a power of two.
+	@tparam kLevels:
+		The number of priority levels, at most 64. Higher levels are popped first.
+	@tparam ConditionVariable:
+		POD thread-safe condition variable type to wait in. */
+	class PODPriorityQueuePattern
+	{
+		static_assert(kLevels > 0 && kLevels <= 64, "The level bitmap holds at most 64 levels.");
+
+		/** A priority level's values. */
+		typedef detail::PODBoundedRing<T, kSize> Ring;
+
+		/** Has a bit set for every level that might be non-empty.
+			Producers set the bit after pushing, and consumers only clear it after they found the level empty. */
+		alignas(64) std::atomic<std::uint64_t> m_levels;
+		/** How to resume waiting coroutines. */
+		Resumer m_resumer;
+		/** The coroutines waiting for an element. */
+		detail::PODParkingLot<ConditionVariable> m_readers;
+		/** The coroutines waiting for a free slot, per level. */
+		detail::PODParkingLot<ConditionVariable> m_writers[kLevels];
+		/** The values of each level. */
+		Ring m_rings[kLevels];
+
+		/** Whether any level of a queue has an element.
+		@param[in] queue:
+			The queue. */
+		static bool readable(
+			void const * queue);
+		/** Whether a level has a free slot.
+		@param[in] ring:
+			The level's ring. */
+		static bool writable(
+			void const * ring);
+
+		/** Tries to remove the oldest value of the highest non-empty level.
+		@param[out] target:
+			The location to move the value to.
+		@param[out] level:
+			The level the value was taken from.
+		@return
+			Whether there was an element. */
+		inline bool try_pop(
+			T &target,
+			std::size_t &level);
+	public:
+		/** The actual capacity of each level. */
+		static constexpr std::size_t kCapacity = Ring::kCapacity;
+
+		/** Initialises the queue. */
+		void initialise();
+
+		/** Sets how coroutines waiting for the queue are resumed.
+			By default, they are resumed directly by the pushing or popping coroutine. Use a scheduler's `deferred()` resumer to enqueue them instead, so that the notifying coroutine continues right away.
+		@param[in] resumer:
+			How to resume waiting coroutines. */
+		inline void set_resumer(
+			Resumer resumer);
+
+		template<class V>
+		/** Pushes a value to the queue, waiting while its level is full.
+		@tparam V:
+			The pushed value's type. */
+		TEMPLATE_COROUTINE(PushPattern, (V), void)
+		CR_STATE(
+			(PODPriorityQueuePattern<T, kSize, kLevels, ConditionVariable> &) queue,
+			(V) value,
+			(std::size_t) priority);
+		CR_EXTERNAL
+
+		union Push {
+			PushPattern<T const&> copy;
+			PushPattern<T &&> move;
+		};
+
+		/** Pops the oldest value of the highest non-empty level. */
+		COROUTINE(Pop, void)
+		CR_STATE(
+			(PODPriorityQueuePattern<T, kSize, kLevels, ConditionVariable> &) queue,
+			(T &) target);
+			/** The level the value was taken from. */
+			std::size_t level;
+		CR_EXTERNAL
+
+		/** Pops the oldest value of the highest non-empty level, unless the deadline expires first.
+			On expiry, the coroutine fails without popping a value. */
+		COROUTINE(TimedPop, void)
+		CR_STATE(
+			(PODPriorityQueuePattern<T, kSize, kLevels, ConditionVariable> &) queue,
+			(T &) target,
+			(Deadline) deadline);
+			/** The level the value was taken from. */
+			std::size_t level;
+		CR_EXTERNAL
+	};
+
+	template<class T, std::size_t kSize, std::size_t kLevels, class ConditionVariable>
+	/** Non-POD fixed capacity queue type with priority levels.
+	@tparam T:
+		The queue's element type.
+	@tparam kSize:
+		The capacity of each priority level. It is rounded up to a power of two.
+	@tparam kLevels:
+		The number of priority levels, at most 64.
+	@tparam ConditionVariable:
+		POD thread-safe condition variable type to wait in. */
+	class PriorityQueuePattern : public PODPriorityQueuePattern<T, kSize, kLevels, ConditionVariable>
+	{
+		using PODPriorityQueuePattern<T, kSize, kLevels, ConditionVariable>::initialise;
+	public:
+		/** Initialises the queue. */
+		inline PriorityQueuePattern();
+	};
+
+	template<class T, std::size_t kSize, std::size_t kLevels>
+	/** POD priority queue type.
+	@tparam T:
+		The queue's data type.
+	@tparam kSize:
+		The capacity of each priority level.
+	@tparam kLevels:
+		The number of priority levels. */
+	using PODPriorityQueue = PODPriorityQueuePattern<T, kSize, kLevels, mt::PODConditionVariable>;
+	template<class T, std::size_t kSize, std::size_t kLevels>
+	/** POD priority queue type with FIFO notifications.
+	@tparam T:
+		The queue's data type.
+	@tparam kSize:
+		The capacity of each priority level.
+	@tparam kLevels:
+		The number of priority levels. */
+	using PODFIFOPriorityQueue = PODPriorityQueuePattern<T, kSize, kLevels, mt::PODFIFOConditionVariable>;
+	template<class T, std::size_t kSize, std::size_t kLevels>
+	/** Priority queue type.
+	@tparam T:
+		The queue's data type.
+	@tparam kSize:
+		The capacity of each priority level.
+	@tparam kLevels:
+		The number of priority levels. */
+	using PriorityQueue = PriorityQueuePattern<T, kSize, kLevels, mt::PODConditionVariable>;
+	template<class T, std::size_t kSize, std::size_t kLevels>
+	/** Priority queue type with FIFO notifications.
+	@tparam T:
+		The queue's data type.
+	@tparam kSize:
+		The capacity of each priority level.
+	@tparam kLevels:
+		The number of priority levels. */
+	using FIFOPriorityQueue = PriorityQueuePattern<T, kSize, kLevels, mt::PODFIFOConditionVariable>;
+}
+
+#include "PriorityQueue.inl"
+
+#endif
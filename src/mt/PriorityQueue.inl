@@ -0,0 +1,113 @@
+#include <cassert>
+
+namespace cr::mt
+{
+	template<class T, std::size_t kSize, std::size_t kLevels, class ConditionVariable>
+	bool PODPriorityQueuePattern<T, kSize, kLevels, ConditionVariable>::readable(
+		void const * queue)
+	{
+		// Only parking coroutines get here, so look at the levels themselves instead of the bitmap, which a consumer might clear for a moment.
+		PODPriorityQueuePattern<T, kSize, kLevels, ConditionVariable> const * self = static_cast<PODPriorityQueuePattern<T, kSize, kLevels, ConditionVariable> const *>(queue);
+		for(std::size_t i = kLevels; i--;)
+			if(self->m_rings[i].readable())
+				return true;
+		return false;
+	}
+
+	template<class T, std::size_t kSize, std::size_t kLevels, class ConditionVariable>
+	bool PODPriorityQueuePattern<T, kSize, kLevels, ConditionVariable>::writable(
+		void const * ring)
+	{
+		return static_cast<Ring const *>(ring)->writable();
+	}
+
+	template<class T, std::size_t kSize, std::size_t kLevels, class ConditionVariable>
+	bool PODPriorityQueuePattern<T, kSize, kLevels, ConditionVariable>::try_pop(
+		T &target,
+		std::size_t &level)
+	{
+		std::uint64_t levels = m_levels.load(std::memory_order_acquire);
+		while(levels)
+		{
+			level = 63 - __builtin_clzll(levels);
+			if(m_rings[level].try_pop(target))
+				return true;
+
+			std::uint64_t const bit = std::uint64_t(1) << level;
+			levels = m_levels.fetch_and(~bit, std::memory_order_acq_rel) & ~bit;
+			// Either a producer that pushed in the meantime sets the bit again after this, or its element is visible here.
+			if(m_rings[level].readable())
+				levels = m_levels.fetch_or(bit, std::memory_order_acq_rel) | bit;
+		}
+		return false;
+	}
+
+	template<class T, std::size_t kSize, std::size_t kLevels, class ConditionVariable>
+	void PODPriorityQueuePattern<T, kSize, kLevels, ConditionVariable>::initialise()
+	{
+		std::atomic_init(&m_levels, (std::uint64_t) 0);
+		m_resumer = Resumer();
+		m_readers.initialise();
+		for(std::size_t i = 0; i < kLevels; i++)
+		{
+			m_writers[i].initialise();
+			m_rings[i].initialise();
+		}
+	}
+
+	template<class T, std::size_t kSize, std::size_t kLevels, class ConditionVariable>
+	void PODPriorityQueuePattern<T, kSize, kLevels, ConditionVariable>::set_resumer(
+		Resumer resumer)
+	{
+		m_resumer = resumer;
+	}
+
+	template<class T, std::size_t kSize, std::size_t kLevels, class ConditionVariable>
+	template<class V>
+	CR_IMPL(PODPriorityQueuePattern<T, kSize, kLevels, ConditionVariable>::PushPattern<V>)
+		assert(priority < kLevels && "Invalid priority level.");
+
+		while(!queue->m_rings[priority].try_push(std::forward<V>(value)))
+		{
+			CR_AWAIT(
+				queue->m_writers[priority].park(&writable, &queue->m_rings[priority]),
+				{ queue->m_writers[priority].leave(); CR_THROW; });
+			queue->m_writers[priority].leave();
+		}
+		queue->m_levels.fetch_or(std::uint64_t(1) << priority, std::memory_order_acq_rel);
+		queue->m_readers.unpark(queue->m_resumer);
+	CR_FINALLY
+	CR_IMPL_END
+
+	template<class T, std::size_t kSize, std::size_t kLevels, class ConditionVariable>
+	CR_IMPL(PODPriorityQueuePattern<T, kSize, kLevels, ConditionVariable>::Pop)
+		while(!queue->try_pop(*target, level))
+		{
+			CR_AWAIT(
+				queue->m_readers.park(&readable, queue),
+				{ queue->m_readers.leave(); CR_THROW; });
+			queue->m_readers.leave();
+		}
+		queue->m_writers[level].unpark(queue->m_resumer);
+	CR_FINALLY
+	CR_IMPL_END
+
+	template<class T, std::size_t kSize, std::size_t kLevels, class ConditionVariable>
+	CR_IMPL(PODPriorityQueuePattern<T, kSize, kLevels, ConditionVariable>::TimedPop)
+		while(!queue->try_pop(*target, level))
+		{
+			CR_AWAIT(
+				queue->m_readers.park_for(&readable, queue, deadline),
+				{ queue->m_readers.leave(); CR_THROW; });
+			queue->m_readers.leave();
+		}
+		queue->m_writers[level].unpark(queue->m_resumer);
+	CR_FINALLY
+	CR_IMPL_END
+
+	template<class T, std::size_t kSize, std::size_t kLevels, class ConditionVariable>
+	PriorityQueuePattern<T, kSize, kLevels, ConditionVariable>::PriorityQueuePattern()
+	{
+		initialise();
+	}
+}
@@ -3,42 +3,73 @@
 #ifndef __libcr_mt_queue_hpp_defined
 #define __libcr_mt_queue_hpp_defined
 
-#include "Semaphore.hpp"
-#include "../sync/Queue.hpp"
-#include "../util/Atomic.hpp"
+#include "ConditionVariable.hpp"
+#include "detail/BoundedRing.hpp"
+#include "detail/ParkingLot.hpp"
+#include "../primitives.hpp"
+#include "../util/RefConv.hpp"
 
 namespace cr::mt
 {
-	template<class T, std::size_t kSize, class Semaphore>
+	template<class T, std::size_t kSize, class ConditionVariable>
 	/** POD fixed queue type.
+		The values are kept in a lock-free ring buffer, and coroutines only wait in a condition variable while the queue is empty or full.
 	@tparam T:
 		The queue's element type.
 		May also be a complex type, as the operations on the queue's values are not atomic.
 	@tparam kSize:
-		The queue's capacity.
-	@tparam Semaphore:
-		POD thread-safe semaphore type.
-		It is important that the operations are acquire-release operations. */
-	class PODFixedQueuePattern : sync::PODQueueBasePattern<Semaphore>
+		The queue's capacity. It is rounded up to a power of two.
+	@tparam ConditionVariable:
+		POD thread-safe condition variable type to wait in. */
+	class PODFixedQueuePattern
 	{
-		/** The queue's values.
-			The values need not be atomic, as semaphores use acquire-release ordering. */
-		std::array<T, kSize> m_values;
-		/** The first element's index. */
-		std::atomic_size_t m_start;
-		/** The end of the queue. */
-		std::atomic_size_t m_end;
+		/** The queue's values. */
+		detail::PODBoundedRing<T, kSize> m_ring;
+		/** The coroutines waiting for an element. */
+		detail::PODParkingLot<ConditionVariable> m_readers;
+		/** The coroutines waiting for a free slot. */
+		detail::PODParkingLot<ConditionVariable> m_writers;
+		/** How to resume waiting coroutines. */
+		Resumer m_resumer;
+
+		/** Whether a queue has an element.
+		@param[in] queue:
+			The queue. */
+		static bool readable(
+			void const * queue);
+		/** Whether a queue has a free slot.
+		@param[in] queue:
+			The queue. */
+		static bool writable(
+			void const * queue);
 	public:
+		/** The queue's actual capacity. */
+		static constexpr std::size_t kCapacity = detail::PODBoundedRing<T, kSize>::kCapacity;
+
 		/** Initialises the queue. */
 		void initialise();
 
+		/** Sets how coroutines waiting for the queue are resumed.
+			By default, they are resumed directly by the pushing or popping coroutine. Use a scheduler's `deferred()` resumer to enqueue them instead, so that the notifying coroutine continues right away.
+		@param[in] resumer:
+			How to resume waiting coroutines. */
+		inline void set_resumer(
+			Resumer resumer);
+
+		/** Describes how `Select` waits until the queue has an element.
+			The element is not taken, so the selecting coroutine still has to pop it afterwards, and waits again if another coroutine was faster. */
+		[[nodiscard]] inline Selectable select_pop();
+		/** Describes how `Select` waits until the queue has a free slot.
+			The slot is not taken, so the selecting coroutine still has to push afterwards, and waits again if another coroutine was faster. */
+		[[nodiscard]] inline Selectable select_push();
+
 		template<class V>
 		/** Pushes a value to the queue.
 		@tparam V:
 			The pushed value's type. */
 		TEMPLATE_COROUTINE(PushPattern, (V), void)
 		CR_STATE(
-			(PODFixedQueuePattern<T, kSize, Semaphore> &) queue,
+			(PODFixedQueuePattern<T, kSize, ConditionVariable> &) queue,
 			(V) value);
 		CR_EXTERNAL
 
@@ -50,40 +81,158 @@ namespace cr::mt
 		/** Pops a value from the queue. */
 		COROUTINE(Pop, void)
 		CR_STATE(
-			(PODFixedQueuePattern<T, kSize, Semaphore> &) queue,
+			(PODFixedQueuePattern<T, kSize, ConditionVariable> &) queue,
 			(T &) target);
 		CR_EXTERNAL
+
+		/** Pops a value from the queue, unless the deadline expires first.
+			On expiry, the coroutine fails without popping a value. */
+		COROUTINE(TimedPop, void)
+		CR_STATE(
+			(PODFixedQueuePattern<T, kSize, ConditionVariable> &) queue,
+			(T &) target,
+			(Deadline) deadline);
+		CR_EXTERNAL
+
+		/** Pushes several values to the queue.
+			Claims as many free slots at once as are available, and checks for waiting coroutines once per batch.
+		@param[in] values:
+			The values to push.
+		@param[in] count:
+			The number of values to push. */
+		COROUTINE(PushBulk, void)
+		CR_STATE(
+			(PODFixedQueuePattern<T, kSize, ConditionVariable> &) queue,
+			(T const *) values,
+			(std::size_t) count);
+			/** The number of values pushed so far. */
+			std::size_t pushed;
+			/** The size of the current batch. */
+			std::size_t batch;
+		CR_EXTERNAL
+
+		/** Pops several values from the queue.
+			Waits until at least `min` values were popped, and pops at most `max` values. Claims as many elements at once as are available, and checks for waiting coroutines once per batch.
+		@param[out] target:
+			The location to move the values to. Must have room for `max` values.
+		@param[in] min:
+			The number of values to wait for.
+		@param[in] max:
+			The maximum number of values to pop.
+		@param[out] count:
+			The number of popped values. */
+		COROUTINE(PopBulk, void)
+		CR_STATE(
+			(PODFixedQueuePattern<T, kSize, ConditionVariable> &) queue,
+			(T *) target,
+			(std::size_t) min,
+			(std::size_t) max,
+			(std::size_t &) count);
+			/** The size of the current batch. */
+			std::size_t batch;
+		CR_EXTERNAL
+
+		/** Waits for a free slot and claims it, so that the element can be constructed in place.
+			The slot has to be handed to `publish()` afterwards. Claimed slots may be published in any order.
+		@param[out] slot:
+			The claimed slot. */
+		COROUTINE(Claim, void)
+		CR_STATE(
+			(PODFixedQueuePattern<T, kSize, ConditionVariable> &) queue,
+			(T * &) slot);
+		CR_EXTERNAL
+
+		/** Makes a claimed slot's element available to consumers.
+		@param[in] slot:
+			The slot returned by `Claim`. */
+		inline void publish(
+			T * slot);
+
+		/** Waits for an element and claims it, so that it can be processed in place.
+			The element has to be handed to `release()` afterwards. Claimed elements may be released in any order.
+		@param[out] element:
+			The claimed element. */
+		COROUTINE(Peek, void)
+		CR_STATE(
+			(PODFixedQueuePattern<T, kSize, ConditionVariable> &) queue,
+			(T const * &) element);
+		CR_EXTERNAL
+
+		/** Waits for an element and claims it, unless the deadline expires first.
+			On expiry, the coroutine fails without claiming an element.
+		@param[out] element:
+			The claimed element.
+		@param[in] deadline:
+			The deadline of the wait, as created by the scheduler. */
+		COROUTINE(TimedPeek, void)
+		CR_STATE(
+			(PODFixedQueuePattern<T, kSize, ConditionVariable> &) queue,
+			(T const * &) element,
+			(Deadline) deadline);
+		CR_EXTERNAL
+
+		/** Frees a claimed element's slot for producers.
+		@param[in] element:
+			The element returned by `Peek` or `TimedPeek`. */
+		inline void release(
+			T const * element);
 	};
 
-	template<std::size_t kSize, class Semaphore>
-	class PODFixedQueuePattern<void, kSize, Semaphore> : sync::PODQueueBasePattern<Semaphore>
+	template<std::size_t kSize, class ConditionVariable>
+	class PODFixedQueuePattern<void, kSize, ConditionVariable>
 	{
+		/** The queue's tokens. */
+		detail::PODBoundedRing<bool, kSize> m_ring;
+		/** The coroutines waiting for a token. */
+		detail::PODParkingLot<ConditionVariable> m_readers;
+		/** The coroutines waiting for a free slot. */
+		detail::PODParkingLot<ConditionVariable> m_writers;
+		/** How to resume waiting coroutines. */
+		Resumer m_resumer;
+
+		static bool readable(
+			void const * queue);
+		static bool writable(
+			void const * queue);
 	public:
+		static constexpr std::size_t kCapacity = detail::PODBoundedRing<bool, kSize>::kCapacity;
+
 		void initialise();
 
+		inline void set_resumer(
+			Resumer resumer);
+
+		inline Selectable select_pop();
+		inline Selectable select_push();
+
 		COROUTINE(Push, void)
 		CR_STATE(
-			(PODFixedQueuePattern<void, kSize, Semaphore> &) queue);
+			(PODFixedQueuePattern<void, kSize, ConditionVariable> &) queue);
 		CR_EXTERNAL
 
 		COROUTINE(Pop, void)
 		CR_STATE(
-			(PODFixedQueuePattern<void, kSize, Semaphore> &) queue);
+			(PODFixedQueuePattern<void, kSize, ConditionVariable> &) queue);
+		CR_EXTERNAL
+
+		COROUTINE(TimedPop, void)
+		CR_STATE(
+			(PODFixedQueuePattern<void, kSize, ConditionVariable> &) queue,
+			(Deadline) deadline);
 		CR_EXTERNAL
 	};
 
-	template<class T, std::size_t kSize, class Semaphore>
+	template<class T, std::size_t kSize, class ConditionVariable>
 	/** Non-POD fixed capacity queue type.
 	@tparam T:
 		The queue's element type.
 	@tparam kSize:
-		The queue's capacity.
-	@tparam Semaphore:
-		The thread-safe semaphore type to use.
-		It is important that the operations are acquire-release operations. */
-	class FixedQueuePattern : public PODFixedQueuePattern<T, kSize, Semaphore>
+		The queue's capacity. It is rounded up to a power of two.
+	@tparam ConditionVariable:
+		POD thread-safe condition variable type to wait in. */
+	class FixedQueuePattern : public PODFixedQueuePattern<T, kSize, ConditionVariable>
 	{
-		using PODFixedQueuePattern<T, kSize, Semaphore>::initialise;
+		using PODFixedQueuePattern<T, kSize, ConditionVariable>::initialise;
 	public:
 		/** Initialises the queue. */
 		inline FixedQueuePattern();
@@ -95,28 +244,28 @@ namespace cr::mt
 		The queue's data type.
 	@tparam kSize:
 		The queue's capacity. */
-	using PODFixedQueue = PODFixedQueuePattern<T, kSize, mt::PODSemaphore>;
+	using PODFixedQueue = PODFixedQueuePattern<T, kSize, mt::PODConditionVariable>;
 	template<class T, std::size_t kSize>
 	/** POD fixed queue type with FIFO notifications.
 	@tparam T:
 		The queue's data type.
 	@tparam kSize:
 		The queue's capacity. */
-	using PODFIFOFixedQueue = PODFixedQueuePattern<T, kSize, mt::PODFIFOSemaphore>;
+	using PODFIFOFixedQueue = PODFixedQueuePattern<T, kSize, mt::PODFIFOConditionVariable>;
 	template<class T, std::size_t kSize>
 	/** Fixed queue type.
 	@tparam T:
 		The queue's data type.
 	@tparam kSize:
 		The queue's capacity. */
-	using FixedQueue = FixedQueuePattern<T, kSize, mt::PODSemaphore>;
+	using FixedQueue = FixedQueuePattern<T, kSize, mt::PODConditionVariable>;
 	template<class T, std::size_t kSize>
 	/** Fixed queue type with FIFO notifications.
 	@tparam T:
 		The queue's data type.
 	@tparam kSize:
 		The queue's capacity. */
-	using FIFOFixedQueue = FixedQueuePattern<T, kSize, mt::PODFIFOSemaphore>;
+	using FIFOFixedQueue = FixedQueuePattern<T, kSize, mt::PODFIFOConditionVariable>;
 }
 
 #include "Queue.inl"
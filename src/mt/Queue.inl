@@ -1,83 +1,273 @@
 namespace cr::mt
 {
-	namespace detail
+	template<class T, std::size_t kSize, class ConditionVariable>
+	bool PODFixedQueuePattern<T, kSize, ConditionVariable>::readable(
+		void const * queue)
 	{
-		template<class Values>
-		std::size_t inc_wrap(
-			Values const& values,
-			std::atomic_size_t &value)
-		{
-			std::size_t index = value.load(std::memory_order_relaxed);
-			std::size_t next;
-			// Increment with wrap-around.
-			do {
-				if(index == values.size() -1)
-					next = 0;
-				else
-					next = index + 1;
-			} while(!value.compare_exchange_weak(
-				index,
-				next,
-				std::memory_order_relaxed,
-				std::memory_order_relaxed));
-
-			return index;
-		}
+		return static_cast<PODFixedQueuePattern<T, kSize, ConditionVariable> const *>(queue)->m_ring.readable();
+	}
+
+	template<class T, std::size_t kSize, class ConditionVariable>
+	bool PODFixedQueuePattern<T, kSize, ConditionVariable>::writable(
+		void const * queue)
+	{
+		return static_cast<PODFixedQueuePattern<T, kSize, ConditionVariable> const *>(queue)->m_ring.writable();
+	}
+
+	template<class T, std::size_t kSize, class ConditionVariable>
+	void PODFixedQueuePattern<T, kSize, ConditionVariable>::initialise()
+	{
+		m_ring.initialise();
+		m_readers.initialise();
+		m_writers.initialise();
+		m_resumer = Resumer();
+	}
+
+	template<class T, std::size_t kSize, class ConditionVariable>
+	void PODFixedQueuePattern<T, kSize, ConditionVariable>::set_resumer(
+		Resumer resumer)
+	{
+		m_resumer = resumer;
 	}
 
-	template<class T, std::size_t kSize, class Semaphore>
-	void PODFixedQueuePattern<T, kSize, Semaphore>::initialise()
+	template<class T, std::size_t kSize, class ConditionVariable>
+	Selectable PODFixedQueuePattern<T, kSize, ConditionVariable>::select_pop()
 	{
-		sync::PODQueueBasePattern<Semaphore>::initialise(kSize);
-		std::atomic_init(&m_start, (std::size_t) 0);
-		std::atomic_init(&m_end, (std::size_t) 0);
+		return detail::PODParkingLot<ConditionVariable>::template selectable<
+			PODFixedQueuePattern<T, kSize, ConditionVariable>,
+			&PODFixedQueuePattern<T, kSize, ConditionVariable>::m_readers,
+			&readable>(this);
 	}
 
-	template<class T, std::size_t kSize, class Semaphore>
+	template<class T, std::size_t kSize, class ConditionVariable>
+	Selectable PODFixedQueuePattern<T, kSize, ConditionVariable>::select_push()
+	{
+		return detail::PODParkingLot<ConditionVariable>::template selectable<
+			PODFixedQueuePattern<T, kSize, ConditionVariable>,
+			&PODFixedQueuePattern<T, kSize, ConditionVariable>::m_writers,
+			&writable>(this);
+	}
+
+	template<class T, std::size_t kSize, class ConditionVariable>
 	template<class V>
-	CR_IMPL(PODFixedQueuePattern<T, kSize, Semaphore>::PushPattern<V>)
-		CR_AWAIT(queue->free());
-		util::assign(
-			queue->m_values[detail::inc_wrap(queue->m_values, queue->m_end)],
-			std::forward<V>(value));
-		queue->push();
+	CR_IMPL(PODFixedQueuePattern<T, kSize, ConditionVariable>::PushPattern<V>)
+		while(!queue->m_ring.try_push(std::forward<V>(value)))
+		{
+			CR_AWAIT(
+				queue->m_writers.park(&writable, queue),
+				{ queue->m_writers.leave(); CR_THROW; });
+			queue->m_writers.leave();
+		}
+		queue->m_readers.unpark(queue->m_resumer);
+	CR_FINALLY
+	CR_IMPL_END
+
+	template<class T, std::size_t kSize, class ConditionVariable>
+	CR_IMPL(PODFixedQueuePattern<T, kSize, ConditionVariable>::Pop)
+		while(!queue->m_ring.try_pop(*target))
+		{
+			CR_AWAIT(
+				queue->m_readers.park(&readable, queue),
+				{ queue->m_readers.leave(); CR_THROW; });
+			queue->m_readers.leave();
+		}
+		queue->m_writers.unpark(queue->m_resumer);
+	CR_FINALLY
+	CR_IMPL_END
+
+	template<class T, std::size_t kSize, class ConditionVariable>
+	CR_IMPL(PODFixedQueuePattern<T, kSize, ConditionVariable>::TimedPop)
+		while(!queue->m_ring.try_pop(*target))
+		{
+			CR_AWAIT(
+				queue->m_readers.park_for(&readable, queue, deadline),
+				{ queue->m_readers.leave(); CR_THROW; });
+			queue->m_readers.leave();
+		}
+		queue->m_writers.unpark(queue->m_resumer);
+	CR_FINALLY
+	CR_IMPL_END
+
+	template<class T, std::size_t kSize, class ConditionVariable>
+	CR_IMPL(PODFixedQueuePattern<T, kSize, ConditionVariable>::PushBulk)
+		for(pushed = 0; pushed < count; pushed += batch)
+		{
+			while(!(batch = queue->m_ring.try_push_bulk(values + pushed, count - pushed)))
+			{
+				CR_AWAIT(
+					queue->m_writers.park(&writable, queue),
+					{ queue->m_writers.leave(); CR_THROW; });
+				queue->m_writers.leave();
+			}
+			queue->m_readers.unpark_n(batch, queue->m_resumer);
+		}
+	CR_FINALLY
+	CR_IMPL_END
+
+	template<class T, std::size_t kSize, class ConditionVariable>
+	CR_IMPL(PODFixedQueuePattern<T, kSize, ConditionVariable>::PopBulk)
+		assert(min <= max);
+
+		for(*count = 0;;)
+		{
+			if((batch = queue->m_ring.try_pop_bulk(target + *count, max - *count)))
+			{
+				*count += batch;
+				queue->m_writers.unpark_n(batch, queue->m_resumer);
+			}
+			if(*count >= min)
+				break;
+
+			CR_AWAIT(
+				queue->m_readers.park(&readable, queue),
+				{ queue->m_readers.leave(); CR_THROW; });
+			queue->m_readers.leave();
+		}
+	CR_FINALLY
+	CR_IMPL_END
+
+	template<class T, std::size_t kSize, class ConditionVariable>
+	CR_IMPL(PODFixedQueuePattern<T, kSize, ConditionVariable>::Claim)
+		while(!(*slot = queue->m_ring.try_claim()))
+		{
+			CR_AWAIT(
+				queue->m_writers.park(&writable, queue),
+				{ queue->m_writers.leave(); CR_THROW; });
+			queue->m_writers.leave();
+		}
+	CR_FINALLY
+	CR_IMPL_END
+
+	template<class T, std::size_t kSize, class ConditionVariable>
+	void PODFixedQueuePattern<T, kSize, ConditionVariable>::publish(
+		T * slot)
+	{
+		m_ring.publish(slot);
+		m_readers.unpark(m_resumer);
+	}
+
+	template<class T, std::size_t kSize, class ConditionVariable>
+	CR_IMPL(PODFixedQueuePattern<T, kSize, ConditionVariable>::Peek)
+		while(!(*element = queue->m_ring.try_peek()))
+		{
+			CR_AWAIT(
+				queue->m_readers.park(&readable, queue),
+				{ queue->m_readers.leave(); CR_THROW; });
+			queue->m_readers.leave();
+		}
 	CR_FINALLY
 	CR_IMPL_END
 
-	template<class T, std::size_t kSize, class Semaphore>
-	CR_IMPL(PODFixedQueuePattern<T, kSize, Semaphore>::Pop)
-		CR_AWAIT(queue->elements());
-		util::assign(
-			*target,
-			std::move(
-				queue->m_values[detail::inc_wrap(queue->m_values, queue->m_start)]));
-		queue->pop();
+	template<class T, std::size_t kSize, class ConditionVariable>
+	CR_IMPL(PODFixedQueuePattern<T, kSize, ConditionVariable>::TimedPeek)
+		while(!(*element = queue->m_ring.try_peek()))
+		{
+			CR_AWAIT(
+				queue->m_readers.park_for(&readable, queue, deadline),
+				{ queue->m_readers.leave(); CR_THROW; });
+			queue->m_readers.leave();
+		}
 	CR_FINALLY
 	CR_IMPL_END
 
-	template<std::size_t kSize, class Semaphore>
-	void PODFixedQueuePattern<void, kSize, Semaphore>::initialise()
+	template<class T, std::size_t kSize, class ConditionVariable>
+	void PODFixedQueuePattern<T, kSize, ConditionVariable>::release(
+		T const * element)
+	{
+		m_ring.release(element);
+		m_writers.unpark(m_resumer);
+	}
+
+	template<std::size_t kSize, class ConditionVariable>
+	bool PODFixedQueuePattern<void, kSize, ConditionVariable>::readable(
+		void const * queue)
+	{
+		return static_cast<PODFixedQueuePattern<void, kSize, ConditionVariable> const *>(queue)->m_ring.readable();
+	}
+
+	template<std::size_t kSize, class ConditionVariable>
+	bool PODFixedQueuePattern<void, kSize, ConditionVariable>::writable(
+		void const * queue)
+	{
+		return static_cast<PODFixedQueuePattern<void, kSize, ConditionVariable> const *>(queue)->m_ring.writable();
+	}
+
+	template<std::size_t kSize, class ConditionVariable>
+	void PODFixedQueuePattern<void, kSize, ConditionVariable>::initialise()
+	{
+		m_ring.initialise();
+		m_readers.initialise();
+		m_writers.initialise();
+		m_resumer = Resumer();
+	}
+
+	template<std::size_t kSize, class ConditionVariable>
+	void PODFixedQueuePattern<void, kSize, ConditionVariable>::set_resumer(
+		Resumer resumer)
+	{
+		m_resumer = resumer;
+	}
+
+	template<std::size_t kSize, class ConditionVariable>
+	Selectable PODFixedQueuePattern<void, kSize, ConditionVariable>::select_pop()
+	{
+		return detail::PODParkingLot<ConditionVariable>::template selectable<
+			PODFixedQueuePattern<void, kSize, ConditionVariable>,
+			&PODFixedQueuePattern<void, kSize, ConditionVariable>::m_readers,
+			&readable>(this);
+	}
+
+	template<std::size_t kSize, class ConditionVariable>
+	Selectable PODFixedQueuePattern<void, kSize, ConditionVariable>::select_push()
 	{
-		sync::PODQueueBasePattern<Semaphore>::initialise(kSize);
+		return detail::PODParkingLot<ConditionVariable>::template selectable<
+			PODFixedQueuePattern<void, kSize, ConditionVariable>,
+			&PODFixedQueuePattern<void, kSize, ConditionVariable>::m_writers,
+			&writable>(this);
 	}
 
-	template<std::size_t kSize, class Semaphore>
-	CR_IMPL(PODFixedQueuePattern<void, kSize, Semaphore>::Push)
-		CR_AWAIT(queue->free());
-		queue->push();
+	template<std::size_t kSize, class ConditionVariable>
+	CR_IMPL(PODFixedQueuePattern<void, kSize, ConditionVariable>::Push)
+		while(!queue->m_ring.try_push(true))
+		{
+			CR_AWAIT(
+				queue->m_writers.park(&writable, queue),
+				{ queue->m_writers.leave(); CR_THROW; });
+			queue->m_writers.leave();
+		}
+		queue->m_readers.unpark(queue->m_resumer);
+	CR_FINALLY
+	CR_IMPL_END
+
+	template<std::size_t kSize, class ConditionVariable>
+	CR_IMPL(PODFixedQueuePattern<void, kSize, ConditionVariable>::Pop)
+		for(bool token; !queue->m_ring.try_pop(token);)
+		{
+			CR_AWAIT(
+				queue->m_readers.park(&readable, queue),
+				{ queue->m_readers.leave(); CR_THROW; });
+			queue->m_readers.leave();
+		}
+		queue->m_writers.unpark(queue->m_resumer);
 	CR_FINALLY
 	CR_IMPL_END
 
-	template<std::size_t kSize, class Semaphore>
-	CR_IMPL(PODFixedQueuePattern<void, kSize, Semaphore>::Pop)
-		CR_AWAIT(queue->elements());
-		queue->pop();
+	template<std::size_t kSize, class ConditionVariable>
+	CR_IMPL(PODFixedQueuePattern<void, kSize, ConditionVariable>::TimedPop)
+		for(bool token; !queue->m_ring.try_pop(token);)
+		{
+			CR_AWAIT(
+				queue->m_readers.park_for(&readable, queue, deadline),
+				{ queue->m_readers.leave(); CR_THROW; });
+			queue->m_readers.leave();
+		}
+		queue->m_writers.unpark(queue->m_resumer);
 	CR_FINALLY
 	CR_IMPL_END
 
-	template<class T, std::size_t kSize, class Semaphore>
-	FixedQueuePattern<T, kSize, Semaphore>::FixedQueuePattern()
+	template<class T, std::size_t kSize, class ConditionVariable>
+	FixedQueuePattern<T, kSize, ConditionVariable>::FixedQueuePattern()
 	{
 		initialise();
 	}
-}
\ No newline at end of file
+}
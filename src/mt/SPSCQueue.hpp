@@ -0,0 +1,146 @@
+/** @file SPSCQueue.hpp
+	Contains the thread-safe single-producer single-consumer queue types. */
+#ifndef __libcr_mt_spscqueue_hpp_defined
+#define __libcr_mt_spscqueue_hpp_defined
+
+#include "detail/BoundedRing.hpp"
+#include "detail/WaiterSlot.hpp"
+#include "../primitives.hpp"
+#include "../util/RefConv.hpp"
+
+#include <atomic>
+#include <cstddef>
+
+namespace cr::mt
+{
+	template<class T, std::size_t kSize>
+	/** POD fixed capacity queue type for exactly one pushing and one popping coroutine, which may run on different threads.
+		Each side only writes its own index, and keeps a copy of the other side's index that it only refreshes when the queue seems full or empty, so that the fast paths need no read-modify-write operations. Instead of condition variables, each side has a single waiting slot.
+	@tparam T:
+		The queue's element type.
+		May also be a complex type, as the operations on the queue's values are not atomic.
+	@tparam kSize:
+		The queue's capacity. It is rounded up to a power of two. */
+	class PODSPSCQueue
+	{
+	public:
+		/** The queue's actual capacity. */
+		static constexpr std::size_t kCapacity = detail::round_up_pow2(kSize);
+	private:
+		static_assert(kSize > 0, "A queue needs to hold at least one element.");
+		/** Masks indices into the value array. */
+		static constexpr std::size_t kMask = kCapacity - 1;
+
+		/** The number of pushed values. Only written by the pushing side. */
+		alignas(64) std::atomic_size_t m_tail;
+		/** The pushing side's copy of `m_head`. */
+		std::size_t m_cached_head;
+		/** The popping coroutine, while it waits for an element. Checked by the pushing side. */
+		detail::PODWaiterSlot m_reader;
+
+		/** The number of popped values. Only written by the popping side. */
+		alignas(64) std::atomic_size_t m_head;
+		/** The popping side's copy of `m_tail`. */
+		std::size_t m_cached_tail;
+		/** The pushing coroutine, while it waits for a free slot. Checked by the popping side. */
+		detail::PODWaiterSlot m_writer;
+
+		/** How to resume waiting coroutines. */
+		alignas(64) Resumer m_resumer;
+		/** The queue's values. */
+		T m_values[kCapacity];
+
+		/** Whether a queue has an element.
+		@param[in] queue:
+			The queue. */
+		static bool readable(
+			void const * queue);
+		/** Whether a queue has a free slot.
+		@param[in] queue:
+			The queue. */
+		static bool writable(
+			void const * queue);
+
+		/** Whether the queue is full, as seen by the pushing side.
+			Only refreshes the pushing side's copy of `m_head` if the copy says that the queue is full. */
+		inline bool full();
+		/** Whether the queue is empty, as seen by the popping side.
+			Only refreshes the popping side's copy of `m_tail` if the copy says that the queue is empty. */
+		inline bool empty();
+
+		template<class V>
+		/** Appends a value and publishes it to the popping side.
+			The queue must not be full.
+		@param[in] value:
+			The value to append. */
+		inline void put(
+			V &&value);
+		/** Removes the oldest value and frees its slot for the pushing side.
+			The queue must not be empty.
+		@param[out] target:
+			The location to move the value to. */
+		inline void take(
+			T &target);
+	public:
+		/** Initialises the queue. */
+		void initialise();
+
+		/** Sets how coroutines waiting for the queue are resumed.
+			By default, they are resumed directly by the pushing or popping coroutine. Use a scheduler's `deferred()` resumer to enqueue them instead, so that the notifying coroutine continues right away.
+		@param[in] resumer:
+			How to resume waiting coroutines. */
+		inline void set_resumer(
+			Resumer resumer);
+
+		template<class V>
+		/** Pushes a value to the queue.
+			Must only be used by one coroutine at a time.
+		@tparam V:
+			The pushed value's type. */
+		TEMPLATE_COROUTINE(PushPattern, (V), void)
+		CR_STATE(
+			(PODSPSCQueue<T, kSize> &) queue,
+			(V) value);
+		CR_EXTERNAL
+
+		union Push {
+			PushPattern<T const&> copy;
+			PushPattern<T &&> move;
+		};
+
+		/** Pops a value from the queue.
+			Must only be used by one coroutine at a time. */
+		COROUTINE(Pop, void)
+		CR_STATE(
+			(PODSPSCQueue<T, kSize> &) queue,
+			(T &) target);
+		CR_EXTERNAL
+
+		/** Pops a value from the queue, unless the deadline expires first.
+			On expiry, the coroutine fails without popping a value. Must only be used by one coroutine at a time. */
+		COROUTINE(TimedPop, void)
+		CR_STATE(
+			(PODSPSCQueue<T, kSize> &) queue,
+			(T &) target,
+			(Deadline) deadline);
+		CR_EXTERNAL
+	};
+
+	template<class T, std::size_t kSize>
+	/** Non-POD fixed capacity queue type for exactly one pushing and one popping coroutine.
+	@tparam T:
+		The queue's element type.
+	@tparam kSize:
+		The queue's capacity. It is rounded up to a power of two. */
+	class SPSCQueue : public PODSPSCQueue<T, kSize>
+	{
+		using PODSPSCQueue<T, kSize>::initialise;
+	public:
+		/** Initialises the queue. */
+		inline SPSCQueue();
+	};
+}
+
+#include "SPSCQueue.inl"
+
+#endif
@@ -0,0 +1,113 @@
+namespace cr::mt
+{
+	template<class T, std::size_t kSize>
+	bool PODSPSCQueue<T, kSize>::readable(
+		void const * queue)
+	{
+		PODSPSCQueue<T, kSize> const * self = static_cast<PODSPSCQueue<T, kSize> const *>(queue);
+		return self->m_head.load(std::memory_order_relaxed)
+			!= self->m_tail.load(std::memory_order_acquire);
+	}
+
+	template<class T, std::size_t kSize>
+	bool PODSPSCQueue<T, kSize>::writable(
+		void const * queue)
+	{
+		PODSPSCQueue<T, kSize> const * self = static_cast<PODSPSCQueue<T, kSize> const *>(queue);
+		return self->m_tail.load(std::memory_order_relaxed)
+			- self->m_head.load(std::memory_order_acquire) != kCapacity;
+	}
+
+	template<class T, std::size_t kSize>
+	bool PODSPSCQueue<T, kSize>::full()
+	{
+		std::size_t const tail = m_tail.load(std::memory_order_relaxed);
+		if(tail - m_cached_head != kCapacity)
+			return false;
+		m_cached_head = m_head.load(std::memory_order_acquire);
+		return tail - m_cached_head == kCapacity;
+	}
+
+	template<class T, std::size_t kSize>
+	bool PODSPSCQueue<T, kSize>::empty()
+	{
+		std::size_t const head = m_head.load(std::memory_order_relaxed);
+		if(head != m_cached_tail)
+			return false;
+		m_cached_tail = m_tail.load(std::memory_order_acquire);
+		return head == m_cached_tail;
+	}
+
+	template<class T, std::size_t kSize>
+	template<class V>
+	void PODSPSCQueue<T, kSize>::put(
+		V &&value)
+	{
+		std::size_t const tail = m_tail.load(std::memory_order_relaxed);
+		util::assign(m_values[tail & kMask], std::forward<V>(value));
+		m_tail.store(tail + 1, std::memory_order_release);
+	}
+
+	template<class T, std::size_t kSize>
+	void PODSPSCQueue<T, kSize>::take(
+		T &target)
+	{
+		std::size_t const head = m_head.load(std::memory_order_relaxed);
+		util::assign(target, std::move(m_values[head & kMask]));
+		m_head.store(head + 1, std::memory_order_release);
+	}
+
+	template<class T, std::size_t kSize>
+	void PODSPSCQueue<T, kSize>::initialise()
+	{
+		std::atomic_init(&m_tail, (std::size_t) 0);
+		m_cached_head = 0;
+		m_reader.initialise();
+		std::atomic_init(&m_head, (std::size_t) 0);
+		m_cached_tail = 0;
+		m_writer.initialise();
+		m_resumer = Resumer();
+	}
+
+	template<class T, std::size_t kSize>
+	void PODSPSCQueue<T, kSize>::set_resumer(
+		Resumer resumer)
+	{
+		m_resumer = resumer;
+	}
+
+	template<class T, std::size_t kSize>
+	template<class V>
+	CR_IMPL(PODSPSCQueue<T, kSize>::PushPattern<V>)
+		// Checking again after waking also refreshes the outdated copy of the other side's index.
+		while(queue->full())
+			CR_AWAIT(queue->m_writer.wait(&writable, queue));
+		queue->put(std::forward<V>(value));
+		queue->m_reader.notify(queue->m_resumer);
+	CR_FINALLY
+	CR_IMPL_END
+
+	template<class T, std::size_t kSize>
+	CR_IMPL(PODSPSCQueue<T, kSize>::Pop)
+		while(queue->empty())
+			CR_AWAIT(queue->m_reader.wait(&readable, queue));
+		queue->take(*target);
+		queue->m_writer.notify(queue->m_resumer);
+	CR_FINALLY
+	CR_IMPL_END
+
+	template<class T, std::size_t kSize>
+	CR_IMPL(PODSPSCQueue<T, kSize>::TimedPop)
+		while(queue->empty())
+			CR_AWAIT(queue->m_reader.wait_for(&readable, queue, deadline));
+		queue->take(*target);
+		queue->m_writer.notify(queue->m_resumer);
+	CR_FINALLY
+	CR_IMPL_END
+
+	template<class T, std::size_t kSize>
+	SPSCQueue<T, kSize>::SPSCQueue()
+	{
+		initialise();
+	}
+}
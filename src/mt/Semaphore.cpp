@@ -3,6 +3,10 @@
 #include "ConditionVariable.hpp"
 
 #include "../Coroutine.hpp"
+#include "../Timeout.hpp"
+#include "../util/Backoff.hpp"
+
+#include <cassert>
 
 namespace cr::mt
 {
@@ -10,55 +14,52 @@ namespace cr::mt
 	void PODSemaphorePattern<ConditionVariable>::initialise(
 		std::size_t count)
 	{
+		assert(count < kWaiter);
+
 		m_cv.initialise();
-		std::atomic_init(&m_count, count);
-		std::atomic_init(&m_registering, (std::size_t) 0);
-		m_mutex.initialise();
+		std::atomic_init(&m_state, (std::uint64_t) count);
 	}
 
 	template<class ConditionVariable>
-	void PODSemaphorePattern<ConditionVariable>::notify()
+	void PODSemaphorePattern<ConditionVariable>::notify(
+		Resumer resumer)
 	{
-		if(m_cv.notify_one())
-			return;
+		std::uint64_t const state = m_state.fetch_add(kCount, std::memory_order_acq_rel);
+		assert(count(state + kCount) && "Semaphore count overflow.");
 
-		// Try to increment the semaphore (safe if it is > 0).
-		std::size_t count = 1;
-		while(count)
-			if(m_count.compare_exchange_weak(
-				count,
-				count + 1,
-				std::memory_order_acq_rel,
-				std::memory_order_relaxed))
-				return;
+		if(waiters(state))
+			hand_over(resumer);
+	}
 
+	template<class ConditionVariable>
+	void PODSemaphorePattern<ConditionVariable>::hand_over(
+		Resumer resumer)
+	{
+		std::uint64_t state = m_state.load(std::memory_order_relaxed);
 		for(;;)
 		{
-			// If there are registering coroutines, try again.
-			if(m_registering.load_strong(std::memory_order_relaxed))
-				continue;
-
-			// Otherwise, lock the semaphore.
-			detail::LockGuard lock { m_mutex };
+			if(!count(state) || !waiters(state))
+				return;
 
-			// If there are registering coroutines, try again.
-			if(m_registering.load_strong(std::memory_order_relaxed))
+			// Claim a unit of the count for a waiting coroutine.
+			if(!m_state.compare_exchange_weak(
+				state,
+				state - kCount - kWaiter,
+				std::memory_order_acquire,
+				std::memory_order_relaxed))
 				continue;
 
-			// Once more, try to remove a coroutine.
-			Coroutine * removed = m_cv.remove_one();
-			if(removed)
-			{
-				lock.unlock();
-				m_cv.acquire_and_complete(removed, removed);
-				(*removed)();
-				return;
-			} else
+			if(!m_cv.notify_one(resumer))
 			{
-				// Otherwise, notify the semaphore.
-				m_count.fetch_add(1, std::memory_order_acq_rel);
-				return;
+				// The claimed coroutine is not in the condition variable yet, or its timeout is being removed, so give the claim back.
+				m_state.fetch_add(kCount + kWaiter, std::memory_order_release);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				// Coroutines entering the condition variable from now on see the count, and hand it over themselves.
+				if(m_cv.empty())
+					return;
 			}
+
+			state = m_state.load(std::memory_order_relaxed);
 		}
 	}
 
@@ -66,43 +67,125 @@ namespace cr::mt
 	sync::mayblock PODSemaphorePattern<ConditionVariable>::WaitCall::libcr_wait(
 		Coroutine * coroutine)
 	{
-		if(m_semaphore.try_wait())
+		if(m_semaphore.take_or_register())
 			return sync::nonblock();
 
-		detail::LockGuard lock { m_semaphore.m_mutex };
-		// Was the semaphore increased in the meantime?
-		if(m_semaphore.try_wait())
+		(void) m_semaphore.m_cv.wait().libcr_wait(coroutine);
+
+		// A notification might have missed the coroutine while it was entering the condition variable.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if(count(m_semaphore.m_state.load(std::memory_order_relaxed)))
+			m_semaphore.hand_over(Resumer());
+
+		return sync::block();
+	}
+
+	template<class ConditionVariable>
+	sync::mayblock PODSemaphorePattern<ConditionVariable>::TimedWaitCall::libcr_wait(
+		Coroutine * coroutine)
+	{
+		if(m_semaphore.take_or_register())
 			return sync::nonblock();
 
-		m_semaphore.m_registering.fetch_add(1, std::memory_order_relaxed);
-		lock.unlock();
+		{
+			// The timing wheel stays locked until the timeout is in the condition variable.
+			Deadline::Registration registration(
+				m_deadline,
+				coroutine,
+				&m_semaphore,
+				&PODSemaphorePattern<ConditionVariable>::remove_timed);
+
+			coroutine->libcr_thread = cr::detail::Thread::kInvalid;
+			m_semaphore.m_cv.push_removable(registration.timeout());
+		}
 
-		(void) m_semaphore.m_cv.wait().libcr_wait(coroutine);
+		// A notification might have missed the coroutine while it was entering the condition variable.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if(count(m_semaphore.m_state.load(std::memory_order_relaxed)))
+			m_semaphore.hand_over(Resumer());
 
-		// Release, because the operation must not be reordered.
-		m_semaphore.m_registering.fetch_sub(1, std::memory_order_release);
 		return sync::block();
 	}
 
 	template<class ConditionVariable>
-	bool PODSemaphorePattern<ConditionVariable>::try_wait()
+	bool PODSemaphorePattern<ConditionVariable>::take_or_register()
 	{
-		std::size_t count = 1;
-		while(count)
-			if(m_count.compare_exchange_weak(
-				count,
-				count-1,
-				std::memory_order_acq_rel,
+		std::uint64_t state = m_state.load(std::memory_order_relaxed);
+		for(;;)
+			if(count(state))
+			{
+				if(m_state.compare_exchange_weak(
+					state,
+					state - kCount,
+					std::memory_order_acquire,
+					std::memory_order_relaxed))
+					return true;
+			} else if(m_state.compare_exchange_weak(
+				state,
+				state + kWaiter,
+				std::memory_order_relaxed,
 				std::memory_order_relaxed))
 			{
-				return true;
+				return false;
 			}
+	}
+
+	template<class ConditionVariable>
+	bool PODSemaphorePattern<ConditionVariable>::remove_timed(
+		void * semaphore,
+		Coroutine * timeout)
+	{
+		PODSemaphorePattern<ConditionVariable> &self = *static_cast<PODSemaphorePattern<ConditionVariable> *>(semaphore);
+		if(!self.m_cv.remove(timeout))
+			return false;
 
-		return false;
+		util::Backoff backoff;
+		std::uint64_t state = self.m_state.load(std::memory_order_relaxed);
+		for(;;)
+		{
+			// A notification claimed the coroutine, but failed to find it, and is about to give the claim back.
+			if(!waiters(state))
+			{
+				backoff.pause();
+				state = self.m_state.load(std::memory_order_relaxed);
+			} else if(self.m_state.compare_exchange_weak(
+				state,
+				state - kWaiter,
+				std::memory_order_relaxed,
+				std::memory_order_relaxed))
+				return true;
+		}
+	}
+
+	template<class ConditionVariable>
+	void PODSemaphorePattern<ConditionVariable>::select_add(
+		void * semaphore,
+		Coroutine * node)
+	{
+		PODSemaphorePattern<ConditionVariable> &self = *static_cast<PODSemaphorePattern<ConditionVariable> *>(semaphore);
+		if(self.take_or_register())
+		{
+			node->resume();
+			return;
+		}
+
+		self.m_cv.push_removable(node);
+
+		// A notification might have missed the node while it was entering the condition variable.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if(count(self.m_state.load(std::memory_order_relaxed)))
+			self.hand_over(Resumer());
+	}
+
+	template<class ConditionVariable>
+	void PODSemaphorePattern<ConditionVariable>::select_release(
+		void * semaphore)
+	{
+		static_cast<PODSemaphorePattern<ConditionVariable> *>(semaphore)->notify();
 	}
 
 	template class PODSemaphorePattern<PODConditionVariable>;
 	template class PODSemaphorePattern<PODFIFOConditionVariable>;
 	template class SemaphorePattern<PODConditionVariable>;
 	template class SemaphorePattern<PODFIFOConditionVariable>;
-}
\ No newline at end of file
+}
@@ -3,11 +3,12 @@
 #ifndef __libcr_mt_semaphore_hpp_defined
 #define __libcr_mt_semaphore_hpp_defined
 
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
 
-#include "detail/SoftMutex.hpp"
-#include "../util/Atomic.hpp"
 #include "../sync/Block.hpp"
+#include "../Selectable.hpp"
 #include "ConditionVariable.hpp"
 
 
@@ -20,24 +21,32 @@ namespace cr::mt
 {
 	template<class ConditionVariable>
 	/** POD semaphore type.
+		The count and the number of waiting coroutines share a single atomic word, so that uncontended waits and notifications take a single atomic read-modify-write operation, and the condition variable is only touched while coroutines are waiting.
 	@tparam ConditionVariable:
 		The condition variable type to use. */
 	class PODSemaphorePattern
 	{
-		/** Soft mutex protecting the semaphore. */
-		detail::PODSoftMutex m_mutex;
+		/** One unit of the count, which occupies the state's lower half. */
+		static constexpr std::uint64_t kCount = 1;
+		/** One waiting coroutine, counted in the state's upper half. */
+		static constexpr std::uint64_t kWaiter = std::uint64_t(1) << 32;
+
 		/** The condition variable. */
 		ConditionVariable m_cv;
-		/** The semaphore's count. */
-		util::Atomic<std::size_t> m_count;
-		/** The count of currently registering coroutines. */
-		util::Atomic<std::size_t> m_registering;
+		/** The semaphore's count and its number of waiting coroutines.
+			A waiting coroutine is counted from before it enters the condition variable until a notification claims it together with a unit of the count, or until its timeout removes it. */
+		std::atomic<std::uint64_t> m_state;
 	public:
-		/** Initialises the semaphore. */
+		/** Initialises the semaphore.
+		@param[in] count:
+			The semaphore's initial count. Must be less than 2^32. */
 		void initialise(
 			std::size_t count = 0);
-		/** Notifies the semaphore. */
-		void notify();
+		/** Notifies the semaphore.
+		@param[in] resumer:
+			How to resume a notified coroutine. */
+		void notify(
+			Resumer resumer = Resumer());
 
 		/** Helper type for waiting for a semaphore using `#CR_AWAIT`. */
 		class WaitCall
@@ -63,9 +72,85 @@ namespace cr::mt
 		/** Waits for the semaphore.
 			To be used with `#CR_AWAIT`. */
 		[[nodiscard]] constexpr WaitCall wait();
+
+		/** Helper type for waiting for a semaphore with a timeout using `#CR_AWAIT`. */
+		class TimedWaitCall
+		{
+			/** The semaphore to wait for. */
+			PODSemaphorePattern<ConditionVariable> &m_semaphore;
+			/** The deadline of the wait. */
+			Deadline m_deadline;
+		public:
+			/** Initialises the timed wait call.
+			@param[in] semaphore:
+				The semaphore to wait for.
+			@param[in] deadline:
+				The deadline of the wait. */
+			constexpr TimedWaitCall(
+				PODSemaphorePattern<ConditionVariable> * semaphore,
+				Deadline const& deadline);
+
+			/** Waits for the semaphore until the deadline expires.
+			@param[in] coroutine:
+				The coroutine to wait for the semaphore.
+			@return
+				Whether the operation is blocking. */
+			[[nodiscard]] sync::mayblock libcr_wait(
+				Coroutine * coroutine);
+		};
+
+		/** Waits for the semaphore until the deadline expires.
+			Fails if the deadline expires before the semaphore is notified. To be used with `#CR_AWAIT`.
+		@param[in] deadline:
+			The deadline of the wait, as created by the scheduler. */
+		[[nodiscard]] constexpr TimedWaitCall wait_for(
+			Deadline const& deadline);
+
+		/** Describes how `Select` waits for the semaphore.
+			A selected wait finishes like `wait()`, so that the unit stays taken. Like timed waits, the select node is counted as a waiting coroutine. */
+		[[nodiscard]] inline Selectable select_wait();
 	private:
-		/** Tries to wait for the semaphore. */
-		bool try_wait();
+		/** The count of a state. */
+		static constexpr std::uint64_t count(
+			std::uint64_t state);
+		/** The number of waiting coroutines of a state. */
+		static constexpr std::uint64_t waiters(
+			std::uint64_t state);
+
+		/** Takes a unit of the count, or registers a waiting coroutine if the count is zero.
+		@return
+			Whether a unit of the count was taken. */
+		bool take_or_register();
+		/** Passes units of the count to waiting coroutines, as long as there are both.
+		@param[in] resumer:
+			How to resume notified coroutines. */
+		void hand_over(
+			Resumer resumer);
+
+		/** Removes an expired timeout from the condition variable, and unregisters its coroutine.
+		@param[in] semaphore:
+			The semaphore.
+		@param[in] timeout:
+			The timeout to remove.
+		@return
+			Whether the timeout was still waiting. */
+		static bool remove_timed(
+			void * semaphore,
+			Coroutine * timeout);
+
+		/** Adds a select node to the semaphore, or notifies it after taking a unit of the count if there is one.
+		@param[in] semaphore:
+			The semaphore.
+		@param[in] node:
+			The node to add. */
+		static void select_add(
+			void * semaphore,
+			Coroutine * node);
+		/** Passes on a unit that a select node kept but does not use.
+		@param[in] semaphore:
+			The semaphore. */
+		static void select_release(
+			void * semaphore);
 	};
 
 	template<class ConditionVariable>
@@ -13,6 +13,42 @@ namespace cr::mt
 		return this;
 	}
 
+	template<class ConditionVariable>
+	constexpr PODSemaphorePattern<ConditionVariable>::TimedWaitCall::TimedWaitCall(
+		PODSemaphorePattern<ConditionVariable> * semaphore,
+		Deadline const& deadline):
+		m_semaphore(*semaphore),
+		m_deadline(deadline)
+	{
+	}
+
+	template<class ConditionVariable>
+	constexpr typename PODSemaphorePattern<ConditionVariable>::TimedWaitCall PODSemaphorePattern<ConditionVariable>::wait_for(
+		Deadline const& deadline)
+	{
+		return TimedWaitCall(this, deadline);
+	}
+
+	template<class ConditionVariable>
+	Selectable PODSemaphorePattern<ConditionVariable>::select_wait()
+	{
+		return Selectable(this, &select_add, &remove_timed, nullptr, &select_release);
+	}
+
+	template<class ConditionVariable>
+	constexpr std::uint64_t PODSemaphorePattern<ConditionVariable>::count(
+		std::uint64_t state)
+	{
+		return state & (kWaiter - 1);
+	}
+
+	template<class ConditionVariable>
+	constexpr std::uint64_t PODSemaphorePattern<ConditionVariable>::waiters(
+		std::uint64_t state)
+	{
+		return state >> 32;
+	}
+
 	template<class ConditionVariable>
 	SemaphorePattern<ConditionVariable>::SemaphorePattern()
 	{
@@ -0,0 +1,191 @@
+#include "SharedMutex.hpp"
+#include "../Coroutine.hpp"
+
+#include <cassert>
+
+namespace cr::mt
+{
+	template<class ConditionVariable>
+	void PODSharedMutexPattern<ConditionVariable>::initialise(
+		bool prefer_writers)
+	{
+		for(ReaderSlot &slot: m_slots)
+			std::atomic_init(&slot.count, std::size_t(0));
+		std::atomic_init(&m_writer, false);
+		std::atomic_init(&m_draining, (Coroutine *) nullptr);
+		m_lock.initialise();
+		m_waiting = 0;
+		m_phase = 0;
+		m_prefer_writers = prefer_writers;
+		m_readers[0].initialise();
+		m_readers[1].initialise();
+		m_writers.initialise();
+	}
+
+	template<class ConditionVariable>
+	std::size_t PODSharedMutexPattern<ConditionVariable>::readers() const
+	{
+		// The slots are read after setting `m_writer`, and readers check `m_writer` after counting themselves in, so every reader is either seen here or backs off.
+		std::size_t sum = 0;
+		for(ReaderSlot const& slot: m_slots)
+			sum += slot.count.load(std::memory_order_seq_cst);
+		return sum;
+	}
+
+	template<class ConditionVariable>
+	void PODSharedMutexPattern<ConditionVariable>::drain(
+		Resumer resumer)
+	{
+		if(readers())
+			return;
+
+		// Several readers might see the count drop to 0, but only one of them takes the writer.
+		if(Coroutine * const writer = m_draining.exchange(nullptr, std::memory_order_acq_rel))
+			resumer(writer);
+	}
+
+	template<class ConditionVariable>
+	sync::mayblock PODSharedMutexPattern<ConditionVariable>::LockCall::libcr_wait(
+		Coroutine * coroutine)
+	{
+		{
+			detail::LockGuard guard(m_mutex.m_lock);
+			if(m_mutex.m_writer.load(std::memory_order_relaxed))
+			{
+				(void) m_mutex.m_writers.wait().libcr_wait(coroutine);
+				return sync::block();
+			}
+
+			// Keep new readers out, and wait for the current ones to unlock the mutex.
+			m_mutex.m_writer.store(true, std::memory_order_seq_cst);
+		}
+
+		if(!m_mutex.readers())
+			return sync::nonblock();
+
+		cr::detail::Thread const thread = coroutine->libcr_thread;
+		// The coroutine might be resumed by any thread as soon as it is draining.
+		coroutine->libcr_thread = cr::detail::Thread::kInvalid;
+		m_mutex.m_draining.store(coroutine, std::memory_order_seq_cst);
+
+		// The last reader might have unlocked the mutex before it could see the coroutine.
+		if(!m_mutex.readers() && m_mutex.m_draining.exchange(nullptr, std::memory_order_acq_rel))
+		{
+			coroutine->libcr_thread = thread;
+			return sync::nonblock();
+		}
+
+		return sync::block();
+	}
+
+	template<class ConditionVariable>
+	bool PODSharedMutexPattern<ConditionVariable>::try_lock()
+	{
+		detail::LockGuard guard(m_lock);
+		if(m_writer.load(std::memory_order_relaxed))
+			return false;
+
+		m_writer.store(true, std::memory_order_seq_cst);
+		if(!readers())
+			return true;
+
+		// Readers that backed off in the meantime cannot have started waiting, as that requires the lock.
+		m_writer.store(false, std::memory_order_release);
+		return false;
+	}
+
+	template<class ConditionVariable>
+	void PODSharedMutexPattern<ConditionVariable>::unlock(
+		Resumer resumer)
+	{
+		assert(m_writer.load(std::memory_order_relaxed));
+		assert(!m_draining.load(std::memory_order_relaxed));
+
+		detail::LockGuard guard(m_lock);
+
+		bool const admit = m_waiting && !(m_prefer_writers && !m_writers.empty());
+		unsigned const phase = m_phase;
+		if(admit)
+		{
+			// Count the admitted readers in before resuming any of them.
+			slot().count.fetch_add(m_waiting, std::memory_order_seq_cst);
+			m_waiting = 0;
+			m_phase ^= 1;
+		}
+
+		// The next writer keeps new readers out while the admitted ones are still running.
+		Coroutine * const writer = m_writers.remove_one();
+		if(writer)
+			m_draining.store(writer, std::memory_order_seq_cst);
+		else
+			m_writer.store(false, std::memory_order_release);
+
+		guard.unlock();
+
+		// No reader can enter the admitted phase's condition variable until the next exclusive lock is unlocked.
+		if(admit)
+			m_readers[phase].notify_all(resumer);
+		if(writer)
+			drain(resumer);
+	}
+
+	template<class ConditionVariable>
+	sync::mayblock PODSharedMutexPattern<ConditionVariable>::SharedLockCall::libcr_wait(
+		Coroutine * coroutine)
+	{
+		ReaderSlot &slot = m_mutex.slot();
+		slot.count.fetch_add(1, std::memory_order_seq_cst);
+		if(!m_mutex.m_writer.load(std::memory_order_seq_cst))
+			return sync::nonblock();
+
+		// Back off, as the writer might be waiting for the count to drop to 0.
+		slot.count.fetch_sub(1, std::memory_order_seq_cst);
+		m_mutex.drain(Resumer());
+
+		detail::LockGuard guard(m_mutex.m_lock);
+		if(!m_mutex.m_writer.load(std::memory_order_relaxed))
+		{
+			// Writers only start waiting for readers while holding the lock, so they will see the reader.
+			slot.count.fetch_add(1, std::memory_order_seq_cst);
+			return sync::nonblock();
+		}
+
+		++m_mutex.m_waiting;
+		(void) m_mutex.m_readers[m_mutex.m_phase].wait().libcr_wait(coroutine);
+		return sync::block();
+	}
+
+	template<class ConditionVariable>
+	bool PODSharedMutexPattern<ConditionVariable>::try_lock_shared()
+	{
+		ReaderSlot &reader = slot();
+		reader.count.fetch_add(1, std::memory_order_seq_cst);
+		if(!m_writer.load(std::memory_order_seq_cst))
+			return true;
+
+		reader.count.fetch_sub(1, std::memory_order_seq_cst);
+		drain(Resumer());
+		return false;
+	}
+
+	template<class ConditionVariable>
+	void PODSharedMutexPattern<ConditionVariable>::unlock_shared(
+		Resumer resumer)
+	{
+		slot().count.fetch_sub(1, std::memory_order_seq_cst);
+		if(m_writer.load(std::memory_order_seq_cst))
+			drain(resumer);
+	}
+
+	template<class ConditionVariable>
+	SharedMutexPattern<ConditionVariable>::SharedMutexPattern(
+		bool prefer_writers)
+	{
+		initialise(prefer_writers);
+	}
+
+	template class PODSharedMutexPattern<PODConditionVariable>;
+	template class PODSharedMutexPattern<PODFIFOConditionVariable>;
+	template class SharedMutexPattern<PODConditionVariable>;
+	template class SharedMutexPattern<PODFIFOConditionVariable>;
+}
@@ -0,0 +1,37 @@
+namespace cr::mt
+{
+	template<class ConditionVariable>
+	typename PODSharedMutexPattern<ConditionVariable>::ReaderSlot &PODSharedMutexPattern<ConditionVariable>::slot()
+	{
+		static std::atomic_size_t s_threads(0);
+		// Threads are spread over the slots in the order in which they first use a shared mutex.
+		static thread_local std::size_t const s_slot = s_threads.fetch_add(1, std::memory_order_relaxed) % kReaderSlots;
+		return m_slots[s_slot];
+	}
+
+	template<class ConditionVariable>
+	constexpr PODSharedMutexPattern<ConditionVariable>::LockCall::LockCall(
+		PODSharedMutexPattern<ConditionVariable> &mutex):
+		m_mutex(mutex)
+	{
+	}
+
+	template<class ConditionVariable>
+	constexpr typename PODSharedMutexPattern<ConditionVariable>::LockCall PODSharedMutexPattern<ConditionVariable>::lock()
+	{
+		return LockCall(*this);
+	}
+
+	template<class ConditionVariable>
+	constexpr PODSharedMutexPattern<ConditionVariable>::SharedLockCall::SharedLockCall(
+		PODSharedMutexPattern<ConditionVariable> &mutex):
+		m_mutex(mutex)
+	{
+	}
+
+	template<class ConditionVariable>
+	constexpr typename PODSharedMutexPattern<ConditionVariable>::SharedLockCall PODSharedMutexPattern<ConditionVariable>::lock_shared()
+	{
+		return SharedLockCall(*this);
+	}
+}
@@ -0,0 +1,208 @@
+/** @file UnboundedQueue.hpp
+	Contains the thread-safe unbounded queue types. */
+#ifndef __libcr_mt_unboundedqueue_hpp_defined
+#define __libcr_mt_unboundedqueue_hpp_defined
+
+#include "ConditionVariable.hpp"
+#include "detail/ParkingLot.hpp"
+#include "detail/SoftMutex.hpp"
+#include "../detail/SegmentPool.hpp"
+#include "../primitives.hpp"
+#include "../util/Backoff.hpp"
+#include "../util/RefConv.hpp"
+
+#include <atomic>
+#include <cstddef>
+
+namespace cr::mt
+{
+	template<class T, std::size_t kSegmentSize, class ConditionVariable>
+	/** POD unbounded queue type.
+		The values are kept in a list of fixed-size segments, which are taken from and returned to a per-thread pool, so that a queue in a steady state does not allocate. Producers claim slots in the tail segment with a single atomic increment, like in the fixed queues, and only lock the producers' end to link the next segment. Consumers lock their own end of the queue. Pushing never waits, and coroutines only wait in a condition variable while the queue is empty.
+		Linking the next segment waits until the elements claimed in the full segment are written, so a producer that is preempted while writing delays the other producers once per segment.
+		The queue has to be destroyed explicitly.
+	@tparam T:
+		The queue's element type.
+		May also be a complex type, as the operations on the queue's values are not atomic.
+	@tparam kSegmentSize:
+		The number of values per segment.
+	@tparam ConditionVariable:
+		POD thread-safe condition variable type to wait in. */
+	class PODUnboundedQueuePattern
+	{
+		/** An element, and whether it was written.
+			Producers write their claimed slots in any order, so consumers check every slot before popping it. */
+		struct Slot
+		{
+			/** The element. */
+			T value;
+			/** Whether the element was written and not popped yet. */
+			std::atomic_bool ready;
+		};
+		/** The queue's segments. */
+		typedef cr::detail::Segment<Slot, kSegmentSize> Segment;
+		/** The pool the segments come from. */
+		typedef cr::detail::SegmentPool<Slot, kSegmentSize> SegmentPool;
+
+		/** The next free slot's index within the tail segment.
+			Producers claim slots by incrementing it, and values past the segment's size make them link the next segment. */
+		alignas(64) std::atomic_size_t m_end;
+		/** Serialises linking the next segment. */
+		detail::PODSoftMutex m_push_mutex;
+		/** The segment the next element is written to.
+			Only replaced after all of its slots were written, so producers that claimed a slot in it can still read it. */
+		Segment * m_tail;
+		/** The number of elements pushed before the tail segment. */
+		std::size_t m_base;
+		/** The number of written elements. */
+		alignas(64) std::atomic_size_t m_pushed;
+		/** Recycled segments taken by the producers. */
+		Segment * m_spare;
+		/** Protects the consumers' end of the queue. */
+		alignas(64) mutable detail::PODSoftMutex m_pop_mutex;
+		/** The segment holding the first element. */
+		Segment * m_head;
+		/** The first element's index within the head segment. */
+		std::size_t m_start;
+		/** The number of popped elements. */
+		std::atomic_size_t m_popped;
+		/** Consumed segments returned to the producers.
+			Producers and consumers often run on different threads, so the per-thread pools alone would not recycle the segments. Consumers push segments, and producers take the whole stack at once. */
+		alignas(64) std::atomic<Segment *> m_recycled;
+		/** The number of segments in `m_recycled` and `m_spare`, so that the queue keeps at most as many as a thread's pool. */
+		std::atomic_size_t m_recycled_count;
+		/** How to resume waiting coroutines. */
+		Resumer m_resumer;
+		/** The coroutines waiting for an element. */
+		detail::PODParkingLot<ConditionVariable> m_readers;
+
+		/** Whether a queue's first element was written, so that it can be popped.
+		@param[in] queue:
+			The queue. */
+		static bool readable(
+			void const * queue);
+
+		/** Takes a recycled segment, or one from the calling thread's pool.
+			The producers' lock must be held. */
+		inline Segment * allocate();
+		/** Returns a segment to the producers, or to the calling thread's pool if the queue already keeps enough segments.
+		@param[in] segment:
+			The consumed segment. */
+		inline void release(
+			Segment * segment);
+
+		/** Links the next segment once all slots of the full tail segment were written. */
+		void extend();
+
+		template<class V>
+		/** Appends a value and notifies a waiting coroutine.
+		@param[in] value:
+			The value to append. */
+		inline void put(
+			V &&value);
+	public:
+		/** Initialises the queue. */
+		void initialise();
+		/** Returns the queue's segments to the calling thread's pool.
+			No coroutine may be using the queue anymore, and the queue must not be used afterwards. */
+		void destroy();
+
+		/** Sets how coroutines waiting for the queue are resumed.
+			By default, they are resumed directly by the pushing coroutine. Use a scheduler's `deferred()` resumer to enqueue them instead, so that the pushing coroutine continues right away.
+		@param[in] resumer:
+			How to resume waiting coroutines. */
+		inline void set_resumer(
+			Resumer resumer);
+
+		/** Copies a value to the end of the queue.
+		@param[in] value:
+			The value to push. */
+		inline void push(
+			T const& value);
+		/** Moves a value to the end of the queue.
+		@param[in] value:
+			The value to push. */
+		inline void push(
+			T &&value);
+
+		/** Tries to pop a value without waiting.
+		@param[out] target:
+			The location to move the value to.
+		@return
+			Whether there was a value. */
+		inline bool try_pop(
+			T &target);
+
+		/** Pops a value from the queue. */
+		COROUTINE(Pop, void)
+		CR_STATE(
+			(PODUnboundedQueuePattern<T, kSegmentSize, ConditionVariable> &) queue,
+			(T &) target);
+		CR_EXTERNAL
+
+		/** Pops a value from the queue, unless the deadline expires first.
+			On expiry, the coroutine fails without popping a value. */
+		COROUTINE(TimedPop, void)
+		CR_STATE(
+			(PODUnboundedQueuePattern<T, kSegmentSize, ConditionVariable> &) queue,
+			(T &) target,
+			(Deadline) deadline);
+		CR_EXTERNAL
+	};
+
+	template<class T, std::size_t kSegmentSize, class ConditionVariable>
+	/** Non-POD unbounded queue type.
+		In contrast to the POD version, this version destroys the queue in the destructor.
+	@tparam T:
+		The queue's element type.
+	@tparam kSegmentSize:
+		The number of values per segment.
+	@tparam ConditionVariable:
+		POD thread-safe condition variable type to wait in. */
+	class UnboundedQueuePattern : public PODUnboundedQueuePattern<T, kSegmentSize, ConditionVariable>
+	{
+		using PODUnboundedQueuePattern<T, kSegmentSize, ConditionVariable>::initialise;
+		using PODUnboundedQueuePattern<T, kSegmentSize, ConditionVariable>::destroy;
+	public:
+		/** Initialises the queue. */
+		inline UnboundedQueuePattern();
+		/** Destroys the queue. */
+		inline ~UnboundedQueuePattern();
+
+		UnboundedQueuePattern(UnboundedQueuePattern const&) = delete;
+		UnboundedQueuePattern &operator=(UnboundedQueuePattern const&) = delete;
+	};
+
+	template<class T, std::size_t kSegmentSize = 32>
+	/** POD unbounded queue type.
+	@tparam T:
+		The queue's data type.
+	@tparam kSegmentSize:
+		The number of values per segment. */
+	using PODUnboundedQueue = PODUnboundedQueuePattern<T, kSegmentSize, mt::PODConditionVariable>;
+	template<class T, std::size_t kSegmentSize = 32>
+	/** POD unbounded queue type with FIFO notifications.
+	@tparam T:
+		The queue's data type.
+	@tparam kSegmentSize:
+		The number of values per segment. */
+	using PODFIFOUnboundedQueue = PODUnboundedQueuePattern<T, kSegmentSize, mt::PODFIFOConditionVariable>;
+	template<class T, std::size_t kSegmentSize = 32>
+	/** Unbounded queue type.
+	@tparam T:
+		The queue's data type.
+	@tparam kSegmentSize:
+		The number of values per segment. */
+	using UnboundedQueue = UnboundedQueuePattern<T, kSegmentSize, mt::PODConditionVariable>;
+	template<class T, std::size_t kSegmentSize = 32>
+	/** Unbounded queue type with FIFO notifications.
+	@tparam T:
+		The queue's data type.
+	@tparam kSegmentSize:
+		The number of values per segment. */
+	using FIFOUnboundedQueue = UnboundedQueuePattern<T, kSegmentSize, mt::PODFIFOConditionVariable>;
+}
+
+#include "UnboundedQueue.inl"
+
+#endif
@@ -0,0 +1,241 @@
+namespace cr::mt
+{
+	template<class T, std::size_t kSegmentSize, class ConditionVariable>
+	bool PODUnboundedQueuePattern<T, kSegmentSize, ConditionVariable>::readable(
+		void const * queue)
+	{
+		PODUnboundedQueuePattern<T, kSegmentSize, ConditionVariable> const * self = static_cast<PODUnboundedQueuePattern<T, kSegmentSize, ConditionVariable> const *>(queue);
+		if(self->m_popped.load(std::memory_order_relaxed)
+			== self->m_pushed.load(std::memory_order_acquire))
+			return false;
+
+		// Later elements may be written before the first one, but only the first one can be popped. Its producer unparks the consumers once it wrote it.
+		detail::LockGuard lock(self->m_pop_mutex);
+		if(self->m_popped.load(std::memory_order_relaxed)
+			== self->m_pushed.load(std::memory_order_acquire))
+			return false;
+
+		Segment const * head = self->m_head;
+		std::size_t start = self->m_start;
+		if(start == kSegmentSize)
+		{
+			head = head->next;
+			start = 0;
+		}
+		return head->values[start].ready.load(std::memory_order_acquire);
+	}
+
+	template<class T, std::size_t kSegmentSize, class ConditionVariable>
+	typename PODUnboundedQueuePattern<T, kSegmentSize, ConditionVariable>::Segment *
+		PODUnboundedQueuePattern<T, kSegmentSize, ConditionVariable>::allocate()
+	{
+		// Only one producer takes the stack at a time, and it takes all of it, so there is no ABA problem.
+		if(!m_spare && m_recycled.load(std::memory_order_relaxed))
+			m_spare = m_recycled.exchange(nullptr, std::memory_order_acquire);
+
+		if(Segment * segment = m_spare)
+		{
+			m_spare = segment->next;
+			m_recycled_count.fetch_sub(1, std::memory_order_relaxed);
+			segment->next = nullptr;
+			return segment;
+		}
+
+		// Consumers clear the slots of recycled segments, but pooled segments may be new or come from a destroyed queue.
+		Segment * segment = SegmentPool::allocate();
+		for(Slot &slot : segment->values)
+			slot.ready.store(false, std::memory_order_relaxed);
+		return segment;
+	}
+
+	template<class T, std::size_t kSegmentSize, class ConditionVariable>
+	void PODUnboundedQueuePattern<T, kSegmentSize, ConditionVariable>::release(
+		Segment * segment)
+	{
+		if(m_recycled_count.load(std::memory_order_relaxed) >= SegmentPool::kMaxPooled)
+		{
+			SegmentPool::release(segment);
+			return;
+		}
+
+		m_recycled_count.fetch_add(1, std::memory_order_relaxed);
+		Segment * top = m_recycled.load(std::memory_order_relaxed);
+		do {
+			segment->next = top;
+		} while(!m_recycled.compare_exchange_weak(
+			top,
+			segment,
+			std::memory_order_release,
+			std::memory_order_relaxed));
+	}
+
+	template<class T, std::size_t kSegmentSize, class ConditionVariable>
+	void PODUnboundedQueuePattern<T, kSegmentSize, ConditionVariable>::initialise()
+	{
+		m_push_mutex.initialise();
+		m_pop_mutex.initialise();
+		m_spare = nullptr;
+		std::atomic_init(&m_recycled, (Segment *) nullptr);
+		std::atomic_init(&m_recycled_count, (std::size_t) 0);
+		m_head = m_tail = allocate();
+		m_start = m_base = 0;
+		std::atomic_init(&m_end, (std::size_t) 0);
+		std::atomic_init(&m_pushed, (std::size_t) 0);
+		std::atomic_init(&m_popped, (std::size_t) 0);
+		m_resumer = Resumer();
+		m_readers.initialise();
+	}
+
+	template<class T, std::size_t kSegmentSize, class ConditionVariable>
+	void PODUnboundedQueuePattern<T, kSegmentSize, ConditionVariable>::destroy()
+	{
+		Segment * const lists[] = {
+			m_head,
+			m_spare,
+			m_recycled.exchange(nullptr, std::memory_order_acquire)
+		};
+		for(Segment * list : lists)
+			while(Segment * segment = list)
+			{
+				list = segment->next;
+				SegmentPool::release(segment);
+			}
+		m_head = m_tail = m_spare = nullptr;
+		m_recycled_count.store(0, std::memory_order_relaxed);
+	}
+
+	template<class T, std::size_t kSegmentSize, class ConditionVariable>
+	void PODUnboundedQueuePattern<T, kSegmentSize, ConditionVariable>::set_resumer(
+		Resumer resumer)
+	{
+		m_resumer = resumer;
+	}
+
+	template<class T, std::size_t kSegmentSize, class ConditionVariable>
+	void PODUnboundedQueuePattern<T, kSegmentSize, ConditionVariable>::extend()
+	{
+		detail::LockGuard lock(m_push_mutex);
+		// Another producer may have linked the next segment already.
+		if(m_end.load(std::memory_order_relaxed) < kSegmentSize)
+			return;
+
+		// Producers that claimed a slot still read the tail segment until they wrote it. Nobody can claim slots in the next segment yet, so the count is exact.
+		std::size_t const end = m_base + kSegmentSize;
+		util::Backoff backoff;
+		while(m_pushed.load(std::memory_order_acquire) < end)
+			backoff.pause();
+
+		// Link the new segment before publishing any of its elements.
+		m_tail = m_tail->next = allocate();
+		m_base = end;
+		m_end.store(0, std::memory_order_release);
+	}
+
+	template<class T, std::size_t kSegmentSize, class ConditionVariable>
+	template<class V>
+	void PODUnboundedQueuePattern<T, kSegmentSize, ConditionVariable>::put(
+		V &&value)
+	{
+		std::size_t index;
+		while((index = m_end.fetch_add(1, std::memory_order_acquire)) >= kSegmentSize)
+			extend();
+
+		Slot &slot = m_tail->values[index];
+		util::assign(slot.value, std::forward<V>(value));
+		slot.ready.store(true, std::memory_order_release);
+		m_pushed.fetch_add(1, std::memory_order_release);
+
+		m_readers.unpark(m_resumer);
+	}
+
+	template<class T, std::size_t kSegmentSize, class ConditionVariable>
+	void PODUnboundedQueuePattern<T, kSegmentSize, ConditionVariable>::push(
+		T const& value)
+	{
+		put(value);
+	}
+
+	template<class T, std::size_t kSegmentSize, class ConditionVariable>
+	void PODUnboundedQueuePattern<T, kSegmentSize, ConditionVariable>::push(
+		T &&value)
+	{
+		put(std::move(value));
+	}
+
+	template<class T, std::size_t kSegmentSize, class ConditionVariable>
+	bool PODUnboundedQueuePattern<T, kSegmentSize, ConditionVariable>::try_pop(
+		T &target)
+	{
+		if(m_popped.load(std::memory_order_relaxed)
+			== m_pushed.load(std::memory_order_acquire))
+			return false;
+
+		detail::LockGuard lock(m_pop_mutex);
+		std::size_t const popped = m_popped.load(std::memory_order_relaxed);
+		if(popped == m_pushed.load(std::memory_order_acquire))
+			return false;
+
+		// The producers already moved on to the next segment, so nobody else uses the consumed one.
+		Segment * empty = nullptr;
+		Segment * head = m_head;
+		std::size_t start = m_start;
+		if(start == kSegmentSize)
+		{
+			empty = head;
+			head = empty->next;
+			start = 0;
+		}
+
+		// The element's producer may still be writing it, while later elements were already written.
+		Slot &slot = head->values[start];
+		if(!slot.ready.load(std::memory_order_acquire))
+			return false;
+
+		util::assign(target, std::move(slot.value));
+		slot.ready.store(false, std::memory_order_relaxed);
+		m_head = head;
+		m_start = start + 1;
+		m_popped.store(popped + 1, std::memory_order_relaxed);
+		lock.unlock();
+
+		if(empty)
+			release(empty);
+		return true;
+	}
+
+	template<class T, std::size_t kSegmentSize, class ConditionVariable>
+	CR_IMPL(PODUnboundedQueuePattern<T, kSegmentSize, ConditionVariable>::Pop)
+		while(!queue->try_pop(*target))
+		{
+			CR_AWAIT(
+				queue->m_readers.park(&readable, queue),
+				{ queue->m_readers.leave(); CR_THROW; });
+			queue->m_readers.leave();
+		}
+	CR_FINALLY
+	CR_IMPL_END
+
+	template<class T, std::size_t kSegmentSize, class ConditionVariable>
+	CR_IMPL(PODUnboundedQueuePattern<T, kSegmentSize, ConditionVariable>::TimedPop)
+		while(!queue->try_pop(*target))
+		{
+			CR_AWAIT(
+				queue->m_readers.park_for(&readable, queue, deadline),
+				{ queue->m_readers.leave(); CR_THROW; });
+			queue->m_readers.leave();
+		}
+	CR_FINALLY
+	CR_IMPL_END
+
+	template<class T, std::size_t kSegmentSize, class ConditionVariable>
+	UnboundedQueuePattern<T, kSegmentSize, ConditionVariable>::UnboundedQueuePattern()
+	{
+		initialise();
+	}
+
+	template<class T, std::size_t kSegmentSize, class ConditionVariable>
+	UnboundedQueuePattern<T, kSegmentSize, ConditionVariable>::~UnboundedQueuePattern()
+	{
+		destroy();
+	}
+}
@@ -0,0 +1,136 @@
+/** @file BoundedRing.hpp
+	Contains the lock-free bounded ring buffer used by the thread-safe queues. */
+#ifndef __libcr_mt_detail_boundedring_hpp_defined
+#define __libcr_mt_detail_boundedring_hpp_defined
+
+#include <atomic>
+#include <cstddef>
+
+namespace cr::mt::detail
+{
+	/** The smallest power of two that is not smaller than a value.
+	@param[in] value:
+		The value to round up.
+	@return
+		The rounded value. */
+	constexpr std::size_t round_up_pow2(
+		std::size_t value);
+
+	template<class T, std::size_t kSize>
+	/** POD lock-free multi-producer multi-consumer bounded ring buffer.
+		Every slot carries a sequence number that tells producers and consumers whose turn it is, so that both sides only contend on their own index, and never wait for each other unless the ring is empty or full.
+	@tparam T:
+		The element type. Must be default constructible and assignable.
+	@tparam kSize:
+		The minimal capacity. It is rounded up to a power of two, so that indices can be masked instead of wrapped. */
+	class PODBoundedRing
+	{
+	public:
+		/** The ring's actual capacity. */
+		static constexpr std::size_t kCapacity = round_up_pow2(kSize);
+	private:
+		static_assert(kSize > 0, "A ring needs to hold at least one element.");
+		/** Masks indices into the slot array. */
+		static constexpr std::size_t kMask = kCapacity - 1;
+
+		/** A slot in the ring. */
+		struct Slot
+		{
+			/** Equals the writing index while the slot is free, and the writing index + 1 while it holds an element. */
+			std::atomic_size_t sequence;
+			/** The slot's element. */
+			T value;
+		};
+
+		/** The slot holding a value.
+		@param[in] value:
+			A value inside the ring. */
+		inline Slot &slot_of(
+			T const * value);
+
+		/** The next index to write to. */
+		alignas(64) std::atomic_size_t m_tail;
+		/** The next index to read from. */
+		alignas(64) std::atomic_size_t m_head;
+		/** The ring's slots. */
+		alignas(64) Slot m_slots[kCapacity];
+	public:
+		/** Initialises the ring to be empty. */
+		inline void initialise();
+
+		template<class V>
+		/** Tries to append an element.
+			The element is only consumed if the call succeeds.
+		@param[in] value:
+			The value to append.
+		@return
+			Whether the ring had room for the element. */
+		inline bool try_push(
+			V &&value);
+
+		/** Tries to remove the oldest element.
+		@param[out] target:
+			The location to move the element to.
+		@return
+			Whether there was an element. */
+		inline bool try_pop(
+			T &target);
+
+		/** Tries to append several elements at once.
+			Claims as many consecutive free slots as available with a single index update.
+		@param[in] values:
+			The values to copy.
+		@param[in] count:
+			The maximum number of values to append.
+		@return
+			The number of appended values. */
+		inline std::size_t try_push_bulk(
+			T const * values,
+			std::size_t count);
+
+		/** Tries to remove several of the oldest elements at once.
+			Claims as many consecutive elements as available with a single index update.
+		@param[out] target:
+			The location to move the elements to.
+		@param[in] max:
+			The maximum number of elements to remove.
+		@return
+			The number of removed elements. */
+		inline std::size_t try_pop_bulk(
+			T * target,
+			std::size_t max);
+
+		/** Tries to claim a free slot, so that an element can be constructed in place.
+			The slot has to be handed to `publish()` afterwards. Slots may be published in any order.
+		@return
+			The claimed slot, or null if the ring is full. */
+		inline T * try_claim();
+		/** Makes a claimed slot's element available to consumers.
+		@param[in] value:
+			The slot returned by `try_claim()`. */
+		inline void publish(
+			T * value);
+
+		/** Tries to claim the oldest element, so that it can be processed in place.
+			The element has to be handed to `release()` afterwards. Elements may be released in any order.
+		@return
+			The claimed element, or null if the ring is empty. */
+		inline T const * try_peek();
+		/** Frees a claimed element's slot for producers.
+		@param[in] value:
+			The element returned by `try_peek()`. */
+		inline void release(
+			T const * value);
+
+		/** Whether the next read would find an element.
+			The returned value may already be outdated. */
+		inline bool readable() const;
+		/** Whether the next write would find a free slot.
+			The returned value may already be outdated. */
+		inline bool writable() const;
+	};
+}
+
+#include "BoundedRing.inl"
+
+#endif
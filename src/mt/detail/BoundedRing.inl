@@ -0,0 +1,294 @@
+#include <cassert>
+#include <cstdint>
+#include <utility>
+
+namespace cr::mt::detail
+{
+	constexpr std::size_t round_up_pow2(
+		std::size_t value)
+	{
+		std::size_t result = 1;
+		while(result < value)
+			result <<= 1;
+		return result;
+	}
+
+	template<class T, std::size_t kSize>
+	void PODBoundedRing<T, kSize>::initialise()
+	{
+		for(std::size_t i = 0; i < kCapacity; i++)
+			std::atomic_init(&m_slots[i].sequence, i);
+		std::atomic_init(&m_tail, (std::size_t) 0);
+		std::atomic_init(&m_head, (std::size_t) 0);
+	}
+
+	template<class T, std::size_t kSize>
+	template<class V>
+	bool PODBoundedRing<T, kSize>::try_push(
+		V &&value)
+	{
+		std::size_t tail = m_tail.load(std::memory_order_relaxed);
+		for(;;)
+		{
+			Slot &slot = m_slots[tail & kMask];
+			std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+			std::ptrdiff_t diff = (std::ptrdiff_t) (sequence - tail);
+			if(!diff)
+			{
+				// The slot is free: claim it.
+				if(m_tail.compare_exchange_weak(
+					tail,
+					tail + 1,
+					std::memory_order_relaxed,
+					std::memory_order_relaxed))
+				{
+					slot.value = std::forward<V>(value);
+					// Publish the element to the consumers.
+					slot.sequence.store(tail + 1, std::memory_order_release);
+					return true;
+				}
+			} else if(diff < 0)
+				// The slot still holds the element from one lap ago: full.
+				return false;
+			else
+				// Another producer claimed the slot, retry with the current index.
+				tail = m_tail.load(std::memory_order_relaxed);
+		}
+	}
+
+	template<class T, std::size_t kSize>
+	bool PODBoundedRing<T, kSize>::try_pop(
+		T &target)
+	{
+		std::size_t head = m_head.load(std::memory_order_relaxed);
+		for(;;)
+		{
+			Slot &slot = m_slots[head & kMask];
+			std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+			std::ptrdiff_t diff = (std::ptrdiff_t) (sequence - (head + 1));
+			if(!diff)
+			{
+				// The slot holds an element: claim it.
+				if(m_head.compare_exchange_weak(
+					head,
+					head + 1,
+					std::memory_order_relaxed,
+					std::memory_order_relaxed))
+				{
+					target = std::move(slot.value);
+					// Free the slot for the producers of the next lap.
+					slot.sequence.store(head + kCapacity, std::memory_order_release);
+					return true;
+				}
+			} else if(diff < 0)
+				// The slot was not written yet: empty.
+				return false;
+			else
+				// Another consumer claimed the slot, retry with the current index.
+				head = m_head.load(std::memory_order_relaxed);
+		}
+	}
+
+	template<class T, std::size_t kSize>
+	std::size_t PODBoundedRing<T, kSize>::try_push_bulk(
+		T const * values,
+		std::size_t count)
+	{
+		if(count > kCapacity)
+			count = kCapacity;
+
+		std::size_t tail = m_tail.load(std::memory_order_relaxed);
+		for(;;)
+		{
+			// Count the free slots starting at the index.
+			std::size_t free = 0;
+			std::ptrdiff_t diff = 0;
+			for(; free < count; free++)
+			{
+				std::size_t const index = tail + free;
+				diff = (std::ptrdiff_t) (m_slots[index & kMask].sequence.load(std::memory_order_acquire) - index);
+				if(diff)
+					break;
+			}
+
+			if(!free)
+			{
+				if(diff < 0 || !count)
+					return 0;
+				tail = m_tail.load(std::memory_order_relaxed);
+				continue;
+			}
+
+			// Claim all free slots at once.
+			if(m_tail.compare_exchange_weak(
+				tail,
+				tail + free,
+				std::memory_order_relaxed,
+				std::memory_order_relaxed))
+			{
+				for(std::size_t i = 0; i < free; i++)
+				{
+					Slot &slot = m_slots[(tail + i) & kMask];
+					slot.value = values[i];
+					slot.sequence.store(tail + i + 1, std::memory_order_release);
+				}
+				return free;
+			}
+		}
+	}
+
+	template<class T, std::size_t kSize>
+	std::size_t PODBoundedRing<T, kSize>::try_pop_bulk(
+		T * target,
+		std::size_t max)
+	{
+		if(max > kCapacity)
+			max = kCapacity;
+
+		std::size_t head = m_head.load(std::memory_order_relaxed);
+		for(;;)
+		{
+			// Count the written slots starting at the index.
+			std::size_t full = 0;
+			std::ptrdiff_t diff = 0;
+			for(; full < max; full++)
+			{
+				std::size_t const index = head + full;
+				diff = (std::ptrdiff_t) (m_slots[index & kMask].sequence.load(std::memory_order_acquire) - (index + 1));
+				if(diff)
+					break;
+			}
+
+			if(!full)
+			{
+				if(diff < 0 || !max)
+					return 0;
+				head = m_head.load(std::memory_order_relaxed);
+				continue;
+			}
+
+			// Claim all written slots at once.
+			if(m_head.compare_exchange_weak(
+				head,
+				head + full,
+				std::memory_order_relaxed,
+				std::memory_order_relaxed))
+			{
+				for(std::size_t i = 0; i < full; i++)
+				{
+					Slot &slot = m_slots[(head + i) & kMask];
+					target[i] = std::move(slot.value);
+					slot.sequence.store(head + i + kCapacity, std::memory_order_release);
+				}
+				return full;
+			}
+		}
+	}
+
+	template<class T, std::size_t kSize>
+	typename PODBoundedRing<T, kSize>::Slot &PODBoundedRing<T, kSize>::slot_of(
+		T const * value)
+	{
+		std::uintptr_t const offset = reinterpret_cast<std::uintptr_t>(value) - reinterpret_cast<std::uintptr_t>(&m_slots[0].value);
+		assert(offset / sizeof(Slot) < kCapacity && !(offset % sizeof(Slot)));
+		return m_slots[offset / sizeof(Slot)];
+	}
+
+	template<class T, std::size_t kSize>
+	T * PODBoundedRing<T, kSize>::try_claim()
+	{
+		std::size_t tail = m_tail.load(std::memory_order_relaxed);
+		for(;;)
+		{
+			Slot &slot = m_slots[tail & kMask];
+			std::ptrdiff_t diff = (std::ptrdiff_t) (slot.sequence.load(std::memory_order_acquire) - tail);
+			if(!diff)
+			{
+				if(m_tail.compare_exchange_weak(
+					tail,
+					tail + 1,
+					std::memory_order_relaxed,
+					std::memory_order_relaxed))
+					return &slot.value;
+			} else if(diff < 0)
+				return nullptr;
+			else
+				tail = m_tail.load(std::memory_order_relaxed);
+		}
+	}
+
+	template<class T, std::size_t kSize>
+	void PODBoundedRing<T, kSize>::publish(
+		T * value)
+	{
+		// The slot's sequence still equals its writing index, as only its claimer may advance it.
+		Slot &slot = slot_of(value);
+		slot.sequence.store(
+			slot.sequence.load(std::memory_order_relaxed) + 1,
+			std::memory_order_release);
+	}
+
+	template<class T, std::size_t kSize>
+	T const * PODBoundedRing<T, kSize>::try_peek()
+	{
+		std::size_t head = m_head.load(std::memory_order_relaxed);
+		for(;;)
+		{
+			Slot &slot = m_slots[head & kMask];
+			std::ptrdiff_t diff = (std::ptrdiff_t) (slot.sequence.load(std::memory_order_acquire) - (head + 1));
+			if(!diff)
+			{
+				if(m_head.compare_exchange_weak(
+					head,
+					head + 1,
+					std::memory_order_relaxed,
+					std::memory_order_relaxed))
+					return &slot.value;
+			} else if(diff < 0)
+				return nullptr;
+			else
+				head = m_head.load(std::memory_order_relaxed);
+		}
+	}
+
+	template<class T, std::size_t kSize>
+	void PODBoundedRing<T, kSize>::release(
+		T const * value)
+	{
+		// The slot's sequence still equals its reading index + 1, as only its claimer may advance it.
+		Slot &slot = slot_of(value);
+		slot.sequence.store(
+			slot.sequence.load(std::memory_order_relaxed) - 1 + kCapacity,
+			std::memory_order_release);
+	}
+
+	template<class T, std::size_t kSize>
+	bool PODBoundedRing<T, kSize>::readable() const
+	{
+		std::size_t head = m_head.load(std::memory_order_relaxed);
+		for(;;)
+		{
+			std::size_t sequence = m_slots[head & kMask].sequence.load(std::memory_order_acquire);
+			std::ptrdiff_t diff = (std::ptrdiff_t) (sequence - (head + 1));
+			if(diff <= 0)
+				return !diff;
+			// The index is outdated.
+			head = m_head.load(std::memory_order_relaxed);
+		}
+	}
+
+	template<class T, std::size_t kSize>
+	bool PODBoundedRing<T, kSize>::writable() const
+	{
+		std::size_t tail = m_tail.load(std::memory_order_relaxed);
+		for(;;)
+		{
+			std::size_t sequence = m_slots[tail & kMask].sequence.load(std::memory_order_acquire);
+			std::ptrdiff_t diff = (std::ptrdiff_t) (sequence - tail);
+			if(diff <= 0)
+				return !diff;
+			// The index is outdated.
+			tail = m_tail.load(std::memory_order_relaxed);
+		}
+	}
+}
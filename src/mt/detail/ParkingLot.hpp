@@ -0,0 +1,188 @@
+/** @file ParkingLot.hpp
+	Contains the slow path that lock-free primitives use to let coroutines wait. */
+#ifndef __libcr_mt_detail_parkinglot_hpp_defined
+#define __libcr_mt_detail_parkinglot_hpp_defined
+
+#include "SoftMutex.hpp"
+#include "../../sync/Block.hpp"
+#include "../../Timeout.hpp"
+#include "../../Resumer.hpp"
+#include "../../Selectable.hpp"
+
+#include <atomic>
+#include <cstddef>
+
+namespace cr::mt::detail
+{
+	template<class ConditionVariable>
+	/** POD waiting room for coroutines that wait for a condition of a lock-free primitive.
+		Coroutines only park after they announced themselves and re-checked the condition, and `unpark()` only takes the lock if someone announced itself, so that the lock-free fast paths stay free of locks and waiting lists.
+	@tparam ConditionVariable:
+		The POD thread-safe condition variable type to park coroutines in. */
+	class PODParkingLot
+	{
+		/** Protects the registration of parking coroutines. */
+		PODSoftMutex m_mutex;
+		/** The parked coroutines. */
+		ConditionVariable m_cv;
+		/** The number of parking or parked coroutines that did not call `leave()` yet. */
+		std::atomic_size_t m_waiting;
+	public:
+		/** Checks whether the awaited condition holds.
+		@param[in] object:
+			The primitive whose condition to check.
+		@return
+			Whether the condition holds. */
+		typedef bool (*ready_t)(
+			void const * object);
+
+		/** Initialises the parking lot. */
+		void initialise();
+
+		/** Helper class for parking a coroutine using `#CR_AWAIT`.
+			Whether the coroutine parked or not, it has to call `leave()` afterwards, also if the wait failed. */
+		class ParkCall
+		{
+			/** The parking lot to park in. */
+			PODParkingLot<ConditionVariable> &m_lot;
+			/** Checks the awaited condition. */
+			ready_t m_ready;
+			/** The primitive whose condition to check. */
+			void const * m_object;
+			/** The deadline of the wait, if timed. */
+			Deadline m_deadline;
+			/** Whether the wait is timed. */
+			bool m_timed;
+		public:
+			/** Initialises the park call.
+			@param[in] lot:
+				The parking lot to park in.
+			@param[in] ready:
+				Checks the awaited condition.
+			@param[in] object:
+				The primitive whose condition to check. */
+			constexpr ParkCall(
+				PODParkingLot<ConditionVariable> &lot,
+				ready_t ready,
+				void const * object);
+			/** Initialises the timed park call.
+			@param[in] lot:
+				The parking lot to park in.
+			@param[in] ready:
+				Checks the awaited condition.
+			@param[in] object:
+				The primitive whose condition to check.
+			@param[in] deadline:
+				The deadline of the wait. */
+			constexpr ParkCall(
+				PODParkingLot<ConditionVariable> &lot,
+				ready_t ready,
+				void const * object,
+				Deadline const& deadline);
+
+			/** Parks a coroutine, unless the condition already holds.
+			@param[in] coroutine:
+				The coroutine to park.
+			@return
+				Whether the coroutine parked. */
+			[[nodiscard]] sync::mayblock libcr_wait(
+				Coroutine * coroutine);
+		};
+
+		/** Parks a coroutine until `unpark()` is called, unless the condition already holds.
+			To be used with `#CR_AWAIT`.
+		@param[in] ready:
+			Checks the awaited condition.
+		@param[in] object:
+			The primitive whose condition to check. */
+		[[nodiscard]] constexpr ParkCall park(
+			ready_t ready,
+			void const * object);
+
+		/** Parks a coroutine until `unpark()` is called or the deadline expires, unless the condition already holds.
+			To be used with `#CR_AWAIT`.
+		@param[in] ready:
+			Checks the awaited condition.
+		@param[in] object:
+			The primitive whose condition to check.
+		@param[in] deadline:
+			The deadline of the wait, as created by the scheduler. */
+		[[nodiscard]] constexpr ParkCall park_for(
+			ready_t ready,
+			void const * object,
+			Deadline const& deadline);
+
+		/** Unregisters a coroutine after it returned from a park call. */
+		inline void leave();
+
+		/** Resumes a parked coroutine, if any.
+			Has to be called after every change that may establish the condition.
+		@param[in] resumer:
+			How to resume the coroutine.
+		@return
+			Whether a coroutine was resumed. */
+		inline bool unpark(
+			Resumer resumer = Resumer());
+
+		/** Resumes up to `count` parked coroutines.
+			Has to be called after every change that may establish the condition for several coroutines.
+		@param[in] count:
+			The maximum number of coroutines to resume.
+		@param[in] resumer:
+			How to resume the coroutines.
+		@return
+			The number of resumed coroutines. */
+		inline std::size_t unpark_n(
+			std::size_t count,
+			Resumer resumer = Resumer());
+
+		/** Resumes all parked coroutines.
+			Has to be called after every change that may establish the condition for all coroutines.
+		@param[in] resumer:
+			How to resume the coroutines.
+		@return
+			Whether any coroutine was resumed. */
+		inline bool unpark_all(
+			Resumer resumer = Resumer());
+
+		/** Resumes all parked coroutines, and sets their error flags. */
+		void fail_all();
+
+		template<class Object, PODParkingLot<ConditionVariable> Object::*kLot, ready_t kReady>
+		/** Describes how `Select` waits until a primitive's condition holds.
+			Select nodes park and leave like coroutines. A kept notification is passed on with `unpark()`.
+		@tparam Object:
+			The primitive's type.
+		@tparam kLot:
+			The primitive's parking lot.
+		@tparam kReady:
+			Checks the awaited condition.
+		@param[in] object:
+			The primitive. */
+		static inline Selectable selectable(
+			Object * object);
+	private:
+		template<class Object, PODParkingLot<ConditionVariable> Object::*kLot, ready_t kReady>
+		/** Parks a select node, or notifies it if the condition already holds. */
+		static void select_add(
+			void * object,
+			Coroutine * node);
+		template<class Object, PODParkingLot<ConditionVariable> Object::*kLot>
+		/** Removes a parked select node, and leaves for it. */
+		static bool select_remove(
+			void * object,
+			Coroutine * node);
+		template<class Object, PODParkingLot<ConditionVariable> Object::*kLot>
+		/** Leaves for a notified select node. */
+		static void select_leave(
+			void * object);
+		template<class Object, PODParkingLot<ConditionVariable> Object::*kLot>
+		/** Passes a kept notification on. */
+		static void select_unpark(
+			void * object);
+	};
+}
+
+#include "ParkingLot.inl"
+
+#endif
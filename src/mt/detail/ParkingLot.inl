@@ -0,0 +1,208 @@
+namespace cr::mt::detail
+{
+	template<class ConditionVariable>
+	void PODParkingLot<ConditionVariable>::initialise()
+	{
+		m_mutex.initialise();
+		m_cv.initialise();
+		std::atomic_init(&m_waiting, (std::size_t) 0);
+	}
+
+	template<class ConditionVariable>
+	constexpr PODParkingLot<ConditionVariable>::ParkCall::ParkCall(
+		PODParkingLot<ConditionVariable> &lot,
+		ready_t ready,
+		void const * object):
+		m_lot(lot),
+		m_ready(ready),
+		m_object(object),
+		m_deadline(),
+		m_timed(false)
+	{
+	}
+
+	template<class ConditionVariable>
+	constexpr PODParkingLot<ConditionVariable>::ParkCall::ParkCall(
+		PODParkingLot<ConditionVariable> &lot,
+		ready_t ready,
+		void const * object,
+		Deadline const& deadline):
+		m_lot(lot),
+		m_ready(ready),
+		m_object(object),
+		m_deadline(deadline),
+		m_timed(true)
+	{
+	}
+
+	template<class ConditionVariable>
+	sync::mayblock PODParkingLot<ConditionVariable>::ParkCall::libcr_wait(
+		Coroutine * coroutine)
+	{
+		// Announce the coroutine before checking, so that a concurrent change either is seen here, or sees the announcement.
+		m_lot.m_waiting.fetch_add(1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		// Registration is locked, so that `unpark()` cannot miss a coroutine between its check and its registration.
+		LockGuard lock(m_lot.m_mutex);
+		if(m_ready(m_object))
+			return sync::nonblock();
+
+		if(m_timed)
+			(void) m_lot.m_cv.wait_for(m_deadline).libcr_wait(coroutine);
+		else
+			(void) m_lot.m_cv.wait().libcr_wait(coroutine);
+		return sync::block();
+	}
+
+	template<class ConditionVariable>
+	constexpr typename PODParkingLot<ConditionVariable>::ParkCall PODParkingLot<ConditionVariable>::park(
+		ready_t ready,
+		void const * object)
+	{
+		return ParkCall(*this, ready, object);
+	}
+
+	template<class ConditionVariable>
+	constexpr typename PODParkingLot<ConditionVariable>::ParkCall PODParkingLot<ConditionVariable>::park_for(
+		ready_t ready,
+		void const * object,
+		Deadline const& deadline)
+	{
+		return ParkCall(*this, ready, object, deadline);
+	}
+
+	template<class ConditionVariable>
+	void PODParkingLot<ConditionVariable>::leave()
+	{
+		m_waiting.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	template<class ConditionVariable>
+	bool PODParkingLot<ConditionVariable>::unpark(
+		Resumer resumer)
+	{
+		// Pairs with the fence in `ParkCall::libcr_wait()`.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if(!m_waiting.load(std::memory_order_relaxed))
+			return false;
+
+		LockGuard lock(m_mutex);
+		Coroutine * removed = m_cv.remove_one();
+		lock.unlock();
+
+		if(!removed)
+			return false;
+		resumer(removed);
+		return true;
+	}
+
+	template<class ConditionVariable>
+	std::size_t PODParkingLot<ConditionVariable>::unpark_n(
+		std::size_t count,
+		Resumer resumer)
+	{
+		// Pairs with the fence in `ParkCall::libcr_wait()`.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		std::size_t unparked = 0;
+		while(unparked < count && m_waiting.load(std::memory_order_relaxed))
+		{
+			LockGuard lock(m_mutex);
+			Coroutine * removed = m_cv.remove_one();
+			lock.unlock();
+
+			if(!removed)
+				break;
+			resumer(removed);
+			++unparked;
+		}
+		return unparked;
+	}
+
+	template<class ConditionVariable>
+	bool PODParkingLot<ConditionVariable>::unpark_all(
+		Resumer resumer)
+	{
+		// Pairs with the fence in `ParkCall::libcr_wait()`.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if(!m_waiting.load(std::memory_order_relaxed))
+			return false;
+
+		{
+			// Coroutines that checked the condition before the change finish registering first, later ones see the change.
+			LockGuard lock(m_mutex);
+		}
+		return m_cv.notify_all(resumer);
+	}
+
+	template<class ConditionVariable>
+	void PODParkingLot<ConditionVariable>::fail_all()
+	{
+		m_cv.fail_all();
+	}
+
+	template<class ConditionVariable>
+	template<class Object, PODParkingLot<ConditionVariable> Object::*kLot, typename PODParkingLot<ConditionVariable>::ready_t kReady>
+	Selectable PODParkingLot<ConditionVariable>::selectable(
+		Object * object)
+	{
+		return Selectable(
+			object,
+			&select_add<Object, kLot, kReady>,
+			&select_remove<Object, kLot>,
+			&select_leave<Object, kLot>,
+			&select_unpark<Object, kLot>);
+	}
+
+	template<class ConditionVariable>
+	template<class Object, PODParkingLot<ConditionVariable> Object::*kLot, typename PODParkingLot<ConditionVariable>::ready_t kReady>
+	void PODParkingLot<ConditionVariable>::select_add(
+		void * object,
+		Coroutine * node)
+	{
+		PODParkingLot<ConditionVariable> &lot = static_cast<Object *>(object)->*kLot;
+		// Announce the node like a parking coroutine, see `ParkCall::libcr_wait()`.
+		lot.m_waiting.fetch_add(1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		LockGuard lock(lot.m_mutex);
+		if(!kReady(object))
+		{
+			lot.m_cv.push_removable(node);
+			return;
+		}
+		lock.unlock();
+
+		node->resume();
+	}
+
+	template<class ConditionVariable>
+	template<class Object, PODParkingLot<ConditionVariable> Object::*kLot>
+	bool PODParkingLot<ConditionVariable>::select_remove(
+		void * object,
+		Coroutine * node)
+	{
+		PODParkingLot<ConditionVariable> &lot = static_cast<Object *>(object)->*kLot;
+		if(!lot.m_cv.remove(node))
+			return false;
+		lot.leave();
+		return true;
+	}
+
+	template<class ConditionVariable>
+	template<class Object, PODParkingLot<ConditionVariable> Object::*kLot>
+	void PODParkingLot<ConditionVariable>::select_leave(
+		void * object)
+	{
+		(static_cast<Object *>(object)->*kLot).leave();
+	}
+
+	template<class ConditionVariable>
+	template<class Object, PODParkingLot<ConditionVariable> Object::*kLot>
+	void PODParkingLot<ConditionVariable>::select_unpark(
+		void * object)
+	{
+		(void) (static_cast<Object *>(object)->*kLot).unpark();
+	}
+}
\ No newline at end of file
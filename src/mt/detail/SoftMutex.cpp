@@ -1,33 +1,56 @@
 #include "SoftMutex.hpp"
+#include "../../util/Backoff.hpp"
 
 namespace cr::mt::detail
 {
 	void PODSoftMutex::lock()
 	{
-		bool value;
-		do {
-			value = false;
-		} while(!m_locked.compare_exchange_weak(
-			value,
-			true,
-			std::memory_order_acquire,
-			std::memory_order_relaxed));
+		util::Backoff backoff;
+		for(;;)
+		{
+			// Only try to take the mutex once it looks unlocked, so that waiting threads do not keep stealing its cache line.
+			std::uint32_t state = m_state.load(std::memory_order_relaxed);
+			if(state == kUnlocked
+			&& m_state.compare_exchange_weak(
+				state,
+				kLocked,
+				std::memory_order_acquire,
+				std::memory_order_relaxed))
+				return;
+
+#ifdef LIBCR_HAS_FUTEX
+			if(backoff.exhausted())
+			{
+				// Announce the sleeping thread, so that unlocking wakes it. The mutex then stays marked, as other threads might still sleep.
+				while(m_state.exchange(kSleeping, std::memory_order_acquire) != kUnlocked)
+					util::futex_wait(m_state, kSleeping);
+				return;
+			}
+#endif
+			backoff.pause();
+		}
 	}
 
 	bool PODSoftMutex::try_lock()
 	{
-		bool value = false;
-		return m_locked.compare_exchange_strong(
-			value,
-			true,
-			std::memory_order_acquire,
-			std::memory_order_relaxed);
+		std::uint32_t state = kUnlocked;
+		return m_state.load(std::memory_order_relaxed) == kUnlocked
+			&& m_state.compare_exchange_strong(
+				state,
+				kLocked,
+				std::memory_order_acquire,
+				std::memory_order_relaxed);
 	}
 
 	void PODSoftMutex::unlock()
 	{
-		assert(m_locked.load(std::memory_order_relaxed));
-		m_locked.store(false, std::memory_order_release);
+		assert(m_state.load(std::memory_order_relaxed) != kUnlocked);
+#ifdef LIBCR_HAS_FUTEX
+		if(m_state.exchange(kUnlocked, std::memory_order_release) == kSleeping)
+			util::futex_wake(m_state, 1);
+#else
+		m_state.store(kUnlocked, std::memory_order_release);
+#endif
 	}
 
 	LockGuard::~LockGuard()
@@ -38,4 +61,4 @@ namespace cr::mt::detail
 			m_mutex = nullptr;
 		}
 	}
-}
\ No newline at end of file
+}
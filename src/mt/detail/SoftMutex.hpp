@@ -4,14 +4,23 @@
 #define __libcr_mt_detail_softmutex_hpp_defined
 
 #include <atomic>
+#include <cstdint>
 
 namespace cr::mt::detail
 {
-	/** POD userspace mutex (not coroutine-aware). */
+	/** POD userspace mutex (not coroutine-aware).
+		Waiting threads spin with `util::Backoff`, and only read the mutex until it looks unlocked. With `LIBCR_FUTEX`, they eventually block in the kernel. */
 	class PODSoftMutex
 	{
-		/** The mutex's locking flag. */
-		std::atomic_bool m_locked;
+		/** The mutex is unlocked. */
+		static constexpr std::uint32_t kUnlocked = 0;
+		/** The mutex is locked. */
+		static constexpr std::uint32_t kLocked = 1;
+		/** The mutex is locked, and threads might be blocked in the kernel. */
+		static constexpr std::uint32_t kSleeping = 2;
+
+		/** The mutex's state. */
+		std::atomic<std::uint32_t> m_state;
 	public:
 		/** Initialises the mutex. */
 		inline void initialise();
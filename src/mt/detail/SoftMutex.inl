@@ -4,7 +4,7 @@ namespace cr::mt::detail
 {
 	void PODSoftMutex::initialise()
 	{
-		std::atomic_init(&m_locked, false);
+		std::atomic_init(&m_state, kUnlocked);
 	}
 
 	SoftMutex::SoftMutex()
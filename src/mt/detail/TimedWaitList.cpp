@@ -0,0 +1,136 @@
+#include "TimedWaitList.hpp"
+#include "../../Coroutine.hpp"
+
+namespace cr::mt::detail
+{
+	void PODTimedWaitList::initialise()
+	{
+		m_mutex.initialise();
+		m_first = nullptr;
+		m_last = nullptr;
+		std::atomic_init(&m_waiting, false);
+	}
+
+	void PODTimedWaitList::push(
+		Coroutine * timeout)
+	{
+		LockGuard lock(m_mutex);
+
+		timeout->libcr_next_waiting.plain = nullptr;
+		timeout->libcr_prev_waiting = m_last;
+		if(m_last)
+			m_last->libcr_next_waiting.plain = timeout;
+		else
+		{
+			m_first = timeout;
+			m_waiting.store(true, std::memory_order_relaxed);
+		}
+		m_last = timeout;
+	}
+
+	bool PODTimedWaitList::push_if_waiting(
+		Coroutine * first,
+		Coroutine * last)
+	{
+		LockGuard lock(m_mutex);
+		if(!m_first)
+			return false;
+
+		Coroutine * prev = m_last;
+		prev->libcr_next_waiting.plain = first;
+		for(Coroutine * coroutine = first;; coroutine = coroutine->libcr_next_waiting.plain)
+		{
+			coroutine->libcr_prev_waiting = prev;
+			if(coroutine == last)
+				break;
+			prev = coroutine;
+		}
+		last->libcr_next_waiting.plain = nullptr;
+		m_last = last;
+		return true;
+	}
+
+	Coroutine * PODTimedWaitList::pop()
+	{
+		if(!m_waiting.load(std::memory_order_relaxed))
+			return nullptr;
+
+		LockGuard lock(m_mutex);
+
+		Coroutine * first = m_first;
+		if(first)
+			unlink(first);
+		return first;
+	}
+
+	Coroutine * PODTimedWaitList::pop_all(
+		Coroutine * &last)
+	{
+		last = nullptr;
+		if(!m_waiting.load(std::memory_order_relaxed))
+			return nullptr;
+
+		LockGuard lock(m_mutex);
+
+		Coroutine * first = m_first;
+		last = m_last;
+		// Clear the back links, so that the timeouts no longer count as waiting.
+		for(Coroutine * timeout = first; timeout; timeout = timeout->libcr_next_waiting.plain)
+			timeout->libcr_prev_waiting = nullptr;
+
+		m_first = m_last = nullptr;
+		m_waiting.store(false, std::memory_order_relaxed);
+		return first;
+	}
+
+	bool PODTimedWaitList::notify_all(
+		bool error,
+		Resumer resumer)
+	{
+		Coroutine * last;
+		Coroutine * timeout = pop_all(last);
+		if(!timeout)
+			return false;
+
+		do {
+			Coroutine * next = timeout->libcr_next_waiting.plain;
+			timeout->libcr_error = error;
+			resumer(timeout);
+			timeout = next;
+		} while(timeout);
+
+		return true;
+	}
+
+	bool PODTimedWaitList::unlink(
+		Coroutine * timeout)
+	{
+		Coroutine * prev = timeout->libcr_prev_waiting;
+		Coroutine * next = timeout->libcr_next_waiting.plain;
+
+		if(prev)
+			prev->libcr_next_waiting.plain = next;
+		else if(m_first == timeout)
+			m_first = next;
+		else
+			return false;
+
+		if(next)
+			next->libcr_prev_waiting = prev;
+		else
+			m_last = prev;
+
+		if(!m_first)
+			m_waiting.store(false, std::memory_order_relaxed);
+
+		timeout->libcr_prev_waiting = nullptr;
+		return true;
+	}
+
+	bool PODTimedWaitList::remove(
+		Coroutine * timeout)
+	{
+		LockGuard lock(m_mutex);
+		return unlink(timeout);
+	}
+}
@@ -0,0 +1,100 @@
+/** @file TimedWaitList.hpp
+	Contains the list of timed waiters of the thread-safe condition variables. */
+#ifndef __libcr_mt_detail_timedwaitlist_hpp_defined
+#define __libcr_mt_detail_timedwaitlist_hpp_defined
+
+#include "SoftMutex.hpp"
+#include "../../Resumer.hpp"
+
+#include <atomic>
+
+namespace cr
+{
+	// Forward declarations.
+	class Coroutine;
+}
+
+namespace cr::mt::detail
+{
+	/** POD doubly linked FIFO list of timeouts waiting for a thread-safe condition variable.
+		The lock-free waiting lists of the condition variables cannot unlink coroutines from the middle, so timed waits are kept in this locked list instead, which supports O(1) removal on expiry. While the list is not empty, the FIFO condition variables append untimed waiting coroutines to it as well, so that they stay behind the timeouts that started waiting before them. */
+	class PODTimedWaitList
+	{
+		/** Protects the list. */
+		PODSoftMutex m_mutex;
+		/** The first waiting timeout. */
+		Coroutine * m_first;
+		/** The last waiting timeout. */
+		Coroutine * m_last;
+		/** Whether the list is not empty.
+			Only modified while locked, but read without locking, so that untimed notifications stay lock-free. */
+		std::atomic_bool m_waiting;
+
+		/** Unlinks a timeout while the list is locked.
+		@param[in] timeout:
+			The timeout to unlink.
+		@return
+			Whether the timeout was still in the list. */
+		bool unlink(
+			Coroutine * timeout);
+	public:
+		/** Initialises the list to be empty. */
+		void initialise();
+
+		/** Whether the list is empty. */
+		inline bool empty() const;
+
+		/** Appends a timeout to the list.
+		@param[in] timeout:
+			The timeout to append. */
+		void push(
+			Coroutine * timeout);
+
+		/** Appends a list of untimed waiting coroutines, unless the list is empty.
+		@param[in] first:
+			The first coroutine to append.
+		@param[in] last:
+			The last coroutine to append. The coroutines are linked through `libcr_next_waiting.plain`.
+		@return
+			Whether the coroutines were appended. */
+		bool push_if_waiting(
+			Coroutine * first,
+			Coroutine * last);
+
+		/** Removes the first timeout, if exists.
+		@return
+			The removed timeout, or null. */
+		Coroutine * pop();
+
+		/** Removes all timeouts.
+		@param[out] last:
+			The last removed timeout, or null.
+		@return
+			The removed timeouts, linked through `libcr_next_waiting.plain`, or null. */
+		Coroutine * pop_all(
+			Coroutine * &last);
+
+		/** Removes and notifies all timeouts.
+		@param[in] error:
+			Whether to set the timeouts' error flags.
+		@param[in] resumer:
+			How to resume the timeouts.
+		@return
+			Whether any timeout was notified. */
+		bool notify_all(
+			bool error,
+			Resumer resumer = Resumer());
+
+		/** Removes a timeout from anywhere in the list.
+		@param[in] timeout:
+			The timeout to remove.
+		@return
+			Whether the timeout was still in the list. */
+		bool remove(
+			Coroutine * timeout);
+	};
+}
+
+#include "TimedWaitList.inl"
+
+#endif
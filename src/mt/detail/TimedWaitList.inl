@@ -0,0 +1,7 @@
+namespace cr::mt::detail
+{
+	bool PODTimedWaitList::empty() const
+	{
+		return !m_waiting.load(std::memory_order_relaxed);
+	}
+}
@@ -0,0 +1,126 @@
+/** @file WaiterSlot.hpp
+	Contains the thread-safe single waiter slot used by single-producer single-consumer primitives. */
+#ifndef __libcr_mt_detail_waiterslot_hpp_defined
+#define __libcr_mt_detail_waiterslot_hpp_defined
+
+#include "../../Coroutine.hpp"
+#include "../../sync/Block.hpp"
+#include "../../Timeout.hpp"
+#include "../../Resumer.hpp"
+
+#include <atomic>
+
+namespace cr::mt::detail
+{
+	/** POD lock-free waiting slot for at most one coroutine.
+		Replaces a condition variable where only a single coroutine can ever wait, so that notifying is a fence and a load unless a coroutine actually waits. */
+	class PODWaiterSlot
+	{
+		/** The waiting coroutine or its timeout, or null. */
+		std::atomic<Coroutine *> m_waiting;
+	public:
+		/** Checks whether the awaited condition holds.
+		@param[in] object:
+			The primitive whose condition to check.
+		@return
+			Whether the condition holds. */
+		typedef bool (*ready_t)(
+			void const * object);
+
+		/** Initialises the slot to be empty. */
+		inline void initialise();
+
+		/** Helper class for waiting in the slot using `#CR_AWAIT`. */
+		class WaitCall
+		{
+			/** The slot to wait in. */
+			PODWaiterSlot &m_slot;
+			/** Checks the awaited condition. */
+			ready_t m_ready;
+			/** The primitive whose condition to check. */
+			void const * m_object;
+			/** The deadline of the wait, if timed. */
+			Deadline m_deadline;
+			/** Whether the wait is timed. */
+			bool m_timed;
+		public:
+			/** Initialises the wait call.
+			@param[in] slot:
+				The slot to wait in.
+			@param[in] ready:
+				Checks the awaited condition.
+			@param[in] object:
+				The primitive whose condition to check. */
+			constexpr WaitCall(
+				PODWaiterSlot &slot,
+				ready_t ready,
+				void const * object);
+			/** Initialises the timed wait call.
+			@param[in] slot:
+				The slot to wait in.
+			@param[in] ready:
+				Checks the awaited condition.
+			@param[in] object:
+				The primitive whose condition to check.
+			@param[in] deadline:
+				The deadline of the wait. */
+			constexpr WaitCall(
+				PODWaiterSlot &slot,
+				ready_t ready,
+				void const * object,
+				Deadline const& deadline);
+
+			/** Puts a coroutine into the slot, unless the condition already holds.
+			@param[in] coroutine:
+				The waiting coroutine.
+			@return
+				Whether the coroutine waits. */
+			[[nodiscard]] inline sync::mayblock libcr_wait(
+				Coroutine * coroutine);
+		};
+
+		/** Waits until `notify()` is called, unless the condition already holds.
+			To be used with `#CR_AWAIT`.
+		@param[in] ready:
+			Checks the awaited condition.
+		@param[in] object:
+			The primitive whose condition to check. */
+		[[nodiscard]] constexpr WaitCall wait(
+			ready_t ready,
+			void const * object);
+
+		/** Waits until `notify()` is called or the deadline expires, unless the condition already holds.
+			To be used with `#CR_AWAIT`.
+		@param[in] ready:
+			Checks the awaited condition.
+		@param[in] object:
+			The primitive whose condition to check.
+		@param[in] deadline:
+			The deadline of the wait, as created by the scheduler. */
+		[[nodiscard]] constexpr WaitCall wait_for(
+			ready_t ready,
+			void const * object,
+			Deadline const& deadline);
+
+		/** Removes an expired timeout from the slot.
+		@param[in] timeout:
+			The timeout to remove.
+		@return
+			Whether the timeout was still in the slot. */
+		inline bool remove(
+			Coroutine * timeout);
+
+		/** Resumes the waiting coroutine, if any.
+			Has to be called after every change that may establish the condition.
+		@param[in] resumer:
+			How to resume the coroutine.
+		@return
+			Whether a coroutine was resumed. */
+		inline bool notify(
+			Resumer resumer = Resumer());
+	};
+}
+
+#include "WaiterSlot.inl"
+
+#endif
@@ -0,0 +1,135 @@
+#include <cassert>
+
+namespace cr::mt::detail
+{
+	void PODWaiterSlot::initialise()
+	{
+		std::atomic_init(&m_waiting, (Coroutine *) nullptr);
+	}
+
+	constexpr PODWaiterSlot::WaitCall::WaitCall(
+		PODWaiterSlot &slot,
+		ready_t ready,
+		void const * object):
+		m_slot(slot),
+		m_ready(ready),
+		m_object(object),
+		m_deadline(),
+		m_timed(false)
+	{
+	}
+
+	constexpr PODWaiterSlot::WaitCall::WaitCall(
+		PODWaiterSlot &slot,
+		ready_t ready,
+		void const * object,
+		Deadline const& deadline):
+		m_slot(slot),
+		m_ready(ready),
+		m_object(object),
+		m_deadline(deadline),
+		m_timed(true)
+	{
+	}
+
+	sync::mayblock PODWaiterSlot::WaitCall::libcr_wait(
+		Coroutine * coroutine)
+	{
+		assert(coroutine != nullptr);
+		assert(!m_slot.m_waiting.load(std::memory_order_relaxed) && "Only a single coroutine can wait in a slot.");
+
+		if(!m_timed)
+		{
+			cr::detail::Thread const thread = coroutine->libcr_thread;
+			coroutine->libcr_thread = cr::detail::Thread::kInvalid;
+
+			// Enter the slot before checking, so that a concurrent change either is seen here, or sees the coroutine.
+			m_slot.m_waiting.store(coroutine, std::memory_order_release);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			// Take the coroutine back out, unless `notify()` was faster.
+			Coroutine * expected = coroutine;
+			if(m_ready(m_object)
+			&& m_slot.m_waiting.compare_exchange_strong(
+				expected,
+				nullptr,
+				std::memory_order_relaxed))
+			{
+				coroutine->libcr_thread = thread;
+				return sync::nonblock();
+			}
+			return sync::block();
+		}
+
+		Coroutine * timeout;
+		bool taken_back;
+		{
+			// The timing wheel stays locked until the timeout is in the slot.
+			Deadline::Registration registration(
+				m_deadline,
+				coroutine,
+				&m_slot,
+				&PODTimeout::remove_from<PODWaiterSlot>);
+
+			coroutine->libcr_thread = cr::detail::Thread::kInvalid;
+			timeout = registration.timeout();
+
+			m_slot.m_waiting.store(timeout, std::memory_order_release);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			Coroutine * expected = timeout;
+			taken_back = m_ready(m_object)
+				&& m_slot.m_waiting.compare_exchange_strong(
+					expected,
+					nullptr,
+					std::memory_order_relaxed);
+		}
+
+		// The timeout is already in the timing wheel, so notify it like `notify()` would, once the timing wheel is unlocked.
+		if(taken_back)
+			timeout->resume();
+		return sync::block();
+	}
+
+	constexpr PODWaiterSlot::WaitCall PODWaiterSlot::wait(
+		ready_t ready,
+		void const * object)
+	{
+		return WaitCall(*this, ready, object);
+	}
+
+	constexpr PODWaiterSlot::WaitCall PODWaiterSlot::wait_for(
+		ready_t ready,
+		void const * object,
+		Deadline const& deadline)
+	{
+		return WaitCall(*this, ready, object, deadline);
+	}
+
+	bool PODWaiterSlot::remove(
+		Coroutine * timeout)
+	{
+		return m_waiting.compare_exchange_strong(
+			timeout,
+			nullptr,
+			std::memory_order_acquire,
+			std::memory_order_relaxed);
+	}
+
+	bool PODWaiterSlot::notify(
+		Resumer resumer)
+	{
+		// Pairs with the fence in `WaitCall::libcr_wait()`.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if(!m_waiting.load(std::memory_order_relaxed))
+			return false;
+
+		Coroutine * waiting = m_waiting.exchange(
+			nullptr,
+			std::memory_order_acquire);
+		if(!waiting)
+			return false;
+		resumer(waiting);
+		return true;
+	}
+}
@@ -0,0 +1,84 @@
+/** @file WorkDeque.hpp
+	Contains a bounded lock-free deque of ready coroutines that supports stealing. */
+#ifndef __libcr_mt_detail_workdeque_hpp_defined
+#define __libcr_mt_detail_workdeque_hpp_defined
+
+#include <atomic>
+#include <cstddef>
+
+namespace cr
+{
+	// Forward declarations.
+	class Coroutine;
+}
+
+namespace cr::mt::detail
+{
+	template<std::size_t kCapacity>
+	/** POD bounded lock-free deque of ready coroutines owned by a scheduler thread.
+		This is a Chase-Lev style ring: only the owning thread pushes, which takes no atomic read-modify-write operation. Coroutines are consumed at the other end by compare-and-swapping the top index, both by the owner and by thieves. The owner thus runs its coroutines in the order they became ready, and a thief claims half of a deque with a single compare-and-swap.
+	@tparam kCapacity:
+		The maximum number of coroutines the deque can hold. */
+	class PODWorkDeque
+	{
+		static_assert(kCapacity >= 2, "A work deque needs to hold at least two coroutines.");
+
+		/** The index of the oldest coroutine.
+			Advanced by whoever consumes coroutines. */
+		alignas(64) std::atomic_size_t m_top;
+		/** The index behind the newest coroutine.
+			Only advanced by the owner. */
+		alignas(64) std::atomic_size_t m_bottom;
+		/** The coroutines in the deque.
+			Consumers may read slots that are overwritten concurrently, but then fail to claim them. */
+		std::atomic<Coroutine *> m_slots[kCapacity];
+	public:
+		/** Initialises the deque to be empty. */
+		inline void initialise();
+
+		/** Approximates the number of coroutines in the deque.
+			The returned value may already be outdated. */
+		inline std::size_t size() const;
+
+		/** Appends a coroutine to the deque.
+			Must only be called by the owning thread.
+		@param[in] coroutine:
+			The coroutine to append.
+		@return
+			Whether the deque had room for the coroutine. */
+		inline bool push(
+			Coroutine * coroutine);
+
+		/** Removes the oldest coroutine from the deque.
+			Must only be called by the owning thread.
+		@return
+			The removed coroutine, or null if the deque was empty. */
+		inline Coroutine * pop();
+
+		/** Moves the older half of a victim's coroutines into this deque in one operation.
+			The stolen coroutines are assigned to the specified thread.
+			Must only be called by this deque's owning thread.
+		@param[in] victim:
+			The deque to steal from.
+		@param[in] thread:
+			The thread that owns this deque.
+		@return
+			The number of stolen coroutines. */
+		inline std::size_t steal_half(
+			PODWorkDeque<kCapacity> &victim,
+			std::size_t thread);
+	};
+
+	template<std::size_t kCapacity>
+	/** Bounded lock-free deque of ready coroutines owned by a scheduler thread. */
+	class WorkDeque : public PODWorkDeque<kCapacity>
+	{
+	public:
+		/** Initialises the deque to be empty. */
+		inline WorkDeque();
+	};
+}
+
+#include "WorkDeque.inl"
+
+#endif
@@ -0,0 +1,97 @@
+#include "../../Coroutine.hpp"
+
+namespace cr::mt::detail
+{
+	template<std::size_t kCapacity>
+	void PODWorkDeque<kCapacity>::initialise()
+	{
+		std::atomic_init(&m_top, std::size_t(0));
+		std::atomic_init(&m_bottom, std::size_t(0));
+		for(std::atomic<Coroutine *> &slot: m_slots)
+			std::atomic_init(&slot, (Coroutine *) nullptr);
+	}
+
+	template<std::size_t kCapacity>
+	std::size_t PODWorkDeque<kCapacity>::size() const
+	{
+		std::size_t const top = m_top.load(std::memory_order_acquire);
+		std::size_t const size = m_bottom.load(std::memory_order_acquire) - top;
+		// The indices are read one after the other, so the top may have overtaken a stale bottom.
+		return size <= kCapacity ? size : 0;
+	}
+
+	template<std::size_t kCapacity>
+	bool PODWorkDeque<kCapacity>::push(
+		Coroutine * coroutine)
+	{
+		std::size_t const bottom = m_bottom.load(std::memory_order_relaxed);
+		// Acquiring the top orders this write after the consumers' reads of the slot.
+		if(bottom - m_top.load(std::memory_order_acquire) == kCapacity)
+			return false;
+
+		m_slots[bottom % kCapacity].store(coroutine, std::memory_order_relaxed);
+		m_bottom.store(bottom + 1, std::memory_order_release);
+		return true;
+	}
+
+	template<std::size_t kCapacity>
+	Coroutine * PODWorkDeque<kCapacity>::pop()
+	{
+		std::size_t top = m_top.load(std::memory_order_acquire);
+		for(;;)
+		{
+			if(top == m_bottom.load(std::memory_order_relaxed))
+				return nullptr;
+
+			Coroutine * coroutine = m_slots[top % kCapacity].load(std::memory_order_relaxed);
+			// Thieves might have claimed the coroutine in the meantime.
+			if(m_top.compare_exchange_weak(top, top + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+				return coroutine;
+		}
+	}
+
+	template<std::size_t kCapacity>
+	std::size_t PODWorkDeque<kCapacity>::steal_half(
+		PODWorkDeque<kCapacity> &victim,
+		std::size_t thread)
+	{
+		std::size_t const bottom = m_bottom.load(std::memory_order_relaxed);
+		std::size_t const room = kCapacity - (bottom - m_top.load(std::memory_order_acquire));
+
+		std::size_t top = victim.m_top.load(std::memory_order_acquire);
+		for(;;)
+		{
+			std::size_t const victim_size = victim.m_bottom.load(std::memory_order_acquire) - top;
+			// The victim's top may have moved past a stale bottom.
+			if(victim_size < 2 || victim_size > kCapacity)
+				return 0;
+
+			std::size_t count = victim_size / 2;
+			if(count > room)
+				count = room;
+			if(!count)
+				return 0;
+
+			// The victim cannot reuse the slots before the top moves, and the copies are discarded if another consumer moved it first.
+			for(std::size_t i = 0; i < count; i++)
+				m_slots[(bottom + i) % kCapacity].store(
+					victim.m_slots[(top + i) % kCapacity].load(std::memory_order_relaxed),
+					std::memory_order_relaxed);
+
+			if(!victim.m_top.compare_exchange_weak(top, top + count, std::memory_order_acq_rel, std::memory_order_acquire))
+				continue;
+
+			for(std::size_t i = 0; i < count; i++)
+				m_slots[(bottom + i) % kCapacity].load(std::memory_order_relaxed)->libcr_thread = (cr::detail::Thread) thread;
+
+			m_bottom.store(bottom + count, std::memory_order_release);
+			return count;
+		}
+	}
+
+	template<std::size_t kCapacity>
+	WorkDeque<kCapacity>::WorkDeque()
+	{
+		PODWorkDeque<kCapacity>::initialise();
+	}
+}
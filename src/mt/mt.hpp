@@ -4,13 +4,19 @@
 #define __libcr_mt_mt_hpp_defined
 
 #include "Barrier.hpp"
+#include "BroadcastRing.hpp"
+#include "Channel.hpp"
 #include "ConditionVariable.hpp"
 #include "Event.hpp"
 #include "Future.hpp"
 #include "Mutex.hpp"
 #include "Promise.hpp"
+#include "PriorityQueue.hpp"
 #include "Queue.hpp"
+#include "SPSCQueue.hpp"
 #include "Semaphore.hpp"
+#include "SharedMutex.hpp"
+#include "UnboundedQueue.hpp"
 
 /** Contains all synchronisation primitives.
 	These primitives are thread-safe. For thread-unsafe versions, see namespace `cr::sync`. */
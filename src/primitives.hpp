@@ -27,6 +27,26 @@
 	Only works with nest coroutines. */
 #define CR_YIELD CR_AWAIT(LibCrScheduler::instance().enqueue())
 
+/** @def CR_SLEEP(duration)
+	Puts the coroutine to sleep for at least `duration`, and lets the scheduler resume it afterwards. `duration` is a `std::chrono::duration`.
+	Only works with nest coroutines. */
+#define CR_SLEEP(duration) CR_AWAIT(LibCrScheduler::instance().sleep_for((duration)))
+
+/** @def CR_SLEEP_UNTIL(time)
+	Puts the coroutine to sleep until `time`, and lets the scheduler resume it afterwards. `time` is a `cr::TimerWheel::clock::time_point`.
+	Only works with nest coroutines. */
+#define CR_SLEEP_UNTIL(time) CR_AWAIT(LibCrScheduler::instance().sleep_until((time)))
+
+/** @def CR_TIMEOUT(timeout, duration)
+	Creates a deadline for a timed wait, such as `wait_for()`, that expires after `duration`. `timeout` is a `cr::PODTimeout` that outlives the wait, and `duration` is a `std::chrono::duration`. On expiry, the wait fails and the `#CR_AWAIT` error handler is executed.
+	Only works with nest coroutines. */
+#define CR_TIMEOUT(timeout, duration) LibCrScheduler::instance().deadline_for((timeout), (duration))
+
+/** @def CR_TIMEOUT_UNTIL(timeout, time)
+	Creates a deadline for a timed wait, such as `wait_for()`, that expires at `time`. `timeout` is a `cr::PODTimeout` that outlives the wait, and `time` is a `cr::TimerWheel::clock::time_point`. On expiry, the wait fails and the `#CR_AWAIT` error handler is executed.
+	Only works with nest coroutines. */
+#define CR_TIMEOUT_UNTIL(timeout, time) LibCrScheduler::instance().deadline_until((timeout), (time))
+
 /** @def CR_PYIELD
 	Saves the execution progress and yields the execution to the calling function.
 	Only works with protothreads. */
@@ -208,7 +228,7 @@
 		cr_label_return: \
 			LIBCR_HELPER_SAVE(id); \
 				if(libcr_parent) \
-					(*libcr_parent)(); \
+					libcr_parent->resume(); \
 			return; \
 		LIBCR_HELPER_LABEL(id): \
 			assert(!"COROUTINE coroutine called after return."); \
@@ -231,7 +251,7 @@
 			goto cr_label_finally; \
 		cr_label_return: \
 			if(libcr_parent) \
-				(*libcr_parent)(); \
+				libcr_parent->resume(); \
 		} while(0); \
 	}
 #endif
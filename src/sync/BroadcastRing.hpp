@@ -0,0 +1,160 @@
+/** @file BroadcastRing.hpp
+	Contains the thread-unsafe single-writer broadcast ring types. */
+#ifndef __libcr_sync_broadcastring_hpp_defined
+#define __libcr_sync_broadcastring_hpp_defined
+
+#include "ConditionVariable.hpp"
+#include "detail/WaiterSlot.hpp"
+#include "../primitives.hpp"
+#include "../util/RefConv.hpp"
+#include <array>
+#include <cstddef>
+
+namespace cr::sync
+{
+	/** What a broadcast ring does when its writer catches up with its slowest subscriber. */
+	enum class BroadcastPolicy
+	{
+		/** The writer waits until the slowest subscriber read the oldest value. */
+		kBackpressure,
+		/** The writer overwrites the oldest value, and subscribers that fell behind skip the lost values. */
+		kOverwrite
+	};
+
+	template<class T, std::size_t kSize, BroadcastPolicy kPolicy = BroadcastPolicy::kBackpressure>
+	/** POD fixed capacity ring that delivers every value to all subscribers.
+		The writer stores each value once and wakes all waiting subscribers with a single notification. Every subscriber reads through its own cursor, so subscribers do not contend with each other. Only one coroutine may write at a time.
+	@tparam T:
+		The ring's data type. Must be copy assignable.
+	@tparam kSize:
+		The ring's capacity.
+	@tparam kPolicy:
+		What to do when the ring is full. */
+	class PODBroadcastRing
+	{
+		static_assert(kSize > 0, "A ring needs to hold at least one element.");
+		/** How many slots have to be free before a waiting writer is resumed. */
+		static constexpr std::size_t kSkip = (kSize + 1) / 2;
+	public:
+		/** A subscriber's reading position.
+			Cursors are provided by the subscribers, usually as part of their coroutine state, and have to stay subscribed while they are in use. */
+		class Cursor
+		{
+			friend class PODBroadcastRing;
+			/** The next subscribed cursor. */
+			Cursor * m_next;
+			/** The number of values read or skipped through the cursor. */
+			std::size_t m_sequence;
+			/** The number of values this cursor skipped because they were overwritten. */
+			std::size_t m_lost;
+		public:
+			/** The number of values this cursor skipped because they were overwritten.
+				Always 0 with `BroadcastPolicy::kBackpressure`. */
+			inline std::size_t lost() const;
+		};
+
+	private:
+		/** The ring's values. */
+		std::array<T, kSize> m_values;
+		/** The number of written values. */
+		std::size_t m_tail;
+		/** A lower bound of the slowest subscriber's sequence. Only updated when the ring seems full. */
+		std::size_t m_slowest;
+		/** The subscribed cursors. */
+		Cursor * m_cursors;
+		/** The subscribers waiting for a value. */
+		PODConditionVariable m_readers;
+		/** The writer, while it waits for the slowest subscriber.
+			Subscribers only resume it once half of the ring is free, so that the writer does not look at all cursors after every read. */
+		detail::PODWaiterSlot m_writer;
+		/** How to resume waiting coroutines. */
+		Resumer m_resumer;
+
+		/** Whether the writer has to wait before writing the next value.
+			Refreshes the slowest subscriber's sequence only if necessary. */
+		inline bool full();
+
+		template<class V>
+		/** Writes a value and notifies the waiting subscribers. */
+		inline void put(
+			V &&value);
+	public:
+		/** Initialises the ring. */
+		void initialise();
+
+		/** Sets how coroutines waiting for the ring are resumed.
+			By default, they are resumed directly by the writing or reading coroutine. Use a scheduler's `deferred()` resumer to enqueue them instead, so that the notifying coroutine continues right away.
+		@param[in] resumer:
+			How to resume waiting coroutines. */
+		inline void set_resumer(
+			Resumer resumer);
+
+		/** Subscribes a cursor to the ring.
+			The cursor receives all values written after this call.
+		@param[out] cursor:
+			The cursor to subscribe. */
+		void subscribe(
+			Cursor &cursor);
+		/** Unsubscribes a cursor from the ring.
+			Must not be called while a subscriber waits with the cursor.
+		@param[in] cursor:
+			The subscribed cursor. */
+		void unsubscribe(
+			Cursor &cursor);
+
+		/** Reads the next value through a cursor, if available.
+		@param[in] cursor:
+			The subscribed cursor.
+		@param[out] target:
+			The location to copy the value to.
+		@return
+			Whether a value was read. */
+		bool try_receive(
+			Cursor &cursor,
+			T &target);
+
+		template<class V>
+		/** Writes a value to the ring.
+			Must only be used by one coroutine at a time.
+		@tparam V:
+			The written value's type. */
+		TEMPLATE_COROUTINE(PublishPattern, (V), void)
+		CR_STATE(
+			(PODBroadcastRing<T, kSize, kPolicy> &) ring,
+			(V) value);
+		CR_EXTERNAL
+
+		union Publish {
+			PublishPattern<T const&> copy;
+			PublishPattern<T &&> move;
+		};
+
+		/** Reads the next value through a cursor, waiting for it if necessary. */
+		COROUTINE(Receive, void)
+		CR_STATE(
+			(PODBroadcastRing<T, kSize, kPolicy> &) ring,
+			(Cursor &) cursor,
+			(T &) target);
+		CR_EXTERNAL
+	};
+
+	template<class T, std::size_t kSize, BroadcastPolicy kPolicy = BroadcastPolicy::kBackpressure>
+	/** Non-POD fixed capacity ring that delivers every value to all subscribers.
+	@tparam T:
+		The ring's data type.
+	@tparam kSize:
+		The ring's capacity.
+	@tparam kPolicy:
+		What to do when the ring is full. */
+	class BroadcastRing : public PODBroadcastRing<T, kSize, kPolicy>
+	{
+		using PODBroadcastRing<T, kSize, kPolicy>::initialise;
+	public:
+		/** Initialises the ring. */
+		inline BroadcastRing();
+	};
+}
+
+#include "BroadcastRing.inl"
+
+#endif
@@ -0,0 +1,127 @@
+#include <cassert>
+
+namespace cr::sync
+{
+	template<class T, std::size_t kSize, BroadcastPolicy kPolicy>
+	std::size_t PODBroadcastRing<T, kSize, kPolicy>::Cursor::lost() const
+	{
+		return m_lost;
+	}
+
+	template<class T, std::size_t kSize, BroadcastPolicy kPolicy>
+	bool PODBroadcastRing<T, kSize, kPolicy>::full()
+	{
+		if(m_tail - m_slowest != kSize)
+			return false;
+
+		// Sequences only grow, so the cached value stays a lower bound until it is refreshed here.
+		m_slowest = m_tail;
+		for(Cursor * cursor = m_cursors; cursor; cursor = cursor->m_next)
+			if(m_tail - cursor->m_sequence > m_tail - m_slowest)
+				m_slowest = cursor->m_sequence;
+		return m_tail - m_slowest == kSize;
+	}
+
+	template<class T, std::size_t kSize, BroadcastPolicy kPolicy>
+	template<class V>
+	void PODBroadcastRing<T, kSize, kPolicy>::put(
+		V &&value)
+	{
+		util::assign(m_values[m_tail++ % kSize], std::forward<V>(value));
+		m_readers.notify_all(m_resumer);
+	}
+
+	template<class T, std::size_t kSize, BroadcastPolicy kPolicy>
+	void PODBroadcastRing<T, kSize, kPolicy>::initialise()
+	{
+		m_tail = 0;
+		m_slowest = 0;
+		m_cursors = nullptr;
+		m_readers.initialise();
+		m_writer.initialise();
+		m_resumer = Resumer();
+	}
+
+	template<class T, std::size_t kSize, BroadcastPolicy kPolicy>
+	void PODBroadcastRing<T, kSize, kPolicy>::set_resumer(
+		Resumer resumer)
+	{
+		m_resumer = resumer;
+	}
+
+	template<class T, std::size_t kSize, BroadcastPolicy kPolicy>
+	void PODBroadcastRing<T, kSize, kPolicy>::subscribe(
+		Cursor &cursor)
+	{
+		cursor.m_sequence = m_tail;
+		cursor.m_lost = 0;
+		cursor.m_next = m_cursors;
+		m_cursors = &cursor;
+	}
+
+	template<class T, std::size_t kSize, BroadcastPolicy kPolicy>
+	void PODBroadcastRing<T, kSize, kPolicy>::unsubscribe(
+		Cursor &cursor)
+	{
+		Cursor ** link = &m_cursors;
+		while(*link != &cursor)
+		{
+			assert(*link && "The cursor is not subscribed.");
+			link = &(*link)->m_next;
+		}
+		*link = cursor.m_next;
+
+		// The writer might have waited for this cursor.
+		if(kPolicy == BroadcastPolicy::kBackpressure)
+			m_writer.notify(m_resumer);
+	}
+
+	template<class T, std::size_t kSize, BroadcastPolicy kPolicy>
+	bool PODBroadcastRing<T, kSize, kPolicy>::try_receive(
+		Cursor &cursor,
+		T &target)
+	{
+		if(cursor.m_sequence == m_tail)
+			return false;
+
+		if(kPolicy == BroadcastPolicy::kOverwrite
+		&& m_tail - cursor.m_sequence > kSize)
+		{
+			std::size_t const oldest = m_tail - kSize;
+			cursor.m_lost += oldest - cursor.m_sequence;
+			cursor.m_sequence = oldest;
+		}
+
+		util::assign(target, m_values[cursor.m_sequence++ % kSize]);
+
+		// While the writer waits, the tail stays put, and every cursor passes this point at most once.
+		if(kPolicy == BroadcastPolicy::kBackpressure
+		&& m_tail - cursor.m_sequence == kSize - kSkip)
+			m_writer.notify(m_resumer);
+		return true;
+	}
+
+	template<class T, std::size_t kSize, BroadcastPolicy kPolicy>
+	template<class V>
+	CR_IMPL(PODBroadcastRing<T, kSize, kPolicy>::PublishPattern<V>)
+		// Only subscribers free slots, and they notify once half of the ring is free.
+		if(kPolicy == BroadcastPolicy::kBackpressure)
+			while(ring->full())
+				CR_AWAIT(ring->m_writer.wait());
+		ring->put(std::forward<V>(value));
+	CR_FINALLY
+	CR_IMPL_END
+
+	template<class T, std::size_t kSize, BroadcastPolicy kPolicy>
+	CR_IMPL(PODBroadcastRing<T, kSize, kPolicy>::Receive)
+		while(!ring->try_receive(*cursor, *target))
+			CR_AWAIT(ring->m_readers.wait());
+	CR_FINALLY
+	CR_IMPL_END
+
+	template<class T, std::size_t kSize, BroadcastPolicy kPolicy>
+	BroadcastRing<T, kSize, kPolicy>::BroadcastRing()
+	{
+		initialise();
+	}
+}
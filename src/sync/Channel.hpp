@@ -0,0 +1,148 @@
+/** @file Channel.hpp
+	Contains the thread-unsafe rendezvous channel types. */
+#ifndef __libcr_sync_channel_hpp_defined
+#define __libcr_sync_channel_hpp_defined
+
+#include "Block.hpp"
+#include "../Resumer.hpp"
+#include "../primitives.hpp"
+#include "../util/RefConv.hpp"
+
+namespace cr::sync
+{
+	template<class T>
+	/** POD unbuffered channel type.
+		A value is only transferred when a sending and a receiving coroutine meet: whichever comes first waits for its counterpart, and the second one moves the value straight from the sender to the receiver's target and resumes the first one.
+	@tparam T:
+		The channel's value type. */
+	class PODChannel
+	{
+		/** A coroutine waiting for its counterpart.
+			Lives in the waiting coroutine's state. */
+		struct Waiter
+		{
+			/** The next waiting coroutine. */
+			Waiter * next;
+			/** The waiting coroutine. */
+			Coroutine * coroutine;
+			/** The value to send, or the receiver's target. */
+			T * value;
+		};
+
+		/** FIFO list of waiting coroutines. */
+		class WaiterList
+		{
+			/** The first waiting coroutine. */
+			Waiter * m_first;
+			/** The last waiting coroutine. */
+			Waiter * m_last;
+		public:
+			/** Initialises the list to be empty. */
+			inline void initialise();
+			/** Appends a waiting coroutine.
+			@param[in] waiter:
+				The waiting coroutine. */
+			inline void push(
+				Waiter &waiter);
+			/** Removes the first waiting coroutine.
+			@return
+				The removed coroutine, or null. */
+			inline Waiter * pop();
+		};
+
+		/** Helper class for meeting a counterpart using `#CR_AWAIT`. */
+		class TransferCall
+		{
+			/** The channel. */
+			PODChannel<T> &m_channel;
+			/** The calling coroutine's waiting record. */
+			Waiter &m_waiter;
+			/** The value to send, or the target to receive into. */
+			T &m_value;
+			/** Whether the calling coroutine sends. */
+			bool m_sending;
+		public:
+			/** Initialises the transfer call.
+			@param[in] channel:
+				The channel.
+			@param[in] waiter:
+				The calling coroutine's waiting record.
+			@param[in] value:
+				The value to send, or the target to receive into.
+			@param[in] sending:
+				Whether the calling coroutine sends. */
+			constexpr TransferCall(
+				PODChannel<T> &channel,
+				Waiter &waiter,
+				T &value,
+				bool sending);
+
+			/** Transfers the value if a counterpart waits, otherwise makes the coroutine wait.
+			@param[in] coroutine:
+				The calling coroutine.
+			@return
+				Whether the call blocks. */
+			[[nodiscard]] inline mayblock libcr_wait(
+				Coroutine * coroutine);
+		};
+
+		/** The waiting senders. */
+		WaiterList m_senders;
+		/** The waiting receivers. */
+		WaiterList m_receivers;
+		/** How to resume waiting coroutines. */
+		Resumer m_resumer;
+	public:
+		/** Initialises the channel. */
+		void initialise();
+
+		/** Sets how waiting coroutines are resumed.
+			By default, they are resumed directly by their counterpart. Use a scheduler's `deferred()` resumer to enqueue them instead, so that the counterpart continues right away.
+		@param[in] resumer:
+			How to resume waiting coroutines. */
+		inline void set_resumer(
+			Resumer resumer);
+
+		template<class V>
+		/** Sends a value through the channel, waiting for a receiver.
+		@tparam V:
+			The sent value's type. */
+		TEMPLATE_COROUTINE(SendPattern, (V), void)
+		CR_STATE(
+			(PODChannel<T> &) channel,
+			(V) value);
+			/** The waiting record. */
+			Waiter waiter;
+		CR_EXTERNAL
+
+		union Send {
+			SendPattern<T const&> copy;
+			SendPattern<T &&> move;
+		};
+
+		/** Receives a value from the channel, waiting for a sender. */
+		COROUTINE(Receive, void)
+		CR_STATE(
+			(PODChannel<T> &) channel,
+			(T &) target);
+			/** The waiting record. */
+			Waiter waiter;
+		CR_EXTERNAL
+	};
+
+	template<class T>
+	/** Non-POD unbuffered channel type.
+	@tparam T:
+		The channel's value type. */
+	class Channel : public PODChannel<T>
+	{
+		using PODChannel<T>::initialise;
+	public:
+		/** Initialises the channel. */
+		inline Channel();
+	};
+}
+
+#include "Channel.inl"
+
+#endif
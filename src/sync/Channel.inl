@@ -0,0 +1,98 @@
+namespace cr::sync
+{
+	template<class T>
+	void PODChannel<T>::WaiterList::initialise()
+	{
+		m_first = m_last = nullptr;
+	}
+
+	template<class T>
+	void PODChannel<T>::WaiterList::push(
+		Waiter &waiter)
+	{
+		waiter.next = nullptr;
+		if(m_last)
+			m_last->next = &waiter;
+		else
+			m_first = &waiter;
+		m_last = &waiter;
+	}
+
+	template<class T>
+	typename PODChannel<T>::Waiter * PODChannel<T>::WaiterList::pop()
+	{
+		Waiter * first = m_first;
+		if(first && !(m_first = first->next))
+			m_last = nullptr;
+		return first;
+	}
+
+	template<class T>
+	constexpr PODChannel<T>::TransferCall::TransferCall(
+		PODChannel<T> &channel,
+		Waiter &waiter,
+		T &value,
+		bool sending):
+		m_channel(channel),
+		m_waiter(waiter),
+		m_value(value),
+		m_sending(sending)
+	{
+	}
+
+	template<class T>
+	mayblock PODChannel<T>::TransferCall::libcr_wait(
+		Coroutine * coroutine)
+	{
+		if(Waiter * other = (m_sending ? m_channel.m_receivers : m_channel.m_senders).pop())
+		{
+			if(m_sending)
+				util::assign(*other->value, std::move(m_value));
+			else
+				util::assign(m_value, std::move(*other->value));
+			m_channel.m_resumer(other->coroutine);
+			return nonblock();
+		}
+
+		m_waiter.coroutine = coroutine;
+		m_waiter.value = &m_value;
+		(m_sending ? m_channel.m_senders : m_channel.m_receivers).push(m_waiter);
+		return block();
+	}
+
+	template<class T>
+	void PODChannel<T>::initialise()
+	{
+		m_senders.initialise();
+		m_receivers.initialise();
+		m_resumer = Resumer();
+	}
+
+	template<class T>
+	void PODChannel<T>::set_resumer(
+		Resumer resumer)
+	{
+		m_resumer = resumer;
+	}
+
+	template<class T>
+	template<class V>
+	CR_IMPL(PODChannel<T>::SendPattern<V>)
+		// A waiting receiver moves the value out of this coroutine's state.
+		CR_AWAIT(TransferCall(*channel, waiter, value, true));
+	CR_FINALLY
+	CR_IMPL_END
+
+	template<class T>
+	CR_IMPL(PODChannel<T>::Receive)
+		// A waiting sender moves the value straight into the target.
+		CR_AWAIT(TransferCall(*channel, waiter, *target, false));
+	CR_FINALLY
+	CR_IMPL_END
+
+	template<class T>
+	Channel<T>::Channel()
+	{
+		initialise();
+	}
+}
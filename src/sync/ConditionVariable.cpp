@@ -24,6 +24,7 @@ namespace cr::sync
 		assert(coroutine != nullptr);
 
 		coroutine->libcr_next_waiting.plain = nullptr;
+		coroutine->libcr_prev_waiting = m_cv.m_last_waiting;
 
 		if(!m_cv.m_first_waiting)
 		{
@@ -38,7 +39,8 @@ namespace cr::sync
 		return block();
 	}
 
-	bool PODFIFOConditionVariable::notify_one()
+	bool PODFIFOConditionVariable::notify_one(
+		Resumer resumer)
 	{
 		Coroutine * first = m_first_waiting;
 		if(first)
@@ -49,9 +51,10 @@ namespace cr::sync
 				m_last_waiting = nullptr;
 			}
 
-			m_first_waiting = first->libcr_next_waiting.plain;
+			if((m_first_waiting = first->libcr_next_waiting.plain))
+				m_first_waiting->libcr_prev_waiting = nullptr;
 
-			(*first)();
+			resumer(first);
 		}
 
 		return first != nullptr;
@@ -68,10 +71,11 @@ namespace cr::sync
 				m_last_waiting = nullptr;
 			}
 
-			m_first_waiting = first->libcr_next_waiting.plain;
+			if((m_first_waiting = first->libcr_next_waiting.plain))
+				m_first_waiting->libcr_prev_waiting = nullptr;
 
 			first->libcr_error = true;
-			(*first)();
+			first->resume();
 		}
 
 		return first != nullptr;
@@ -90,12 +94,14 @@ namespace cr::sync
 			m_last_waiting = nullptr;
 		}
 
-		m_first_waiting = first->libcr_next_waiting.plain;
+		if((m_first_waiting = first->libcr_next_waiting.plain))
+			m_first_waiting->libcr_prev_waiting = nullptr;
 
 		return first;
 	}
 
-	bool PODFIFOConditionVariable::notify_all()
+	bool PODFIFOConditionVariable::notify_all(
+		Resumer resumer)
 	{
 		Coroutine * coroutine = m_first_waiting;
 
@@ -108,8 +114,9 @@ namespace cr::sync
 		do
 		{
 			next = coroutine->libcr_next_waiting.plain;
+			coroutine->libcr_prev_waiting = nullptr;
 
-			(*coroutine)();
+			resumer(coroutine);
 		} while((coroutine = next));
 
 		return true;
@@ -128,9 +135,10 @@ namespace cr::sync
 		do
 		{
 			next = coroutine->libcr_next_waiting.plain;
+			coroutine->libcr_prev_waiting = nullptr;
 
 			coroutine->libcr_error = true;
-			(*coroutine)();
+			coroutine->resume();
 
 		} while((coroutine = next));
 
@@ -148,6 +156,42 @@ namespace cr::sync
 		return first;
 	}
 
+	block PODFIFOConditionVariable::TimedWaitCall::libcr_wait(
+		Coroutine * coroutine)
+	{
+		assert(coroutine != nullptr);
+
+		Deadline::Registration registration(
+			m_deadline,
+			coroutine,
+			&m_cv,
+			&PODTimeout::remove_from<PODFIFOConditionVariable>);
+
+		return m_cv.wait().libcr_wait(registration.timeout());
+	}
+
+	bool PODFIFOConditionVariable::remove(
+		Coroutine * coroutine)
+	{
+		Coroutine * prev = coroutine->libcr_prev_waiting;
+		Coroutine * next = coroutine->libcr_next_waiting.plain;
+
+		if(prev)
+			prev->libcr_next_waiting.plain = next;
+		else if(m_first_waiting == coroutine)
+			m_first_waiting = next;
+		else
+			return false;
+
+		if(next)
+			next->libcr_prev_waiting = prev;
+		else
+			m_last_waiting = prev;
+
+		coroutine->libcr_prev_waiting = nullptr;
+		return true;
+	}
+
 	FIFOConditionVariable::FIFOConditionVariable()
 	{
 		initialise();
@@ -170,19 +214,24 @@ namespace cr::sync
 		assert(coroutine != nullptr);
 
 		coroutine->libcr_next_waiting.plain = m_cv.m_waiting;
+		coroutine->libcr_prev_waiting = nullptr;
+		if(m_cv.m_waiting)
+			m_cv.m_waiting->libcr_prev_waiting = coroutine;
 		m_cv.m_waiting = coroutine;
 
 		return block();
 	}
 
-	bool PODConditionVariable::notify_one()
+	bool PODConditionVariable::notify_one(
+		Resumer resumer)
 	{
 		if(!m_waiting)
 			return false;
 
 		Coroutine * first = m_waiting;
-		m_waiting = first->libcr_next_waiting.plain;
-		(*first)();
+		if((m_waiting = first->libcr_next_waiting.plain))
+			m_waiting->libcr_prev_waiting = nullptr;
+		resumer(first);
 
 		return true;
 	}
@@ -193,10 +242,11 @@ namespace cr::sync
 			return false;
 
 		Coroutine * first = m_waiting;
-		m_waiting = first->libcr_next_waiting.plain;
+		if((m_waiting = first->libcr_next_waiting.plain))
+			m_waiting->libcr_prev_waiting = nullptr;
 
 		first->libcr_error = true;
-		(*first)();
+		first->resume();
 
 		return true;
 	}
@@ -204,12 +254,13 @@ namespace cr::sync
 	Coroutine * PODConditionVariable::remove_one()
 	{
 		Coroutine * first = m_waiting;
-		if(first)
-			m_waiting = first->libcr_next_waiting.plain;
+		if(first && (m_waiting = first->libcr_next_waiting.plain))
+			m_waiting->libcr_prev_waiting = nullptr;
 		return first;
 	}
 
-	bool PODConditionVariable::notify_all()
+	bool PODConditionVariable::notify_all(
+		Resumer resumer)
 	{
 		Coroutine * coroutine = m_waiting;
 		m_waiting = nullptr;
@@ -220,8 +271,9 @@ namespace cr::sync
 		while(coroutine)
 		{
 			Coroutine * next = coroutine->libcr_next_waiting.plain;
+			coroutine->libcr_prev_waiting = nullptr;
 
-			(*coroutine)();
+			resumer(coroutine);
 
 			coroutine = next;
 		}
@@ -240,9 +292,10 @@ namespace cr::sync
 		while(coroutine)
 		{
 			Coroutine * next = coroutine->libcr_next_waiting.plain;
+			coroutine->libcr_prev_waiting = nullptr;
 
 			coroutine->libcr_error = true;
-			(*coroutine)();
+			coroutine->resume();
 
 			coroutine = next;
 		}
@@ -259,6 +312,40 @@ namespace cr::sync
 
 	}
 
+	block PODConditionVariable::TimedWaitCall::libcr_wait(
+		Coroutine * coroutine)
+	{
+		assert(coroutine != nullptr);
+
+		Deadline::Registration registration(
+			m_deadline,
+			coroutine,
+			&m_cv,
+			&PODTimeout::remove_from<PODConditionVariable>);
+
+		return m_cv.wait().libcr_wait(registration.timeout());
+	}
+
+	bool PODConditionVariable::remove(
+		Coroutine * coroutine)
+	{
+		Coroutine * prev = coroutine->libcr_prev_waiting;
+		Coroutine * next = coroutine->libcr_next_waiting.plain;
+
+		if(prev)
+			prev->libcr_next_waiting.plain = next;
+		else if(m_waiting == coroutine)
+			m_waiting = next;
+		else
+			return false;
+
+		if(next)
+			next->libcr_prev_waiting = prev;
+
+		coroutine->libcr_prev_waiting = nullptr;
+		return true;
+	}
+
 	ConditionVariable::ConditionVariable()
 	{
 		initialise();
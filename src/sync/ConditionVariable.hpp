@@ -4,6 +4,8 @@
 #define __libcr_sync_conditionvariable_hpp_defined
 
 #include "Block.hpp"
+#include "../Timeout.hpp"
+#include "../Resumer.hpp"
 
 
 #ifdef LIBCR_INLINE
@@ -22,7 +24,8 @@ namespace cr
 
 namespace cr::sync
 {
-	/** POD condition variable with FIFO notifications. */
+	/** POD condition variable with FIFO notifications.
+		The waiting queue is doubly linked, so that timed out coroutines can be removed in O(1). */
 	class PODFIFOConditionVariable
 	{
 		/** The first coroutine waiting. */
@@ -61,14 +64,59 @@ namespace cr::sync
 		/** Adds a coroutine to the queue. */
 		[[nodiscard]] constexpr WaitCall wait();
 
+		/** Helper class for waiting for a condition variable with a timeout using `#CR_AWAIT`. */
+		class TimedWaitCall
+		{
+			/** The condition variable to wait for. */
+			PODFIFOConditionVariable &m_cv;
+			/** The deadline of the wait. */
+			Deadline m_deadline;
+		public:
+			/** Initialises the timed wait call.
+			@param[in] cv:
+				The condition variable to wait for.
+			@param[in] deadline:
+				The deadline of the wait. */
+			constexpr TimedWaitCall(
+				PODFIFOConditionVariable &cv,
+				Deadline const& deadline);
+
+			/** Adds a coroutine's timeout to the queue, and registers it with the scheduler.
+			@param[in] coroutine:
+				The coroutine to add to the waiting queue.
+			@return
+				Whether the call blocks. */
+			__LIBCR_INLINE block libcr_wait(
+				Coroutine * coroutine);
+		};
+
+		/** Adds a coroutine to the queue until it is notified or the deadline expires.
+			On expiry, the coroutine is removed from the queue and resumed with its error flag set.
+		@param[in] deadline:
+			The deadline of the wait, as created by the scheduler. */
+		[[nodiscard]] constexpr TimedWaitCall wait_for(
+			Deadline const& deadline);
+
+		/** Removes a waiting coroutine from anywhere in the queue.
+			Does not notify the removed coroutine.
+		@param[in] coroutine:
+			The coroutine to remove.
+		@return
+			Whether the coroutine was still waiting. */
+		__LIBCR_INLINE bool remove(
+			Coroutine * coroutine);
+
 		/** Returns the first coroutine in the waiting list. */
 		inline Coroutine * front();
 
 		/** Notifies the first waiting coroutine, if exists.
 			Removes the notified coroutine from the waiting queue.
+		@param[in] resumer:
+			How to resume the notified coroutine.
 		@return
 			Whether a coroutine was removed. */
-		__LIBCR_INLINE bool notify_one();
+		__LIBCR_INLINE bool notify_one(
+			Resumer resumer = Resumer());
 
 		/** Notifies the first waiting coroutine, if exists, and sets its error flag.
 			Removes the notified coroutine from the waiting queue.
@@ -84,9 +132,12 @@ namespace cr::sync
 
 		/** Notifies all waiting coroutines.
 			Only notifies and removes coroutines that were waiting before the call, not those added during the call.
+		@param[in] resumer:
+			How to resume the notified coroutines.
 		@return
 			Whether any coroutine was executed. */
-		__LIBCR_INLINE bool notify_all();
+		__LIBCR_INLINE bool notify_all(
+			Resumer resumer = Resumer());
 
 		/** Notifies all waiting coroutines, and sets their error flags.
 			Only notifies and removes coroutines that were waiting before the call, not those added during the call.
@@ -95,7 +146,7 @@ namespace cr::sync
 		__LIBCR_INLINE bool fail_all();
 
 		/** Removes all waiting coroutines.
-			Does not notify the removed coroutines.
+			Does not notify the removed coroutines. The removed coroutines keep stale `libcr_prev_waiting` links.
 		@return
 			The first removed coroutine, or null. */
 		__LIBCR_INLINE Coroutine * remove_all();
@@ -114,7 +165,8 @@ namespace cr::sync
 		__LIBCR_INLINE ~FIFOConditionVariable();
 	};
 
-	/** POD condition variable, with LIFO notifications. */
+	/** POD condition variable, with LIFO notifications.
+		The waiting stack is doubly linked, so that timed out coroutines can be removed in O(1). */
 	class PODConditionVariable
 	{
 		/** The waiting coroutine.*/
@@ -151,13 +203,58 @@ namespace cr::sync
 		/** Adds a coroutine to the queue. */
 		[[nodiscard]] constexpr WaitCall wait();
 
+		/** Helper class for waiting for a condition variable with a timeout using `#CR_AWAIT`. */
+		class TimedWaitCall
+		{
+			/** The condition variable to wait for. */
+			PODConditionVariable &m_cv;
+			/** The deadline of the wait. */
+			Deadline m_deadline;
+		public:
+			/** Initialises the timed wait call.
+			@param[in] cv:
+				The condition variable to wait for.
+			@param[in] deadline:
+				The deadline of the wait. */
+			constexpr TimedWaitCall(
+				PODConditionVariable &cv,
+				Deadline const& deadline);
+
+			/** Adds a coroutine's timeout to the queue, and registers it with the scheduler.
+			@param[in] coroutine:
+				The coroutine to add to the waiting queue.
+			@return
+				Whether the call blocks. */
+			__LIBCR_INLINE block libcr_wait(
+				Coroutine * coroutine);
+		};
+
+		/** Adds a coroutine to the queue until it is notified or the deadline expires.
+			On expiry, the coroutine is removed from the queue and resumed with its error flag set.
+		@param[in] deadline:
+			The deadline of the wait, as created by the scheduler. */
+		[[nodiscard]] constexpr TimedWaitCall wait_for(
+			Deadline const& deadline);
+
+		/** Removes a waiting coroutine from anywhere in the queue.
+			Does not notify the removed coroutine.
+		@param[in] coroutine:
+			The coroutine to remove.
+		@return
+			Whether the coroutine was still waiting. */
+		__LIBCR_INLINE bool remove(
+			Coroutine * coroutine);
+
 		/** The waiting coroutine, or `null`. */
 		inline Coroutine * front();
 
 		/** Notifies the waiting coroutine, if exists.
+		@param[in] resumer:
+			How to resume the notified coroutine.
 		@return
 			Whether a coroutine was notified. */
-		__LIBCR_INLINE bool notify_one();
+		__LIBCR_INLINE bool notify_one(
+			Resumer resumer = Resumer());
 
 		/** Notifies the first waiting coroutine, if exists, and sets its error flag.
 			Removes the notified coroutine from the waiting queue.
@@ -172,9 +269,12 @@ namespace cr::sync
 		__LIBCR_INLINE Coroutine * remove_one();
 
 		/** Notifies all waiting coroutines.
+		@param[in] resumer:
+			How to resume the notified coroutines.
 		@return
 			Whether any coroutine was executed. */
-		__LIBCR_INLINE bool notify_all();
+		__LIBCR_INLINE bool notify_all(
+			Resumer resumer = Resumer());
 
 		/** Notifies all waiting coroutines, and sets their error flags.
 			Only notifies and removes coroutines that were waiting before the call, not those added during the call.
@@ -183,7 +283,7 @@ namespace cr::sync
 		__LIBCR_INLINE bool fail_all();
 
 		/** Removes all waiting coroutines.
-			Does not notify the removed coroutines.
+			Does not notify the removed coroutines. The removed coroutines keep stale `libcr_prev_waiting` links.
 		@return
 			The first removed coroutine, or null. */
 		__LIBCR_INLINE Coroutine * remove_all();
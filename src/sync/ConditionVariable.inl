@@ -16,6 +16,20 @@ namespace cr::sync
 		return WaitCall(*this);
 	}
 
+	constexpr PODFIFOConditionVariable::TimedWaitCall::TimedWaitCall(
+		PODFIFOConditionVariable &cv,
+		Deadline const& deadline):
+		m_cv(cv),
+		m_deadline(deadline)
+	{
+	}
+
+	constexpr PODFIFOConditionVariable::TimedWaitCall PODFIFOConditionVariable::wait_for(
+		Deadline const& deadline)
+	{
+		return TimedWaitCall(*this, deadline);
+	}
+
 	Coroutine * PODFIFOConditionVariable::front()
 	{
 		return m_first_waiting;
@@ -37,6 +51,20 @@ namespace cr::sync
 		return WaitCall(*this);
 	}
 
+	constexpr PODConditionVariable::TimedWaitCall::TimedWaitCall(
+		PODConditionVariable &cv,
+		Deadline const& deadline):
+		m_cv(cv),
+		m_deadline(deadline)
+	{
+	}
+
+	constexpr PODConditionVariable::TimedWaitCall PODConditionVariable::wait_for(
+		Deadline const& deadline)
+	{
+		return TimedWaitCall(*this, deadline);
+	}
+
 	Coroutine * PODConditionVariable::front()
 	{
 		return m_waiting;
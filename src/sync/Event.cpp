@@ -45,6 +45,36 @@ namespace cr::sync
 		}
 	}
 
+	template<class ConditionVariable>
+	mayblock PODEventPattern<ConditionVariable>::TimedWaitCall::libcr_wait(
+		Coroutine * coroutine)
+	{
+		if(m_event.m_happened)
+			return nonblock();
+		else
+			return m_event.m_cv.wait_for(m_deadline).libcr_wait(coroutine);
+	}
+
+	template<class ConditionVariable>
+	void PODEventPattern<ConditionVariable>::select_add(
+		void * event,
+		Coroutine * node)
+	{
+		PODEventPattern<ConditionVariable> &self = *static_cast<PODEventPattern<ConditionVariable> *>(event);
+		if(self.m_happened)
+			node->resume();
+		else
+			(void) self.m_cv.wait().libcr_wait(node);
+	}
+
+	template<class ConditionVariable>
+	bool PODEventPattern<ConditionVariable>::select_remove(
+		void * event,
+		Coroutine * node)
+	{
+		return static_cast<PODEventPattern<ConditionVariable> *>(event)->m_cv.remove(node);
+	}
+
 	template<class ConditionVariable>
 	bool PODEventPattern<ConditionVariable>::happened() const
 	{
@@ -65,6 +95,30 @@ namespace cr::sync
 			m_happened = true;
 	}
 
+	template<class ConditionVariable>
+	void PODConsumableEventPattern<ConditionVariable>::select_add(
+		void * event,
+		Coroutine * node)
+	{
+		PODConsumableEventPattern<ConditionVariable> &self = *static_cast<PODConsumableEventPattern<ConditionVariable> *>(event);
+		if(self.m_happened)
+		{
+			self.clear();
+			node->resume();
+		} else
+			(void) self.m_cv.wait().libcr_wait(node);
+	}
+
+	template<class ConditionVariable>
+	void PODConsumableEventPattern<ConditionVariable>::select_release(
+		void * event)
+	{
+		PODConsumableEventPattern<ConditionVariable> &self = *static_cast<PODConsumableEventPattern<ConditionVariable> *>(event);
+		// The event might have been fired again in the meantime, and stays active then.
+		if(!self.m_happened)
+			self.fire();
+	}
+
 	template<class ConditionVariable>
 	ConsumableEventPattern<ConditionVariable>::ConsumableEventPattern()
 	{
@@ -85,6 +139,20 @@ namespace cr::sync
 		}
 	}
 
+	template<class ConditionVariable>
+	mayblock PODConsumableEventPattern<ConditionVariable>::TimedConsumeCall::libcr_wait(
+		Coroutine * coroutine)
+	{
+		if(m_event.m_happened)
+		{
+			m_event.clear();
+			return nonblock();
+		} else
+		{
+			return m_event.m_cv.wait_for(m_deadline).libcr_wait(coroutine);
+		}
+	}
+
 	template class PODEventPattern<PODConditionVariable>;
 	template class PODEventPattern<PODFIFOConditionVariable>;
 	template class EventPattern<PODConditionVariable>;
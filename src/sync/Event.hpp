@@ -11,6 +11,7 @@
 
 #include "ConditionVariable.hpp"
 #include "Block.hpp"
+#include "../Selectable.hpp"
 
 namespace cr::sync
 {
@@ -28,6 +29,25 @@ namespace cr::sync
 		ConditionVariable m_cv;
 		/** Whether the event happened. */
 		bool m_happened;
+
+		/** Adds a select node to the event, or notifies it if the event happened.
+		@param[in] event:
+			The event.
+		@param[in] node:
+			The node to add. */
+		static void select_add(
+			void * event,
+			Coroutine * node);
+		/** Removes a select node from the event.
+		@param[in] event:
+			The event.
+		@param[in] node:
+			The node to remove.
+		@return
+			Whether the node was still waiting. */
+		static bool select_remove(
+			void * event,
+			Coroutine * node);
 	public:
 		/** Initialises the event. */
 		__LIBCR_INLINE void initialise();
@@ -66,6 +86,44 @@ namespace cr::sync
 			If has not yet happened, blocks the coroutine until the event happens. To be used with `#CR_AWAIT`. */
 		[[nodiscard]] constexpr WaitCall wait();
 
+		/** Helper class for waiting for an event with a timeout using `#CR_AWAIT`. */
+		class TimedWaitCall
+		{
+			/** The event to wait for. */
+			PODEventPattern<ConditionVariable> &m_event;
+			/** The deadline of the wait. */
+			Deadline m_deadline;
+		public:
+			/** Initialises the timed wait call.
+			@param[in] event:
+				The event to wait for.
+			@param[in] deadline:
+				The deadline of the wait. */
+			constexpr TimedWaitCall(
+				PODEventPattern<ConditionVariable> &event,
+				Deadline const& deadline);
+
+			/** Waits for the event until the deadline expires.
+				Blocks if the event did not happen yet.
+			@param[in] coroutine:
+				The coroutine to wait for the event.
+			@return
+				Whether the call blocks. */
+			[[nodiscard]] __LIBCR_INLINE mayblock libcr_wait(
+				Coroutine * coroutine);
+		};
+
+		/** Waits until the event happens or the deadline expires.
+			If has not yet happened, blocks the coroutine until the event happens, and fails if the deadline expires first. To be used with `#CR_AWAIT`.
+		@param[in] deadline:
+			The deadline of the wait, as created by the scheduler. */
+		[[nodiscard]] constexpr TimedWaitCall wait_for(
+			Deadline const& deadline);
+
+		/** Describes how `Select` waits for the event.
+			A selected wait finishes like `wait()`. */
+		[[nodiscard]] inline Selectable select_wait();
+
 		/** Whether the event happened. */
 		inline bool happened() const;
 	};
@@ -80,6 +138,8 @@ namespace cr::sync
 		using PODEventPattern<ConditionVariable>::fire;
 		using PODEventPattern<ConditionVariable>::clear;
 		using PODEventPattern<ConditionVariable>::wait;
+		using PODEventPattern<ConditionVariable>::wait_for;
+		using PODEventPattern<ConditionVariable>::select_wait;
 		using PODEventPattern<ConditionVariable>::happened;
 
 		/** Initialises the event. */
@@ -93,6 +153,21 @@ namespace cr::sync
 	{
 		using PODEventPattern<ConditionVariable>::m_cv;
 		using PODEventPattern<ConditionVariable>::m_happened;
+		using PODEventPattern<ConditionVariable>::select_remove;
+
+		/** Adds a select node to the event, or notifies it after consuming the event if it happened.
+		@param[in] event:
+			The event.
+		@param[in] node:
+			The node to add. */
+		static void select_add(
+			void * event,
+			Coroutine * node);
+		/** Passes on a consumption that a select node kept but does not use.
+		@param[in] event:
+			The event. */
+		static void select_release(
+			void * event);
 	public:
 		using PODEventPattern<ConditionVariable>::initialise;
 		using PODEventPattern<ConditionVariable>::clear;
@@ -126,6 +201,43 @@ namespace cr::sync
 		/** Waits until the event happens.
 			If has not yet happened, blocks the coroutine until the event happens. Otherwise, clears the event. To be used with `#CR_AWAIT`. */
 		[[nodiscard]] constexpr ConsumeCall consume();
+
+		/** Helper class for waiting for a consumable event with a timeout using `#CR_AWAIT`. */
+		class TimedConsumeCall
+		{
+			/** The event to wait for. */
+			PODConsumableEventPattern<ConditionVariable> &m_event;
+			/** The deadline of the wait. */
+			Deadline m_deadline;
+		public:
+			/** Initialises the timed wait call.
+			@param[in] event:
+				The consumable event to wait for.
+			@param[in] deadline:
+				The deadline of the wait. */
+			constexpr TimedConsumeCall(
+				PODConsumableEventPattern<ConditionVariable> &event,
+				Deadline const& deadline);
+
+			/** Waits for the event until the deadline expires.
+			@param[in] coroutine:
+				The coroutine waiting for the event.
+			@return
+				Whether the call blocks. */
+			[[nodiscard]] __LIBCR_INLINE mayblock libcr_wait(
+				Coroutine * coroutine);
+		};
+
+		/** Waits until the event happens or the deadline expires.
+			If has not yet happened, blocks the coroutine until the event happens, and fails if the deadline expires first. Otherwise, clears the event. To be used with `#CR_AWAIT`.
+		@param[in] deadline:
+			The deadline of the wait, as created by the scheduler. */
+		[[nodiscard]] constexpr TimedConsumeCall consume_for(
+			Deadline const& deadline);
+
+		/** Describes how `Select` waits for the event.
+			A selected wait finishes like `consume()`. */
+		[[nodiscard]] inline Selectable select_consume();
 	};
 
 	template<class ConditionVariable>
@@ -136,6 +248,8 @@ namespace cr::sync
 		using PODConsumableEventPattern<ConditionVariable>::fire;
 		using PODConsumableEventPattern<ConditionVariable>::clear;
 		using PODConsumableEventPattern<ConditionVariable>::consume;
+		using PODConsumableEventPattern<ConditionVariable>::consume_for;
+		using PODConsumableEventPattern<ConditionVariable>::select_consume;
 		using PODConsumableEventPattern<ConditionVariable>::happened;
 
 		/** Initialises the event. */
@@ -15,6 +15,30 @@ namespace cr::sync
 		return WaitCall(*this);
 	}
 
+	template<class ConditionVariable>
+	constexpr PODEventPattern<ConditionVariable>::TimedWaitCall::TimedWaitCall(
+		PODEventPattern<ConditionVariable> &event,
+		Deadline const& deadline):
+		m_event(event),
+		m_deadline(deadline)
+	{
+	}
+
+	template<class ConditionVariable>
+	constexpr
+		typename PODEventPattern<ConditionVariable>::TimedWaitCall
+		PODEventPattern<ConditionVariable>::wait_for(
+			Deadline const& deadline)
+	{
+		return TimedWaitCall(*this, deadline);
+	}
+
+	template<class ConditionVariable>
+	Selectable PODEventPattern<ConditionVariable>::select_wait()
+	{
+		return Selectable(this, &select_add, &select_remove, nullptr, nullptr);
+	}
+
 	template<class ConditionVariable>
 	constexpr PODConsumableEventPattern<ConditionVariable>::ConsumeCall::ConsumeCall(
 		PODConsumableEventPattern<ConditionVariable> &event):
@@ -29,6 +53,30 @@ namespace cr::sync
 	{
 		return ConsumeCall(*this);
 	}
+
+	template<class ConditionVariable>
+	constexpr PODConsumableEventPattern<ConditionVariable>::TimedConsumeCall::TimedConsumeCall(
+		PODConsumableEventPattern<ConditionVariable> &event,
+		Deadline const& deadline):
+		m_event(event),
+		m_deadline(deadline)
+	{
+	}
+
+	template<class ConditionVariable>
+	constexpr
+		typename PODConsumableEventPattern<ConditionVariable>::TimedConsumeCall
+		PODConsumableEventPattern<ConditionVariable>::consume_for(
+			Deadline const& deadline)
+	{
+		return TimedConsumeCall(*this, deadline);
+	}
+
+	template<class ConditionVariable>
+	Selectable PODConsumableEventPattern<ConditionVariable>::select_consume()
+	{
+		return Selectable(this, &select_add, &select_remove, nullptr, &select_release);
+	}
 }
 
 #ifdef LIBCR_INLINE
@@ -22,6 +22,7 @@ namespace cr::sync
 	{
 	public:
 		using Event::wait;
+		using Event::select_wait;
 		using Event::initialise;
 
 		/** Fulfills the promise.
@@ -50,6 +51,7 @@ namespace cr::sync
 		using PODFutureBasePattern<Event>::fulfill;
 	public:
 		using PODFutureBasePattern<Event>::wait;
+		using PODFutureBasePattern<Event>::select_wait;
 		using PODFutureBasePattern<Event>::initialise;
 		using PODFutureBasePattern<Event>::fulfilled;
 		using PODFutureBasePattern<Event>::listeners;
@@ -68,6 +70,7 @@ namespace cr::sync
 		using PODFutureBasePattern<Event>::fulfill;
 	public:
 		using PODFutureBasePattern<Event>::wait;
+		using PODFutureBasePattern<Event>::select_wait;
 		using PODFutureBasePattern<Event>::initialise;
 		using PODFutureBasePattern<Event>::fulfilled;
 		using PODFutureBasePattern<Event>::listeners;
@@ -103,6 +106,7 @@ namespace cr::sync
 		FuturePattern();
 
 		using PODFuturePattern<void, Event>::wait;
+		using PODFuturePattern<void, Event>::select_wait;
 		using PODFuturePattern<void, Event>::initialise;
 		using PODFuturePattern<void, Event>::fulfilled;
 		using PODFuturePattern<void, Event>::listeners;
@@ -120,6 +124,7 @@ namespace cr::sync
 		FuturePattern();
 
 		using PODFuturePattern<T, Event>::wait;
+		using PODFuturePattern<T, Event>::select_wait;
 		using PODFuturePattern<T, Event>::initialise;
 		using PODFuturePattern<T, Event>::fulfilled;
 		using PODFuturePattern<T, Event>::listeners;
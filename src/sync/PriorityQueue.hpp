@@ -0,0 +1,166 @@
+/** @file PriorityQueue.hpp
+	Contains the thread-unsafe priority queue types. */
+#ifndef __libcr_sync_priorityqueue_hpp_defined
+#define __libcr_sync_priorityqueue_hpp_defined
+
+#include "Semaphore.hpp"
+#include "../primitives.hpp"
+#include "../util/RefConv.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace cr::sync
+{
+	template<class T, std::size_t kSize, std::size_t kLevels, class Semaphore>
+	/** POD fixed capacity queue type with priority levels.
+		Every level is a FIFO queue of its own, so that pushing to a full level never blocks the other levels. Popping takes the oldest value of the highest non-empty level, which is found through a bitmap of the non-empty levels.
+	@tparam T:
+		The queue's data type.
+	@tparam kSize:
+		The capacity of each priority level.
+	@tparam kLevels:
+		The number of priority levels, at most 64. Higher levels are popped first.
+	@tparam Semaphore:
+		The semaphore type to use internally. */
+	class PODPriorityQueuePattern
+	{
+		static_assert(kSize > 0, "A level needs to hold at least one element.");
+		static_assert(kLevels > 0 && kLevels <= 64, "The level bitmap holds at most 64 levels.");
+
+		/** The values of each level. */
+		std::array<std::array<T, kSize>, kLevels> m_values;
+		/** The first element's index within each level. */
+		std::array<std::size_t, kLevels> m_start;
+		/** The number of elements in each level. */
+		std::array<std::size_t, kLevels> m_count;
+		/** Has a bit set for every non-empty level. */
+		std::uint64_t m_levels;
+		/** The elements in all levels. */
+		Semaphore m_elements;
+		/** The free slots in each level. */
+		std::array<Semaphore, kLevels> m_free;
+		/** How to resume waiting coroutines. */
+		Resumer m_resumer;
+
+		template<class V>
+		/** Appends a value to a level.
+			The slot must have been taken before.
+		@param[in] priority:
+			The level to append to.
+		@param[in] value:
+			The value to append. */
+		inline void put(
+			std::size_t priority,
+			V &&value);
+		/** Removes the oldest value of the highest non-empty level.
+			The element must have been taken before.
+		@param[out] target:
+			The location to move the value to.
+		@return
+			The level the value was taken from. */
+		inline std::size_t take(
+			T &target);
+	public:
+		/** Initialises the queue. */
+		void initialise();
+
+		/** Sets how coroutines waiting for the queue are resumed.
+			By default, they are resumed directly by the pushing or popping coroutine. Use a scheduler's `deferred()` resumer to enqueue them instead, so that the notifying coroutine continues right away.
+		@param[in] resumer:
+			How to resume waiting coroutines. */
+		inline void set_resumer(
+			Resumer resumer);
+
+		template<class V>
+		/** Pushes a value to the queue, waiting while its level is full.
+		@tparam V:
+			The pushed value's type. */
+		TEMPLATE_COROUTINE(PushPattern, (V), void)
+		CR_STATE(
+			(PODPriorityQueuePattern<T, kSize, kLevels, Semaphore> &) queue,
+			(V) value,
+			(std::size_t) priority);
+		CR_EXTERNAL
+
+		union Push {
+			PushPattern<T const&> copy;
+			PushPattern<T &&> move;
+		};
+
+		/** Pops the oldest value of the highest non-empty level. */
+		COROUTINE(Pop, void)
+		CR_STATE(
+			(PODPriorityQueuePattern<T, kSize, kLevels, Semaphore> &) queue,
+			(T &) target);
+		CR_EXTERNAL
+
+		/** Pops the oldest value of the highest non-empty level, unless the deadline expires first.
+			On expiry, the coroutine fails without popping a value. */
+		COROUTINE(TimedPop, void)
+		CR_STATE(
+			(PODPriorityQueuePattern<T, kSize, kLevels, Semaphore> &) queue,
+			(T &) target,
+			(Deadline) deadline);
+		CR_EXTERNAL
+	};
+
+	template<class T, std::size_t kSize, std::size_t kLevels, class Semaphore>
+	/** Non-POD fixed capacity queue type with priority levels.
+	@tparam T:
+		The queue's element type.
+	@tparam kSize:
+		The capacity of each priority level.
+	@tparam kLevels:
+		The number of priority levels, at most 64.
+	@tparam Semaphore:
+		The semaphore type to use. */
+	class PriorityQueuePattern : public PODPriorityQueuePattern<T, kSize, kLevels, Semaphore>
+	{
+		using PODPriorityQueuePattern<T, kSize, kLevels, Semaphore>::initialise;
+	public:
+		/** Initialises the queue. */
+		inline PriorityQueuePattern();
+	};
+
+	template<class T, std::size_t kSize, std::size_t kLevels>
+	/** POD priority queue type.
+	@tparam T:
+		The queue's data type.
+	@tparam kSize:
+		The capacity of each priority level.
+	@tparam kLevels:
+		The number of priority levels. */
+	using PODPriorityQueue = PODPriorityQueuePattern<T, kSize, kLevels, sync::PODSemaphore>;
+	template<class T, std::size_t kSize, std::size_t kLevels>
+	/** POD priority queue type with FIFO notifications.
+	@tparam T:
+		The queue's data type.
+	@tparam kSize:
+		The capacity of each priority level.
+	@tparam kLevels:
+		The number of priority levels. */
+	using PODFIFOPriorityQueue = PODPriorityQueuePattern<T, kSize, kLevels, sync::PODFIFOSemaphore>;
+	template<class T, std::size_t kSize, std::size_t kLevels>
+	/** Priority queue type.
+	@tparam T:
+		The queue's data type.
+	@tparam kSize:
+		The capacity of each priority level.
+	@tparam kLevels:
+		The number of priority levels. */
+	using PriorityQueue = PriorityQueuePattern<T, kSize, kLevels, sync::PODSemaphore>;
+	template<class T, std::size_t kSize, std::size_t kLevels>
+	/** Priority queue type with FIFO notifications.
+	@tparam T:
+		The queue's data type.
+	@tparam kSize:
+		The capacity of each priority level.
+	@tparam kLevels:
+		The number of priority levels. */
+	using FIFOPriorityQueue = PriorityQueuePattern<T, kSize, kLevels, sync::PODFIFOSemaphore>;
+}
+
+#include "PriorityQueue.inl"
+
+#endif
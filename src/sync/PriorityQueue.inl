@@ -0,0 +1,84 @@
+#include <cassert>
+
+namespace cr::sync
+{
+	template<class T, std::size_t kSize, std::size_t kLevels, class Semaphore>
+	template<class V>
+	void PODPriorityQueuePattern<T, kSize, kLevels, Semaphore>::put(
+		std::size_t priority,
+		V &&value)
+	{
+		std::size_t end = m_start[priority] + m_count[priority]++;
+		if(end >= kSize)
+			end -= kSize;
+		util::assign(m_values[priority][end], std::forward<V>(value));
+		m_levels |= std::uint64_t(1) << priority;
+	}
+
+	template<class T, std::size_t kSize, std::size_t kLevels, class Semaphore>
+	std::size_t PODPriorityQueuePattern<T, kSize, kLevels, Semaphore>::take(
+		T &target)
+	{
+		assert(m_levels && "The element was not taken.");
+		std::size_t const level = 63 - __builtin_clzll(m_levels);
+
+		std::size_t &start = m_start[level];
+		util::assign(target, std::move(m_values[level][start]));
+		if(++start == kSize)
+			start = 0;
+		if(!--m_count[level])
+			m_levels &= ~(std::uint64_t(1) << level);
+		return level;
+	}
+
+	template<class T, std::size_t kSize, std::size_t kLevels, class Semaphore>
+	void PODPriorityQueuePattern<T, kSize, kLevels, Semaphore>::initialise()
+	{
+		for(std::size_t i = 0; i < kLevels; i++)
+		{
+			m_start[i] = m_count[i] = 0;
+			m_free[i].initialise(kSize);
+		}
+		m_levels = 0;
+		m_elements.initialise(0);
+		m_resumer = Resumer();
+	}
+
+	template<class T, std::size_t kSize, std::size_t kLevels, class Semaphore>
+	void PODPriorityQueuePattern<T, kSize, kLevels, Semaphore>::set_resumer(
+		Resumer resumer)
+	{
+		m_resumer = resumer;
+	}
+
+	template<class T, std::size_t kSize, std::size_t kLevels, class Semaphore>
+	template<class V>
+	CR_IMPL(PODPriorityQueuePattern<T, kSize, kLevels, Semaphore>::PushPattern<V>)
+		assert(priority < kLevels && "Invalid priority level.");
+
+		CR_AWAIT(queue->m_free[priority].wait());
+		queue->put(priority, std::forward<V>(value));
+		queue->m_elements.notify(queue->m_resumer);
+	CR_FINALLY
+	CR_IMPL_END
+
+	template<class T, std::size_t kSize, std::size_t kLevels, class Semaphore>
+	CR_IMPL(PODPriorityQueuePattern<T, kSize, kLevels, Semaphore>::Pop)
+		CR_AWAIT(queue->m_elements.wait());
+		queue->m_free[queue->take(*target)].notify(queue->m_resumer);
+	CR_FINALLY
+	CR_IMPL_END
+
+	template<class T, std::size_t kSize, std::size_t kLevels, class Semaphore>
+	CR_IMPL(PODPriorityQueuePattern<T, kSize, kLevels, Semaphore>::TimedPop)
+		CR_AWAIT(queue->m_elements.wait_for(deadline));
+		queue->m_free[queue->take(*target)].notify(queue->m_resumer);
+	CR_FINALLY
+	CR_IMPL_END
+
+	template<class T, std::size_t kSize, std::size_t kLevels, class Semaphore>
+	PriorityQueuePattern<T, kSize, kLevels, Semaphore>::PriorityQueuePattern()
+	{
+		initialise();
+	}
+}
@@ -5,6 +5,7 @@
 
 #include "Semaphore.hpp"
 #include "../primitives.hpp"
+#include <algorithm>
 #include <array>
 
 namespace cr::sync
@@ -17,6 +18,8 @@ namespace cr::sync
 		Semaphore m_elements;
 		/** The currently free slots.*/
 		Semaphore m_free;
+		/** How to resume the coroutines notified by `push()` and `pop()`. */
+		Resumer m_resumer;
 	public:
 		/** Initialises the queue.
 		@param[in] capacity:
@@ -30,13 +33,66 @@ namespace cr::sync
 		/** Waits until there is at least one element in the queue.
 			To be used with `#CR_AWAIT`. */
 		[[nodiscard]] constexpr typename Semaphore::WaitCall elements();
+		/** Waits until there is at least one free slot in the queue, or the deadline expires.
+			To be used with `#CR_AWAIT`.
+		@param[in] deadline:
+			The deadline of the wait, as created by the scheduler. */
+		[[nodiscard]] constexpr typename Semaphore::TimedWaitCall free_for(
+			Deadline const& deadline);
+		/** Waits until there is at least one element in the queue, or the deadline expires.
+			To be used with `#CR_AWAIT`.
+		@param[in] deadline:
+			The deadline of the wait, as created by the scheduler. */
+		[[nodiscard]] constexpr typename Semaphore::TimedWaitCall elements_for(
+			Deadline const& deadline);
+
+		/** Describes how `Select` waits until the queue has an element.
+			The element is not taken, so the selecting coroutine still has to pop it afterwards. */
+		[[nodiscard]] inline Selectable select_pop();
+		/** Describes how `Select` waits until the queue has a free slot.
+			The slot is not taken, so the selecting coroutine still has to push afterwards. */
+		[[nodiscard]] inline Selectable select_push();
+
+		/** Sets how coroutines waiting for the queue are resumed.
+			By default, they are resumed directly within `push()` and `pop()`. Use a scheduler's `deferred()` resumer to enqueue them instead, so that the notifying coroutine continues right away.
+		@param[in] resumer:
+			How to resume notified coroutines. */
+		inline void set_resumer(
+			Resumer resumer);
+
+		/** Takes up to `max` free slots without waiting.
+		@param[in] max:
+			The maximum number of slots to take.
+		@return
+			The number of slots taken. */
+		inline std::size_t take_free(
+			std::size_t max);
+		/** Takes up to `max` elements without waiting.
+		@param[in] max:
+			The maximum number of elements to take.
+		@return
+			The number of elements taken. */
+		inline std::size_t take_elements(
+			std::size_t max);
 
 		/** Adds an element to the queue, notifying `elements()`.
 			This has to be called after the element is added. */
 		inline void push();
+		/** Adds several elements to the queue at once, notifying `elements()`.
+			This has to be called after the elements are added.
+		@param[in] count:
+			The number of added elements. */
+		inline void push(
+			std::size_t count);
 		/** Removes an element from the queue, notifying `free()`.
 			This has to be called after the element is removed. */
 		inline void pop();
+		/** Removes several elements from the queue at once, notifying `free()`.
+			This has to be called after the elements are removed.
+		@param[in] count:
+			The number of removed elements. */
+		inline void pop(
+			std::size_t count);
 	};
 
 	template<class T, std::size_t kSize, class Semaphore>
@@ -49,12 +105,72 @@ namespace cr::sync
 		The condition variable type to use internally. */
 	class PODFixedQueuePattern : PODQueueBasePattern<Semaphore>
 	{
+	public:
+		using PODQueueBasePattern<Semaphore>::set_resumer;
+		using PODQueueBasePattern<Semaphore>::select_pop;
+		using PODQueueBasePattern<Semaphore>::select_push;
+	private:
 		/** The queue's values. */
 		std::array<T, kSize> m_values;
+		/** Whether each slot was written or read ahead of a slot that is still claimed. */
+		std::array<bool, kSize> m_finished;
 		/** The first element's index. */
 		std::size_t m_start;
 		/** The end of the queue. */
 		std::size_t m_end;
+		/** The end of the published elements. Slots from here up to `m_end` are claimed or were written ahead of a claimed slot. */
+		std::size_t m_published;
+		/** The start of the occupied slots. Slots from here up to `m_start` are peeked or were read ahead of a peeked slot. */
+		std::size_t m_released;
+
+		/** Marks slots as finished, and moves an index over all finished slots that follow it.
+		@param[in,out] index:
+			`m_published` or `m_released`.
+		@param[in] slot:
+			The first finished slot.
+		@param[in] count:
+			The number of finished slots.
+		@return
+			How many slots the index moved. */
+		inline std::size_t finish(
+			std::size_t &index,
+			std::size_t slot,
+			std::size_t count);
+		/** Publishes written slots, notifying `elements()` once they directly follow the published elements.
+		@param[in] slot:
+			The first written slot.
+		@param[in] count:
+			The number of written slots. */
+		inline void published(
+			std::size_t slot,
+			std::size_t count);
+		/** Releases read slots, notifying `free()` once they directly follow the free slots.
+		@param[in] slot:
+			The first read slot.
+		@param[in] count:
+			The number of read slots. */
+		inline void released(
+			std::size_t slot,
+			std::size_t count);
+
+		/** Copies values to the end of the queue.
+			The slots must have been taken before.
+		@param[in] values:
+			The values to copy.
+		@param[in] count:
+			The number of values to copy. */
+		inline void write(
+			T const * values,
+			std::size_t count);
+		/** Moves values from the start of the queue.
+			The elements must have been taken before.
+		@param[out] target:
+			The location to move the values to.
+		@param[in] count:
+			The number of values to move. */
+		inline void read(
+			T * target,
+			std::size_t count);
 	public:
 		/** Initialises the queue. */
 		void initialise();
@@ -80,12 +196,108 @@ namespace cr::sync
 			(PODFixedQueuePattern<T, kSize, Semaphore> &) queue,
 			(T &) target);
 		CR_EXTERNAL
+
+		/** Pops a value from the queue, unless the deadline expires first.
+			On expiry, the coroutine fails without popping a value. */
+		COROUTINE(TimedPop, void)
+		CR_STATE(
+			(PODFixedQueuePattern<T, kSize, Semaphore> &) queue,
+			(T &) target,
+			(Deadline) deadline);
+		CR_EXTERNAL
+
+		/** Pushes several values to the queue.
+			Takes as many free slots at once as are available, and notifies waiting coroutines once per batch.
+		@param[in] values:
+			The values to push.
+		@param[in] count:
+			The number of values to push. */
+		COROUTINE(PushBulk, void)
+		CR_STATE(
+			(PODFixedQueuePattern<T, kSize, Semaphore> &) queue,
+			(T const *) values,
+			(std::size_t) count);
+			/** The number of values pushed so far. */
+			std::size_t pushed;
+			/** The size of the current batch. */
+			std::size_t batch;
+		CR_EXTERNAL
+
+		/** Pops several values from the queue.
+			Waits until at least `min` values were popped, and pops at most `max` values. Takes as many elements at once as are available, and notifies waiting coroutines once per batch.
+		@param[out] target:
+			The location to move the values to. Must have room for `max` values.
+		@param[in] min:
+			The number of values to wait for.
+		@param[in] max:
+			The maximum number of values to pop.
+		@param[out] count:
+			The number of popped values. */
+		COROUTINE(PopBulk, void)
+		CR_STATE(
+			(PODFixedQueuePattern<T, kSize, Semaphore> &) queue,
+			(T *) target,
+			(std::size_t) min,
+			(std::size_t) max,
+			(std::size_t &) count);
+			/** The size of the current batch. */
+			std::size_t batch;
+		CR_EXTERNAL
+
+		/** Waits for a free slot and claims it, so that the element can be constructed in place.
+			The slot has to be handed to `publish()` afterwards. Claimed slots may be published in any order. Until a slot is published, consumers do not see the elements pushed after it.
+		@param[out] slot:
+			The claimed slot. */
+		COROUTINE(Claim, void)
+		CR_STATE(
+			(PODFixedQueuePattern<T, kSize, Semaphore> &) queue,
+			(T * &) slot);
+		CR_EXTERNAL
+
+		/** Makes a claimed slot's element available to consumers.
+		@param[in] slot:
+			The slot returned by `Claim`. */
+		inline void publish(
+			T * slot);
+
+		/** Waits for an element and claims it, so that it can be processed in place.
+			The element has to be handed to `release()` afterwards. Claimed elements may be released in any order. Until an element is released, producers cannot reuse the slots popped after it.
+		@param[out] element:
+			The claimed element. */
+		COROUTINE(Peek, void)
+		CR_STATE(
+			(PODFixedQueuePattern<T, kSize, Semaphore> &) queue,
+			(T const * &) element);
+		CR_EXTERNAL
+
+		/** Waits for an element and claims it, unless the deadline expires first.
+			On expiry, the coroutine fails without claiming an element.
+		@param[out] element:
+			The claimed element.
+		@param[in] deadline:
+			The deadline of the wait, as created by the scheduler. */
+		COROUTINE(TimedPeek, void)
+		CR_STATE(
+			(PODFixedQueuePattern<T, kSize, Semaphore> &) queue,
+			(T const * &) element,
+			(Deadline) deadline);
+		CR_EXTERNAL
+
+		/** Frees a claimed element's slot for producers.
+		@param[in] element:
+			The element returned by `Peek` or `TimedPeek`. */
+		inline void release(
+			T const * element);
 	};
 
 	template<std::size_t kSize, class Semaphore>
 	class PODFixedQueuePattern<void, kSize, Semaphore> : PODQueueBasePattern<Semaphore>
 	{
 	public:
+		using PODQueueBasePattern<Semaphore>::set_resumer;
+		using PODQueueBasePattern<Semaphore>::select_pop;
+		using PODQueueBasePattern<Semaphore>::select_push;
+
 		void initialise();
 
 		COROUTINE(Push, void)
@@ -97,6 +309,12 @@ namespace cr::sync
 		CR_STATE(
 			(PODFixedQueuePattern<void, kSize, Semaphore> &) queue);
 		CR_EXTERNAL
+
+		COROUTINE(TimedPop, void)
+		CR_STATE(
+			(PODFixedQueuePattern<void, kSize, Semaphore> &) queue,
+			(Deadline) deadline);
+		CR_EXTERNAL
 	};
 
 	template<class T, std::size_t kSize, class Semaphore>
@@ -8,6 +8,7 @@ namespace cr::sync
 		assert(capacity > 0);
 		m_elements.initialise(0);
 		m_free.initialise(capacity);
+		m_resumer = Resumer();
 	}
 
 	template<class Semaphore>
@@ -22,23 +23,155 @@ namespace cr::sync
 		return m_elements.wait();
 	}
 
+	template<class Semaphore>
+	constexpr typename Semaphore::TimedWaitCall PODQueueBasePattern<Semaphore>::free_for(
+		Deadline const& deadline)
+	{
+		return m_free.wait_for(deadline);
+	}
+
+	template<class Semaphore>
+	constexpr typename Semaphore::TimedWaitCall PODQueueBasePattern<Semaphore>::elements_for(
+		Deadline const& deadline)
+	{
+		return m_elements.wait_for(deadline);
+	}
+
+	template<class Semaphore>
+	Selectable PODQueueBasePattern<Semaphore>::select_pop()
+	{
+		return m_elements.select_available();
+	}
+
+	template<class Semaphore>
+	Selectable PODQueueBasePattern<Semaphore>::select_push()
+	{
+		return m_free.select_available();
+	}
+
+	template<class Semaphore>
+	void PODQueueBasePattern<Semaphore>::set_resumer(
+		Resumer resumer)
+	{
+		m_resumer = resumer;
+	}
+
+	template<class Semaphore>
+	std::size_t PODQueueBasePattern<Semaphore>::take_free(
+		std::size_t max)
+	{
+		return m_free.try_wait(max);
+	}
+
+	template<class Semaphore>
+	std::size_t PODQueueBasePattern<Semaphore>::take_elements(
+		std::size_t max)
+	{
+		return m_elements.try_wait(max);
+	}
+
 	template<class Semaphore>
 	void PODQueueBasePattern<Semaphore>::push()
 	{
-		m_elements.notify();
+		m_elements.notify(m_resumer);
+	}
+
+	template<class Semaphore>
+	void PODQueueBasePattern<Semaphore>::push(
+		std::size_t count)
+	{
+		m_elements.notify_n(count, m_resumer);
 	}
 
 	template<class Semaphore>
 	void PODQueueBasePattern<Semaphore>::pop()
 	{
-		m_free.notify();
+		m_free.notify(m_resumer);
+	}
+
+	template<class Semaphore>
+	void PODQueueBasePattern<Semaphore>::pop(
+		std::size_t count)
+	{
+		m_free.notify_n(count, m_resumer);
 	}
 
 	template<class T, std::size_t kSize, class Semaphore>
 	void PODFixedQueuePattern<T, kSize, Semaphore>::initialise()
 	{
 		PODQueueBasePattern<Semaphore>::initialise(kSize);
+		m_finished.fill(false);
 		m_start = m_end = 0;
+		m_published = m_released = 0;
+	}
+
+	template<class T, std::size_t kSize, class Semaphore>
+	std::size_t PODFixedQueuePattern<T, kSize, Semaphore>::finish(
+		std::size_t &index,
+		std::size_t slot,
+		std::size_t count)
+	{
+		if(slot != index)
+		{
+			// Slots before these are still claimed, so wait for them.
+			for(std::size_t i = 0; i < count; i++)
+				m_finished[(slot + i) % kSize] = true;
+			return 0;
+		}
+
+		if((index += count) >= kSize)
+			index -= kSize;
+		// The slot at the index itself is never finished, so this stops before going around.
+		for(; m_finished[index]; count++)
+		{
+			m_finished[index] = false;
+			if(++index == kSize)
+				index = 0;
+		}
+		return count;
+	}
+
+	template<class T, std::size_t kSize, class Semaphore>
+	void PODFixedQueuePattern<T, kSize, Semaphore>::published(
+		std::size_t slot,
+		std::size_t count)
+	{
+		if(std::size_t const moved = finish(m_published, slot, count))
+			this->push(moved);
+	}
+
+	template<class T, std::size_t kSize, class Semaphore>
+	void PODFixedQueuePattern<T, kSize, Semaphore>::released(
+		std::size_t slot,
+		std::size_t count)
+	{
+		if(std::size_t const moved = finish(m_released, slot, count))
+			this->pop(moved);
+	}
+
+	template<class T, std::size_t kSize, class Semaphore>
+	void PODFixedQueuePattern<T, kSize, Semaphore>::write(
+		T const * values,
+		std::size_t count)
+	{
+		// Copy in at most two contiguous ranges, split where the ring wraps.
+		std::size_t const first = std::min(count, kSize - m_end);
+		std::copy(values, values + first, m_values.begin() + m_end);
+		std::copy(values + first, values + count, m_values.begin());
+		if((m_end += count) >= kSize)
+			m_end -= kSize;
+	}
+
+	template<class T, std::size_t kSize, class Semaphore>
+	void PODFixedQueuePattern<T, kSize, Semaphore>::read(
+		T * target,
+		std::size_t count)
+	{
+		std::size_t const first = std::min(count, kSize - m_start);
+		std::move(m_values.begin() + m_start, m_values.begin() + m_start + first, target);
+		std::move(m_values.begin(), m_values.begin() + (count - first), target + first);
+		if((m_start += count) >= kSize)
+			m_start -= kSize;
 	}
 
 	template<class T, std::size_t kSize, class Semaphore>
@@ -50,7 +183,7 @@ namespace cr::sync
 			std::forward<V>(value));
 		if(queue->m_values.size() == queue->m_end)
 			queue->m_end = 0;
-		queue->push();
+		queue->published((queue->m_end + kSize - 1) % kSize, 1);
 	CR_FINALLY
 	CR_IMPL_END
 
@@ -60,10 +193,95 @@ namespace cr::sync
 		util::assign(*target, std::move(queue->m_values[queue->m_start++]));
 		if(queue->m_values.size() == queue->m_start)
 			queue->m_start = 0;
-		queue->pop();
+		queue->released((queue->m_start + kSize - 1) % kSize, 1);
+	CR_FINALLY
+	CR_IMPL_END
+
+	template<class T, std::size_t kSize, class Semaphore>
+	CR_IMPL(PODFixedQueuePattern<T, kSize, Semaphore>::TimedPop)
+		CR_AWAIT(queue->elements_for(deadline));
+		util::assign(*target, std::move(queue->m_values[queue->m_start++]));
+		if(queue->m_values.size() == queue->m_start)
+			queue->m_start = 0;
+		queue->released((queue->m_start + kSize - 1) % kSize, 1);
+	CR_FINALLY
+	CR_IMPL_END
+
+	template<class T, std::size_t kSize, class Semaphore>
+	CR_IMPL(PODFixedQueuePattern<T, kSize, Semaphore>::PushBulk)
+		for(pushed = 0; pushed < count; pushed += batch)
+		{
+			CR_AWAIT(queue->free());
+			batch = 1 + queue->take_free(count - pushed - 1);
+			queue->write(values + pushed, batch);
+			queue->published((queue->m_end + kSize - batch) % kSize, batch);
+		}
+	CR_FINALLY
+	CR_IMPL_END
+
+	template<class T, std::size_t kSize, class Semaphore>
+	CR_IMPL(PODFixedQueuePattern<T, kSize, Semaphore>::PopBulk)
+		assert(min <= max);
+
+		*count = 0;
+		do {
+			batch = 0;
+			if(*count < min)
+			{
+				CR_AWAIT(queue->elements());
+				batch = 1;
+			}
+			batch += queue->take_elements(max - *count - batch);
+			queue->read(target + *count, batch);
+			*count += batch;
+			queue->released((queue->m_start + kSize - batch) % kSize, batch);
+		} while(*count < min);
+	CR_FINALLY
+	CR_IMPL_END
+
+	template<class T, std::size_t kSize, class Semaphore>
+	CR_IMPL(PODFixedQueuePattern<T, kSize, Semaphore>::Claim)
+		CR_AWAIT(queue->free());
+		*slot = &queue->m_values[queue->m_end++];
+		if(queue->m_values.size() == queue->m_end)
+			queue->m_end = 0;
+	CR_FINALLY
+	CR_IMPL_END
+
+	template<class T, std::size_t kSize, class Semaphore>
+	void PODFixedQueuePattern<T, kSize, Semaphore>::publish(
+		T * slot)
+	{
+		assert(slot >= m_values.data() && slot < m_values.data() + kSize);
+		published(slot - m_values.data(), 1);
+	}
+
+	template<class T, std::size_t kSize, class Semaphore>
+	CR_IMPL(PODFixedQueuePattern<T, kSize, Semaphore>::Peek)
+		CR_AWAIT(queue->elements());
+		*element = &queue->m_values[queue->m_start++];
+		if(queue->m_values.size() == queue->m_start)
+			queue->m_start = 0;
 	CR_FINALLY
 	CR_IMPL_END
 
+	template<class T, std::size_t kSize, class Semaphore>
+	CR_IMPL(PODFixedQueuePattern<T, kSize, Semaphore>::TimedPeek)
+		CR_AWAIT(queue->elements_for(deadline));
+		*element = &queue->m_values[queue->m_start++];
+		if(queue->m_values.size() == queue->m_start)
+			queue->m_start = 0;
+	CR_FINALLY
+	CR_IMPL_END
+
+	template<class T, std::size_t kSize, class Semaphore>
+	void PODFixedQueuePattern<T, kSize, Semaphore>::release(
+		T const * element)
+	{
+		assert(element >= m_values.data() && element < m_values.data() + kSize);
+		released(element - m_values.data(), 1);
+	}
+
 	template<std::size_t kSize, class Semaphore>
 	void PODFixedQueuePattern<void, kSize, Semaphore>::initialise()
 	{
@@ -84,6 +302,13 @@ namespace cr::sync
 	CR_FINALLY
 	CR_IMPL_END
 
+	template<std::size_t kSize, class Semaphore>
+	CR_IMPL(PODFixedQueuePattern<void, kSize, Semaphore>::TimedPop)
+		CR_AWAIT(queue->elements_for(deadline));
+		queue->pop();
+	CR_FINALLY
+	CR_IMPL_END
+
 	template<class T, std::size_t kSize, class Semaphore>
 	FixedQueuePattern<T, kSize, Semaphore>::FixedQueuePattern()
 	{
@@ -0,0 +1,98 @@
+/** @file SPSCQueue.hpp
+	Contains the thread-unsafe single-producer single-consumer queue types. */
+#ifndef __libcr_sync_spscqueue_hpp_defined
+#define __libcr_sync_spscqueue_hpp_defined
+
+#include "detail/WaiterSlot.hpp"
+#include "../primitives.hpp"
+#include "../util/RefConv.hpp"
+#include <array>
+
+namespace cr::sync
+{
+	template<class T, std::size_t kSize>
+	/** POD fixed capacity queue type for exactly one pushing and one popping coroutine.
+		Instead of two semaphores, each side has a single waiting slot, so that pushing and popping is an index update and a null check unless the other side waits.
+	@tparam T:
+		The queue's data type.
+	@tparam kSize:
+		The queue's capacity. */
+	class PODSPSCQueue
+	{
+		static_assert(kSize > 0, "A queue needs to hold at least one element.");
+
+		/** The queue's values. */
+		std::array<T, kSize> m_values;
+		/** The number of popped values. */
+		std::size_t m_head;
+		/** The number of pushed values. */
+		std::size_t m_tail;
+		/** The popping coroutine, while it waits for an element. */
+		detail::PODWaiterSlot m_reader;
+		/** The pushing coroutine, while it waits for a free slot. */
+		detail::PODWaiterSlot m_writer;
+		/** How to resume waiting coroutines. */
+		Resumer m_resumer;
+	public:
+		/** Initialises the queue. */
+		void initialise();
+
+		/** Sets how coroutines waiting for the queue are resumed.
+			By default, they are resumed directly by the pushing or popping coroutine. Use a scheduler's `deferred()` resumer to enqueue them instead, so that the notifying coroutine continues right away.
+		@param[in] resumer:
+			How to resume waiting coroutines. */
+		inline void set_resumer(
+			Resumer resumer);
+
+		template<class V>
+		/** Pushes a value to the queue.
+			Must only be used by one coroutine at a time.
+		@tparam V:
+			The pushed value's type. */
+		TEMPLATE_COROUTINE(PushPattern, (V), void)
+		CR_STATE(
+			(PODSPSCQueue<T, kSize> &) queue,
+			(V) value);
+		CR_EXTERNAL
+
+		union Push {
+			PushPattern<T const&> copy;
+			PushPattern<T &&> move;
+		};
+
+		/** Pops a value from the queue.
+			Must only be used by one coroutine at a time. */
+		COROUTINE(Pop, void)
+		CR_STATE(
+			(PODSPSCQueue<T, kSize> &) queue,
+			(T &) target);
+		CR_EXTERNAL
+
+		/** Pops a value from the queue, unless the deadline expires first.
+			On expiry, the coroutine fails without popping a value. Must only be used by one coroutine at a time. */
+		COROUTINE(TimedPop, void)
+		CR_STATE(
+			(PODSPSCQueue<T, kSize> &) queue,
+			(T &) target,
+			(Deadline) deadline);
+		CR_EXTERNAL
+	};
+
+	template<class T, std::size_t kSize>
+	/** Non-POD fixed capacity queue type for exactly one pushing and one popping coroutine.
+	@tparam T:
+		The queue's data type.
+	@tparam kSize:
+		The queue's capacity. */
+	class SPSCQueue : public PODSPSCQueue<T, kSize>
+	{
+		using PODSPSCQueue<T, kSize>::initialise;
+	public:
+		/** Initialises the queue. */
+		inline SPSCQueue();
+	};
+}
+
+#include "SPSCQueue.inl"
+
+#endif
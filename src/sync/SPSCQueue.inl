@@ -0,0 +1,55 @@
+namespace cr::sync
+{
+	template<class T, std::size_t kSize>
+	void PODSPSCQueue<T, kSize>::initialise()
+	{
+		m_head = m_tail = 0;
+		m_reader.initialise();
+		m_writer.initialise();
+		m_resumer = Resumer();
+	}
+
+	template<class T, std::size_t kSize>
+	void PODSPSCQueue<T, kSize>::set_resumer(
+		Resumer resumer)
+	{
+		m_resumer = resumer;
+	}
+
+	template<class T, std::size_t kSize>
+	template<class V>
+	CR_IMPL(PODSPSCQueue<T, kSize>::PushPattern<V>)
+		// Only the popping coroutine frees slots, and it notifies after doing so.
+		if(queue->m_tail - queue->m_head == kSize)
+			CR_AWAIT(queue->m_writer.wait());
+		util::assign(
+			queue->m_values[queue->m_tail++ % kSize],
+			std::forward<V>(value));
+		queue->m_reader.notify(queue->m_resumer);
+	CR_FINALLY
+	CR_IMPL_END
+
+	template<class T, std::size_t kSize>
+	CR_IMPL(PODSPSCQueue<T, kSize>::Pop)
+		if(queue->m_tail == queue->m_head)
+			CR_AWAIT(queue->m_reader.wait());
+		util::assign(*target, std::move(queue->m_values[queue->m_head++ % kSize]));
+		queue->m_writer.notify(queue->m_resumer);
+	CR_FINALLY
+	CR_IMPL_END
+
+	template<class T, std::size_t kSize>
+	CR_IMPL(PODSPSCQueue<T, kSize>::TimedPop)
+		if(queue->m_tail == queue->m_head)
+			CR_AWAIT(queue->m_reader.wait_for(deadline));
+		util::assign(*target, std::move(queue->m_values[queue->m_head++ % kSize]));
+		queue->m_writer.notify(queue->m_resumer);
+	CR_FINALLY
+	CR_IMPL_END
+
+	template<class T, std::size_t kSize>
+	SPSCQueue<T, kSize>::SPSCQueue()
+	{
+		initialise();
+	}
+}
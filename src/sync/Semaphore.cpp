@@ -31,15 +31,107 @@ namespace cr::sync
 	}
 
 	template<class ConditionVariable>
-	bool PODSemaphorePattern<ConditionVariable>::notify()
+	mayblock PODSemaphorePattern<ConditionVariable>::TimedWaitCall::libcr_wait(
+		Coroutine * coroutine)
+	{
+		if(m_semaphore.m_counter == 0)
+			return m_semaphore.m_cv.wait_for(m_deadline).libcr_wait(coroutine);
+		else
+		{
+			--m_semaphore.m_counter;
+			return nonblock();
+		}
+	}
+
+	template<class ConditionVariable>
+	std::size_t PODSemaphorePattern<ConditionVariable>::try_wait(
+		std::size_t max)
+	{
+		std::size_t const taken = m_counter < max ? m_counter : max;
+		m_counter -= taken;
+		return taken;
+	}
+
+	template<class ConditionVariable>
+	bool PODSemaphorePattern<ConditionVariable>::notify(
+		Resumer resumer)
 	{
-		bool notified = m_cv.notify_one();
+		bool notified = m_cv.notify_one(resumer);
 		if(!notified)
 			++m_counter;
 
 		return notified;
 	}
 
+	template<class ConditionVariable>
+	std::size_t PODSemaphorePattern<ConditionVariable>::notify_n(
+		std::size_t count,
+		Resumer resumer)
+	{
+		m_counter += count;
+
+		std::size_t notified = 0;
+		// Take the notified coroutine's share before resuming it, as it may access the counter right away.
+		while(m_counter)
+		{
+			Coroutine * waiting = m_cv.remove_one();
+			if(!waiting)
+				break;
+			--m_counter;
+			++notified;
+			resumer(waiting);
+		}
+
+		return notified;
+	}
+
+	template<class ConditionVariable>
+	void PODSemaphorePattern<ConditionVariable>::select_add(
+		void * semaphore,
+		Coroutine * node)
+	{
+		PODSemaphorePattern<ConditionVariable> &self = *static_cast<PODSemaphorePattern<ConditionVariable> *>(semaphore);
+		if(self.m_counter == 0)
+			(void) self.m_cv.wait().libcr_wait(node);
+		else
+		{
+			--self.m_counter;
+			node->resume();
+		}
+	}
+
+	template<class ConditionVariable>
+	bool PODSemaphorePattern<ConditionVariable>::select_remove(
+		void * semaphore,
+		Coroutine * node)
+	{
+		return static_cast<PODSemaphorePattern<ConditionVariable> *>(semaphore)->m_cv.remove(node);
+	}
+
+	template<class ConditionVariable>
+	void PODSemaphorePattern<ConditionVariable>::select_release(
+		void * semaphore)
+	{
+		(void) static_cast<PODSemaphorePattern<ConditionVariable> *>(semaphore)->notify();
+	}
+
+	template<class ConditionVariable>
+	void PODSemaphorePattern<ConditionVariable>::select_give_back(
+		void * semaphore)
+	{
+		++static_cast<PODSemaphorePattern<ConditionVariable> *>(semaphore)->m_counter;
+	}
+
+	template<class ConditionVariable>
+	void PODSemaphorePattern<ConditionVariable>::select_pass_on(
+		void * semaphore)
+	{
+		PODSemaphorePattern<ConditionVariable> &self = *static_cast<PODSemaphorePattern<ConditionVariable> *>(semaphore);
+		// The unit was given back when the node was notified, so hand it to a waiting coroutine, if it is still there.
+		if(self.try_wait(1))
+			(void) self.notify();
+	}
+
 	template<class ConditionVariable>
 	SemaphorePattern<ConditionVariable>::SemaphorePattern(
 		std::size_t counter)
@@ -4,6 +4,7 @@
 #define __libcr_sync_semaphore_hpp_defined
 
 #include "ConditionVariable.hpp"
+#include "../Selectable.hpp"
 
 namespace cr::sync
 {
@@ -15,6 +16,40 @@ namespace cr::sync
 		ConditionVariable m_cv;
 		/** The semaphore's counter. */
 		std::size_t m_counter;
+
+		/** Adds a select node to the semaphore, or notifies it after decrementing the counter if it is not 0.
+		@param[in] semaphore:
+			The semaphore.
+		@param[in] node:
+			The node to add. */
+		static void select_add(
+			void * semaphore,
+			Coroutine * node);
+		/** Removes a select node from the semaphore.
+		@param[in] semaphore:
+			The semaphore.
+		@param[in] node:
+			The node to remove.
+		@return
+			Whether the node was still waiting. */
+		static bool select_remove(
+			void * semaphore,
+			Coroutine * node);
+		/** Passes on a unit that a select node kept but does not use.
+		@param[in] semaphore:
+			The semaphore. */
+		static void select_release(
+			void * semaphore);
+		/** Gives the unit taken for a notified select node back to the counter, without notifying anyone.
+		@param[in] semaphore:
+			The semaphore. */
+		static void select_give_back(
+			void * semaphore);
+		/** Passes a kept notification that the counter is not 0 on to a waiting coroutine.
+		@param[in] semaphore:
+			The semaphore. */
+		static void select_pass_on(
+			void * semaphore);
 	public:
 		/** Initialises the semaphore.
 		@param[in] counter:
@@ -47,10 +82,73 @@ namespace cr::sync
 			Blocks if the semaphore counter is 0. */
 		[[nodiscard]] constexpr WaitCall wait();
 
+		/** Helper class for waiting for a semaphore with a timeout using `#CR_AWAIT`. */
+		class TimedWaitCall
+		{
+			/** The semaphore to wait for. */
+			PODSemaphorePattern<ConditionVariable> &m_semaphore;
+			/** The deadline of the wait. */
+			Deadline m_deadline;
+		public:
+			/** Initialises the timed wait call.
+			@param[in] semaphore:
+				The semaphore to wait for.
+			@param[in] deadline:
+				The deadline of the wait. */
+			constexpr TimedWaitCall(
+				PODSemaphorePattern<ConditionVariable> &semaphore,
+				Deadline const& deadline);
+
+			/** Waits for the semaphore until the deadline expires.
+			@param[in] coroutine:
+				The coroutine to wait.
+			@return
+				Whether the operation blocks. */
+			[[nodiscard]] mayblock libcr_wait(
+				Coroutine * coroutine);
+		};
+
+		/** Waits for the semaphore until the deadline expires.
+			Blocks if the semaphore counter is 0. Fails if the deadline expires before the semaphore is notified.
+		@param[in] deadline:
+			The deadline of the wait, as created by the scheduler. */
+		[[nodiscard]] constexpr TimedWaitCall wait_for(
+			Deadline const& deadline);
+
+		/** Decrements the semaphore counter by up to `max` without blocking.
+		@param[in] max:
+			The maximum amount to take.
+		@return
+			The amount taken. */
+		std::size_t try_wait(
+			std::size_t max);
+
 		/** Notifies the semaphore.
+		@param[in] resumer:
+			How to resume a notified coroutine.
 		@return
 			Whether any coroutine was directly notified. */
-		bool notify();
+		bool notify(
+			Resumer resumer = Resumer());
+
+		/** Notifies the semaphore `count` times at once.
+			Waiting coroutines are notified one by one while the notifications last, and the rest is added to the counter.
+		@param[in] count:
+			How often to notify the semaphore.
+		@param[in] resumer:
+			How to resume the notified coroutines.
+		@return
+			The number of directly notified coroutines. */
+		std::size_t notify_n(
+			std::size_t count,
+			Resumer resumer = Resumer());
+
+		/** Describes how `Select` waits for the semaphore.
+			A selected wait finishes like `wait()`, so that the counter stays decremented. */
+		[[nodiscard]] inline Selectable select_wait();
+		/** Describes how `Select` waits until the semaphore counter is not 0.
+			Unlike `select_wait()`, the counter is left as it is, so that the selecting coroutine still has to wait for the semaphore afterwards. */
+		[[nodiscard]] inline Selectable select_available();
 	};
 
 	template<class ConditionVariable>
@@ -59,7 +157,12 @@ namespace cr::sync
 	{
 	public:
 		using PODSemaphorePattern<ConditionVariable>::wait;
+		using PODSemaphorePattern<ConditionVariable>::wait_for;
+		using PODSemaphorePattern<ConditionVariable>::try_wait;
 		using PODSemaphorePattern<ConditionVariable>::notify;
+		using PODSemaphorePattern<ConditionVariable>::notify_n;
+		using PODSemaphorePattern<ConditionVariable>::select_wait;
+		using PODSemaphorePattern<ConditionVariable>::select_available;
 
 		/** Creates a semaphore.
 		@param[in] counter:
@@ -12,6 +12,34 @@ namespace cr::sync
 	{
 		return WaitCall(*this);
 	}
+
+	template<class ConditionVariable>
+	constexpr PODSemaphorePattern<ConditionVariable>::TimedWaitCall::TimedWaitCall(
+		PODSemaphorePattern<ConditionVariable> &semaphore,
+		Deadline const& deadline):
+		m_semaphore(semaphore),
+		m_deadline(deadline)
+	{
+	}
+
+	template<class ConditionVariable>
+	constexpr typename PODSemaphorePattern<ConditionVariable>::TimedWaitCall PODSemaphorePattern<ConditionVariable>::wait_for(
+		Deadline const& deadline)
+	{
+		return TimedWaitCall(*this, deadline);
+	}
+
+	template<class ConditionVariable>
+	Selectable PODSemaphorePattern<ConditionVariable>::select_wait()
+	{
+		return Selectable(this, &select_add, &select_remove, nullptr, &select_release);
+	}
+
+	template<class ConditionVariable>
+	Selectable PODSemaphorePattern<ConditionVariable>::select_available()
+	{
+		return Selectable(this, &select_add, &select_remove, &select_give_back, &select_pass_on);
+	}
 }
 
 #ifdef LIBCR_INLINE
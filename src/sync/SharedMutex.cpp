@@ -0,0 +1,139 @@
+#ifndef __libcr_sync_sharedmutex_cpp_defined
+#define __libcr_sync_sharedmutex_cpp_defined
+
+#ifndef LIBCR_SYNC_SHAREDMUTEX_INLINE
+#include "SharedMutex.hpp"
+#else
+#undef LIBCR_SYNC_SHAREDMUTEX_INLINE
+#endif
+
+#include <cassert>
+
+namespace cr::sync
+{
+	template<class ConditionVariable>
+	void PODSharedMutexPattern<ConditionVariable>::initialise(
+		bool prefer_writers)
+	{
+		m_readers[0].initialise();
+		m_readers[1].initialise();
+		m_writers.initialise();
+		m_draining = nullptr;
+		m_active = 0;
+		m_waiting = 0;
+		m_phase = 0;
+		m_writer = false;
+		m_prefer_writers = prefer_writers;
+	}
+
+	template<class ConditionVariable>
+	void PODSharedMutexPattern<ConditionVariable>::drain(
+		Resumer resumer)
+	{
+		if(m_active || !m_draining)
+			return;
+
+		Coroutine * const writer = m_draining;
+		m_draining = nullptr;
+		resumer(writer);
+	}
+
+	template<class ConditionVariable>
+	mayblock PODSharedMutexPattern<ConditionVariable>::LockCall::libcr_wait(
+		Coroutine * coroutine)
+	{
+		if(m_mutex.m_writer)
+			return m_mutex.m_writers.wait().libcr_wait(coroutine);
+
+		// Keep new readers out, and wait for the current ones to unlock the mutex.
+		m_mutex.m_writer = true;
+		if(!m_mutex.m_active)
+			return nonblock();
+
+		m_mutex.m_draining = coroutine;
+		return block();
+	}
+
+	template<class ConditionVariable>
+	bool PODSharedMutexPattern<ConditionVariable>::try_lock()
+	{
+		if(m_writer || m_active)
+			return false;
+
+		m_writer = true;
+		return true;
+	}
+
+	template<class ConditionVariable>
+	void PODSharedMutexPattern<ConditionVariable>::unlock(
+		Resumer resumer)
+	{
+		assert(m_writer && !m_active && !m_draining);
+
+		bool const admit = m_waiting && !(m_prefer_writers && !m_writers.empty());
+		unsigned const phase = m_phase;
+		if(admit)
+		{
+			// Count the admitted readers before resuming any of them.
+			m_active = m_waiting;
+			m_waiting = 0;
+			m_phase ^= 1;
+		}
+
+		// The next writer keeps new readers out while the admitted ones are still running.
+		m_draining = m_writers.remove_one();
+		m_writer = m_draining != nullptr;
+
+		if(admit)
+			m_readers[phase].notify_all(resumer);
+		drain(resumer);
+	}
+
+	template<class ConditionVariable>
+	mayblock PODSharedMutexPattern<ConditionVariable>::SharedLockCall::libcr_wait(
+		Coroutine * coroutine)
+	{
+		if(!m_mutex.m_writer)
+		{
+			++m_mutex.m_active;
+			return nonblock();
+		}
+
+		++m_mutex.m_waiting;
+		return m_mutex.m_readers[m_mutex.m_phase].wait().libcr_wait(coroutine);
+	}
+
+	template<class ConditionVariable>
+	bool PODSharedMutexPattern<ConditionVariable>::try_lock_shared()
+	{
+		if(m_writer)
+			return false;
+
+		++m_active;
+		return true;
+	}
+
+	template<class ConditionVariable>
+	void PODSharedMutexPattern<ConditionVariable>::unlock_shared(
+		Resumer resumer)
+	{
+		assert(m_active != 0);
+
+		--m_active;
+		drain(resumer);
+	}
+
+	template<class ConditionVariable>
+	SharedMutexPattern<ConditionVariable>::SharedMutexPattern(
+		bool prefer_writers)
+	{
+		PODSharedMutexPattern<ConditionVariable>::initialise(prefer_writers);
+	}
+
+	template class PODSharedMutexPattern<PODConditionVariable>;
+	template class PODSharedMutexPattern<PODFIFOConditionVariable>;
+	template class SharedMutexPattern<PODConditionVariable>;
+	template class SharedMutexPattern<PODFIFOConditionVariable>;
+}
+
+#endif
@@ -0,0 +1,154 @@
+/** @file SharedMutex.hpp
+	Contains the shared mutex class. */
+#ifndef __libcr_sync_sharedmutex_hpp_defined
+#define __libcr_sync_sharedmutex_hpp_defined
+
+#include "ConditionVariable.hpp"
+#include "Block.hpp"
+
+#include <cstddef>
+
+namespace cr::sync
+{
+	template<class ConditionVariable>
+	/** POD shared mutex type.
+		The mutex is either locked exclusively by a single writer, or shared by any number of readers. Readers that arrive while a writer holds or waits for the mutex wait until it is unlocked, and are then admitted all at once. By default, unlocking an exclusive lock admits the waiting readers before the next writer, so that neither side starves.
+	@tparam ConditionVariable:
+		Which condition variable flavour to use. */
+	class PODSharedMutexPattern
+	{
+		/** The waiting readers.
+			Readers wait in the condition variable of the current phase, so that readers arriving while others are being admitted are not admitted with them. */
+		ConditionVariable m_readers[2];
+		/** The waiting writers. */
+		ConditionVariable m_writers;
+		/** The writer waiting for the readers to unlock the mutex, or null. */
+		Coroutine * m_draining;
+		/** How many readers share the mutex. */
+		std::size_t m_active;
+		/** How many readers wait in the current phase's condition variable. */
+		std::size_t m_waiting;
+		/** The current phase's index into `m_readers`. */
+		unsigned m_phase;
+		/** Whether a writer holds or waits for the mutex. */
+		bool m_writer;
+		/** Whether unlocking an exclusive lock prefers waiting writers over waiting readers. */
+		bool m_prefer_writers;
+
+		/** Gives the mutex to the writer waiting for the readers, if they are done.
+		@param[in] resumer:
+			How to resume the writer. */
+		void drain(
+			Resumer resumer);
+	public:
+		/** Initialises the mutex to an unlocked state.
+		@param[in] prefer_writers:
+			Whether unlocking an exclusive lock hands the mutex to the next waiting writer before admitting waiting readers. Increases writer throughput, but readers can starve while writers keep waiting. */
+		void initialise(
+			bool prefer_writers = false);
+
+		/** Helper type that simplifies usage of `lock()` with `#CR_AWAIT`. */
+		class LockCall
+		{
+			/** The mutex to lock. */
+			PODSharedMutexPattern<ConditionVariable> &m_mutex;
+		public:
+			/** Creates a lock call.
+			@param[in] mutex:
+				The mutex to lock. */
+			constexpr LockCall(
+				PODSharedMutexPattern<ConditionVariable> &mutex);
+
+			/** Locks the mutex exclusively, or waits until it is handed to the coroutine.
+			@param[in] coroutine:
+				The coroutine locking the mutex.
+			@return
+				Whether the call blocks. */
+			[[nodiscard]] mayblock libcr_wait(
+				Coroutine * coroutine);
+		};
+
+		/** Locks the mutex exclusively.
+			To be used with `#CR_AWAIT`. */
+		[[nodiscard]] constexpr LockCall lock();
+
+		/** Tries to lock the mutex exclusively.
+			Never blocks the coroutine.
+		@return
+			Whether the lock was acquired. */
+		bool try_lock();
+
+		/** Unlocks an exclusive lock.
+			Admits all waiting readers and hands the mutex to the next waiting writer, as configured in `initialise()`.
+		@param[in] resumer:
+			How to resume the admitted coroutines. */
+		void unlock(
+			Resumer resumer = Resumer());
+
+		/** Helper type that simplifies usage of `lock_shared()` with `#CR_AWAIT`. */
+		class SharedLockCall
+		{
+			/** The mutex to lock. */
+			PODSharedMutexPattern<ConditionVariable> &m_mutex;
+		public:
+			/** Creates a shared lock call.
+			@param[in] mutex:
+				The mutex to lock. */
+			constexpr SharedLockCall(
+				PODSharedMutexPattern<ConditionVariable> &mutex);
+
+			/** Locks the mutex shared, or waits until the coroutine is admitted.
+			@param[in] coroutine:
+				The coroutine locking the mutex.
+			@return
+				Whether the call blocks. */
+			[[nodiscard]] mayblock libcr_wait(
+				Coroutine * coroutine);
+		};
+
+		/** Locks the mutex shared.
+			Blocks while a writer holds or waits for the mutex. To be used with `#CR_AWAIT`. */
+		[[nodiscard]] constexpr SharedLockCall lock_shared();
+
+		/** Tries to lock the mutex shared.
+			Never blocks the coroutine.
+		@return
+			Whether the lock was acquired. */
+		bool try_lock_shared();
+
+		/** Unlocks a shared lock.
+			The last reader hands the mutex to the waiting writer, if any.
+		@param[in] resumer:
+			How to resume the waiting writer. */
+		void unlock_shared(
+			Resumer resumer = Resumer());
+	};
+
+	template<class ConditionVariable>
+	/** Shared mutex type. */
+	class SharedMutexPattern : PODSharedMutexPattern<ConditionVariable>
+	{
+	public:
+		/** Creates an unlocked shared mutex.
+		@param[in] prefer_writers:
+			Whether to prefer waiting writers over waiting readers, see `PODSharedMutexPattern::initialise()`. */
+		explicit SharedMutexPattern(
+			bool prefer_writers = false);
+
+		using PODSharedMutexPattern<ConditionVariable>::lock;
+		using PODSharedMutexPattern<ConditionVariable>::try_lock;
+		using PODSharedMutexPattern<ConditionVariable>::unlock;
+		using PODSharedMutexPattern<ConditionVariable>::lock_shared;
+		using PODSharedMutexPattern<ConditionVariable>::try_lock_shared;
+		using PODSharedMutexPattern<ConditionVariable>::unlock_shared;
+	};
+
+	typedef PODSharedMutexPattern<PODConditionVariable> PODSharedMutex;
+	typedef PODSharedMutexPattern<PODFIFOConditionVariable> PODFIFOSharedMutex;
+	typedef SharedMutexPattern<PODConditionVariable> SharedMutex;
+	typedef SharedMutexPattern<PODFIFOConditionVariable> FIFOSharedMutex;
+}
+
+#include "SharedMutex.inl"
+
+#endif
@@ -0,0 +1,33 @@
+namespace cr::sync
+{
+	template<class ConditionVariable>
+	constexpr PODSharedMutexPattern<ConditionVariable>::LockCall::LockCall(
+		PODSharedMutexPattern<ConditionVariable> &mutex):
+		m_mutex(mutex)
+	{
+	}
+
+	template<class ConditionVariable>
+	constexpr typename PODSharedMutexPattern<ConditionVariable>::LockCall PODSharedMutexPattern<ConditionVariable>::lock()
+	{
+		return LockCall(*this);
+	}
+
+	template<class ConditionVariable>
+	constexpr PODSharedMutexPattern<ConditionVariable>::SharedLockCall::SharedLockCall(
+		PODSharedMutexPattern<ConditionVariable> &mutex):
+		m_mutex(mutex)
+	{
+	}
+
+	template<class ConditionVariable>
+	constexpr typename PODSharedMutexPattern<ConditionVariable>::SharedLockCall PODSharedMutexPattern<ConditionVariable>::lock_shared()
+	{
+		return SharedLockCall(*this);
+	}
+}
+
+#ifdef LIBCR_INLINE
+#define LIBCR_SYNC_SHAREDMUTEX_INLINE
+#include "SharedMutex.cpp"
+#endif
@@ -0,0 +1,154 @@
+/** @file UnboundedQueue.hpp
+	Contains the thread-unsafe unbounded queue types. */
+#ifndef __libcr_sync_unboundedqueue_hpp_defined
+#define __libcr_sync_unboundedqueue_hpp_defined
+
+#include "Semaphore.hpp"
+#include "../detail/SegmentPool.hpp"
+#include "../primitives.hpp"
+#include "../util/RefConv.hpp"
+#include <cstddef>
+
+namespace cr::sync
+{
+	template<class T, std::size_t kSegmentSize, class Semaphore>
+	/** POD unbounded queue type.
+		The values are kept in a list of fixed-size segments, which are taken from and returned to a per-thread pool, so that a queue in a steady state does not allocate. Pushing never waits.
+		The queue has to be destroyed explicitly.
+	@tparam T:
+		The queue's data type.
+	@tparam kSegmentSize:
+		The number of values per segment.
+	@tparam Semaphore:
+		The semaphore type to use internally. */
+	class PODUnboundedQueuePattern
+	{
+		/** The queue's segments. */
+		typedef cr::detail::Segment<T, kSegmentSize> Segment;
+		/** The pool the segments come from. */
+		typedef cr::detail::SegmentPool<T, kSegmentSize> SegmentPool;
+
+		/** The segment holding the first element. */
+		Segment * m_head;
+		/** The segment the next element is written to. */
+		Segment * m_tail;
+		/** The first element's index within the head segment. */
+		std::size_t m_start;
+		/** The next element's index within the tail segment. */
+		std::size_t m_end;
+		/** The elements in the queue. */
+		Semaphore m_elements;
+		/** How to resume waiting coroutines. */
+		Resumer m_resumer;
+
+		/** Removes the first element.
+			The element must have been taken before.
+		@param[out] target:
+			The location to move the element to. */
+		inline void take(
+			T &target);
+
+		template<class V>
+		/** Appends a value and notifies a waiting coroutine.
+		@param[in] value:
+			The value to append. */
+		inline void put(
+			V &&value);
+	public:
+		/** Initialises the queue. */
+		void initialise();
+		/** Returns the queue's segments to the calling thread's pool.
+			No coroutine may be waiting anymore, and the queue must not be used afterwards. */
+		void destroy();
+
+		/** Sets how coroutines waiting for the queue are resumed.
+			By default, they are resumed directly within `push()` and `pop()`. Use a scheduler's `deferred()` resumer to enqueue them instead, so that the notifying coroutine continues right away.
+		@param[in] resumer:
+			How to resume waiting coroutines. */
+		inline void set_resumer(
+			Resumer resumer);
+
+		/** Copies a value to the end of the queue.
+		@param[in] value:
+			The value to push. */
+		inline void push(
+			T const& value);
+		/** Moves a value to the end of the queue.
+		@param[in] value:
+			The value to push. */
+		inline void push(
+			T &&value);
+
+		/** Pops a value from the queue. */
+		COROUTINE(Pop, void)
+		CR_STATE(
+			(PODUnboundedQueuePattern<T, kSegmentSize, Semaphore> &) queue,
+			(T &) target);
+		CR_EXTERNAL
+
+		/** Pops a value from the queue, unless the deadline expires first.
+			On expiry, the coroutine fails without popping a value. */
+		COROUTINE(TimedPop, void)
+		CR_STATE(
+			(PODUnboundedQueuePattern<T, kSegmentSize, Semaphore> &) queue,
+			(T &) target,
+			(Deadline) deadline);
+		CR_EXTERNAL
+	};
+
+	template<class T, std::size_t kSegmentSize, class Semaphore>
+	/** Non-POD unbounded queue type.
+		In contrast to the POD version, this version destroys the queue in the destructor.
+	@tparam T:
+		The queue's element type.
+	@tparam kSegmentSize:
+		The number of values per segment.
+	@tparam Semaphore:
+		The semaphore type to use. */
+	class UnboundedQueuePattern : public PODUnboundedQueuePattern<T, kSegmentSize, Semaphore>
+	{
+		using PODUnboundedQueuePattern<T, kSegmentSize, Semaphore>::initialise;
+		using PODUnboundedQueuePattern<T, kSegmentSize, Semaphore>::destroy;
+	public:
+		/** Initialises the queue. */
+		inline UnboundedQueuePattern();
+		/** Destroys the queue. */
+		inline ~UnboundedQueuePattern();
+
+		UnboundedQueuePattern(UnboundedQueuePattern const&) = delete;
+		UnboundedQueuePattern &operator=(UnboundedQueuePattern const&) = delete;
+	};
+
+	template<class T, std::size_t kSegmentSize = 32>
+	/** POD unbounded queue type.
+	@tparam T:
+		The queue's data type.
+	@tparam kSegmentSize:
+		The number of values per segment. */
+	using PODUnboundedQueue = PODUnboundedQueuePattern<T, kSegmentSize, sync::PODSemaphore>;
+	template<class T, std::size_t kSegmentSize = 32>
+	/** POD unbounded queue type with FIFO notifications.
+	@tparam T:
+		The queue's data type.
+	@tparam kSegmentSize:
+		The number of values per segment. */
+	using PODFIFOUnboundedQueue = PODUnboundedQueuePattern<T, kSegmentSize, sync::PODFIFOSemaphore>;
+	template<class T, std::size_t kSegmentSize = 32>
+	/** Unbounded queue type.
+	@tparam T:
+		The queue's data type.
+	@tparam kSegmentSize:
+		The number of values per segment. */
+	using UnboundedQueue = UnboundedQueuePattern<T, kSegmentSize, sync::PODSemaphore>;
+	template<class T, std::size_t kSegmentSize = 32>
+	/** Unbounded queue type with FIFO notifications.
+	@tparam T:
+		The queue's data type.
+	@tparam kSegmentSize:
+		The number of values per segment. */
+	using FIFOUnboundedQueue = UnboundedQueuePattern<T, kSegmentSize, sync::PODFIFOSemaphore>;
+}
+
+#include "UnboundedQueue.inl"
+
+#endif
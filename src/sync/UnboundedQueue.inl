@@ -0,0 +1,100 @@
+#include <cassert>
+
+namespace cr::sync
+{
+	template<class T, std::size_t kSegmentSize, class Semaphore>
+	void PODUnboundedQueuePattern<T, kSegmentSize, Semaphore>::take(
+		T &target)
+	{
+		if(m_start == kSegmentSize)
+		{
+			// The element was pushed, so the next segment exists.
+			Segment * const empty = m_head;
+			m_head = empty->next;
+			m_start = 0;
+			SegmentPool::release(empty);
+		}
+		util::assign(target, std::move(m_head->values[m_start++]));
+	}
+
+	template<class T, std::size_t kSegmentSize, class Semaphore>
+	void PODUnboundedQueuePattern<T, kSegmentSize, Semaphore>::initialise()
+	{
+		m_head = m_tail = SegmentPool::allocate();
+		m_start = m_end = 0;
+		m_elements.initialise(0);
+		m_resumer = Resumer();
+	}
+
+	template<class T, std::size_t kSegmentSize, class Semaphore>
+	void PODUnboundedQueuePattern<T, kSegmentSize, Semaphore>::destroy()
+	{
+		while(Segment * segment = m_head)
+		{
+			m_head = segment->next;
+			SegmentPool::release(segment);
+		}
+		m_tail = nullptr;
+	}
+
+	template<class T, std::size_t kSegmentSize, class Semaphore>
+	void PODUnboundedQueuePattern<T, kSegmentSize, Semaphore>::set_resumer(
+		Resumer resumer)
+	{
+		m_resumer = resumer;
+	}
+
+	template<class T, std::size_t kSegmentSize, class Semaphore>
+	template<class V>
+	void PODUnboundedQueuePattern<T, kSegmentSize, Semaphore>::put(
+		V &&value)
+	{
+		if(m_end == kSegmentSize)
+		{
+			m_tail = m_tail->next = SegmentPool::allocate();
+			m_end = 0;
+		}
+		util::assign(m_tail->values[m_end++], std::forward<V>(value));
+		m_elements.notify(m_resumer);
+	}
+
+	template<class T, std::size_t kSegmentSize, class Semaphore>
+	void PODUnboundedQueuePattern<T, kSegmentSize, Semaphore>::push(
+		T const& value)
+	{
+		put(value);
+	}
+
+	template<class T, std::size_t kSegmentSize, class Semaphore>
+	void PODUnboundedQueuePattern<T, kSegmentSize, Semaphore>::push(
+		T &&value)
+	{
+		put(std::move(value));
+	}
+
+	template<class T, std::size_t kSegmentSize, class Semaphore>
+	CR_IMPL(PODUnboundedQueuePattern<T, kSegmentSize, Semaphore>::Pop)
+		CR_AWAIT(queue->m_elements.wait());
+		queue->take(*target);
+	CR_FINALLY
+	CR_IMPL_END
+
+	template<class T, std::size_t kSegmentSize, class Semaphore>
+	CR_IMPL(PODUnboundedQueuePattern<T, kSegmentSize, Semaphore>::TimedPop)
+		CR_AWAIT(queue->m_elements.wait_for(deadline));
+		queue->take(*target);
+	CR_FINALLY
+	CR_IMPL_END
+
+	template<class T, std::size_t kSegmentSize, class Semaphore>
+	UnboundedQueuePattern<T, kSegmentSize, Semaphore>::UnboundedQueuePattern()
+	{
+		initialise();
+	}
+
+	template<class T, std::size_t kSegmentSize, class Semaphore>
+	UnboundedQueuePattern<T, kSegmentSize, Semaphore>::~UnboundedQueuePattern()
+	{
+		destroy();
+	}
+}
@@ -0,0 +1,100 @@
+/** @file WaiterSlot.hpp
+	Contains the single waiter slot used by single-producer single-consumer primitives. */
+#ifndef __libcr_sync_detail_waiterslot_hpp_defined
+#define __libcr_sync_detail_waiterslot_hpp_defined
+
+#include "../Block.hpp"
+#include "../../Coroutine.hpp"
+#include "../../Timeout.hpp"
+#include "../../Resumer.hpp"
+
+namespace cr::sync::detail
+{
+	/** POD waiting slot for at most one coroutine.
+		Replaces a condition variable where only a single coroutine can ever wait. */
+	class PODWaiterSlot
+	{
+		/** The waiting coroutine or its timeout, or null. */
+		Coroutine * m_waiting;
+	public:
+		/** Initialises the slot to be empty. */
+		inline void initialise();
+
+		/** Helper class for waiting in the slot using `#CR_AWAIT`. */
+		class WaitCall
+		{
+			/** The slot to wait in. */
+			PODWaiterSlot &m_slot;
+		public:
+			/** Initialises the wait call.
+			@param[in] slot:
+				The slot to wait in. */
+			constexpr WaitCall(
+				PODWaiterSlot &slot);
+
+			/** Puts a coroutine into the slot.
+			@param[in] coroutine:
+				The waiting coroutine.
+			@return
+				Whether the call blocks. */
+			inline block libcr_wait(
+				Coroutine * coroutine);
+		};
+
+		/** Helper class for waiting in the slot with a timeout using `#CR_AWAIT`. */
+		class TimedWaitCall
+		{
+			/** The slot to wait in. */
+			PODWaiterSlot &m_slot;
+			/** The deadline of the wait. */
+			Deadline m_deadline;
+		public:
+			/** Initialises the timed wait call.
+			@param[in] slot:
+				The slot to wait in.
+			@param[in] deadline:
+				The deadline of the wait. */
+			constexpr TimedWaitCall(
+				PODWaiterSlot &slot,
+				Deadline const& deadline);
+
+			/** Puts a coroutine's timeout into the slot, and registers it with the scheduler.
+			@param[in] coroutine:
+				The waiting coroutine.
+			@return
+				Whether the call blocks. */
+			inline block libcr_wait(
+				Coroutine * coroutine);
+		};
+
+		/** Waits until `notify()` is called.
+			To be used with `#CR_AWAIT`. */
+		[[nodiscard]] constexpr WaitCall wait();
+		/** Waits until `notify()` is called or the deadline expires.
+			To be used with `#CR_AWAIT`.
+		@param[in] deadline:
+			The deadline of the wait, as created by the scheduler. */
+		[[nodiscard]] constexpr TimedWaitCall wait_for(
+			Deadline const& deadline);
+
+		/** Removes an expired timeout from the slot.
+		@param[in] timeout:
+			The timeout to remove.
+		@return
+			Whether the timeout was still in the slot. */
+		inline bool remove(
+			Coroutine * timeout);
+
+		/** Resumes the waiting coroutine, if any.
+		@param[in] resumer:
+			How to resume the coroutine.
+		@return
+			Whether a coroutine was resumed. */
+		inline bool notify(
+			Resumer resumer = Resumer());
+	};
+}
+
+#include "WaiterSlot.inl"
+
+#endif
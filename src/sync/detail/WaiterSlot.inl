@@ -0,0 +1,78 @@
+#include <cassert>
+
+namespace cr::sync::detail
+{
+	void PODWaiterSlot::initialise()
+	{
+		m_waiting = nullptr;
+	}
+
+	constexpr PODWaiterSlot::WaitCall::WaitCall(
+		PODWaiterSlot &slot):
+		m_slot(slot)
+	{
+	}
+
+	block PODWaiterSlot::WaitCall::libcr_wait(
+		Coroutine * coroutine)
+	{
+		assert(coroutine != nullptr);
+		assert(!m_slot.m_waiting && "Only a single coroutine can wait in a slot.");
+
+		m_slot.m_waiting = coroutine;
+		return block();
+	}
+
+	constexpr PODWaiterSlot::TimedWaitCall::TimedWaitCall(
+		PODWaiterSlot &slot,
+		Deadline const& deadline):
+		m_slot(slot),
+		m_deadline(deadline)
+	{
+	}
+
+	block PODWaiterSlot::TimedWaitCall::libcr_wait(
+		Coroutine * coroutine)
+	{
+		assert(coroutine != nullptr);
+
+		Deadline::Registration registration(
+			m_deadline,
+			coroutine,
+			&m_slot,
+			&PODTimeout::remove_from<PODWaiterSlot>);
+
+		return m_slot.wait().libcr_wait(registration.timeout());
+	}
+
+	constexpr PODWaiterSlot::WaitCall PODWaiterSlot::wait()
+	{
+		return WaitCall(*this);
+	}
+
+	constexpr PODWaiterSlot::TimedWaitCall PODWaiterSlot::wait_for(
+		Deadline const& deadline)
+	{
+		return TimedWaitCall(*this, deadline);
+	}
+
+	bool PODWaiterSlot::remove(
+		Coroutine * timeout)
+	{
+		if(m_waiting != timeout)
+			return false;
+		m_waiting = nullptr;
+		return true;
+	}
+
+	bool PODWaiterSlot::notify(
+		Resumer resumer)
+	{
+		Coroutine * waiting = m_waiting;
+		if(!waiting)
+			return false;
+		m_waiting = nullptr;
+		resumer(waiting);
+		return true;
+	}
+}
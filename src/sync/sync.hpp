@@ -4,13 +4,19 @@
 #define __libcr_sync_sync_hpp_defined
 
 #include "Barrier.hpp"
+#include "BroadcastRing.hpp"
+#include "Channel.hpp"
 #include "ConditionVariable.hpp"
 #include "Event.hpp"
 #include "Future.hpp"
 #include "Mutex.hpp"
 #include "Promise.hpp"
+#include "PriorityQueue.hpp"
 #include "Queue.hpp"
+#include "SPSCQueue.hpp"
 #include "Semaphore.hpp"
+#include "SharedMutex.hpp"
+#include "UnboundedQueue.hpp"
 
 /** Contains all synchronisation primitives.
 	These primitives are not thread-safe, however. For thread-safe versions, see namespace `cr::mt`. */
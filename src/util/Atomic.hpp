@@ -17,6 +17,7 @@ namespace cr::util
 		using std::atomic<T>::atomic;
 
 		/** Reads the globally latest value.
+			By default, this is a compare-and-swap, which takes the cache line exclusively even if nothing changes. With `LIBCR_FENCED_LOADS`, it is a full fence followed by a plain load instead, which relies on the hardware's cache coherence rather than on guarantees of the C++ memory model. This holds on multi-copy atomic architectures, such as x86 and ARMv8.
 		@param[in] order:
 			The memory order to use.
 		@return
@@ -3,6 +3,15 @@ namespace cr::util
 	template<class T>
 	T Atomic<T>::load_strong(std::memory_order order)
 	{
+#ifdef LIBCR_FENCED_LOADS
+		// After a full fence, cache coherence makes the load see every store that other threads made visible, without taking the cache line exclusively.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if(order == std::memory_order_release)
+			order = std::memory_order_relaxed;
+		else if(order == std::memory_order_acq_rel)
+			order = std::memory_order_acquire;
+		return std::atomic<T>::load(order);
+#else
 		T expected = T();
 		std::atomic<T>::compare_exchange_strong(
 			expected,
@@ -10,6 +19,7 @@ namespace cr::util
 			order,
 			order);
 		return expected;
+#endif
 	}
 
 	template<class T>
@@ -0,0 +1,43 @@
+#include "Backoff.hpp"
+
+#ifdef LIBCR_HAS_FUTEX
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace cr::util
+{
+	static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t));
+
+	void futex_wait(
+		std::atomic<std::uint32_t> &word,
+		std::uint32_t expected)
+	{
+		// Fails with EAGAIN if the word changed, and with EINTR on signals, both of which the caller handles by checking again.
+		(void) syscall(
+			SYS_futex,
+			reinterpret_cast<std::uint32_t *>(&word),
+			FUTEX_WAIT_PRIVATE,
+			expected,
+			nullptr,
+			nullptr,
+			0);
+	}
+
+	void futex_wake(
+		std::atomic<std::uint32_t> &word,
+		int count)
+	{
+		(void) syscall(
+			SYS_futex,
+			reinterpret_cast<std::uint32_t *>(&word),
+			FUTEX_WAKE_PRIVATE,
+			count,
+			nullptr,
+			nullptr,
+			0);
+	}
+}
+
+#endif
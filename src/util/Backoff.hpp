@@ -0,0 +1,80 @@
+/** @file Backoff.hpp
+	Contains the backoff policy shared by the library's internal spin loops. */
+#ifndef __libcr_util_backoff_hpp_defined
+#define __libcr_util_backoff_hpp_defined
+
+#include <atomic>
+#include <cstdint>
+
+#ifndef LIBCR_BACKOFF_MAX_SPINS
+/** How many spin-wait hints a backoff round executes at most.
+	Rounds start with a single hint, and double in length up to this value. */
+#define LIBCR_BACKOFF_MAX_SPINS 64
+#endif
+
+#ifndef LIBCR_BACKOFF_YIELD_ROUNDS
+/** After how many backoff rounds a spinning thread yields to the operating system instead of spinning. */
+#define LIBCR_BACKOFF_YIELD_ROUNDS 12
+#endif
+
+#ifndef LIBCR_BACKOFF_SLEEP_ROUNDS
+/** After how many backoff rounds a spinning thread blocks in the kernel, where supported. */
+#define LIBCR_BACKOFF_SLEEP_ROUNDS 16
+#endif
+
+#if defined(LIBCR_FUTEX) && defined(__linux__)
+/** Defined if spin loops that can block fall back to futexes. */
+#define LIBCR_HAS_FUTEX 1
+#endif
+
+namespace cr::util
+{
+	/** Executes the CPU's spin-wait hint, such as `pause` on x86.
+		Tells the CPU that the thread is spinning, so that it saves power and leaves execution resources to hyper-threaded siblings. */
+	inline void cpu_relax();
+
+	/** Exponential backoff for spin loops.
+		Waiting threads spin for exponentially growing rounds, and then yield to the operating system. Spin loops that can block should check `exhausted()`, and block in the kernel once it holds. The limits are configured at build time via `LIBCR_BACKOFF_MAX_SPINS`, `LIBCR_BACKOFF_YIELD_ROUNDS`, and `LIBCR_BACKOFF_SLEEP_ROUNDS`. */
+	class Backoff
+	{
+		/** How many backoff rounds were executed. */
+		std::uint32_t m_rounds;
+		/** How many spin-wait hints the next round executes. */
+		std::uint32_t m_spins;
+	public:
+		/** Creates a backoff that starts with the shortest round. */
+		constexpr Backoff();
+
+		/** Waits before the next attempt.
+			Spins for the current round's length, or yields the thread if spinning did not help for long enough. */
+		inline void pause();
+
+		/** Whether the caller should block instead of spinning on. */
+		inline bool exhausted() const;
+	};
+
+#ifdef LIBCR_HAS_FUTEX
+	/** Blocks the thread until a word is woken, unless it changed already.
+		May return spuriously.
+	@param[in] word:
+		The word to wait for.
+	@param[in] expected:
+		The word's value to block on. */
+	void futex_wait(
+		std::atomic<std::uint32_t> &word,
+		std::uint32_t expected);
+
+	/** Wakes threads that are blocked on a word.
+	@param[in] word:
+		The word to wake.
+	@param[in] count:
+		How many threads to wake at most. */
+	void futex_wake(
+		std::atomic<std::uint32_t> &word,
+		int count);
+#endif
+}
+
+#include "Backoff.inl"
+
+#endif
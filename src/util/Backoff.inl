@@ -0,0 +1,41 @@
+#include <thread>
+
+namespace cr::util
+{
+	void cpu_relax()
+	{
+#if defined(__x86_64__) || defined(__i386__)
+		__builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+		asm volatile("yield" ::: "memory");
+#else
+		std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+	}
+
+	constexpr Backoff::Backoff():
+		m_rounds(0),
+		m_spins(1)
+	{
+	}
+
+	void Backoff::pause()
+	{
+		if(m_rounds < LIBCR_BACKOFF_YIELD_ROUNDS)
+		{
+			for(std::uint32_t i = 0; i < m_spins; i++)
+				cpu_relax();
+			if(m_spins < LIBCR_BACKOFF_MAX_SPINS)
+				m_spins <<= 1;
+		} else
+			std::this_thread::yield();
+
+		if(m_rounds < LIBCR_BACKOFF_SLEEP_ROUNDS)
+			++m_rounds;
+	}
+
+	bool Backoff::exhausted() const
+	{
+		return m_rounds >= LIBCR_BACKOFF_SLEEP_ROUNDS;
+	}
+}
@@ -1,11 +1,13 @@
 /** @file CVTraits.hpp
-	Contains the add_cv_pod_t and remove_cv_pod_t helper types. */
+	Contains the add_cv_pod_t and remove_cv_pod_t helper types, and the is_mt_cv_v helper constant. */
 #ifndef __libcr_util_cvtraits_hpp_defined
 #define __libcr_util_cvtraits_hpp_defined
 
 #include "../mt/ConditionVariable.hpp"
 #include "../sync/ConditionVariable.hpp"
 
+#include <type_traits>
+
 namespace cr::util
 {
 	template<class ConditionVariable>
@@ -33,12 +35,24 @@ namespace cr::util
 	template<> struct RemoveCVPOD<sync::FIFOConditionVariable> { typedef sync::FIFOConditionVariable type; };
 	template<> struct AddCVPOD<sync::FIFOConditionVariable> { typedef sync::PODFIFOConditionVariable type; };
 
+	template<class ConditionVariable>
+	/** Helper type for checking whether a condition variable is thread-safe. */
+	struct IsMtCV : std::false_type {};
+
+	template<> struct IsMtCV<mt::PODConditionVariable> : std::true_type {};
+	template<> struct IsMtCV<mt::ConditionVariable> : std::true_type {};
+	template<> struct IsMtCV<mt::PODFIFOConditionVariable> : std::true_type {};
+	template<> struct IsMtCV<mt::FIFOConditionVariable> : std::true_type {};
+
 	template<class ConditionVariable>
 	/** Gets the non-POD version of a condition variable. */
 	using remove_cv_pod_t = typename RemoveCVPOD<ConditionVariable>::type;
 	template<class ConditionVariable>
 	/** Gets the POD version of a condition variable. */
 	using add_cv_pod_t = typename AddCVPOD<ConditionVariable>::type;
+	template<class ConditionVariable>
+	/** Whether a condition variable is thread-safe. */
+	constexpr bool is_mt_cv_v = IsMtCV<ConditionVariable>::value;
 }
 
 #endif
\ No newline at end of file
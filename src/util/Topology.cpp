@@ -0,0 +1,85 @@
+#include "Topology.hpp"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <tuple>
+
+namespace cr::util
+{
+#ifdef __linux__
+	/** Reads a CPU's topology attribute.
+	@param[in] cpu:
+		The CPU number.
+	@param[in] attribute:
+		The attribute's name.
+	@return
+		The attribute's value, or -1 if unknown. */
+	static int topology(
+		int cpu,
+		char const * attribute)
+	{
+		std::ifstream file("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/" + attribute);
+		int value = -1;
+		if(!(file >> value))
+			return -1;
+		return value;
+	}
+#endif
+
+	std::vector<int> cpu_order()
+	{
+		std::vector<int> order;
+#ifdef __linux__
+		cpu_set_t allowed;
+		if(sched_getaffinity(0, sizeof(allowed), &allowed))
+			return order;
+
+		// (sibling index, package, core, cpu)
+		std::vector<std::tuple<int, int, int, int>> cpus;
+		for(int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+		{
+			if(!CPU_ISSET(cpu, &allowed))
+				continue;
+
+			int package = topology(cpu, "physical_package_id");
+			int core = topology(cpu, "core_id");
+			int sibling = 0;
+			if(core != -1)
+				for(auto const &other : cpus)
+					if(std::get<1>(other) == package && std::get<2>(other) == core)
+						sibling++;
+
+			cpus.emplace_back(sibling, package, core, cpu);
+		}
+
+		std::sort(cpus.begin(), cpus.end());
+		order.reserve(cpus.size());
+		for(auto const &cpu : cpus)
+			order.push_back(std::get<3>(cpu));
+#endif
+		return order;
+	}
+
+	bool pin_thread(
+		int cpu)
+	{
+#ifdef __linux__
+		if(cpu < 0 || cpu >= CPU_SETSIZE)
+			return false;
+
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		CPU_SET(cpu, &set);
+		return !pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+		(void) cpu;
+		return false;
+#endif
+	}
+}
@@ -0,0 +1,25 @@
+/** @file Topology.hpp
+	Contains helpers for placing scheduling threads on CPUs. */
+#ifndef __libcr_util_topology_hpp_defined
+#define __libcr_util_topology_hpp_defined
+
+#include <vector>
+
+namespace cr::util
+{
+	/** Lists the CPUs the process may run on, in the order in which threads should be placed on them.
+		Physical cores come before their hyper-threaded siblings, and the cores of one package are listed together. The topology is read from `/sys/devices/system/cpu`.
+	@return
+		The CPU numbers, or an empty list if they cannot be determined on this platform. */
+	std::vector<int> cpu_order();
+
+	/** Pins the calling thread to a CPU.
+	@param[in] cpu:
+		The CPU number.
+	@return
+		Whether the thread was pinned. Always fails on platforms without thread affinity support. */
+	bool pin_thread(
+		int cpu);
+}
+
+#endif
@@ -6,6 +6,7 @@
 #include "Argument.hpp"
 #include "AutoCoroutine.hpp"
 #include "CVTraits.hpp"
+#include "Topology.hpp"
 
 /** Contains all utilities used by or useful for the coroutine library. */
 namespace cr::util